@@ -0,0 +1,105 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: Arena.cpp contains the block list behind the arena allocator.
+ *
+ * Blocks form a list that is only ever appended to; current is the block allocations
+ * come from. A reset points current back at the first block, and the blocks after it
+ * are reused in order as the next simulation grows into them.
+*/
+
+
+
+#include "Arena.h"
+#include <string.h>
+
+#define ARENA_HEADER ((sizeof(ArenaBlock) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+
+
+/*************************************************************************
+*   @ Arena                                                               *
+*                                                                         *
+ *************************************************************************/
+
+void arenaInit(Arena* arena, size_t blockBytes)
+{
+	memset(arena, 0, sizeof(*arena));
+	arena->blockBytes = blockBytes > 0 ? blockBytes : ARENA_BLOCK_BYTES;
+}
+
+/* Returns ARENA_ALIGN aligned memory, not cleared, or NULL when malloc fails. */
+
+void* arenaAlloc(Arena* arena, size_t bytes)
+{
+	ArenaBlock* block = arena->current;
+
+	bytes = (bytes + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+
+	if ((block == NULL) || (block->size - block->used < bytes))
+	{
+		ArenaBlock* next = block != NULL ? block->next : arena->first;
+
+		if ((next == NULL) || (next->size < bytes))
+		{
+			size_t size = bytes > arena->blockBytes ? bytes : arena->blockBytes;
+
+			next = (ArenaBlock*)malloc(ARENA_HEADER + size);
+
+			if (next == NULL)
+			{
+				return NULL;
+			}
+			next->size = size;
+			arena->blocks++;
+
+			/* A new block goes right after the current one; retained blocks stay behind it. */
+
+			if (block != NULL)
+			{
+				next->next  = block->next;
+				block->next = next;
+			}
+			else
+			{
+				next->next   = arena->first;
+				arena->first = next;
+			}
+		}
+
+		next->used     = 0;
+		arena->current = next;
+		block          = next;
+	}
+
+	void* memory = (unsigned char*)block + ARENA_HEADER + block->used;
+
+	block->used += bytes;
+
+	return memory;
+}
+
+void arenaReset(Arena* arena)
+{
+	arena->current = arena->first;
+
+	if (arena->first != NULL)
+	{
+		arena->first->used = 0;
+	}
+}
+
+void arenaFree(Arena* arena)
+{
+	while (arena->first != NULL)
+	{
+		ArenaBlock* next = arena->first->next;
+
+		free(arena->first);
+		arena->first = next;
+	}
+	arena->current = NULL;
+}
+
+/*************************************************************************
+*   @ End of Arena                                                        *
+*                                                                         *
+ *************************************************************************/
@@ -0,0 +1,39 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: Bump allocator for simulation state. Engines and page indexes created in an
+ * arena carve their arrays from a few large blocks instead of one malloc each; a reset
+ * rewinds the arena in O(1) and keeps its blocks, so the next simulation of the same
+ * size runs without a single call to malloc.
+*/
+
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdlib.h>
+
+#define ARENA_BLOCK_BYTES    (1 << 20)
+#define ARENA_ALIGN          16
+
+
+struct ArenaBlock
+{
+	ArenaBlock* next;
+	size_t      size;            /* usable bytes after the header */
+	size_t      used;
+};
+
+struct Arena
+{
+	ArenaBlock*        first;
+	ArenaBlock*        current;
+	size_t             blockBytes;
+	unsigned long long blocks;       /* blocks ever allocated, i.e. calls to malloc */
+};
+
+void  arenaInit(Arena* arena, size_t blockBytes);
+void* arenaAlloc(Arena* arena, size_t bytes);
+void  arenaReset(Arena* arena);
+void  arenaFree(Arena* arena);
+
+#endif // !ARENA_H
@@ -0,0 +1,514 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: Belady.cpp contains the small-string FIFO / CLOCK simulator and the exhaustive
+ * and random anomaly searches.
+ *
+ * Exhaustive search: only strings in canonical form are generated (every page appears
+ * for the first time in the order 0, 1, 2, ...), since renaming pages does not change any
+ * fault count. All canonical prefixes of BELADY_PREFIX_LENGTH references are the work
+ * items; threads take them in order and extend each one depth first, advancing one
+ * simulator per frame count by a single reference at every level. A string's index is
+ * its position in lexicographic order, so the counterexample with the lowest index is the
+ * shortest and lexicographically first; threads skip work above the best index found.
+ *
+ * Random search: sample i is generated from the seed and i alone, so the result does not
+ * depend on the thread count; the first anomalous sample is shrunk by dropping references
+ * for as long as the anomaly stays.
+*/
+
+
+
+#include "Belady.h"
+#include "PagingEngine.h"
+#include "TraceParser.h"
+#include <string.h>
+#include <stdio.h>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+
+
+/* One simulation with a fixed frame count; no allocation, pages are small numbers. */
+
+struct BeladySim
+{
+	unsigned char  frame[BELADY_MAX_PAGES];        /* page in each frame */
+	unsigned char  where[BELADY_MAX_PAGES];        /* frame of each page, BELADY_NONE when out */
+	unsigned char  referenced[BELADY_MAX_PAGES];   /* CLOCK */
+	unsigned char  used;
+	unsigned char  hand;
+	unsigned short faults;
+};
+
+struct BeladySearch
+{
+	int                             policy;
+	int                             pages;
+	int                             length;          /* length of the strings searched now */
+	int                             lowFrames;       /* k and k + 1 are compared for k in */
+	int                             highFrames;      /* [lowFrames, highFrames] */
+	unsigned long long              samples;         /* 0: exhaustive */
+	unsigned long long              seed;
+	unsigned char*                  prefixes;
+	int                             prefixLength;
+	size_t                          prefixesNum;
+	std::atomic<size_t>             next;
+	std::atomic<size_t>             best;            /* lowest work item with a counterexample */
+	std::atomic<unsigned long long> checked;
+	std::mutex                      lock;
+	unsigned char                   found[BELADY_MAX_LENGTH];
+};
+
+
+static void   beladyReset(const BeladySearch* search, BeladySim* sims);
+static void   beladyAccess(BeladySim* sim, int policy, int framesNum, int page);
+static int    findAnomaly(const BeladySearch* search, const BeladySim* sims);
+static int    stringAnomaly(const BeladySearch* search, const unsigned char* refs, int length, BeladySim* sims);
+static int    extendString(BeladySearch* search, const BeladySim* sims, unsigned char* refs, int depth, int distinct,
+	unsigned long long* checked);
+static void   recordFound(BeladySearch* search, size_t item, const unsigned char* refs);
+static void   listPrefixes(BeladySearch* search, unsigned char* prefix, int depth, int distinct);
+static void   exhaustiveWorker(BeladySearch* search);
+static void   randomWorker(BeladySearch* search);
+static int    shrinkString(const BeladySearch* search, unsigned char* refs, int length);
+
+
+/*************************************************************************
+*   @ Small simulator                                                     *
+*                                                                         *
+*  Same replacement as the FIFO and CLOCK engines: frames are filled in   *
+*  order, the hand starts at frame 0 and CLOCK sets the referenced bit on *
+*  every load and hit.                                                    *
+ *************************************************************************/
+
+static void beladyReset(const BeladySearch* search, BeladySim* sims)
+{
+	for (int k = search->lowFrames; k <= search->highFrames + 1; k++)
+	{
+		memset(&sims[k], 0, sizeof(BeladySim));
+		memset(sims[k].where, BELADY_NONE, sizeof(sims[k].where));
+	}
+}
+
+static inline void beladyAccess(BeladySim* sim, int policy, int framesNum, int page)
+{
+	int frame = sim->where[page];
+
+	if (frame != BELADY_NONE)
+	{
+		sim->referenced[frame] = 1;
+		return;
+	}
+
+	sim->faults++;
+
+	if (sim->used < framesNum)
+	{
+		frame = sim->used++;
+	}
+	else
+	{
+		while ((policy == POLICY_CLOCK) && sim->referenced[sim->hand])
+		{
+			sim->referenced[sim->hand] = 0;
+			sim->hand = sim->hand + 1 == framesNum ? 0 : sim->hand + 1;
+		}
+
+		frame     = sim->hand;
+		sim->hand = sim->hand + 1 == framesNum ? 0 : sim->hand + 1;
+		sim->where[sim->frame[frame]] = BELADY_NONE;
+	}
+
+	sim->frame[frame]      = (unsigned char)page;
+	sim->where[page]       = (unsigned char)frame;
+	sim->referenced[frame] = 1;
+}
+
+/* Returns the k whose k + 1 frames fault more than k frames, 0 if none. */
+
+static int findAnomaly(const BeladySearch* search, const BeladySim* sims)
+{
+	for (int k = search->lowFrames; k <= search->highFrames; k++)
+	{
+		if (sims[k + 1].faults > sims[k].faults)
+		{
+			return k;
+		}
+	}
+
+	return 0;
+}
+
+static int stringAnomaly(const BeladySearch* search, const unsigned char* refs, int length, BeladySim* sims)
+{
+	beladyReset(search, sims);
+
+	for (int i = 0; i < length; i++)
+	{
+		for (int k = search->lowFrames; k <= search->highFrames + 1; k++)
+		{
+			beladyAccess(&sims[k], search->policy, k, refs[i]);
+		}
+	}
+
+	return findAnomaly(search, sims);
+}
+
+/*************************************************************************
+*   @ End of Small simulator                                              *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Exhaustive search                                                   *
+*                                                                         *
+ *************************************************************************/
+
+static int extendString(BeladySearch* search, const BeladySim* sims, unsigned char* refs, int depth, int distinct,
+	unsigned long long* checked)
+{
+	BeladySim next[BELADY_MAX_PAGES + 1];
+	int       last = distinct < search->pages ? distinct : search->pages - 1;
+
+	if (depth == search->length)
+	{
+		(*checked)++;
+		return findAnomaly(search, sims) != 0;
+	}
+
+	for (int page = 0; page <= last; page++)
+	{
+		for (int k = search->lowFrames; k <= search->highFrames + 1; k++)
+		{
+			next[k] = sims[k];
+			beladyAccess(&next[k], search->policy, k, page);
+		}
+		refs[depth] = (unsigned char)page;
+
+		if (extendString(search, next, refs, depth + 1, distinct + (page == distinct), checked))
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+static void recordFound(BeladySearch* search, size_t item, const unsigned char* refs)
+{
+	std::lock_guard<std::mutex> guard(search->lock);
+
+	if (item < search->best)
+	{
+		memcpy(search->found, refs, (size_t)search->length);
+		search->best = item;
+	}
+}
+
+/* Appends the canonical prefixes in lexicographic order; with prefixes NULL only counts them. */
+
+static void listPrefixes(BeladySearch* search, unsigned char* prefix, int depth, int distinct)
+{
+	if (depth == search->prefixLength)
+	{
+		if (search->prefixes != NULL)
+		{
+			memcpy(search->prefixes + search->prefixesNum * search->prefixLength, prefix, (size_t)depth);
+		}
+		search->prefixesNum++;
+		return;
+	}
+
+	for (int page = 0; page <= (distinct < search->pages ? distinct : search->pages - 1); page++)
+	{
+		prefix[depth] = (unsigned char)page;
+		listPrefixes(search, prefix, depth + 1, distinct + (page == distinct));
+	}
+}
+
+static void exhaustiveWorker(BeladySearch* search)
+{
+	BeladySim          sims[BELADY_MAX_PAGES + 1];
+	unsigned char      refs[BELADY_MAX_LENGTH];
+	unsigned long long checked = 0;
+	size_t             item;
+
+	while (((item = search->next++) < search->prefixesNum) && (item < search->best))
+	{
+		int distinct = 0;
+
+		memcpy(refs, search->prefixes + item * search->prefixLength, (size_t)search->prefixLength);
+		beladyReset(search, sims);
+
+		for (int i = 0; i < search->prefixLength; i++)
+		{
+			for (int k = search->lowFrames; k <= search->highFrames + 1; k++)
+			{
+				beladyAccess(&sims[k], search->policy, k, refs[i]);
+			}
+			distinct += refs[i] == distinct;
+		}
+
+		if (extendString(search, sims, refs, search->prefixLength, distinct, &checked))
+		{
+			recordFound(search, item, refs);
+		}
+	}
+
+	search->checked += checked;
+}
+
+/*************************************************************************
+*   @ End of Exhaustive search                                            *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Random search                                                       *
+*                                                                         *
+ *************************************************************************/
+
+static void randomWorker(BeladySearch* search)
+{
+	BeladySim          sims[BELADY_MAX_PAGES + 1];
+	unsigned char      refs[BELADY_MAX_LENGTH];
+	unsigned long long checked = 0;
+	size_t             item;
+
+	while (((item = search->next++) < search->samples) && (item < search->best))
+	{
+		unsigned long long state = search->seed ^ pageHash(item + 1);
+
+		for (int i = 0; i < search->length; i++)
+		{
+			state  += 0x9e3779b97f4a7c15ULL;
+			refs[i] = (unsigned char)(pageHash(state) % (unsigned long long)search->pages);
+		}
+		checked++;
+
+		if (stringAnomaly(search, refs, search->length, sims))
+		{
+			recordFound(search, item, refs);
+		}
+	}
+
+	search->checked += checked;
+}
+
+/* Drops references while the anomaly stays, then renames pages in order of first use. */
+
+static int shrinkString(const BeladySearch* search, unsigned char* refs, int length)
+{
+	BeladySim     sims[BELADY_MAX_PAGES + 1];
+	unsigned char trial[BELADY_MAX_LENGTH];
+	unsigned char name[BELADY_MAX_PAGES];
+	int           named = 0;
+
+	for (int changed = 1; changed;)
+	{
+		changed = 0;
+
+		for (int i = 0; i < length; i++)
+		{
+			memcpy(trial, refs, (size_t)i);
+			memcpy(trial + i, refs + i + 1, (size_t)(length - i - 1));
+
+			if (stringAnomaly(search, trial, length - 1, sims))
+			{
+				memcpy(refs, trial, (size_t)(length - 1));
+				length--;
+				i--;
+				changed = 1;
+			}
+		}
+	}
+
+	memset(name, BELADY_NONE, sizeof(name));
+
+	for (int i = 0; i < length; i++)
+	{
+		if (name[refs[i]] == BELADY_NONE)
+		{
+			name[refs[i]] = (unsigned char)named++;
+		}
+		refs[i] = name[refs[i]];
+	}
+
+	return length;
+}
+
+/*************************************************************************
+*   @ End of Random search                                                *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Belady command                                                      *
+*                                                                         *
+ *************************************************************************/
+
+static int runBeladySearch(BeladySearch* search, int maxLength, int threads)
+{
+	std::thread   workers[TRACE_MAX_THREADS];
+	unsigned char prefix[BELADY_MAX_LENGTH];
+	int           length = 0;
+
+	search->checked = 0;
+	search->best    = (size_t)-1;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	/* Exhaustive: one length at a time, so the first hit is a shortest counterexample. */
+
+	for (search->length = search->samples > 0 ? maxLength : 1; search->length <= maxLength; search->length++)
+	{
+		search->next = 0;
+
+		if (search->samples == 0)
+		{
+			search->prefixLength = search->length < BELADY_PREFIX_LENGTH ? search->length : BELADY_PREFIX_LENGTH;
+			search->prefixes     = NULL;
+			search->prefixesNum  = 0;
+			listPrefixes(search, prefix, 0, 0);
+			search->prefixes     = (unsigned char*)malloc(search->prefixesNum * search->prefixLength);
+
+			if (search->prefixes == NULL)
+			{
+				return -1;
+			}
+			search->prefixesNum = 0;
+			listPrefixes(search, prefix, 0, 0);
+		}
+
+		for (int t = 1; t < threads; t++)
+		{
+			workers[t] = std::thread(search->samples > 0 ? randomWorker : exhaustiveWorker, search);
+		}
+		(search->samples > 0 ? randomWorker : exhaustiveWorker)(search);
+
+		for (int t = 1; t < threads; t++)
+		{
+			workers[t].join();
+		}
+
+		free(search->prefixes);
+		search->prefixes = NULL;
+
+		if (search->best != (size_t)-1)
+		{
+			length = search->length;
+			break;
+		}
+	}
+
+	if ((length > 0) & (search->samples > 0))
+	{
+		length = shrinkString(search, search->found, length);
+	}
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	printf("\n Belady search %s: %d pages, %s up to %d references, frames %d-%d, %d threads\n",
+		policyName(search->policy), search->pages, search->samples > 0 ? "random strings" : "all strings", maxLength,
+		search->lowFrames, search->highFrames + 1, threads);
+	printf(" Checked %llu strings in %.2f s\n", (unsigned long long)search->checked, seconds);
+
+	if (length == 0)
+	{
+		printf(" No anomaly found\n");
+		return 0;
+	}
+
+	BeladySearch all;
+	BeladySim    sims[BELADY_MAX_PAGES + 1];
+
+	all.policy     = search->policy;
+	all.lowFrames  = 1;
+	all.highFrames = search->pages - 1;
+	stringAnomaly(&all, search->found, length, sims);
+
+	printf(" Counterexample of %d references:", length);
+
+	for (int i = 0; i < length; i++)
+	{
+		printf(" %d", search->found[i] + 1);
+	}
+	printf("\n\n");
+	printf(" ---------------------------\n");
+	printf("| Frames | Faults | Anomaly |\n");
+	printf(" ---------------------------\n");
+
+	for (int k = 1; k <= search->pages; k++)
+	{
+		printf("| %6d | %6d | %-7s |\n", k, sims[k].faults,
+			(k > 1) && (sims[k].faults > sims[k - 1].faults) ? "  yes" : "");
+	}
+	printf(" ---------------------------\n");
+
+	return 0;
+}
+
+int runBeladyCommand(int argCount, char* args[])
+{
+	BeladySearch search;
+	int          policies[2];
+	int          policiesNum = 0;
+	int          status      = 0;
+
+	if (argCount < 4)
+	{
+		printf("Usage: %s\n", BELADY_USAGE);
+		return -1;
+	}
+
+	int pages     = atoi(args[2]);
+	int maxLength = atoi(args[3]);
+	int frames    = argCount > 4 ? atoi(args[4]) : 0;
+	int threads   = argCount > 5 ? atoi(args[5]) : 0;
+
+	if ((strcmp(args[1], "fifo") == 0) | (strcmp(args[1], "all") == 0))
+	{
+		policies[policiesNum++] = POLICY_FIFO;
+	}
+	if ((strcmp(args[1], "clock") == 0) | (strcmp(args[1], "all") == 0))
+	{
+		policies[policiesNum++] = POLICY_CLOCK;
+	}
+
+	if (threads <= 0)
+	{
+		threads = (int)std::thread::hardware_concurrency();
+	}
+	threads = threads < 1 ? 1 : threads > TRACE_MAX_THREADS ? TRACE_MAX_THREADS : threads;
+
+	if ((policiesNum == 0) | (pages < 2) | (pages > BELADY_MAX_PAGES) | (maxLength < 1) |
+		(maxLength > BELADY_MAX_LENGTH) | (frames < 0) | (frames >= pages))
+	{
+		printf("Usage: %s\n", BELADY_USAGE);
+		return -1;
+	}
+
+	search.pages      = pages;
+	search.lowFrames  = frames > 0 ? frames : 1;
+	search.highFrames = frames > 0 ? frames : pages - 1;
+	search.samples    = argCount > 6 ? strtoull(args[6], NULL, 10) : 0;
+	search.seed       = argCount > 7 ? strtoull(args[7], NULL, 10) : 1;
+	search.prefixes   = NULL;
+
+	for (int p = 0; (p < policiesNum) & (status == 0); p++)
+	{
+		search.policy = policies[p];
+		status        = runBeladySearch(&search, maxLength, threads);
+	}
+
+	return status;
+}
+
+/*************************************************************************
+*   @ End of Belady command                                               *
+*                                                                         *
+ *************************************************************************/
@@ -0,0 +1,22 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: Search for Belady's anomaly, a reference string on which a policy faults more
+ * with k + 1 frames than with k. Short strings are enumerated exhaustively by increasing
+ * length, or long ones sampled at random and shrunk, on several threads, reporting the
+ * smallest counterexample found. Only non-stack policies (FIFO, CLOCK) can show it.
+*/
+
+
+#ifndef BELADY_H
+#define BELADY_H
+
+#define BELADY_USAGE         "belady <fifo|clock|all> <pages> <maxLength> [frames] [threads] [samples] [seed]"
+#define BELADY_MAX_PAGES     16
+#define BELADY_MAX_LENGTH    64
+#define BELADY_PREFIX_LENGTH 8
+#define BELADY_NONE          0xFF
+
+
+int runBeladyCommand(int argCount, char* args[]);
+
+#endif // !BELADY_H
@@ -0,0 +1,44 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: Bit scans on 64-bit words, with the intrinsic of the compiler at hand. Both
+ * count from the least significant bit and need a word that is not zero.
+*/
+
+
+#ifndef BITS_H
+#define BITS_H
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+
+/* Number of zero bits above the highest set bit of word. */
+
+static inline int countLeadingZeros(unsigned long long word)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+
+	_BitScanReverse64(&index, word);
+	return 63 - (int)index;
+#else
+	return __builtin_clzll(word);
+#endif
+}
+
+/* Number of zero bits below the lowest set bit of word. */
+
+static inline int countTrailingZeros(unsigned long long word)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+
+	_BitScanForward64(&index, word);
+	return (int)index;
+#else
+	return __builtin_ctzll(word);
+#endif
+}
+
+#endif // !BITS_H
@@ -0,0 +1,698 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: FaultCapture.cpp contains the userfaultfd fault capture, its fault ring and
+ * flusher, and three sample workloads for the 'capture' command.
+ *
+ * The heap is a memfd (shmem) mapping registered for missing and, where the kernel has
+ * UFFD_FEATURE_MINOR_SHMEM, minor faults. Missing faults are resolved with a zero page.
+ * Re-arming drops the page table entries with MADV_DONTNEED while the data stays in the
+ * memfd, so the next access raises a minor fault resolved with UFFDIO_CONTINUE. Only the
+ * first access to a page in each re-arm interval is recorded, which keeps the overhead
+ * far below instruction level tracing.
+*/
+
+
+
+#include "FaultCapture.h"
+#include "TraceParser.h"
+#include "TraceCommands.h"
+#include "PagingEngine.h"
+#include <string.h>
+#include <atomic>
+#include <thread>
+
+#ifdef __linux__
+#include <linux/userfaultfd.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#define FAULT_CAPTURE_SUPPORTED
+#endif
+
+#ifndef UFFD_USER_MODE_ONLY
+#define UFFD_USER_MODE_ONLY 1
+#endif
+
+
+struct FaultEvent
+{
+	unsigned long long page;
+	unsigned long long time;
+	unsigned char      access;
+};
+
+
+/* Single producer (fault handler) / single consumer (flusher) ring. */
+
+struct FaultRing
+{
+	FaultEvent*         events;
+	size_t              mask;
+	std::atomic<size_t> head;
+	std::atomic<size_t> tail;
+};
+
+
+/* Capture state; one capture per process, like the menu's reference string. heapUsed
+ * is written by the workload's thread and read by the handler when it re-arms. */
+
+static struct
+{
+	int                 uffd;
+	int                 memfd;
+	char*               heap;
+	size_t              heapBytes;
+	std::atomic<size_t> heapUsed;
+	size_t              pageBytes;
+	int                 minorFaults;
+	unsigned int        rearmMs;
+	unsigned long long  startNs;
+	unsigned int        pid;
+	std::atomic<int>    running;
+	std::thread         handler;
+	std::thread         flusher;
+	FaultRing           ring;
+	TraceWriter         writer;
+	CaptureStats        stats;
+	int                 failed;         /* a fault could not be resolved, capture stopped */
+} capture;
+
+
+static void runWorkload(const char* name, size_t heapBytes);
+
+#ifdef FAULT_CAPTURE_SUPPORTED
+
+static unsigned long long nowNs();
+static void handlerLoop();
+static void flusherLoop();
+static void resolveFault(const struct uffd_msg* msg);
+static void stopOnFailure(unsigned long long address, int error);
+
+
+/*************************************************************************
+*   @ Fault ring                                                          *
+*                                                                         *
+*  The handler never blocks on the ring: the faulting thread is stopped   *
+*  until the fault is resolved, so a full ring drops the event instead.   *
+ *************************************************************************/
+
+static int ringPush(FaultRing* ring, const FaultEvent* event)
+{
+	size_t head = ring->head.load(std::memory_order_relaxed);
+
+	if (head - ring->tail.load(std::memory_order_acquire) > ring->mask)
+	{
+		return -1;
+	}
+
+	ring->events[head & ring->mask] = *event;
+	ring->head.store(head + 1, std::memory_order_release);
+
+	return 0;
+}
+
+static size_t ringPop(FaultRing* ring, PageRef* refs, size_t max, unsigned int pid)
+{
+	size_t tail  = ring->tail.load(std::memory_order_relaxed);
+	size_t count = ring->head.load(std::memory_order_acquire) - tail;
+
+	if (count > max)
+	{
+		count = max;
+	}
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const FaultEvent* event = &ring->events[(tail + i) & ring->mask];
+
+		refs[i].page   = event->page;
+		refs[i].time   = event->time;
+		refs[i].pid    = pid;
+		refs[i].access = event->access;
+	}
+
+	ring->tail.store(tail + count, std::memory_order_release);
+
+	return count;
+}
+
+/*************************************************************************
+*   @ End of Fault ring                                                   *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Capture start                                                       *
+*                                                                         *
+*  Creates the memfd heap, opens userfaultfd (user mode only first, so    *
+*  unprivileged users work with vm.unprivileged_userfaultfd = 0),         *
+*  negotiates minor fault support and starts handler and flusher.         *
+ *************************************************************************/
+
+int captureStart(const char* tracePath, size_t heapBytes, unsigned int rearmMs)
+{
+	struct uffdio_api      api;
+	struct uffdio_register reg;
+
+	memset(&capture.stats, 0, sizeof(capture.stats));
+	capture.pageBytes = (size_t)sysconf(_SC_PAGESIZE);
+	capture.heapBytes = (heapBytes + capture.pageBytes - 1) & ~(capture.pageBytes - 1);
+	capture.heapUsed.store(0);
+	capture.failed    = 0;
+	capture.rearmMs   = rearmMs;
+	capture.pid       = (unsigned int)getpid();
+
+	capture.memfd = memfd_create("pgcapture", MFD_CLOEXEC);
+
+	if ((capture.memfd < 0) || (ftruncate(capture.memfd, (off_t)capture.heapBytes) != 0))
+	{
+		printf("Cannot create capture heap!\n");
+		return -1;
+	}
+
+	capture.heap = (char*)mmap(NULL, capture.heapBytes, PROT_READ | PROT_WRITE, MAP_SHARED, capture.memfd, 0);
+
+	if (capture.heap == MAP_FAILED)
+	{
+		printf("Cannot map capture heap!\n");
+		close(capture.memfd);
+		return -1;
+	}
+
+	capture.minorFaults = 1;
+
+	for (int attempt = 0; attempt < 4; attempt++)
+	{
+		int flags = O_CLOEXEC | O_NONBLOCK | ((attempt & 1) == 0 ? UFFD_USER_MODE_ONLY : 0);
+
+		capture.uffd = (int)syscall(SYS_userfaultfd, flags);
+
+		if (capture.uffd < 0)
+		{
+			continue;
+		}
+
+		memset(&api, 0, sizeof(api));
+		api.api      = UFFD_API;
+		api.features = attempt < 2 ? UFFD_FEATURE_MINOR_SHMEM : 0;
+
+		if (ioctl(capture.uffd, UFFDIO_API, &api) == 0)
+		{
+			capture.minorFaults = attempt < 2;
+			break;
+		}
+
+		close(capture.uffd);
+		capture.uffd = -1;
+	}
+
+	if (capture.uffd < 0)
+	{
+		printf("userfaultfd is not available (check vm.unprivileged_userfaultfd)!\n");
+		munmap(capture.heap, capture.heapBytes);
+		close(capture.memfd);
+		return -1;
+	}
+
+	memset(&reg, 0, sizeof(reg));
+	reg.range.start = (unsigned long long)(size_t)capture.heap;
+	reg.range.len   = capture.heapBytes;
+	reg.mode        = UFFDIO_REGISTER_MODE_MISSING | (capture.minorFaults ? UFFDIO_REGISTER_MODE_MINOR : 0);
+
+	capture.ring.events = (FaultEvent*)malloc(CAPTURE_RING_EVENTS * sizeof(FaultEvent));
+	capture.ring.mask   = CAPTURE_RING_EVENTS - 1;
+	capture.ring.head.store(0);
+	capture.ring.tail.store(0);
+
+	if ((ioctl(capture.uffd, UFFDIO_REGISTER, &reg) != 0) || (capture.ring.events == NULL) ||
+		(traceWriterOpen(&capture.writer, tracePath) != 0))
+	{
+		printf("Cannot register capture heap!\n");
+
+		if (capture.writer.file != NULL)
+		{
+			traceWriterClose(&capture.writer);
+		}
+		free(capture.ring.events);
+		close(capture.uffd);
+		munmap(capture.heap, capture.heapBytes);
+		close(capture.memfd);
+		return -1;
+	}
+
+	if ((rearmMs > 0) & !capture.minorFaults)
+	{
+		printf("Kernel has no shmem minor faults; only first touches are captured.\n");
+	}
+
+	capture.startNs = nowNs();
+	capture.running.store(1);
+	capture.handler = std::thread(handlerLoop);
+	capture.flusher = std::thread(flusherLoop);
+
+	return 0;
+}
+
+/*************************************************************************
+*   @ End of Capture start                                                *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Capture alloc                                                       *
+*                                                                         *
+*  Bump allocator over the registered heap, 64 byte aligned. Workloads    *
+*  allocate once and keep their memory for the whole capture.             *
+ *************************************************************************/
+
+void* captureAlloc(size_t bytes)
+{
+	size_t offset = (capture.heapUsed.load(std::memory_order_relaxed) + 63) & ~(size_t)63;
+
+	if ((capture.heap == NULL) | (offset + bytes > capture.heapBytes))
+	{
+		return NULL;
+	}
+
+	capture.heapUsed.store(offset + bytes, std::memory_order_release);
+
+	return capture.heap + offset;
+}
+
+/*************************************************************************
+*   @ End of Capture alloc                                                *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Capture stop                                                        *
+*                                                                         *
+*  Stops the handler first (no fault can be pending once the workload     *
+*  returned), then lets the flusher drain the ring and closes the trace.  *
+ *************************************************************************/
+
+int captureStop(CaptureStats* stats)
+{
+	int status;
+
+	capture.running.store(0);
+	capture.handler.join();
+	capture.flusher.join();
+
+	status = traceWriterClose(&capture.writer);
+
+	if (capture.failed)
+	{
+		status = -1;
+	}
+
+	close(capture.uffd);
+	munmap(capture.heap, capture.heapBytes);
+	close(capture.memfd);
+	free(capture.ring.events);
+	capture.heap = NULL;
+
+	if (stats != NULL)
+	{
+		*stats = capture.stats;
+	}
+
+	return status;
+}
+
+/*************************************************************************
+*   @ End of Capture stop                                                 *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Handler loop                                                        *
+*                                                                         *
+*  Waits on userfaultfd, records and resolves each fault, and re-arms     *
+*  the heap every rearmMs milliseconds.                                   *
+ *************************************************************************/
+
+static unsigned long long nowNs()
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (unsigned long long)now.tv_sec * 1000000000ULL + (unsigned long long)now.tv_nsec;
+}
+
+static void handlerLoop()
+{
+	struct uffd_msg    msgs[16];
+	unsigned long long lastRearm = capture.startNs;
+	int                timeout   = capture.rearmMs > 0 && capture.rearmMs < 50 ? (int)capture.rearmMs : 50;
+
+	while (capture.running.load(std::memory_order_relaxed))
+	{
+		struct pollfd pfd = { capture.uffd, POLLIN, 0 };
+
+		if ((poll(&pfd, 1, timeout) > 0) && (pfd.revents & POLLIN))
+		{
+			ssize_t got = read(capture.uffd, msgs, sizeof(msgs));
+
+			for (ssize_t i = 0; i < got / (ssize_t)sizeof(struct uffd_msg); i++)
+			{
+				if (msgs[i].event == UFFD_EVENT_PAGEFAULT)
+				{
+					resolveFault(&msgs[i]);
+				}
+			}
+		}
+
+		size_t heapUsed = capture.heapUsed.load(std::memory_order_acquire);
+
+		if ((capture.rearmMs > 0) & capture.minorFaults & (heapUsed > 0) & !capture.failed)
+		{
+			unsigned long long now = nowNs();
+
+			if (now - lastRearm >= capture.rearmMs * 1000000ULL)
+			{
+				size_t used = (heapUsed + capture.pageBytes - 1) & ~(capture.pageBytes - 1);
+
+				madvise(capture.heap, used, MADV_DONTNEED);
+				capture.stats.rearms++;
+				lastRearm = now;
+			}
+		}
+	}
+}
+
+static void resolveFault(const struct uffd_msg* msg)
+{
+	unsigned long long address = msg->arg.pagefault.address & ~(unsigned long long)(capture.pageBytes - 1);
+	FaultEvent         event;
+	int                result;
+
+	event.page   = (address - (unsigned long long)(size_t)capture.heap) / capture.pageBytes;
+	event.time   = nowNs() - capture.startNs;
+	event.access = (msg->arg.pagefault.flags & UFFD_PAGEFAULT_FLAG_WRITE) ? ACCESS_WRITE : ACCESS_READ;
+
+	if (ringPush(&capture.ring, &event) != 0)
+	{
+		capture.stats.dropped++;
+	}
+	capture.stats.faults++;
+
+	do
+	{
+		if (msg->arg.pagefault.flags & UFFD_PAGEFAULT_FLAG_MINOR)
+		{
+			struct uffdio_continue resume;
+
+			memset(&resume, 0, sizeof(resume));
+			resume.range.start = address;
+			resume.range.len   = capture.pageBytes;
+			result = ioctl(capture.uffd, UFFDIO_CONTINUE, &resume);
+		}
+		else
+		{
+			struct uffdio_zeropage zero;
+
+			memset(&zero, 0, sizeof(zero));
+			zero.range.start = address;
+			zero.range.len   = capture.pageBytes;
+			result = ioctl(capture.uffd, UFFDIO_ZEROPAGE, &zero);
+		}
+	} while ((result != 0) && (errno == EAGAIN));
+
+	/* EEXIST: the page was mapped meanwhile, but the faulting thread still sleeps. */
+
+	if ((result != 0) && (errno == EEXIST))
+	{
+		struct uffdio_range range;
+
+		range.start = address;
+		range.len   = capture.pageBytes;
+		result      = ioctl(capture.uffd, UFFDIO_WAKE, &range);
+	}
+
+	if (result != 0)
+	{
+		stopOnFailure(address, errno);
+	}
+	else if (msg->arg.pagefault.flags & UFFD_PAGEFAULT_FLAG_MINOR)
+	{
+		capture.stats.minorFaults++;
+	}
+}
+
+/* Gives the heap back to the kernel, so the workload runs on uncaptured, and wakes the
+ * faulting thread; captureStop then reports the failure. */
+
+static void stopOnFailure(unsigned long long address, int error)
+{
+	struct uffdio_range range;
+
+	capture.stats.failures++;
+
+	if (!capture.failed)
+	{
+		printf("Resolving the fault at %#llx failed (%s), capture stopped!\n", address, strerror(error));
+
+		range.start = (unsigned long long)(size_t)capture.heap;
+		range.len   = capture.heapBytes;
+		ioctl(capture.uffd, UFFDIO_UNREGISTER, &range);
+		capture.failed = 1;
+	}
+
+	range.start = address;
+	range.len   = capture.pageBytes;
+	ioctl(capture.uffd, UFFDIO_WAKE, &range);
+}
+
+/*************************************************************************
+*   @ End of Handler loop                                                 *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Flusher loop                                                        *
+*                                                                         *
+*  Drains the ring into the trace writer in batches; exits once capture   *
+*  stopped and the ring is empty.                                         *
+ *************************************************************************/
+
+static void flusherLoop()
+{
+	static PageRef refs[4096];
+
+	for (;;)
+	{
+		int    running = capture.running.load(std::memory_order_acquire);
+		size_t count   = ringPop(&capture.ring, refs, 4096, capture.pid);
+
+		if (count > 0)
+		{
+			traceWriterAppend(&capture.writer, refs, count);
+		}
+		else if (!running)
+		{
+			break;
+		}
+		else
+		{
+			usleep(1000);
+		}
+	}
+}
+
+/*************************************************************************
+*   @ End of Flusher loop                                                 *
+*                                                                         *
+ *************************************************************************/
+
+#else
+
+int captureStart(const char* tracePath, size_t heapBytes, unsigned int rearmMs)
+{
+	printf("Fault capture needs Linux userfaultfd!\n");
+	return -1;
+}
+
+void* captureAlloc(size_t bytes)
+{
+	return NULL;
+}
+
+int captureStop(CaptureStats* stats)
+{
+	return -1;
+}
+
+#endif
+
+
+/*************************************************************************
+*   @ Sample workloads                                                    *
+*                                                                         *
+*  scan   - sequential passes over the whole heap                         *
+*  random - 80% of touches on 20% of the pages                            *
+*  matrix - naive double matrix product, column walks stride the heap     *
+ *************************************************************************/
+
+static void runWorkload(const char* name, size_t heapBytes)
+{
+	volatile unsigned long long sink = 0;
+
+	if (strcmp(name, "scan") == 0)
+	{
+		size_t          words = heapBytes / 2 / sizeof(unsigned long long);
+		unsigned long long* data = (unsigned long long*)captureAlloc(words * sizeof(unsigned long long));
+
+		for (int pass = 0; (pass < 8) & (data != NULL); pass++)
+		{
+			for (size_t i = 0; i < words; i += 8)
+			{
+				data[i] += pass;
+				sink    += data[i];
+			}
+		}
+	}
+	else if (strcmp(name, "random") == 0)
+	{
+		size_t         pages = heapBytes / 2 / 4096;
+		unsigned char* data  = (unsigned char*)captureAlloc(pages * 4096);
+		unsigned int   state = 12345;
+
+		for (size_t i = 0; (i < pages * 64) & (data != NULL); i++)
+		{
+			size_t page;
+
+			state = state * 1103515245u + 12345u;
+
+			if ((state >> 16) % 10 < 8)
+			{
+				page = (state >> 8) % (pages / 5 + 1);
+			}
+			else
+			{
+				page = (state >> 8) % pages;
+			}
+			data[page * 4096 + (i & 4095)]++;
+			sink += data[page * 4096];
+		}
+	}
+	else
+	{
+		size_t  n = 16;
+
+		while (3 * (n * 2) * (n * 2) * sizeof(double) <= heapBytes / 2)
+		{
+			n *= 2;
+		}
+
+		double* a = (double*)captureAlloc(n * n * sizeof(double));
+		double* b = (double*)captureAlloc(n * n * sizeof(double));
+		double* c = (double*)captureAlloc(n * n * sizeof(double));
+
+		if ((a == NULL) | (b == NULL) | (c == NULL))
+		{
+			return;
+		}
+
+		for (size_t i = 0; i < n * n; i++)
+		{
+			a[i] = (double)(i % 7);
+			b[i] = (double)(i % 5);
+		}
+
+		for (size_t i = 0; i < n; i++)
+		{
+			for (size_t j = 0; j < n; j++)
+			{
+				double sum = 0.0;
+
+				for (size_t k = 0; k < n; k++)
+				{
+					sum += a[i * n + k] * b[k * n + j];
+				}
+				c[i * n + j] = sum;
+			}
+		}
+		sink += (unsigned long long)c[n + 1];
+	}
+}
+
+/*************************************************************************
+*   @ End of Sample workloads                                             *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Capture command                                                     *
+*                                                                         *
+*  Captures one sample workload into a binary trace and, when a frame     *
+*  count is given, replays it through every policy.                       *
+ *************************************************************************/
+
+int runCaptureCommand(int argCount, char* args[])
+{
+	CaptureStats stats;
+	size_t       heapBytes;
+	unsigned int rearmMs;
+
+	if (argCount < 3)
+	{
+		printf("Usage: %s\n", CAPTURE_USAGE);
+		return -1;
+	}
+
+	if ((strcmp(args[2], "scan") != 0) & (strcmp(args[2], "random") != 0) & (strcmp(args[2], "matrix") != 0))
+	{
+		printf("Unknown workload '%s'!\n", args[2]);
+		return -1;
+	}
+
+	heapBytes = (size_t)(argCount > 3 ? atoi(args[3]) : 64) << 20;
+	rearmMs   = argCount > 4 ? (unsigned int)atoi(args[4]) : 10;
+
+	if ((heapBytes == 0) || (captureStart(args[1], heapBytes, rearmMs) != 0))
+	{
+		return -1;
+	}
+
+	runWorkload(args[2], heapBytes);
+
+	if (captureStop(&stats) != 0)
+	{
+		if (stats.failures > 0)
+		{
+			printf("Capture into '%s' stopped: %llu faults could not be resolved!\n", args[1], stats.failures);
+		}
+		else
+		{
+			printf("Writing '%s' failed!\n", args[1]);
+		}
+		return -1;
+	}
+
+	printf("Captured %llu faults (%llu minor, %llu re-arms, %llu dropped) into %s\n",
+		stats.faults, stats.minorFaults, stats.rearms, stats.dropped, args[1]);
+
+	if (argCount > 5)
+	{
+		return simulateTraceFile(args[1], TRACE_FORMAT_BINARY, atoi(args[5]), POLICY_COUNT, 1, NULL);
+	}
+
+	return 0;
+}
+
+/*************************************************************************
+*   @ End of Capture command                                              *
+*                                                                         *
+ *************************************************************************/
@@ -0,0 +1,37 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: Page fault capture through Linux userfaultfd. A workload allocates its heap
+ * with captureAlloc (the shim); faults on that heap are recorded with timestamps into
+ * a lock-free ring and flushed to a binary page trace by a background thread.
+*/
+
+
+#ifndef FAULT_CAPTURE_H
+#define FAULT_CAPTURE_H
+
+#include "Trace.h"
+
+#define CAPTURE_USAGE        "capture <output.ptr> <scan|random|matrix> [heapMiB] [rearmMs] [frames]"
+#define CAPTURE_RING_EVENTS  (1 << 20)
+
+
+struct CaptureStats
+{
+	unsigned long long faults;
+	unsigned long long minorFaults;
+	unsigned long long dropped;
+	unsigned long long rearms;
+	unsigned long long failures;     /* faults that could not be resolved */
+};
+
+
+/* Shim used by captured workloads. rearmMs > 0 unmaps the heap every rearmMs
+ * milliseconds so that pages already touched fault again on their next access. */
+
+int   captureStart(const char* tracePath, size_t heapBytes, unsigned int rearmMs);
+void* captureAlloc(size_t bytes);
+int   captureStop(CaptureStats* stats);
+
+int   runCaptureCommand(int argCount, char* args[]);
+
+#endif // !FAULT_CAPTURE_H
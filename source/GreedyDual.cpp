@@ -0,0 +1,556 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: GreedyDual.cpp contains the cost map, the GreedyDual family and the cost
+ * command.
+ *
+ * Cost map: a text file of "first,last,cost[,size]" lines, pages as in the trace (decimal
+ * or 0x hex), ranges not overlapping; '#' starts a comment. Pages outside every range
+ * cost 1 and take one frame, so an empty map gives plain fault counts.
+ *
+ * All policies share one binary heap of resident pages ordered by priority, ties going
+ * to the least recently used page, so a reference is O(log frames). LRU's priority is
+ * the time of last use and it never inflates.
+*/
+
+
+
+#include "GreedyDual.h"
+#include "TraceParser.h"
+#include <string.h>
+
+
+static int  compareRanges(const void* a, const void* b);
+static void evictTop(GreedyDual* cache);
+static void heapFix(GreedyDual* cache, int slot);
+static int  heapBefore(const GreedyDual* cache, int a, int b);
+
+static const char* greedyDualNames[GD_COUNT] = { "lru", "gd", "gds", "gdsf" };
+
+
+/* Policies fed by one pass over a trace. */
+
+struct CostRun
+{
+	GreedyDual     caches[GD_COUNT];
+	int            cachesNum;
+	const CostMap* map;
+};
+
+
+/*************************************************************************
+*   @ Cost map                                                            *
+*                                                                         *
+ *************************************************************************/
+
+static int compareRanges(const void* a, const void* b)
+{
+	unsigned long long firstA = ((const CostRange*)a)->first;
+	unsigned long long firstB = ((const CostRange*)b)->first;
+
+	return firstA < firstB ? -1 : firstA > firstB;
+}
+
+int costMapLoad(CostMap* map, const char* path)
+{
+	char   line[512];
+	size_t capacity = 0;
+	int    lineNum  = 0;
+	FILE*  file     = fopen(path, "r");
+
+	map->ranges = NULL;
+	map->count  = 0;
+
+	if (file == NULL)
+	{
+		printf("Cannot open cost map '%s'!\n", path);
+		return -1;
+	}
+
+	while (fgets(line, sizeof(line), file) != NULL)
+	{
+		CostRange range;
+		char*     p = line;
+
+		lineNum++;
+
+		while ((*p == ' ') | (*p == '\t'))
+		{
+			p++;
+		}
+
+		if ((*p < '0') | (*p > '9'))
+		{
+			continue;
+		}
+
+		range.first = strtoull(p, &p, 0);
+		range.last  = *p == ',' ? strtoull(p + 1, &p, 0) : 0;
+		range.cost  = *p == ',' ? strtod(p + 1, &p) : -1.0;
+		range.size  = *p == ',' ? (int)strtol(p + 1, &p, 10) : 1;
+
+		if ((range.last < range.first) | (range.cost < 0.0) | (range.size < 1))
+		{
+			printf("Bad cost map line %d: %s", lineNum, line);
+			fclose(file);
+			costMapFree(map);
+			return -1;
+		}
+
+		if (map->count == capacity)
+		{
+			size_t     grownCapacity = capacity ? capacity * 2 : 64;
+			CostRange* grown         = (CostRange*)realloc(map->ranges, grownCapacity * sizeof(CostRange));
+
+			if (grown == NULL)
+			{
+				fclose(file);
+				costMapFree(map);
+				return -1;
+			}
+			map->ranges = grown;
+			capacity    = grownCapacity;
+		}
+		map->ranges[map->count++] = range;
+	}
+
+	fclose(file);
+
+	if (map->count > 0)
+	{
+		qsort(map->ranges, map->count, sizeof(CostRange), compareRanges);
+	}
+
+	/* A page in two ranges would take the cost of whichever the search lands on. */
+
+	for (size_t i = 1; i < map->count; i++)
+	{
+		if (map->ranges[i].first <= map->ranges[i - 1].last)
+		{
+			printf("Cost map '%s' has overlapping ranges %#llx-%#llx and %#llx-%#llx!\n", path,
+				map->ranges[i - 1].first, map->ranges[i - 1].last, map->ranges[i].first, map->ranges[i].last);
+			costMapFree(map);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+void costMapFree(CostMap* map)
+{
+	free(map->ranges);
+	map->ranges = NULL;
+	map->count  = 0;
+}
+
+void costMapFind(const CostMap* map, unsigned long long page, double* cost, int* size)
+{
+	size_t low  = 0;
+	size_t high = map->count;
+
+	/* Last range starting at or before the page. */
+
+	while (low < high)
+	{
+		size_t middle = (low + high) / 2;
+
+		if (map->ranges[middle].first <= page)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	if ((low > 0) && (page <= map->ranges[low - 1].last))
+	{
+		*cost = map->ranges[low - 1].cost;
+		*size = map->ranges[low - 1].size;
+	}
+	else
+	{
+		*cost = 1.0;
+		*size = 1;
+	}
+}
+
+/*************************************************************************
+*   @ End of Cost map                                                     *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Create / destroy                                                    *
+*                                                                         *
+ *************************************************************************/
+
+const char* greedyDualName(int policy)
+{
+	return ((policy >= 0) & (policy < GD_COUNT)) ? greedyDualNames[policy] : "?";
+}
+
+int greedyDualCreate(GreedyDual* cache, int policy, int framesNum)
+{
+	memset(cache, 0, sizeof(*cache));
+
+	if ((policy < 0) | (policy >= GD_COUNT) | (framesNum < 1))
+	{
+		return -1;
+	}
+
+	cache->policy       = policy;
+	cache->framesNum    = framesNum;
+	cache->residentPage = (unsigned long long*)malloc(framesNum * sizeof(unsigned long long));
+	cache->cost         = (double*)malloc(framesNum * sizeof(double));
+	cache->size         = (int*)malloc(framesNum * sizeof(int));
+	cache->frequency    = (unsigned int*)malloc(framesNum * sizeof(unsigned int));
+	cache->priority     = (double*)malloc(framesNum * sizeof(double));
+	cache->stamp        = (unsigned long long*)malloc(framesNum * sizeof(unsigned long long));
+	cache->heap         = (int*)malloc(framesNum * sizeof(int));
+	cache->heapSlot     = (int*)malloc(framesNum * sizeof(int));
+	cache->freeSlots    = (int*)malloc(framesNum * sizeof(int));
+
+	if ((cache->residentPage == NULL) | (cache->cost == NULL) | (cache->size == NULL) | (cache->frequency == NULL) |
+		(cache->priority == NULL) | (cache->stamp == NULL) | (cache->heap == NULL) | (cache->heapSlot == NULL) |
+		(cache->freeSlots == NULL) || (pageIndexInit(&cache->pages, (size_t)framesNum) != 0))
+	{
+		greedyDualDestroy(cache);
+		return -1;
+	}
+
+	/* Slot 0 is handed out first. */
+
+	for (int slot = 0; slot < framesNum; slot++)
+	{
+		cache->freeSlots[slot] = framesNum - 1 - slot;
+	}
+	cache->freeNum = framesNum;
+
+	return 0;
+}
+
+void greedyDualDestroy(GreedyDual* cache)
+{
+	free(cache->residentPage);
+	free(cache->cost);
+	free(cache->size);
+	free(cache->frequency);
+	free(cache->priority);
+	free(cache->stamp);
+	free(cache->heap);
+	free(cache->heapSlot);
+	free(cache->freeSlots);
+	pageIndexFree(&cache->pages);
+	memset(cache, 0, sizeof(*cache));
+}
+
+/*************************************************************************
+*   @ End of Create / destroy                                             *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ GreedyDual access                                                   *
+*                                                                         *
+*  A fault evicts lowest priority pages until the new page fits; every    *
+*  victim raises the inflation value L to its priority, which ages all    *
+*  pages still resident without touching them.                            *
+ *************************************************************************/
+
+static inline double pagePriority(const GreedyDual* cache, int slot)
+{
+	switch (cache->policy)
+	{
+	case GD_COST:
+		return cache->inflation + cache->cost[slot];
+	case GD_SIZE:
+		return cache->inflation + cache->cost[slot] / (double)cache->size[slot];
+	case GD_FREQUENCY:
+		return cache->inflation + (double)cache->frequency[slot] * cache->cost[slot] / (double)cache->size[slot];
+	default:
+		return (double)cache->clock;
+	}
+}
+
+int greedyDualAccess(GreedyDual* cache, const CostMap* map, const PageRef* ref)
+{
+	unsigned long long value;
+	double             cost;
+	int                size;
+	int                slot;
+
+	cache->clock++;
+	cache->stats.references++;
+
+	if (pageIndexFind(&cache->pages, ref->page, &value))
+	{
+		slot = (int)value;
+
+		cache->frequency[slot]++;
+		cache->stamp[slot]    = cache->clock;
+		cache->priority[slot] = pagePriority(cache, slot);
+		heapFix(cache, cache->heapSlot[slot]);
+		return 0;
+	}
+
+	costMapFind(map, ref->page, &cost, &size);
+
+	cache->stats.faults++;
+	cache->totalCost += cost;
+
+	if (size > cache->framesNum)
+	{
+		cache->bypassed++;
+		return 1;
+	}
+
+	while (cache->usedFrames + size > cache->framesNum)
+	{
+		evictTop(cache);
+	}
+
+	slot = cache->freeSlots[--cache->freeNum];
+
+	if (pageIndexSet(&cache->pages, ref->page, (unsigned long long)slot) != 0)
+	{
+		cache->freeNum++;
+		return -1;
+	}
+
+	cache->residentPage[slot] = ref->page;
+	cache->cost[slot]         = cost;
+	cache->size[slot]         = size;
+	cache->frequency[slot]    = 1;
+	cache->stamp[slot]        = cache->clock;
+	cache->priority[slot]     = pagePriority(cache, slot);
+	cache->usedFrames        += size;
+
+	cache->heap[cache->residents]  = slot;
+	cache->heapSlot[slot]          = cache->residents++;
+	heapFix(cache, cache->residents - 1);
+
+	return 1;
+}
+
+static void evictTop(GreedyDual* cache)
+{
+	int victim = cache->heap[0];
+
+	if (cache->policy != GD_LRU)
+	{
+		cache->inflation = cache->priority[victim];
+	}
+
+	cache->residents--;
+	cache->heap[0] = cache->heap[cache->residents];
+	cache->heapSlot[cache->heap[0]] = 0;
+
+	if (cache->residents > 0)
+	{
+		heapFix(cache, 0);
+	}
+
+	pageIndexRemove(&cache->pages, cache->residentPage[victim]);
+	cache->usedFrames -= cache->size[victim];
+	cache->freeSlots[cache->freeNum++] = victim;
+	cache->stats.evictions++;
+}
+
+/*************************************************************************
+*   @ End of GreedyDual access                                            *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Priority heap                                                       *
+*                                                                         *
+ *************************************************************************/
+
+static inline int heapBefore(const GreedyDual* cache, int a, int b)
+{
+	if (cache->priority[a] != cache->priority[b])
+	{
+		return cache->priority[a] < cache->priority[b];
+	}
+	return cache->stamp[a] < cache->stamp[b];
+}
+
+/* Moves the entry at position to its place, up or down. */
+
+static void heapFix(GreedyDual* cache, int position)
+{
+	int slot = cache->heap[position];
+
+	while (position > 0)
+	{
+		int parent = (position - 1) / 2;
+
+		if (!heapBefore(cache, slot, cache->heap[parent]))
+		{
+			break;
+		}
+		cache->heap[position] = cache->heap[parent];
+		cache->heapSlot[cache->heap[position]] = position;
+		position = parent;
+	}
+
+	for (;;)
+	{
+		int child = position * 2 + 1;
+
+		if (child >= cache->residents)
+		{
+			break;
+		}
+		if ((child + 1 < cache->residents) && heapBefore(cache, cache->heap[child + 1], cache->heap[child]))
+		{
+			child++;
+		}
+		if (!heapBefore(cache, cache->heap[child], slot))
+		{
+			break;
+		}
+		cache->heap[position] = cache->heap[child];
+		cache->heapSlot[cache->heap[position]] = position;
+		position = child;
+	}
+
+	cache->heap[position] = slot;
+	cache->heapSlot[slot] = position;
+}
+
+/*************************************************************************
+*   @ End of Priority heap                                                *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Cost command                                                        *
+*                                                                         *
+ *************************************************************************/
+
+static int costRunSink(void* context, const PageRef* refs, size_t count)
+{
+	CostRun* run = (CostRun*)context;
+
+	for (int c = 0; c < run->cachesNum; c++)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			if (greedyDualAccess(&run->caches[c], run->map, &refs[i]) < 0)
+			{
+				return -1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+int runCostCommand(int argCount, char* args[])
+{
+	CostRun run;
+	CostMap map;
+	int     selected = GD_COUNT;
+	int     status;
+
+	if (argCount < 5)
+	{
+		printf("Usage: %s\n", COST_USAGE);
+		return -1;
+	}
+
+	int format    = traceFormatFromName(args[1]);
+	int framesNum = atoi(args[3]);
+
+	if ((argCount > 5) && (strcmp(args[5], "all") != 0))
+	{
+		selected = -1;
+
+		for (int policy = 0; policy < GD_COUNT; policy++)
+		{
+			if (strcmp(args[5], greedyDualNames[policy]) == 0)
+			{
+				selected = policy;
+			}
+		}
+	}
+
+	if ((format == TRACE_FORMAT_UNKNOWN) | (framesNum < 1) | (selected < 0))
+	{
+		printf("Usage: %s\n", COST_USAGE);
+		return -1;
+	}
+
+	if (costMapLoad(&map, args[4]) != 0)
+	{
+		return -1;
+	}
+
+	run.cachesNum = 0;
+	run.map       = &map;
+
+	for (int policy = 0; policy < GD_COUNT; policy++)
+	{
+		if ((selected != GD_COUNT) & (selected != policy))
+		{
+			continue;
+		}
+
+		if (greedyDualCreate(&run.caches[run.cachesNum], policy, framesNum) != 0)
+		{
+			printf("Not enough memory for %d frames!\n", framesNum);
+
+			for (int c = 0; c < run.cachesNum; c++)
+			{
+				greedyDualDestroy(&run.caches[c]);
+			}
+			costMapFree(&map);
+			return -1;
+		}
+		run.cachesNum++;
+	}
+
+	status = loadTrace(args[2], format, 0, costRunSink, &run);
+
+	if (status == 0)
+	{
+		double baseline = run.caches[0].totalCost;
+
+		printf("\n Trace %s: %llu references, %d frames, %zu cost ranges\n\n", args[2],
+			run.caches[0].stats.references, framesNum, map.count);
+		printf(" -------------------------------------------------------------------------\n");
+		printf("| Policy |     Faults     |       Total cost       | vs %-4s |  Bypassed  |\n",
+			greedyDualName(run.caches[0].policy));
+		printf(" -------------------------------------------------------------------------\n");
+
+		for (int c = 0; c < run.cachesNum; c++)
+		{
+			GreedyDual* cache = &run.caches[c];
+
+			printf("| %-6s | %14llu | %22.2f | %6.1f%% | %10llu |\n", greedyDualName(cache->policy),
+				cache->stats.faults, cache->totalCost, baseline > 0.0 ? 100.0 * cache->totalCost / baseline : 0.0,
+				cache->bypassed);
+		}
+		printf(" -------------------------------------------------------------------------\n");
+	}
+
+	for (int c = 0; c < run.cachesNum; c++)
+	{
+		greedyDualDestroy(&run.caches[c]);
+	}
+	costMapFree(&map);
+
+	return status == 0 ? 0 : -1;
+}
+
+/*************************************************************************
+*   @ End of Cost command                                                 *
+*                                                                         *
+ *************************************************************************/
@@ -0,0 +1,78 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: Cost aware replacement. A cost map gives every page a fault cost and a size in
+ * frames (pages from local SSD and from remote storage cost differently); GreedyDual,
+ * GreedyDual-Size and GreedyDual-Size-Frequency evict the page of lowest priority
+ * L + cost (/ size, * frequency), where the inflation value L rises to the priority of
+ * each victim. Reports the total fault cost next to the fault count, against size aware
+ * LRU.
+*/
+
+
+#ifndef GREEDY_DUAL_H
+#define GREEDY_DUAL_H
+
+#include "PagingEngine.h"
+
+#define COST_USAGE           "cost <lackey|pin|csv|bin> <file> <frames> <costs.csv> [lru|gd|gds|gdsf|all]"
+
+#define GD_LRU               0
+#define GD_COST              1   /* GreedyDual: L + cost */
+#define GD_SIZE              2   /* GreedyDual-Size: L + cost / size */
+#define GD_FREQUENCY         3   /* GreedyDual-Size-Frequency: L + frequency * cost / size */
+#define GD_COUNT             4
+
+
+/* Pages first..last (inclusive) cost cost per fault and take size frames. */
+
+struct CostRange
+{
+	unsigned long long first;
+	unsigned long long last;
+	double             cost;
+	int                size;
+};
+
+struct CostMap
+{
+	CostRange* ranges;       /* sorted by first */
+	size_t     count;
+};
+
+struct GreedyDual
+{
+	int                 policy;
+	int                 framesNum;
+	int                 usedFrames;     /* sum of the sizes of the resident pages */
+	int                 residents;
+	unsigned long long* residentPage;   /* per resident slot */
+	double*             cost;
+	int*                size;
+	unsigned int*       frequency;      /* references since the page was loaded */
+	double*             priority;
+	unsigned long long* stamp;          /* last use, breaks priority ties */
+	int*                heap;           /* slots, lowest priority on top */
+	int*                heapSlot;
+	int*                freeSlots;
+	int                 freeNum;
+	PageIndex           pages;          /* resident page -> slot */
+	double              inflation;
+	unsigned long long  clock;
+	unsigned long long  bypassed;       /* pages larger than the memory, never loaded */
+	double              totalCost;      /* cost of all faults */
+	EngineStats         stats;
+};
+
+int  costMapLoad(CostMap* map, const char* path);
+void costMapFree(CostMap* map);
+void costMapFind(const CostMap* map, unsigned long long page, double* cost, int* size);
+
+const char* greedyDualName(int policy);
+
+int  greedyDualCreate(GreedyDual* cache, int policy, int framesNum);
+void greedyDualDestroy(GreedyDual* cache);
+int  greedyDualAccess(GreedyDual* cache, const CostMap* map, const PageRef* ref);
+
+int  runCostCommand(int argCount, char* args[]);
+
+#endif // !GREEDY_DUAL_H
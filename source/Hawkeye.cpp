@@ -0,0 +1,596 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: Hawkeye.cpp contains OPTgen, the predictor, the Hawkeye cache and the hawkeye
+ * command.
+ *
+ * The traces carry no program counter, so the context of a reference is a hash of its
+ * page and process. The frames form one fully associative set, so OPTgen's occupancy
+ * vector spans HAWKEYE_HISTORY * framesNum references; it is kept in a segment tree with
+ * range add and range maximum, which makes every reference O(log framesNum) instead of
+ * O(reuse interval).
+ *
+ * Hawkeye ages every other line on an insertion and evicts a line of the highest age; in
+ * a fully associative memory that is the least recently used cache-friendly page, so the
+ * ages are kept as two LRU lists instead and every step stays O(1). The oldest averse page
+ * goes first; evicting a friendly page trains its context down, as in Hawkeye.
+*/
+
+
+
+#include "Hawkeye.h"
+#include "TraceParser.h"
+#include <string.h>
+#include <chrono>
+
+
+static unsigned int pageContext(const PageRef* ref);
+static void         treeApply(Hawkeye* cache, int node, int value);
+static void         treeBuild(Hawkeye* cache, int node);
+static void         treePush(Hawkeye* cache, int node);
+static void         treeAdd(Hawkeye* cache, int low, int high);
+static int          treeMax(Hawkeye* cache, int low, int high);
+static void         treeClear(Hawkeye* cache, int leaf);
+static void         optgenAccess(Hawkeye* cache, unsigned long long page, unsigned int context);
+static void         optgenPrune(Hawkeye* cache);
+static void         train(Hawkeye* cache, unsigned int context, int friendly);
+static int          chooseVictim(Hawkeye* cache);
+static void         listUnlink(Hawkeye* cache, int frame);
+static void         listPushMru(Hawkeye* cache, int frame, int list);
+
+
+/*************************************************************************
+*   @ Create / destroy                                                    *
+*                                                                         *
+ *************************************************************************/
+
+int hawkeyeCreate(Hawkeye* cache, int framesNum)
+{
+	memset(cache, 0, sizeof(*cache));
+
+	if ((framesNum < 1) | (framesNum > (1 << 26)))
+	{
+		return -1;
+	}
+
+	cache->framesNum = framesNum;
+	cache->window    = (unsigned long long)HAWKEYE_HISTORY * (unsigned long long)framesNum;
+	cache->leaves    = 1;
+
+	while ((unsigned long long)cache->leaves < cache->window)
+	{
+		cache->leaves *= 2;
+		cache->height++;
+	}
+
+	cache->mru[0]       = cache->mru[1] = -1;
+	cache->lru[0]       = cache->lru[1] = -1;
+	cache->framePage    = (unsigned long long*)malloc(framesNum * sizeof(unsigned long long));
+	cache->frameContext = (unsigned int*)malloc(framesNum * sizeof(unsigned int));
+	cache->frameList    = (unsigned char*)malloc(framesNum);
+	cache->dirty        = (unsigned char*)calloc(framesNum, 1);
+	cache->older        = (int*)malloc(framesNum * sizeof(int));
+	cache->newer        = (int*)malloc(framesNum * sizeof(int));
+	cache->counters     = (unsigned char*)malloc((size_t)1 << HAWKEYE_CONTEXT_BITS);
+	cache->occupancy    = (int*)calloc((size_t)cache->leaves * 2, sizeof(int));
+	cache->pending      = (int*)calloc((size_t)cache->leaves, sizeof(int));
+	cache->stale        = (unsigned long long*)malloc((size_t)cache->window * sizeof(unsigned long long));
+	cache->historyLimit = (size_t)cache->window * HAWKEYE_HISTORY_FACTOR;
+
+	if ((cache->framePage == NULL) | (cache->frameContext == NULL) | (cache->frameList == NULL) |
+		(cache->dirty == NULL) | (cache->older == NULL) | (cache->newer == NULL) | (cache->counters == NULL) |
+		(cache->occupancy == NULL) | (cache->pending == NULL) | (cache->stale == NULL) || (pageIndexInit(&cache->frames, (size_t)framesNum) != 0) ||
+		(pageIndexInit(&cache->history, (size_t)framesNum) != 0))
+	{
+		hawkeyeDestroy(cache);
+		return -1;
+	}
+
+	/* Everything starts weakly friendly, so an untrained Hawkeye is LRU. */
+
+	memset(cache->counters, HAWKEYE_FRIENDLY, (size_t)1 << HAWKEYE_CONTEXT_BITS);
+
+	return 0;
+}
+
+void hawkeyeDestroy(Hawkeye* cache)
+{
+	free(cache->framePage);
+	free(cache->frameContext);
+	free(cache->frameList);
+	free(cache->dirty);
+	free(cache->older);
+	free(cache->newer);
+	free(cache->counters);
+	free(cache->occupancy);
+	free(cache->pending);
+	free(cache->stale);
+	pageIndexFree(&cache->frames);
+	pageIndexFree(&cache->history);
+	memset(cache, 0, sizeof(*cache));
+}
+
+/*************************************************************************
+*   @ End of Create / destroy                                             *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ OPTgen                                                              *
+*                                                                         *
+*  Leaf t % leaves counts the pages OPT holds across time t. A page used  *
+*  at prev and again at now would have been kept by OPT if no time in     *
+*  [prev, now) was already full; it is then added to all of them. A page  *
+*  last used a window or more ago can only be a miss: whenever the pages  *
+*  outnumber the window HAWKEYE_HISTORY_FACTOR times, those entries are   *
+*  pruned and train their context down, like Hawkeye's sampler does for   *
+*  the lines it drops.                                                    *
+ *************************************************************************/
+
+static inline unsigned int pageContext(const PageRef* ref)
+{
+	return (unsigned int)(pageHash(ref->page ^ ((unsigned long long)ref->pid << 48)) >> 32) &
+		(((unsigned int)1 << HAWKEYE_CONTEXT_BITS) - 1);
+}
+
+static void train(Hawkeye* cache, unsigned int context, int friendly)
+{
+	unsigned char* counter = &cache->counters[context];
+
+	if (friendly)
+	{
+		*counter += *counter < HAWKEYE_COUNTER_MAX;
+	}
+	else
+	{
+		*counter -= *counter > 0;
+	}
+}
+
+/* Bottom-up segment tree: node n covers nodes 2n and 2n + 1, leaves are leaves..2 * leaves - 1. */
+
+static inline void treeApply(Hawkeye* cache, int node, int value)
+{
+	cache->occupancy[node] += value;
+
+	if (node < cache->leaves)
+	{
+		cache->pending[node] += value;
+	}
+}
+
+static void treeBuild(Hawkeye* cache, int node)
+{
+	for (node >>= 1; node > 0; node >>= 1)
+	{
+		int left  = cache->occupancy[2 * node];
+		int right = cache->occupancy[2 * node + 1];
+
+		cache->occupancy[node] = (left > right ? left : right) + cache->pending[node];
+	}
+}
+
+static void treePush(Hawkeye* cache, int node)
+{
+	for (int shift = cache->height; shift > 0; shift--)
+	{
+		int parent = node >> shift;
+
+		if (cache->pending[parent] != 0)
+		{
+			treeApply(cache, 2 * parent, cache->pending[parent]);
+			treeApply(cache, 2 * parent + 1, cache->pending[parent]);
+			cache->pending[parent] = 0;
+		}
+	}
+}
+
+static void treeAdd(Hawkeye* cache, int low, int high)
+{
+	int first = low + cache->leaves;
+	int last  = high - 1 + cache->leaves;
+
+	for (low = first, high = last + 1; low < high; low >>= 1, high >>= 1)
+	{
+		if (low & 1)
+		{
+			treeApply(cache, low++, 1);
+		}
+		if (high & 1)
+		{
+			treeApply(cache, --high, 1);
+		}
+	}
+
+	treeBuild(cache, first);
+	treeBuild(cache, last);
+}
+
+static int treeMax(Hawkeye* cache, int low, int high)
+{
+	int result = 0;
+
+	low  += cache->leaves;
+	high += cache->leaves;
+	treePush(cache, low);
+	treePush(cache, high - 1);
+
+	for (; low < high; low >>= 1, high >>= 1)
+	{
+		if (low & 1)
+		{
+			result = cache->occupancy[low] > result ? cache->occupancy[low] : result;
+			low++;
+		}
+		if (high & 1)
+		{
+			high--;
+			result = cache->occupancy[high] > result ? cache->occupancy[high] : result;
+		}
+	}
+
+	return result;
+}
+
+static void treeClear(Hawkeye* cache, int leaf)
+{
+	leaf += cache->leaves;
+	treePush(cache, leaf);
+	cache->occupancy[leaf] = 0;
+	treeBuild(cache, leaf);
+}
+
+static void optgenAccess(Hawkeye* cache, unsigned long long page, unsigned int context)
+{
+	int                 created = 0;
+	unsigned long long* entry   = pageIndexSlot(&cache->history, page, &created);
+	unsigned long long  now     = cache->optTime++;
+	int                 nowLeaf = (int)(now & (unsigned long long)(cache->leaves - 1));
+
+	treeClear(cache, nowLeaf);
+	cache->optAccesses++;
+
+	if (entry == NULL)
+	{
+		return;
+	}
+
+	if (!created)
+	{
+		unsigned long long prev     = *entry >> HAWKEYE_CONTEXT_BITS;
+		unsigned int       owner    = (unsigned int)(*entry & (((unsigned long long)1 << HAWKEYE_CONTEXT_BITS) - 1));
+		int                prevLeaf = (int)(prev & (unsigned long long)(cache->leaves - 1));
+		int                kept     = now - prev < cache->window;
+
+		/* [prev, now) wraps around the leaves when prevLeaf > nowLeaf. */
+
+		if (kept & (prevLeaf < nowLeaf))
+		{
+			kept = treeMax(cache, prevLeaf, nowLeaf) < cache->framesNum;
+		}
+		else if (kept)
+		{
+			kept = (treeMax(cache, prevLeaf, cache->leaves) < cache->framesNum) &&
+				((nowLeaf == 0) || (treeMax(cache, 0, nowLeaf) < cache->framesNum));
+		}
+
+		if (kept & (prevLeaf < nowLeaf))
+		{
+			treeAdd(cache, prevLeaf, nowLeaf);
+		}
+		else if (kept)
+		{
+			treeAdd(cache, prevLeaf, cache->leaves);
+
+			if (nowLeaf > 0)
+			{
+				treeAdd(cache, 0, nowLeaf);
+			}
+		}
+
+		cache->optHits += kept;
+		train(cache, owner, kept);
+	}
+
+	*entry = now << HAWKEYE_CONTEXT_BITS | context;
+
+	if (cache->history.count > cache->historyLimit)
+	{
+		optgenPrune(cache);
+	}
+}
+
+static void optgenPrune(Hawkeye* cache)
+{
+	unsigned long long page;
+	unsigned long long entry;
+	size_t             staleNum;
+
+	do
+	{
+		size_t cursor = 0;
+
+		staleNum = 0;
+
+		while ((staleNum < (size_t)cache->window) && pageIndexNext(&cache->history, &cursor, &page, &entry))
+		{
+			if (cache->optTime - (entry >> HAWKEYE_CONTEXT_BITS) >= cache->window)
+			{
+				cache->stale[staleNum++] = page;
+				train(cache, (unsigned int)(entry & (((unsigned long long)1 << HAWKEYE_CONTEXT_BITS) - 1)), 0);
+			}
+		}
+
+		for (size_t s = 0; s < staleNum; s++)
+		{
+			pageIndexRemove(&cache->history, cache->stale[s]);
+		}
+	} while (staleNum == (size_t)cache->window);
+
+	cache->historyLimit = cache->history.count * 2;
+
+	if (cache->historyLimit < (size_t)cache->window * HAWKEYE_HISTORY_FACTOR)
+	{
+		cache->historyLimit = (size_t)cache->window * HAWKEYE_HISTORY_FACTOR;
+	}
+}
+
+/*************************************************************************
+*   @ End of OPTgen                                                       *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Hawkeye access                                                      *
+*                                                                         *
+ *************************************************************************/
+
+int hawkeyeAccess(Hawkeye* cache, const PageRef* ref)
+{
+	unsigned long long slot;
+	unsigned int       context = pageContext(ref);
+	int                frame;
+	int                fault   = 0;
+
+	cache->stats.references++;
+
+	optgenAccess(cache, ref->page, context);
+
+	if (pageIndexFind(&cache->frames, ref->page, &slot))
+	{
+		frame = (int)slot;
+		listUnlink(cache, frame);
+	}
+	else
+	{
+		if (cache->usedFrames < cache->framesNum)
+		{
+			frame = cache->usedFrames++;
+		}
+		else
+		{
+			frame = chooseVictim(cache);
+
+			cache->stats.evictions++;
+			cache->stats.writebacks += cache->dirty[frame];
+			listUnlink(cache, frame);
+			pageIndexRemove(&cache->frames, cache->framePage[frame]);
+		}
+
+		if (pageIndexSet(&cache->frames, ref->page, (unsigned long long)frame) != 0)
+		{
+			return -1;
+		}
+
+		cache->framePage[frame] = ref->page;
+		cache->dirty[frame]     = 0;
+		cache->stats.faults++;
+		fault = 1;
+	}
+
+	cache->frameContext[frame]  = context;
+	cache->dirty[frame]        |= (ref->access == ACCESS_WRITE);
+	listPushMru(cache, frame, cache->counters[context] >= HAWKEYE_FRIENDLY ? HAWKEYE_FRIENDLY_LIST : HAWKEYE_AVERSE);
+
+	return fault;
+}
+
+static int chooseVictim(Hawkeye* cache)
+{
+	int frame = cache->lru[HAWKEYE_AVERSE];
+
+	if (frame == -1)
+	{
+		frame = cache->lru[HAWKEYE_FRIENDLY_LIST];
+		train(cache, cache->frameContext[frame], 0);
+	}
+
+	return frame;
+}
+
+static void listUnlink(Hawkeye* cache, int frame)
+{
+	int list  = cache->frameList[frame];
+	int older = cache->older[frame];
+	int newer = cache->newer[frame];
+
+	if (newer != -1)
+	{
+		cache->older[newer] = older;
+	}
+	else
+	{
+		cache->mru[list] = older;
+	}
+
+	if (older != -1)
+	{
+		cache->newer[older] = newer;
+	}
+	else
+	{
+		cache->lru[list] = newer;
+	}
+}
+
+static void listPushMru(Hawkeye* cache, int frame, int list)
+{
+	cache->frameList[frame] = (unsigned char)list;
+	cache->older[frame]     = cache->mru[list];
+	cache->newer[frame]     = -1;
+
+	if (cache->mru[list] != -1)
+	{
+		cache->newer[cache->mru[list]] = frame;
+	}
+	else
+	{
+		cache->lru[list] = frame;
+	}
+	cache->mru[list] = frame;
+}
+
+/*************************************************************************
+*   @ End of Hawkeye access                                               *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Hawkeye command                                                     *
+*                                                                         *
+*  LRU, Hawkeye and OPT replay the trace from memory at every frame       *
+*  count; the gap closed is the share of LRU's extra faults over OPT      *
+*  that Hawkeye avoids.                                                   *
+ *************************************************************************/
+
+static int engineReplay(int policy, int framesNum, const TraceBuffer* buffer, const unsigned long long* nextUse,
+	EngineStats* stats)
+{
+	PagingEngine engine;
+	AccessResult result;
+
+	if (engineCreate(&engine, policy, framesNum) != 0)
+	{
+		return -1;
+	}
+	engineSetFuture(&engine, nextUse);
+
+	for (size_t i = 0; i < buffer->count; i++)
+	{
+		engineAccess(&engine, &buffer->refs[i], &result);
+	}
+
+	*stats = engine.stats;
+	engineDestroy(&engine);
+
+	return 0;
+}
+
+int runHawkeyeCommand(int argCount, char* args[])
+{
+	TraceBuffer         buffer;
+	Hawkeye             cache;
+	EngineStats         lru;
+	EngineStats         opt;
+	unsigned long long* nextUse;
+	int                 points[HAWKEYE_MAX_POINTS];
+	int                 pointsNum = 0;
+	int                 status    = 0;
+
+	if (argCount < 4)
+	{
+		printf("Usage: %s\n", HAWKEYE_USAGE);
+		return -1;
+	}
+
+	int format = traceFormatFromName(args[1]);
+
+	for (char* frames = args[3]; (*frames != '\0') & (pointsNum < HAWKEYE_MAX_POINTS);)
+	{
+		long framesNum = strtol(frames, &frames, 10);
+
+		if (framesNum < 1)
+		{
+			pointsNum = 0;
+			break;
+		}
+		points[pointsNum++] = (int)framesNum;
+
+		if (*frames == ',')
+		{
+			frames++;
+		}
+	}
+
+	if ((format == TRACE_FORMAT_UNKNOWN) | (pointsNum == 0))
+	{
+		printf("Usage: %s\n", HAWKEYE_USAGE);
+		return -1;
+	}
+
+	traceBufferInit(&buffer);
+
+	if (loadTrace(args[2], format, 0, traceBufferSink, &buffer) != 0)
+	{
+		traceBufferFree(&buffer);
+		return -1;
+	}
+
+	nextUse = (unsigned long long*)malloc((buffer.count + 1) * sizeof(unsigned long long));
+
+	if ((nextUse == NULL) || (computeNextUse(buffer.refs, buffer.count, nextUse) != 0))
+	{
+		printf("Not enough memory for the next uses!\n");
+		free(nextUse);
+		traceBufferFree(&buffer);
+		return -1;
+	}
+
+	printf("\n Trace %s: %llu references\n\n", args[2], (unsigned long long)buffer.count);
+	printf(" -----------------------------------------------------------------------------------------------------\n");
+	printf("|     Frames     |      LRU       |    Hawkeye     |      OPT       | Gap closed | OPTgen hits | M/s  |\n");
+	printf(" -----------------------------------------------------------------------------------------------------\n");
+
+	for (int p = 0; (p < pointsNum) & (status == 0); p++)
+	{
+		if ((engineReplay(POLICY_LRU, points[p], &buffer, NULL, &lru) != 0) |
+			(engineReplay(POLICY_OPT, points[p], &buffer, nextUse, &opt) != 0) |
+			(hawkeyeCreate(&cache, points[p]) != 0))
+		{
+			printf("Not enough memory for %d frames!\n", points[p]);
+			hawkeyeDestroy(&cache);
+			status = -1;
+			break;
+		}
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		for (size_t i = 0; (i < buffer.count) & (status == 0); i++)
+		{
+			status = hawkeyeAccess(&cache, &buffer.refs[i]) < 0 ? -1 : 0;
+		}
+
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		double gap     = (double)lru.faults - (double)opt.faults;
+
+		printf("| %14d | %14llu | %14llu | %14llu | %9.1f%% | %10.1f%% | %4.1f |\n", points[p], lru.faults,
+			cache.stats.faults, opt.faults, gap > 0.0 ? 100.0 * ((double)lru.faults - (double)cache.stats.faults) / gap : 0.0,
+			cache.optAccesses ? 100.0 * (double)cache.optHits / (double)cache.optAccesses : 0.0,
+			seconds > 0.0 ? (double)buffer.count / seconds / 1e6 : 0.0);
+
+		hawkeyeDestroy(&cache);
+	}
+	printf(" -----------------------------------------------------------------------------------------------------\n");
+
+	free(nextUse);
+	traceBufferFree(&buffer);
+
+	return status;
+}
+
+/*************************************************************************
+*   @ End of Hawkeye command                                              *
+*                                                                         *
+ *************************************************************************/
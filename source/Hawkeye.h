@@ -0,0 +1,65 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: Hawkeye style predictive replacement. OPTgen reconstructs the decisions of
+ * Belady's OPT over a sliding window of past references; each reuse OPT would have kept
+ * trains a saturating counter of the context of the earlier reference up, each reuse it
+ * would have missed trains it down. Pages whose context predicts cache-friendly are kept
+ * in LRU order, cache-averse pages are evicted first.
+*/
+
+
+#ifndef HAWKEYE_H
+#define HAWKEYE_H
+
+#include "PagingEngine.h"
+
+#define HAWKEYE_USAGE          "hawkeye <lackey|pin|csv|bin> <file> <frames[,frames...]>"
+#define HAWKEYE_MAX_POINTS     16
+#define HAWKEYE_COUNTER_MAX    7       /* 3-bit counters */
+#define HAWKEYE_FRIENDLY       4       /* counters at or above it predict cache-friendly */
+#define HAWKEYE_CONTEXT_BITS   13
+#define HAWKEYE_HISTORY        8       /* OPTgen window in multiples of the frames */
+#define HAWKEYE_HISTORY_FACTOR 2       /* history entries per window reference before pruning */
+
+#define HAWKEYE_AVERSE         0
+#define HAWKEYE_FRIENDLY_LIST  1
+
+
+struct Hawkeye
+{
+	int                 framesNum;
+	int                 usedFrames;
+	unsigned long long* framePage;
+	unsigned int*       frameContext;
+	unsigned char*      frameList;      /* HAWKEYE_AVERSE or HAWKEYE_FRIENDLY_LIST */
+	unsigned char*      dirty;
+	int*                older;
+	int*                newer;
+	int                 mru[2];
+	int                 lru[2];
+	PageIndex           frames;         /* resident page -> frame */
+	unsigned char*      counters;       /* context -> saturating counter */
+
+	/* OPTgen: OPT's resident pages at each time of the window, in a segment tree. */
+	unsigned long long  window;
+	int                 leaves;         /* power of two >= window, time t is leaf t % leaves */
+	int                 height;
+	int*                occupancy;      /* subtree maximum, without the pending adds above it */
+	int*                pending;        /* add not yet pushed to the children */
+	unsigned long long  optTime;
+	PageIndex           history;        /* page -> last time and context */
+	size_t              historyLimit;   /* history count that triggers pruning */
+	unsigned long long* stale;          /* window history entries being pruned */
+	unsigned long long  optAccesses;
+	unsigned long long  optHits;
+
+	EngineStats         stats;
+};
+
+int  hawkeyeCreate(Hawkeye* cache, int framesNum);
+void hawkeyeDestroy(Hawkeye* cache);
+int  hawkeyeAccess(Hawkeye* cache, const PageRef* ref);
+
+int  runHawkeyeCommand(int argCount, char* args[]);
+
+#endif // !HAWKEYE_H
@@ -0,0 +1,879 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: HugePages.cpp contains the mixed page size simulation and the huge command.
+ *
+ * Memory is a set of blocks of ratio base frames (512 for 2 MiB pages, 262144 for 1 GiB
+ * pages). Base pages fill partly used blocks first so whole blocks stay free for huge
+ * pages; pinned% of the blocks hold one unmovable frame and can never become a huge page.
+ * When no whole block is free, promotion reclaims LRU units until a block's worth of
+ * frames is free and then compacts: the base pages of the emptiest movable block are
+ * migrated into the free frames of other blocks.
+ *
+ * Mapped base pages and huge pages are units of one LRU list. A fault maps a base page;
+ * once promote% of the base pages of a region are resident the region is promoted. When
+ * the LRU unit is a huge page whose used share is below demote% it is split into the
+ * base pages that were used, which frees the rest of its block, otherwise it is evicted
+ * whole. A small LRU TLB holds one entry per mapping; unmapping or migrating a page starts
+ * a new mapping, so stale entries never hit.
+*/
+
+
+
+#include "HugePages.h"
+#include "TraceParser.h"
+#include <string.h>
+
+#define HUGE_MODES   3
+
+
+struct HugeRegion
+{
+	int                 resident;     /* base pages mapped */
+	int                 unit;         /* huge page unit, -1 when not promoted */
+	int                 used;         /* huge page: sub-pages referenced */
+	unsigned long long* usedMap;      /* huge page: bit per referenced sub-page */
+};
+
+struct HugeStats
+{
+	unsigned long long references;
+	unsigned long long faults;
+	unsigned long long promotions;
+	unsigned long long failedPromotions;
+	unsigned long long demotions;
+	unsigned long long evictions;
+	unsigned long long migrations;       /* base pages moved by compaction */
+};
+
+struct HugeSim
+{
+	int                 shift;
+	int                 ratio;
+	int                 promotePages;
+	int                 demotePercent;
+
+	/* Frame pool. */
+	int                 blocksNum;
+	int*                blockFree;        /* free frames of each block */
+	unsigned char*      blockPinned;
+	unsigned char*      blockHuge;
+	int*                blockUnits;       /* first base page unit of each block */
+	int                 movableBlocks;
+	int*                wholeBlocks;      /* stack of blocks with every frame free */
+	int                 wholeNum;
+	int*                partialBlocks;    /* blocks with some frames free */
+	int*                partialSlot;
+	int                 partialNum;
+	long long           freeFrames;
+
+	/* Units in LRU order. */
+	int                 unitsCapacity;
+	unsigned long long* unitKey;          /* base page, or region | HUGE_KEY_BIT */
+	int*                unitBlock;
+	unsigned long long* unitMapping;      /* TLB key: mapping number << 1 | huge */
+	int*                nextInBlock;
+	int*                prevInBlock;
+	int*                older;
+	int*                newer;
+	int                 mru;
+	int                 lru;
+	int*                freeUnits;
+	int                 freeUnitsNum;
+	PageIndex           mapped;           /* unit key -> unit */
+	unsigned long long  mappings;
+
+	PageIndex           regionIndex;      /* region -> regions[] */
+	HugeRegion*         regions;
+	size_t              regionsNum;
+	size_t              regionsCapacity;
+
+	long long           hugeMapped;
+	long long           hugeUsed;
+
+	PagingEngine        tlb;
+	HugeStats           stats;
+};
+
+
+static int  hugeSimCreate(HugeSim* sim, int shift, long long framesNum, int promotePages, int demotePercent,
+	int pinnedPercent, int tlbEntries);
+static void hugeSimDestroy(HugeSim* sim);
+static int  hugeSimAccess(HugeSim* sim, const PageRef* ref);
+
+static int  allocBaseFrame(HugeSim* sim);
+static int  takeWholeBlock(HugeSim* sim);
+static void compactBlock(HugeSim* sim, int block);
+static void freeBaseFrame(HugeSim* sim, int block);
+static void partialAdd(HugeSim* sim, int block);
+static void partialRemove(HugeSim* sim, int block);
+
+static int  unitCreate(HugeSim* sim, unsigned long long key, int block);
+static void unitRemove(HugeSim* sim, int unit);
+static void unitMove(HugeSim* sim, int unit, int block);
+static void unitUnlink(HugeSim* sim, int unit);
+static void unitPushMru(HugeSim* sim, int unit);
+static void unitPushLru(HugeSim* sim, int unit);
+
+static HugeRegion* regionFor(HugeSim* sim, unsigned long long region);
+static void        promoteRegion(HugeSim* sim, unsigned long long region, HugeRegion* info);
+static void        evictLru(HugeSim* sim);
+
+static const char* modeNames[HUGE_MODES] = { "base", "thp", "always" };
+
+
+/*************************************************************************
+*   @ Create / destroy                                                    *
+*                                                                         *
+ *************************************************************************/
+
+static int hugeSimCreate(HugeSim* sim, int shift, long long framesNum, int promotePages, int demotePercent,
+	int pinnedPercent, int tlbEntries)
+{
+	memset(sim, 0, sizeof(*sim));
+
+	sim->shift         = shift;
+	sim->ratio         = 1 << shift;
+	sim->promotePages  = promotePages;
+	sim->demotePercent = demotePercent;
+	sim->blocksNum     = (int)(framesNum >> shift);
+	sim->unitsCapacity = (int)((long long)sim->blocksNum << shift);
+	sim->mru           = -1;
+	sim->lru           = -1;
+
+	if (sim->blocksNum < 1)
+	{
+		return -1;
+	}
+
+	sim->blockFree     = (int*)malloc(sim->blocksNum * sizeof(int));
+	sim->blockPinned   = (unsigned char*)calloc(sim->blocksNum, 1);
+	sim->blockHuge     = (unsigned char*)calloc(sim->blocksNum, 1);
+	sim->blockUnits    = (int*)malloc(sim->blocksNum * sizeof(int));
+	sim->wholeBlocks   = (int*)malloc(sim->blocksNum * sizeof(int));
+	sim->partialBlocks = (int*)malloc(sim->blocksNum * sizeof(int));
+	sim->partialSlot   = (int*)malloc(sim->blocksNum * sizeof(int));
+	sim->unitKey       = (unsigned long long*)malloc(sim->unitsCapacity * sizeof(unsigned long long));
+	sim->unitBlock     = (int*)malloc(sim->unitsCapacity * sizeof(int));
+	sim->unitMapping   = (unsigned long long*)malloc(sim->unitsCapacity * sizeof(unsigned long long));
+	sim->nextInBlock   = (int*)malloc(sim->unitsCapacity * sizeof(int));
+	sim->prevInBlock   = (int*)malloc(sim->unitsCapacity * sizeof(int));
+	sim->older         = (int*)malloc(sim->unitsCapacity * sizeof(int));
+	sim->newer         = (int*)malloc(sim->unitsCapacity * sizeof(int));
+	sim->freeUnits     = (int*)malloc(sim->unitsCapacity * sizeof(int));
+
+	if ((sim->blockFree == NULL) | (sim->blockPinned == NULL) | (sim->blockHuge == NULL) | (sim->blockUnits == NULL) |
+		(sim->wholeBlocks == NULL) | (sim->partialBlocks == NULL) | (sim->partialSlot == NULL) |
+		(sim->unitKey == NULL) | (sim->unitBlock == NULL) | (sim->unitMapping == NULL) | (sim->nextInBlock == NULL) |
+		(sim->prevInBlock == NULL) |
+		(sim->older == NULL) | (sim->newer == NULL) | (sim->freeUnits == NULL) | (pageIndexInit(&sim->mapped, 1024) != 0) |
+		(pageIndexInit(&sim->regionIndex, 64) != 0) | (engineCreate(&sim->tlb, POLICY_LRU, tlbEntries) != 0))
+	{
+		hugeSimDestroy(sim);
+		return -1;
+	}
+
+	/* Pinned blocks are spread evenly over the pool; whole blocks are taken from the top. */
+
+	for (int block = sim->blocksNum - 1; block >= 0; block--)
+	{
+		sim->blockUnits[block] = -1;
+
+		if ((long long)(block + 1) * pinnedPercent / 100 != (long long)block * pinnedPercent / 100)
+		{
+			sim->blockFree[block]   = sim->ratio - 1;
+			sim->blockPinned[block] = 1;
+			sim->freeFrames        += sim->ratio - 1;
+			partialAdd(sim, block);
+		}
+		else
+		{
+			sim->blockFree[block] = sim->ratio;
+			sim->freeFrames      += sim->ratio;
+			sim->wholeBlocks[sim->wholeNum++] = block;
+			sim->movableBlocks++;
+		}
+	}
+
+	for (int unit = 0; unit < sim->unitsCapacity; unit++)
+	{
+		sim->freeUnits[unit] = sim->unitsCapacity - 1 - unit;
+	}
+	sim->freeUnitsNum = sim->unitsCapacity;
+
+	return 0;
+}
+
+static void hugeSimDestroy(HugeSim* sim)
+{
+	for (size_t r = 0; r < sim->regionsNum; r++)
+	{
+		free(sim->regions[r].usedMap);
+	}
+
+	free(sim->blockFree);
+	free(sim->blockPinned);
+	free(sim->blockHuge);
+	free(sim->blockUnits);
+	free(sim->wholeBlocks);
+	free(sim->partialBlocks);
+	free(sim->partialSlot);
+	free(sim->unitKey);
+	free(sim->unitBlock);
+	free(sim->unitMapping);
+	free(sim->nextInBlock);
+	free(sim->prevInBlock);
+	free(sim->older);
+	free(sim->newer);
+	free(sim->freeUnits);
+	free(sim->regions);
+	pageIndexFree(&sim->mapped);
+	pageIndexFree(&sim->regionIndex);
+	engineDestroy(&sim->tlb);
+	memset(sim, 0, sizeof(*sim));
+}
+
+/*************************************************************************
+*   @ End of Create / destroy                                             *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Access                                                              *
+*                                                                         *
+*  A reference is a hit when its base page or its region's huge page is   *
+*  mapped. A fault maps the base page, evicting LRU units until a frame   *
+*  is free, and may promote the region. Returns 1 on a page fault.        *
+ *************************************************************************/
+
+static int hugeSimAccess(HugeSim* sim, const PageRef* ref)
+{
+	unsigned long long region = ref->page >> sim->shift;
+	unsigned long long slot;
+	HugeRegion*        info   = regionFor(sim, region);
+	AccessResult       result;
+	PageRef            entry;
+	int                unit;
+	int                fault  = 0;
+
+	if (info == NULL)
+	{
+		return -1;
+	}
+
+	sim->stats.references++;
+
+	if (info->unit >= 0)
+	{
+		unsigned long long index = ref->page & (sim->ratio - 1);
+		unsigned long long bit   = 1ULL << (index & 63);
+
+		if (!(info->usedMap[index >> 6] & bit))
+		{
+			info->usedMap[index >> 6] |= bit;
+			info->used++;
+			sim->hugeUsed++;
+		}
+		unit = info->unit;
+	}
+	else if (pageIndexFind(&sim->mapped, ref->page, &slot))
+	{
+		unit = (int)slot;
+	}
+	else
+	{
+		int block;
+
+		while ((block = allocBaseFrame(sim)) < 0)
+		{
+			evictLru(sim);
+		}
+
+		unit = unitCreate(sim, ref->page, block);
+		info->resident++;
+		fault = 1;
+		sim->stats.faults++;
+
+		if (info->resident == sim->promotePages)
+		{
+			promoteRegion(sim, region, info);
+
+			if (info->unit >= 0)
+			{
+				unit = info->unit;
+			}
+		}
+	}
+
+	unitUnlink(sim, unit);
+	unitPushMru(sim, unit);
+
+	entry.page   = sim->unitMapping[unit];
+	entry.access = ACCESS_READ;
+	engineAccess(&sim->tlb, &entry, &result);
+
+	return fault;
+}
+
+static HugeRegion* regionFor(HugeSim* sim, unsigned long long region)
+{
+	int                 created;
+	unsigned long long* slot = pageIndexSlot(&sim->regionIndex, region, &created);
+
+	if (slot == NULL)
+	{
+		return NULL;
+	}
+
+	if (created)
+	{
+		if (sim->regionsNum == sim->regionsCapacity)
+		{
+			size_t      capacity = sim->regionsCapacity ? sim->regionsCapacity * 2 : 64;
+			HugeRegion* grown    = (HugeRegion*)realloc(sim->regions, capacity * sizeof(HugeRegion));
+
+			if (grown == NULL)
+			{
+				pageIndexRemove(&sim->regionIndex, region);
+				return NULL;
+			}
+			sim->regions         = grown;
+			sim->regionsCapacity = capacity;
+		}
+
+		*slot = sim->regionsNum++;
+		memset(&sim->regions[*slot], 0, sizeof(HugeRegion));
+		sim->regions[*slot].unit = -1;
+	}
+
+	return &sim->regions[*slot];
+}
+
+/*************************************************************************
+*   @ End of Access                                                       *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Promote / evict                                                     *
+*                                                                         *
+*  Promotion unmaps the base pages of the region, which count as used     *
+*  sub-pages of the new huge page, and maps the region to a whole block.  *
+*  It only fails when every block is pinned.                              *
+ *************************************************************************/
+
+static void promoteRegion(HugeSim* sim, unsigned long long region, HugeRegion* info)
+{
+	unsigned long long first = region << sim->shift;
+	unsigned long long slot;
+	int                block;
+
+	if (sim->movableBlocks == 0)
+	{
+		sim->stats.failedPromotions++;
+		return;
+	}
+
+	info->usedMap = (unsigned long long*)calloc((sim->ratio + 63) / 64, sizeof(unsigned long long));
+
+	if (info->usedMap == NULL)
+	{
+		sim->stats.failedPromotions++;
+		return;
+	}
+
+	for (int i = 0; (i < sim->ratio) && (info->resident > 0); i++)
+	{
+		if (pageIndexFind(&sim->mapped, first + i, &slot))
+		{
+			int unit = (int)slot;
+
+			freeBaseFrame(sim, sim->unitBlock[unit]);
+			unitUnlink(sim, unit);
+			unitRemove(sim, unit);
+			info->usedMap[i >> 6] |= 1ULL << (i & 63);
+			info->used++;
+			info->resident--;
+		}
+	}
+
+	block = takeWholeBlock(sim);
+	sim->blockFree[block] = 0;
+	sim->blockHuge[block] = 1;
+	sim->freeFrames      -= sim->ratio;
+
+	info->unit = unitCreate(sim, region | HUGE_KEY_BIT, block);
+	unitPushMru(sim, info->unit);
+
+	sim->hugeMapped++;
+	sim->hugeUsed += info->used;
+	sim->stats.promotions++;
+}
+
+static void evictLru(HugeSim* sim)
+{
+	int                unit  = sim->lru;
+	unsigned long long key   = sim->unitKey[unit];
+	int                block = sim->unitBlock[unit];
+
+	unitUnlink(sim, unit);
+	unitRemove(sim, unit);
+
+	if (!(key & HUGE_KEY_BIT))
+	{
+		regionFor(sim, key >> sim->shift)->resident--;
+		freeBaseFrame(sim, block);
+		sim->stats.evictions++;
+		return;
+	}
+
+	HugeRegion*        info  = regionFor(sim, key & ~HUGE_KEY_BIT);
+	unsigned long long first = (key & ~HUGE_KEY_BIT) << sim->shift;
+
+	sim->hugeMapped--;
+	sim->hugeUsed -= info->used;
+	info->unit     = -1;
+
+	sim->blockHuge[block] = 0;
+
+	if ((info->used > 0) && ((long long)info->used * 100 < (long long)sim->demotePercent * sim->ratio))
+	{
+		/* Split: the used sub-pages stay in the block as cold base pages. */
+
+		for (int i = 0; i < sim->ratio; i++)
+		{
+			if (info->usedMap[i >> 6] & (1ULL << (i & 63)))
+			{
+				unitPushLru(sim, unitCreate(sim, first + i, block));
+			}
+		}
+
+		info->resident         = info->used;
+		sim->blockFree[block]  = sim->ratio - info->used;
+		sim->freeFrames       += sim->ratio - info->used;
+		partialAdd(sim, block);
+		sim->stats.demotions++;
+	}
+	else
+	{
+		sim->blockFree[block]  = sim->ratio;
+		sim->freeFrames       += sim->ratio;
+		sim->wholeBlocks[sim->wholeNum++] = block;
+		sim->stats.evictions++;
+	}
+
+	info->used = 0;
+	free(info->usedMap);
+	info->usedMap = NULL;
+}
+
+/*************************************************************************
+*   @ End of Promote / evict                                              *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Frame pool                                                          *
+*                                                                         *
+*  Base frames come from the last partly used block, then from a whole    *
+*  block. Returns the block, or -1 when memory is full.                   *
+ *************************************************************************/
+
+static int allocBaseFrame(HugeSim* sim)
+{
+	int block;
+
+	if (sim->partialNum > 0)
+	{
+		block = sim->partialBlocks[sim->partialNum - 1];
+	}
+	else if (sim->wholeNum > 0)
+	{
+		block = sim->wholeBlocks[--sim->wholeNum];
+		partialAdd(sim, block);
+	}
+	else
+	{
+		return -1;
+	}
+
+	sim->blockFree[block]--;
+	sim->freeFrames--;
+
+	if (sim->blockFree[block] == 0)
+	{
+		partialRemove(sim, block);
+	}
+
+	return block;
+}
+
+static void freeBaseFrame(HugeSim* sim, int block)
+{
+	if (sim->blockFree[block]++ == 0)
+	{
+		partialAdd(sim, block);
+	}
+	sim->freeFrames++;
+
+	if (sim->blockFree[block] == sim->ratio)
+	{
+		partialRemove(sim, block);
+		sim->wholeBlocks[sim->wholeNum++] = block;
+	}
+}
+
+/* Reclaims and compacts until a whole block is free; needs a movable block. */
+
+static int takeWholeBlock(HugeSim* sim)
+{
+	while (sim->wholeNum == 0)
+	{
+		int source = -1;
+
+		if (sim->freeFrames >= sim->ratio)
+		{
+			for (int block = 0; block < sim->blocksNum; block++)
+			{
+				if (!sim->blockPinned[block] && !sim->blockHuge[block] &&
+					((source < 0) || (sim->blockFree[block] > sim->blockFree[source])))
+				{
+					source = block;
+				}
+			}
+		}
+
+		if (source >= 0)
+		{
+			compactBlock(sim, source);
+		}
+		else
+		{
+			evictLru(sim);
+		}
+	}
+
+	return sim->wholeBlocks[--sim->wholeNum];
+}
+
+/* Migrates every base page of block into free frames of the other blocks. */
+
+static void compactBlock(HugeSim* sim, int block)
+{
+	int used = sim->ratio - sim->blockFree[block];
+
+	if (sim->blockFree[block] > 0)
+	{
+		partialRemove(sim, block);
+	}
+
+	while (sim->blockUnits[block] != -1)
+	{
+		int unit = sim->blockUnits[block];
+
+		unitMove(sim, unit, allocBaseFrame(sim));
+		sim->unitMapping[unit] = ++sim->mappings << 1;
+		sim->stats.migrations++;
+	}
+
+	sim->blockFree[block] = sim->ratio;
+	sim->freeFrames      += used;
+	sim->wholeBlocks[sim->wholeNum++] = block;
+}
+
+static void partialAdd(HugeSim* sim, int block)
+{
+	sim->partialSlot[block]               = sim->partialNum;
+	sim->partialBlocks[sim->partialNum++] = block;
+}
+
+static void partialRemove(HugeSim* sim, int block)
+{
+	int last = sim->partialBlocks[--sim->partialNum];
+
+	sim->partialBlocks[sim->partialSlot[block]] = last;
+	sim->partialSlot[last]                      = sim->partialSlot[block];
+}
+
+/*************************************************************************
+*   @ End of Frame pool                                                   *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Units                                                               *
+*                                                                         *
+*  Mapped pages linked from the most to the least recently used. A new    *
+*  unit is not linked yet.                                                *
+ *************************************************************************/
+
+static int unitCreate(HugeSim* sim, unsigned long long key, int block)
+{
+	int unit = sim->freeUnits[--sim->freeUnitsNum];
+
+	sim->unitKey[unit]     = key;
+	sim->unitMapping[unit] = (++sim->mappings << 1) | (key >> 63);
+	sim->unitBlock[unit]   = -1;
+	sim->older[unit]     = -1;
+	sim->newer[unit]     = -1;
+	pageIndexSet(&sim->mapped, key, (unsigned long long)unit);
+
+	if (key & HUGE_KEY_BIT)
+	{
+		sim->unitBlock[unit] = block;
+	}
+	else
+	{
+		unitMove(sim, unit, block);
+	}
+
+	return unit;
+}
+
+static void unitRemove(HugeSim* sim, int unit)
+{
+	if (!(sim->unitKey[unit] & HUGE_KEY_BIT))
+	{
+		unitMove(sim, unit, -1);
+	}
+	pageIndexRemove(&sim->mapped, sim->unitKey[unit]);
+	sim->freeUnits[sim->freeUnitsNum++] = unit;
+}
+
+/* Moves a base page unit from the page list of its block to that of block (-1: none). */
+
+static void unitMove(HugeSim* sim, int unit, int block)
+{
+	int from = sim->unitBlock[unit];
+
+	if (from != -1)
+	{
+		if (sim->prevInBlock[unit] != -1)
+		{
+			sim->nextInBlock[sim->prevInBlock[unit]] = sim->nextInBlock[unit];
+		}
+		else
+		{
+			sim->blockUnits[from] = sim->nextInBlock[unit];
+		}
+
+		if (sim->nextInBlock[unit] != -1)
+		{
+			sim->prevInBlock[sim->nextInBlock[unit]] = sim->prevInBlock[unit];
+		}
+	}
+
+	sim->unitBlock[unit] = block;
+
+	if (block != -1)
+	{
+		sim->prevInBlock[unit] = -1;
+		sim->nextInBlock[unit] = sim->blockUnits[block];
+
+		if (sim->blockUnits[block] != -1)
+		{
+			sim->prevInBlock[sim->blockUnits[block]] = unit;
+		}
+		sim->blockUnits[block] = unit;
+	}
+}
+
+static void unitUnlink(HugeSim* sim, int unit)
+{
+	int older = sim->older[unit];
+	int newer = sim->newer[unit];
+
+	if (newer != -1)
+	{
+		sim->older[newer] = older;
+	}
+	else if (sim->mru == unit)
+	{
+		sim->mru = older;
+	}
+
+	if (older != -1)
+	{
+		sim->newer[older] = newer;
+	}
+	else if (sim->lru == unit)
+	{
+		sim->lru = newer;
+	}
+
+	sim->older[unit] = -1;
+	sim->newer[unit] = -1;
+}
+
+static void unitPushMru(HugeSim* sim, int unit)
+{
+	sim->older[unit] = sim->mru;
+	sim->newer[unit] = -1;
+
+	if (sim->mru != -1)
+	{
+		sim->newer[sim->mru] = unit;
+	}
+	else
+	{
+		sim->lru = unit;
+	}
+	sim->mru = unit;
+}
+
+static void unitPushLru(HugeSim* sim, int unit)
+{
+	sim->newer[unit] = sim->lru;
+	sim->older[unit] = -1;
+
+	if (sim->lru != -1)
+	{
+		sim->older[sim->lru] = unit;
+	}
+	else
+	{
+		sim->mru = unit;
+	}
+	sim->lru = unit;
+}
+
+/*************************************************************************
+*   @ End of Units                                                        *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Huge command                                                        *
+*                                                                         *
+*  Runs base pages only, promotion at promote% and promotion on the first *
+*  fault of a region side by side. TLB reach is the memory covered by the *
+*  TLB entries at the end of the trace, bloat the unused part of the huge *
+*  pages, and fragmentation the share of free memory that is not in      *
+*  whole free blocks. Migrated counts base pages moved by compaction.     *
+ *************************************************************************/
+
+static int hugeRunSink(void* context, const PageRef* refs, size_t count)
+{
+	HugeSim* sims = (HugeSim*)context;
+
+	for (int m = 0; m < HUGE_MODES; m++)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			if (hugeSimAccess(&sims[m], &refs[i]) < 0)
+			{
+				return -1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+int runHugeCommand(int argCount, char* args[])
+{
+	HugeSim   sims[HUGE_MODES];
+	int       format;
+	long long framesNum;
+	int       shift         = HUGE_SHIFT_2M;
+	int       promotePercent = argCount > 5 ? atoi(args[5]) : 50;
+	int       demotePercent  = argCount > 6 ? atoi(args[6]) : 25;
+	int       pinnedPercent  = argCount > 7 ? atoi(args[7]) : 0;
+	int       tlbEntries     = argCount > 8 ? atoi(args[8]) : HUGE_TLB_ENTRIES;
+	int       status;
+
+	if (argCount < 4)
+	{
+		printf("Usage: %s\n", HUGE_USAGE);
+		return -1;
+	}
+
+	format    = traceFormatFromName(args[1]);
+	framesNum = atoll(args[3]) << (20 - TRACE_PAGE_SHIFT);
+
+	if ((argCount > 4) && (strcmp(args[4], "1g") == 0))
+	{
+		shift = HUGE_SHIFT_1G;
+	}
+	else if ((argCount > 4) && (strcmp(args[4], "2m") != 0))
+	{
+		format = TRACE_FORMAT_UNKNOWN;
+	}
+
+	if ((format == TRACE_FORMAT_UNKNOWN) | (promotePercent < 1) | (promotePercent > 100) | (demotePercent < 0) |
+		(pinnedPercent < 0) | (pinnedPercent > 100) | (tlbEntries < 1))
+	{
+		printf("Usage: %s\n", HUGE_USAGE);
+		return -1;
+	}
+
+	for (int m = 0; m < HUGE_MODES; m++)
+	{
+		int promotePages = m == 0 ? (1 << shift) + 1 : m == 1 ? ((1 << shift) * promotePercent + 99) / 100 : 1;
+
+		if (hugeSimCreate(&sims[m], shift, framesNum, promotePages, demotePercent, pinnedPercent, tlbEntries) != 0)
+		{
+			printf("%s MiB of memory is not enough for one huge page or cannot be allocated!\n", args[3]);
+
+			while (m >= 0)
+			{
+				hugeSimDestroy(&sims[m--]);
+			}
+			return -1;
+		}
+	}
+
+	status = loadTrace(args[2], format, 0, hugeRunSink, sims);
+
+	if (status == 0)
+	{
+		printf("\n Trace %s: %llu references, %s MiB, %s pages, %d%% promote, %d%% demote, %d%% pinned\n\n",
+			args[2], sims[0].stats.references, args[3], shift == HUGE_SHIFT_1G ? "1 GiB" : "2 MiB",
+			promotePercent, demotePercent, pinnedPercent);
+		printf(" -----------------------------------------------------------------------------------------------------------\n");
+		printf("| Mode   |    Faults    |  TLB misses  | Promoted  |  Demoted  | Migrated  | Reach MiB | Bloat MiB | Frag   |\n");
+		printf(" -----------------------------------------------------------------------------------------------------------\n");
+
+		for (int m = 0; m < HUGE_MODES; m++)
+		{
+			HugeSim*           sim       = &sims[m];
+			unsigned long long reach     = 0;
+			long long          wholeFree = (long long)sim->wholeNum << sim->shift;
+
+			for (int unit = sim->mru; unit != -1; unit = sim->older[unit])
+			{
+				if (pageIndexFind(&sim->tlb.frames, sim->unitMapping[unit], NULL))
+				{
+					reach += (sim->unitMapping[unit] & 1) ? 1ULL << sim->shift : 1;
+				}
+			}
+
+			printf("| %-6s | %12llu | %12llu | %9llu | %9llu | %9llu | %9.1f | %9.1f | %5.1f%% |\n", modeNames[m],
+				sim->stats.faults, sim->tlb.stats.faults, sim->stats.promotions, sim->stats.demotions,
+				sim->stats.migrations, (double)reach / (1 << (20 - TRACE_PAGE_SHIFT)),
+				(double)((sim->hugeMapped << sim->shift) - sim->hugeUsed) / (1 << (20 - TRACE_PAGE_SHIFT)),
+				sim->freeFrames ? 100.0 * (double)(sim->freeFrames - wholeFree) / (double)sim->freeFrames : 0.0);
+		}
+		printf(" -----------------------------------------------------------------------------------------------------------\n");
+	}
+	else
+	{
+		printf("Simulation failed!\n");
+	}
+
+	for (int m = 0; m < HUGE_MODES; m++)
+	{
+		hugeSimDestroy(&sims[m]);
+	}
+
+	return status == 0 ? 0 : -1;
+}
+
+/*************************************************************************
+*   @ End of Huge command                                                 *
+*                                                                         *
+ *************************************************************************/
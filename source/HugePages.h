@@ -0,0 +1,24 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: Mixed base page / huge page simulation. Physical memory is a pool of huge page
+ * sized blocks of base frames; regions that are used enough are promoted to a huge page
+ * when a whole free block is left, and cold, sparsely used huge pages are split again
+ * under memory pressure, much like transparent huge pages.
+*/
+
+
+#ifndef HUGE_PAGES_H
+#define HUGE_PAGES_H
+
+#include "PagingEngine.h"
+
+#define HUGE_USAGE          "huge <lackey|pin|csv|bin> <file> <memoryMiB> [2m|1g] [promote%] [demote%] [pinned%] [tlbEntries]"
+#define HUGE_SHIFT_2M       9
+#define HUGE_SHIFT_1G       18
+#define HUGE_KEY_BIT        (1ULL << 63)
+#define HUGE_TLB_ENTRIES    1536
+
+
+int runHugeCommand(int argCount, char* args[]);
+
+#endif // !HUGE_PAGES_H
@@ -0,0 +1,502 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: IdleSampler.cpp contains the idle page tracking sampler.
+ *
+ * Every interval the resident pages of the target are listed from /proc/<pid>/maps and
+ * /proc/<pid>/pagemap, their frames are marked idle in /sys/kernel/mm/page_idle/bitmap,
+ * and one interval later the bitmap is read back: a cleared idle bit means the page was
+ * accessed. Pagemap and bitmap are accessed with batched pread/pwrite calls over sorted
+ * frame numbers. Needs root and CONFIG_IDLE_PAGE_TRACKING.
+*/
+
+
+
+#include "IdleSampler.h"
+#include "PagingEngine.h"
+#include <string.h>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#define IDLE_SAMPLER_SUPPORTED
+#endif
+
+#define IDLE_BITMAP_PATH   "/sys/kernel/mm/page_idle/bitmap"
+#define IDLE_MAX_FRAMES    16
+#define PAGEMAP_PRESENT    (1ULL << 63)
+#define PAGEMAP_PFN_MASK   ((1ULL << 55) - 1)
+
+
+/* A resident virtual page and the physical frame backing it. */
+
+struct IdlePage
+{
+	unsigned long long vpage;
+	unsigned long long pfn;
+};
+
+/* One 64-bit word of the idle bitmap: bits written as idle and bits read back. */
+
+struct IdleWord
+{
+	unsigned long long index;
+	unsigned long long marked;
+	unsigned long long idle;
+};
+
+struct IdleScan
+{
+	IdlePage* pages;
+	size_t    pagesNum;
+	size_t    pagesCapacity;
+	IdleWord* words;
+	size_t    wordsNum;
+	size_t    wordsCapacity;
+};
+
+#ifdef IDLE_SAMPLER_SUPPORTED
+
+static int  scanResidentPages(int pid, int pagemapFd, IdleScan* scan);
+static int  markIdle(int bitmapFd, IdleScan* scan);
+static int  readIdle(int bitmapFd, IdleScan* scan);
+static int  comparePfn(const void* a, const void* b);
+static int  compareVpage(const void* a, const void* b);
+
+
+/*************************************************************************
+*   @ Scan resident pages                                                 *
+*                                                                         *
+*  Walks every mapping of the target and reads its pagemap entries        *
+*  IDLE_BATCH_ENTRIES at a time. Frame numbers read as zero when the      *
+*  caller lacks CAP_SYS_ADMIN, in which case nothing can be tracked.      *
+ *************************************************************************/
+
+static int scanResidentPages(int pid, int pagemapFd, IdleScan* scan)
+{
+	unsigned long long entries[IDLE_BATCH_ENTRIES];
+	unsigned long long start;
+	unsigned long long end;
+	char               path[64];
+	char               line[512];
+
+	snprintf(path, sizeof(path), "/proc/%d/maps", pid);
+
+	FILE* maps = fopen(path, "r");
+
+	if (maps == NULL)
+	{
+		return -1;
+	}
+
+	scan->pagesNum = 0;
+
+	while (fgets(line, sizeof(line), maps) != NULL)
+	{
+		if ((sscanf(line, "%llx-%llx", &start, &end) != 2) | (strstr(line, "[vsyscall]") != NULL))
+		{
+			continue;
+		}
+
+		for (unsigned long long vpage = start >> 12; vpage < end >> 12; vpage += IDLE_BATCH_ENTRIES)
+		{
+			size_t  batch = (size_t)((end >> 12) - vpage < IDLE_BATCH_ENTRIES ? (end >> 12) - vpage : IDLE_BATCH_ENTRIES);
+			ssize_t got   = pread(pagemapFd, entries, batch * sizeof(entries[0]), (off_t)(vpage * sizeof(entries[0])));
+
+			for (ssize_t i = 0; i < got / (ssize_t)sizeof(entries[0]); i++)
+			{
+				if ((entries[i] & PAGEMAP_PRESENT) && (entries[i] & PAGEMAP_PFN_MASK))
+				{
+					if (scan->pagesNum == scan->pagesCapacity)
+					{
+						size_t    capacity = scan->pagesCapacity ? scan->pagesCapacity * 2 : 4096;
+						IdlePage* grown    = (IdlePage*)realloc(scan->pages, capacity * sizeof(IdlePage));
+
+						if (grown == NULL)
+						{
+							fclose(maps);
+							return -1;
+						}
+						scan->pages         = grown;
+						scan->pagesCapacity = capacity;
+					}
+
+					scan->pages[scan->pagesNum].vpage = vpage + (unsigned long long)i;
+					scan->pages[scan->pagesNum].pfn   = entries[i] & PAGEMAP_PFN_MASK;
+					scan->pagesNum++;
+				}
+			}
+		}
+	}
+
+	fclose(maps);
+
+	return 0;
+}
+
+/*************************************************************************
+*   @ End of Scan resident pages                                          *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Mark idle                                                           *
+*                                                                         *
+*  Sorts the pages by frame, folds them into bitmap words and writes      *
+*  runs of consecutive words with one pwrite per IDLE_BATCH_ENTRIES.      *
+ *************************************************************************/
+
+static int markIdle(int bitmapFd, IdleScan* scan)
+{
+	qsort(scan->pages, scan->pagesNum, sizeof(IdlePage), comparePfn);
+
+	scan->wordsNum = 0;
+
+	for (size_t i = 0; i < scan->pagesNum; i++)
+	{
+		unsigned long long index = scan->pages[i].pfn >> 6;
+
+		if ((scan->wordsNum == 0) || (scan->words[scan->wordsNum - 1].index != index))
+		{
+			if (scan->wordsNum == scan->wordsCapacity)
+			{
+				size_t    capacity = scan->wordsCapacity ? scan->wordsCapacity * 2 : 4096;
+				IdleWord* grown    = (IdleWord*)realloc(scan->words, capacity * sizeof(IdleWord));
+
+				if (grown == NULL)
+				{
+					return -1;
+				}
+				scan->words         = grown;
+				scan->wordsCapacity = capacity;
+			}
+
+			scan->words[scan->wordsNum].index  = index;
+			scan->words[scan->wordsNum].marked = 0;
+			scan->words[scan->wordsNum].idle   = 0;
+			scan->wordsNum++;
+		}
+		scan->words[scan->wordsNum - 1].marked |= 1ULL << (scan->pages[i].pfn & 63);
+	}
+
+	for (size_t first = 0; first < scan->wordsNum;)
+	{
+		unsigned long long run[IDLE_BATCH_ENTRIES];
+		size_t             count = 0;
+
+		while ((first + count < scan->wordsNum) & (count < IDLE_BATCH_ENTRIES) &&
+			(scan->words[first + count].index == scan->words[first].index + count))
+		{
+			run[count] = scan->words[first + count].marked;
+			count++;
+		}
+
+		if (pwrite(bitmapFd, run, count * 8, (off_t)(scan->words[first].index * 8)) != (ssize_t)(count * 8))
+		{
+			return -1;
+		}
+		first += count;
+	}
+
+	return 0;
+}
+
+/*************************************************************************
+*   @ End of Mark idle                                                    *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Read idle                                                           *
+*                                                                         *
+*  Reads back the same words. Bits that were marked and are no longer     *
+*  idle (marked & ~idle) are the frames accessed during the interval.     *
+ *************************************************************************/
+
+static int readIdle(int bitmapFd, IdleScan* scan)
+{
+	for (size_t first = 0; first < scan->wordsNum;)
+	{
+		unsigned long long run[IDLE_BATCH_ENTRIES];
+		size_t             count = 1;
+
+		while ((first + count < scan->wordsNum) & (count < IDLE_BATCH_ENTRIES) &&
+			(scan->words[first + count].index == scan->words[first].index + count))
+		{
+			count++;
+		}
+
+		if (pread(bitmapFd, run, count * 8, (off_t)(scan->words[first].index * 8)) != (ssize_t)(count * 8))
+		{
+			return -1;
+		}
+
+		for (size_t i = 0; i < count; i++)
+		{
+			scan->words[first + i].idle = run[i];
+		}
+		first += count;
+	}
+
+	return 0;
+}
+
+static int comparePfn(const void* a, const void* b)
+{
+	unsigned long long pfnA = ((const IdlePage*)a)->pfn;
+	unsigned long long pfnB = ((const IdlePage*)b)->pfn;
+
+	return pfnA < pfnB ? -1 : pfnA > pfnB;
+}
+
+static int compareVpage(const void* a, const void* b)
+{
+	unsigned long long vpageA = ((const IdlePage*)a)->vpage;
+	unsigned long long vpageB = ((const IdlePage*)b)->vpage;
+
+	return vpageA < vpageB ? -1 : vpageA > vpageB;
+}
+
+/*************************************************************************
+*   @ End of Read idle                                                    *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Idle command                                                        *
+*                                                                         *
+*  Samples the target, feeds the accessed pages of every interval (in     *
+*  address order, stamped with the interval end) to an LRU and a CLOCK    *
+*  engine per frame count, and prints the working set per interval and    *
+*  the fault rates at the end.                                            *
+ *************************************************************************/
+
+int runIdleCommand(int argCount, char* args[])
+{
+	PagingEngine engines[IDLE_MAX_FRAMES * 2];
+	IdleScan     scan;
+	TraceWriter  writer;
+	PageIndex    touched;
+	IdlePage*    accessed = NULL;
+	int          enginesNum = 0;
+	int          status     = 0;
+	int          writing    = 0;
+	char         path[64];
+
+	if (argCount < 5)
+	{
+		printf("Usage: %s\n", IDLE_USAGE);
+		return -1;
+	}
+
+	int          pid      = atoi(args[1]);
+	unsigned int interval = (unsigned int)atoi(args[2]);
+	int          samples  = atoi(args[3]);
+	char*        frames   = args[4];
+
+	while ((*frames != '\0') & (enginesNum < IDLE_MAX_FRAMES * 2))
+	{
+		int framesNum = (int)strtol(frames, &frames, 10);
+
+		if ((framesNum < 1) || (engineCreate(&engines[enginesNum], POLICY_LRU, framesNum) != 0))
+		{
+			break;
+		}
+		if (engineCreate(&engines[enginesNum + 1], POLICY_CLOCK, framesNum) != 0)
+		{
+			engineDestroy(&engines[enginesNum]);
+			break;
+		}
+		enginesNum += 2;
+
+		if (*frames == ',')
+		{
+			frames++;
+		}
+	}
+
+	if ((pid <= 0) | (interval == 0) | (samples < 1) | (enginesNum == 0) | (*frames != '\0'))
+	{
+		if ((enginesNum == IDLE_MAX_FRAMES * 2) & (*frames != '\0'))
+		{
+			printf("At most %d frame sizes!\n", IDLE_MAX_FRAMES);
+		}
+		else
+		{
+			printf("Usage: %s\n", IDLE_USAGE);
+		}
+
+		for (int e = 0; e < enginesNum; e++)
+		{
+			engineDestroy(&engines[e]);
+		}
+		return -1;
+	}
+
+	snprintf(path, sizeof(path), "/proc/%d/pagemap", pid);
+
+	int pagemapFd = open(path, O_RDONLY);
+	int bitmapFd  = open(IDLE_BITMAP_PATH, O_RDWR);
+
+	if ((pagemapFd < 0) | (bitmapFd < 0))
+	{
+		printf("Cannot open %s or %s (root and CONFIG_IDLE_PAGE_TRACKING needed)!\n", path, IDLE_BITMAP_PATH);
+		status = -1;
+	}
+
+	memset(&scan, 0, sizeof(scan));
+	pageIndexInit(&touched, 4096);
+
+	if ((status == 0) & (argCount > 5))
+	{
+		status  = traceWriterOpen(&writer, args[5]);
+		writing = status == 0;
+	}
+
+	if ((status == 0) && ((scanResidentPages(pid, pagemapFd, &scan) != 0) || (markIdle(bitmapFd, &scan) != 0)))
+	{
+		printf("Cannot mark pages of process %d idle!\n", pid);
+		status = -1;
+	}
+
+	unsigned long long wssTotal = 0;
+	unsigned long long wssMax   = 0;
+	int                taken    = 0;
+
+	if (status == 0)
+	{
+		printf("\n Sample | Resident pages | Accessed pages\n");
+	}
+
+	for (int sample = 1; (sample <= samples) & (status == 0); sample++)
+	{
+		size_t accessedNum = 0;
+
+		usleep(interval * 1000);
+
+		if (readIdle(bitmapFd, &scan) != 0)
+		{
+			status = -1;
+			break;
+		}
+
+		accessed = (IdlePage*)realloc(accessed, (scan.pagesNum + 1) * sizeof(IdlePage));
+
+		if (accessed == NULL)
+		{
+			status = -1;
+			break;
+		}
+
+		for (size_t i = 0, w = 0; i < scan.pagesNum; i++)
+		{
+			unsigned long long bit = 1ULL << (scan.pages[i].pfn & 63);
+
+			while (scan.words[w].index != scan.pages[i].pfn >> 6)
+			{
+				w++;
+			}
+
+			if (!(scan.words[w].idle & bit))
+			{
+				accessed[accessedNum++] = scan.pages[i];
+			}
+		}
+
+		qsort(accessed, accessedNum, sizeof(IdlePage), compareVpage);
+
+		for (size_t i = 0; i < accessedNum; i++)
+		{
+			PageRef      ref;
+			AccessResult result;
+
+			ref.page   = accessed[i].vpage;
+			ref.time   = (unsigned long long)sample * interval * 1000000ULL;
+			ref.pid    = (unsigned int)pid;
+			ref.access = ACCESS_READ;
+
+			for (int e = 0; e < enginesNum; e++)
+			{
+				engineAccess(&engines[e], &ref, &result);
+			}
+
+			if (writing)
+			{
+				traceWriterAppend(&writer, &ref, 1);
+			}
+			pageIndexSet(&touched, ref.page, 1);
+		}
+
+		wssTotal += accessedNum;
+		wssMax    = accessedNum > wssMax ? accessedNum : wssMax;
+		taken++;
+
+		printf(" %6d | %14llu | %14llu\n", sample, (unsigned long long)scan.pagesNum, (unsigned long long)accessedNum);
+
+		if ((scanResidentPages(pid, pagemapFd, &scan) != 0) || (markIdle(bitmapFd, &scan) != 0))
+		{
+			printf("Process %d is gone.\n", pid);
+			break;
+		}
+	}
+
+	if (status == 0)
+	{
+		printf("\n Working set per %u ms over %d samples: avg %.0f pages, max %llu pages, %llu distinct pages touched\n\n",
+			interval, taken, taken > 0 ? (double)wssTotal / taken : 0.0, wssMax, (unsigned long long)touched.count);
+		printf(" ---------------------------------------------------------\n");
+		printf("|  Frames  | LRU faults  | CLOCK faults |  LRU   | CLOCK  |\n");
+		printf(" ---------------------------------------------------------\n");
+
+		for (int e = 0; e < enginesNum; e += 2)
+		{
+			EngineStats* lru   = &engines[e].stats;
+			EngineStats* clock = &engines[e + 1].stats;
+
+			printf("| %8d | %11llu | %12llu | %5.1f%% | %5.1f%% |\n", engines[e].framesNum, lru->faults, clock->faults,
+				lru->references ? 100.0 * (double)lru->faults / (double)lru->references : 0.0,
+				clock->references ? 100.0 * (double)clock->faults / (double)clock->references : 0.0);
+		}
+		printf(" ---------------------------------------------------------\n");
+	}
+
+	if (writing)
+	{
+		traceWriterClose(&writer);
+	}
+	if (pagemapFd >= 0)
+	{
+		close(pagemapFd);
+	}
+	if (bitmapFd >= 0)
+	{
+		close(bitmapFd);
+	}
+	for (int e = 0; e < enginesNum; e++)
+	{
+		engineDestroy(&engines[e]);
+	}
+	pageIndexFree(&touched);
+	free(scan.pages);
+	free(scan.words);
+	free(accessed);
+
+	return status;
+}
+
+/*************************************************************************
+*   @ End of Idle command                                                 *
+*                                                                         *
+ *************************************************************************/
+
+#else
+
+int runIdleCommand(int argCount, char* args[])
+{
+	printf("Idle page tracking needs Linux!\n");
+	return -1;
+}
+
+#endif
@@ -0,0 +1,20 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: Working set sampler for a running process based on Linux idle page tracking.
+ * Pages accessed between two samples become page references for the LRU and CLOCK
+ * engines, so a service can be sized without instrumenting it.
+*/
+
+
+#ifndef IDLE_SAMPLER_H
+#define IDLE_SAMPLER_H
+
+#include "Trace.h"
+
+#define IDLE_USAGE         "idle <pid> <intervalMs> <samples> <frames[,frames...]> [output.ptr]"
+#define IDLE_BATCH_ENTRIES 512
+
+
+int runIdleCommand(int argCount, char* args[]);
+
+#endif // !IDLE_SAMPLER_H
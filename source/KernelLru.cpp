@@ -0,0 +1,627 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: KernelLru.cpp contains the two-list and MGLRU reclaim engines and the kernel
+ * command.
+ *
+ * Both treat the trace as mapped memory: a reference only sets the page's accessed bit,
+ * and a fault maps the page with the bit set, so a page has to be used again before
+ * reclaim sees it as used twice.
+ *
+ * Two-list (mm/vmscan.c, mm/workingset.c): reclaim first moves active pages to the
+ * inactive list while the active list is the larger one, clearing their accessed bits.
+ * At the inactive tail an accessed page is kept one more trip with PG_referenced set, or
+ * activated if PG_referenced was already set; a page that was not accessed is evicted and
+ * leaves a shadow entry holding the nonresident age, a counter of evictions and
+ * activations. A refault whose distance (the age since its eviction) is at most the
+ * active list size would have stayed resident with that much more memory, so the page
+ * goes straight to the active list.
+ *
+ * MGLRU (mm/vmscan.c, lru_gen): new pages join the second youngest generation. Aging
+ * creates a new youngest generation and walks every mapped page, moving the accessed ones
+ * into it; it runs every scanRefs references and whenever reclaim finds only the two
+ * youngest generations left. Reclaim takes the oldest generation's pages, moving accessed
+ * ones to the youngest generation. A refault within MGLRU_MAX_GENS generations of its
+ * eviction joins the youngest generation.
+*/
+
+
+
+#include "KernelLru.h"
+#include "TraceParser.h"
+#include <string.h>
+
+#define KERNEL_NONE          -1
+
+
+static const char* kernelModeNames[] = { "Two-list", "MGLRU" };
+
+
+const char* kernelModeName(int mode)
+{
+	return (mode == KERNEL_TWO_LIST) | (mode == KERNEL_MGLRU) ? kernelModeNames[mode] : "?";
+}
+
+
+/*************************************************************************
+*   @ Lists                                                               *
+*                                                                         *
+ *************************************************************************/
+
+static void listPushNewest(KernelLru* lru, int list, int frame)
+{
+	lru->list[frame]  = (unsigned char)list;
+	lru->newer[frame] = KERNEL_NONE;
+	lru->older[frame] = lru->newest[list];
+
+	if (lru->newest[list] != KERNEL_NONE)
+	{
+		lru->newer[lru->newest[list]] = frame;
+	}
+	else
+	{
+		lru->oldest[list] = frame;
+	}
+	lru->newest[list] = frame;
+	lru->sizes[list]++;
+}
+
+static void listPushOldest(KernelLru* lru, int list, int frame)
+{
+	lru->list[frame]  = (unsigned char)list;
+	lru->older[frame] = KERNEL_NONE;
+	lru->newer[frame] = lru->oldest[list];
+
+	if (lru->oldest[list] != KERNEL_NONE)
+	{
+		lru->older[lru->oldest[list]] = frame;
+	}
+	else
+	{
+		lru->newest[list] = frame;
+	}
+	lru->oldest[list] = frame;
+	lru->sizes[list]++;
+}
+
+static void listUnlink(KernelLru* lru, int frame)
+{
+	int list = lru->list[frame];
+
+	if (lru->older[frame] != KERNEL_NONE)
+	{
+		lru->newer[lru->older[frame]] = lru->newer[frame];
+	}
+	else
+	{
+		lru->oldest[list] = lru->newer[frame];
+	}
+
+	if (lru->newer[frame] != KERNEL_NONE)
+	{
+		lru->older[lru->newer[frame]] = lru->older[frame];
+	}
+	else
+	{
+		lru->newest[list] = lru->older[frame];
+	}
+	lru->sizes[list]--;
+}
+
+static inline void listMove(KernelLru* lru, int list, int frame)
+{
+	listUnlink(lru, frame);
+	listPushNewest(lru, list, frame);
+}
+
+/*************************************************************************
+*   @ End of Lists                                                        *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Init / free                                                         *
+*                                                                         *
+ *************************************************************************/
+
+int kernelLruCreate(KernelLru* lru, int mode, int framesNum, unsigned long long scanRefs)
+{
+	memset(lru, 0, sizeof(*lru));
+
+	if ((framesNum < 1) | ((mode != KERNEL_TWO_LIST) & (mode != KERNEL_MGLRU)))
+	{
+		return -1;
+	}
+
+	lru->mode       = mode;
+	lru->framesNum  = framesNum;
+	lru->scanRefs   = scanRefs;
+	lru->maxSeq     = MGLRU_MIN_GENS + 1;
+	lru->framePage  = (unsigned long long*)malloc((size_t)framesNum * sizeof(unsigned long long));
+	lru->accessed   = (unsigned char*)calloc((size_t)framesNum, 1);
+	lru->referenced = (unsigned char*)calloc((size_t)framesNum, 1);
+	lru->dirty      = (unsigned char*)calloc((size_t)framesNum, 1);
+	lru->list       = (unsigned char*)calloc((size_t)framesNum, 1);
+	lru->older      = (int*)malloc((size_t)framesNum * sizeof(int));
+	lru->newer      = (int*)malloc((size_t)framesNum * sizeof(int));
+	lru->stale      = (unsigned long long*)malloc((size_t)framesNum * sizeof(unsigned long long));
+
+	for (int list = 0; list < MGLRU_MAX_GENS; list++)
+	{
+		lru->newest[list] = KERNEL_NONE;
+		lru->oldest[list] = KERNEL_NONE;
+	}
+
+	if ((lru->framePage == NULL) | (lru->accessed == NULL) | (lru->referenced == NULL) | (lru->dirty == NULL) |
+		(lru->list == NULL) | (lru->older == NULL) | (lru->newer == NULL) | (lru->stale == NULL) ||
+		(pageIndexInit(&lru->frames, (size_t)framesNum) != 0) ||
+		(pageIndexInit(&lru->shadows, (size_t)framesNum * KERNEL_SHADOW_FACTOR) != 0))
+	{
+		kernelLruDestroy(lru);
+		return -1;
+	}
+
+	lru->shadowLimit = (size_t)framesNum * KERNEL_SHADOW_FACTOR;
+
+	return 0;
+}
+
+void kernelLruDestroy(KernelLru* lru)
+{
+	free(lru->framePage);
+	free(lru->accessed);
+	free(lru->referenced);
+	free(lru->dirty);
+	free(lru->list);
+	free(lru->older);
+	free(lru->newer);
+	free(lru->stale);
+	pageIndexFree(&lru->frames);
+	pageIndexFree(&lru->shadows);
+	memset(lru, 0, sizeof(*lru));
+}
+
+/*************************************************************************
+*   @ End of Init / free                                                  *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Shadow entries                                                      *
+*                                                                         *
+*  A shadow is stale once it can no longer activate its refault: more     *
+*  than framesNum evictions and activations ago (the active list never    *
+*  holds more), or MGLRU_MAX_GENS generations ago. Stale shadows are      *
+*  pruned whenever the shadows double past KERNEL_SHADOW_FACTOR per       *
+*  frame, like the shadow node shrinker.                                  *
+ *************************************************************************/
+
+static inline int shadowStale(const KernelLru* lru, unsigned long long token)
+{
+	if (lru->mode == KERNEL_TWO_LIST)
+	{
+		return lru->nonresidentAge - token > (unsigned long long)lru->framesNum;
+	}
+	return lru->maxSeq - token >= MGLRU_MAX_GENS;
+}
+
+static void kernelPruneShadows(KernelLru* lru)
+{
+	unsigned long long page;
+	unsigned long long token;
+	size_t             staleNum;
+
+	do
+	{
+		size_t cursor = 0;
+
+		staleNum = 0;
+
+		while ((staleNum < (size_t)lru->framesNum) && pageIndexNext(&lru->shadows, &cursor, &page, &token))
+		{
+			if (shadowStale(lru, token))
+			{
+				lru->stale[staleNum++] = page;
+			}
+		}
+
+		for (size_t s = 0; s < staleNum; s++)
+		{
+			pageIndexRemove(&lru->shadows, lru->stale[s]);
+		}
+	} while (staleNum == (size_t)lru->framesNum);
+
+	lru->shadowLimit = lru->shadows.count * 2;
+
+	if (lru->shadowLimit < (size_t)lru->framesNum * KERNEL_SHADOW_FACTOR)
+	{
+		lru->shadowLimit = (size_t)lru->framesNum * KERNEL_SHADOW_FACTOR;
+	}
+}
+
+/*************************************************************************
+*   @ End of Shadow entries                                               *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Two-list reclaim                                                    *
+*                                                                         *
+ *************************************************************************/
+
+static int twoListReclaim(KernelLru* lru)
+{
+	for (;;)
+	{
+		for (int moved = 0; (moved < KERNEL_DEACTIVATE) && (lru->sizes[KERNEL_ACTIVE] > lru->sizes[KERNEL_INACTIVE]);
+			moved++)
+		{
+			int frame = lru->oldest[KERNEL_ACTIVE];
+
+			lru->accessed[frame] = 0;
+			listMove(lru, KERNEL_INACTIVE, frame);
+			lru->kernel.deactivations++;
+		}
+
+		int frame = lru->oldest[KERNEL_INACTIVE];
+
+		if (!lru->accessed[frame])
+		{
+			return frame;
+		}
+
+		lru->accessed[frame] = 0;
+
+		if (lru->referenced[frame])
+		{
+			lru->referenced[frame] = 0;
+			listMove(lru, KERNEL_ACTIVE, frame);
+			lru->kernel.activations++;
+			lru->nonresidentAge++;
+		}
+		else
+		{
+			lru->referenced[frame] = 1;
+			listMove(lru, KERNEL_INACTIVE, frame);
+		}
+	}
+}
+
+/*************************************************************************
+*   @ End of Two-list reclaim                                             *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ MGLRU aging and reclaim                                             *
+*                                                                         *
+*  Generation seq lives in list seq % MGLRU_MAX_GENS. With all four in    *
+*  use, aging first folds the oldest generation into the next one.        *
+ *************************************************************************/
+
+static void mglruAge(KernelLru* lru)
+{
+	if (lru->maxSeq - lru->minSeq + 1 >= MGLRU_MAX_GENS)
+	{
+		int from = (int)(lru->minSeq % MGLRU_MAX_GENS);
+		int to   = (int)((lru->minSeq + 1) % MGLRU_MAX_GENS);
+
+		while (lru->newest[from] != KERNEL_NONE)
+		{
+			int frame = lru->newest[from];
+
+			listUnlink(lru, frame);
+			listPushOldest(lru, to, frame);
+		}
+		lru->minSeq++;
+	}
+
+	lru->maxSeq++;
+	lru->kernel.agings++;
+
+	int youngest = (int)(lru->maxSeq % MGLRU_MAX_GENS);
+
+	for (int frame = 0; frame < lru->usedFrames; frame++)
+	{
+		lru->kernel.walkedPtes++;
+
+		if (lru->accessed[frame])
+		{
+			lru->accessed[frame] = 0;
+			listMove(lru, youngest, frame);
+			lru->kernel.activations++;
+		}
+	}
+}
+
+static int mglruReclaim(KernelLru* lru)
+{
+	for (;;)
+	{
+		if (lru->maxSeq - lru->minSeq + 1 <= MGLRU_MIN_GENS)
+		{
+			mglruAge(lru);
+		}
+
+		int oldest = (int)(lru->minSeq % MGLRU_MAX_GENS);
+		int frame  = lru->oldest[oldest];
+
+		if (frame == KERNEL_NONE)
+		{
+			lru->minSeq++;
+			continue;
+		}
+
+		if (!lru->accessed[frame])
+		{
+			return frame;
+		}
+
+		lru->accessed[frame] = 0;
+		listMove(lru, (int)(lru->maxSeq % MGLRU_MAX_GENS), frame);
+		lru->kernel.activations++;
+	}
+}
+
+/*************************************************************************
+*   @ End of MGLRU aging and reclaim                                      *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Access                                                              *
+*                                                                         *
+ *************************************************************************/
+
+int kernelLruAccess(KernelLru* lru, const PageRef* ref, AccessResult* result)
+{
+	unsigned long long value;
+	unsigned long long token;
+	int                frame;
+	int                list;
+
+	result->fault       = 0;
+	result->evicted     = 0;
+	result->victimPage  = 0;
+	result->victimDirty = 0;
+
+	lru->stats.references++;
+
+	if ((lru->mode == KERNEL_MGLRU) & (lru->scanRefs != 0) && (++lru->sinceScan >= lru->scanRefs))
+	{
+		lru->sinceScan = 0;
+		mglruAge(lru);
+	}
+
+	if (pageIndexFind(&lru->frames, ref->page, &value))
+	{
+		frame                = (int)value;
+		result->frame        = frame;
+		lru->accessed[frame] = 1;
+		lru->dirty[frame]   |= ref->access == ACCESS_WRITE;
+		return 0;
+	}
+
+	result->fault = 1;
+	lru->stats.faults++;
+
+	if (lru->usedFrames < lru->framesNum)
+	{
+		frame = lru->usedFrames++;
+	}
+	else
+	{
+		frame = lru->mode == KERNEL_TWO_LIST ? twoListReclaim(lru) : mglruReclaim(lru);
+
+		result->evicted     = 1;
+		result->victimPage  = lru->framePage[frame];
+		result->victimDirty = lru->dirty[frame];
+		lru->stats.evictions++;
+		lru->stats.writebacks += lru->dirty[frame];
+
+		listUnlink(lru, frame);
+		pageIndexRemove(&lru->frames, result->victimPage);
+
+		if (pageIndexSet(&lru->shadows, result->victimPage,
+			lru->mode == KERNEL_TWO_LIST ? lru->nonresidentAge++ : lru->maxSeq) != 0)
+		{
+			return -1;
+		}
+		if (lru->shadows.count > lru->shadowLimit)
+		{
+			kernelPruneShadows(lru);
+		}
+	}
+
+	/* Where the page starts: the workingset test of its shadow, else as a new page. */
+
+	int refault = pageIndexFind(&lru->shadows, ref->page, &token);
+
+	if (refault)
+	{
+		pageIndexRemove(&lru->shadows, ref->page);
+		lru->kernel.refaults++;
+	}
+
+	if (lru->mode == KERNEL_TWO_LIST)
+	{
+		list = KERNEL_INACTIVE;
+
+		if (refault && (lru->nonresidentAge - token <= (unsigned long long)lru->sizes[KERNEL_ACTIVE]))
+		{
+			list = KERNEL_ACTIVE;
+			lru->nonresidentAge++;
+		}
+	}
+	else if (refault && (lru->maxSeq - token < MGLRU_MAX_GENS))
+	{
+		list = (int)(lru->maxSeq % MGLRU_MAX_GENS);
+	}
+	else if (refault)
+	{
+		list = (int)((lru->minSeq + (lru->minSeq + MGLRU_MIN_GENS < lru->maxSeq)) % MGLRU_MAX_GENS);
+	}
+	else
+	{
+		list = (int)((lru->maxSeq - 1) % MGLRU_MAX_GENS);
+	}
+
+	if (refault && (list == (lru->mode == KERNEL_TWO_LIST ? KERNEL_ACTIVE : (int)(lru->maxSeq % MGLRU_MAX_GENS))))
+	{
+		lru->kernel.refaultActivations++;
+		lru->kernel.activations++;
+	}
+
+	if (pageIndexSet(&lru->frames, ref->page, (unsigned long long)frame) != 0)
+	{
+		return -1;
+	}
+
+	lru->framePage[frame]  = ref->page;
+	lru->accessed[frame]   = 1;
+	lru->referenced[frame] = 0;
+	lru->dirty[frame]      = ref->access == ACCESS_WRITE;
+	result->frame          = frame;
+	listPushNewest(lru, list, frame);
+
+	return 1;
+}
+
+/*************************************************************************
+*   @ End of Access                                                       *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Kernel command                                                      *
+*                                                                         *
+*  Exact LRU and CLOCK next to the two kernel engines, for each of the    *
+*  frame counts.                                                          *
+ *************************************************************************/
+
+int runKernelCommand(int argCount, char* args[])
+{
+	TraceBuffer  buffer;
+	PagingEngine engines[2];
+	KernelLru    kernels[2];
+	AccessResult result;
+	int          points[KERNEL_MAX_POINTS];
+	int          pointsNum = 0;
+	long long    scanRefs  = argCount > 4 ? atoll(args[4]) : -1;
+	int          format    = argCount > 3 ? traceFormatFromName(args[1]) : TRACE_FORMAT_UNKNOWN;
+	int          status    = 0;
+
+	for (char* frames = argCount > 3 ? args[3] : (char*)""; (*frames != '\0') & (pointsNum < KERNEL_MAX_POINTS);)
+	{
+		long framesNum = strtol(frames, &frames, 10);
+
+		if (framesNum < 1)
+		{
+			pointsNum = 0;
+			break;
+		}
+		points[pointsNum++] = (int)framesNum;
+
+		if (*frames == ',')
+		{
+			frames++;
+		}
+	}
+
+	if ((format == TRACE_FORMAT_UNKNOWN) | (pointsNum == 0) | (scanRefs < -1))
+	{
+		printf("Usage: %s\n", KERNEL_USAGE);
+		return -1;
+	}
+
+	traceBufferInit(&buffer);
+
+	if (loadTrace(args[2], format, 0, traceBufferSink, &buffer) != 0)
+	{
+		traceBufferFree(&buffer);
+		return -1;
+	}
+
+	printf("\n Trace %s: %llu references, MGLRU page table walk every ", args[2], (unsigned long long)buffer.count);
+
+	if (scanRefs < 0)
+	{
+		printf("frames references\n\n");
+	}
+	else if (scanRefs == 0)
+	{
+		printf("time reclaim runs out of generations\n\n");
+	}
+	else
+	{
+		printf("%lld references\n\n", scanRefs);
+	}
+
+	printf(" ---------------------------------------------------------------------------------------------------------------------\n");
+	printf("|  Frames  |     LRU      |    CLOCK     |   Two-list   | Refaults  | Activated |    MGLRU     | Refaults  |  Walks   |\n");
+	printf(" ---------------------------------------------------------------------------------------------------------------------\n");
+
+	for (int p = 0; (p < pointsNum) & (status == 0); p++)
+	{
+		unsigned long long walk = scanRefs < 0 ? (unsigned long long)points[p] : (unsigned long long)scanRefs;
+
+		memset(engines, 0, sizeof(engines));
+		memset(kernels, 0, sizeof(kernels));
+
+		if ((engineCreate(&engines[0], POLICY_LRU, points[p]) != 0) |
+			(engineCreate(&engines[1], POLICY_CLOCK, points[p]) != 0) |
+			(kernelLruCreate(&kernels[0], KERNEL_TWO_LIST, points[p], 0) != 0) |
+			(kernelLruCreate(&kernels[1], KERNEL_MGLRU, points[p], walk) != 0))
+		{
+			printf("Not enough memory for %d frames!\n", points[p]);
+			status = -1;
+		}
+
+		for (size_t i = 0; (i < buffer.count) & (status == 0); i++)
+		{
+			engineAccess(&engines[0], &buffer.refs[i], &result);
+			engineAccess(&engines[1], &buffer.refs[i], &result);
+
+			if ((kernelLruAccess(&kernels[0], &buffer.refs[i], &result) < 0) |
+				(kernelLruAccess(&kernels[1], &buffer.refs[i], &result) < 0))
+			{
+				printf("Not enough memory for the shadow entries!\n");
+				status = -1;
+			}
+		}
+
+		if (status == 0)
+		{
+			printf("| %8d | %12llu | %12llu | %12llu | %9llu | %9llu | %12llu | %9llu | %8llu |\n", points[p],
+				engines[0].stats.faults, engines[1].stats.faults, kernels[0].stats.faults, kernels[0].kernel.refaults,
+				kernels[0].kernel.refaultActivations, kernels[1].stats.faults, kernels[1].kernel.refaults,
+				kernels[1].kernel.agings);
+		}
+
+		for (int e = 0; e < 2; e++)
+		{
+			engineDestroy(&engines[e]);
+			kernelLruDestroy(&kernels[e]);
+		}
+	}
+
+	if (status == 0)
+	{
+		printf(" ---------------------------------------------------------------------------------------------------------------------\n");
+		printf(" Refaults found a shadow entry; activated ones went straight to the active list.\n");
+	}
+
+	traceBufferFree(&buffer);
+
+	return status;
+}
+
+/*************************************************************************
+*   @ End of Kernel command                                               *
+*                                                                         *
+ *************************************************************************/
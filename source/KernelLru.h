@@ -0,0 +1,82 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: Engines modelling Linux page reclaim instead of textbook LRU. The two-list
+ * engine keeps active and inactive lists, gives referenced pages a second trip around the
+ * inactive list, and uses shadow entries of evicted pages to activate refaults whose
+ * refault distance fits in the active list. The multi-generational engine (MGLRU) keeps
+ * up to four generations; references only set the accessed bit, periodic page table walks
+ * move accessed pages to a new youngest generation, and reclaim evicts the oldest one.
+ * Both report through the AccessResult and EngineStats of the paging engines.
+*/
+
+
+#ifndef KERNEL_LRU_H
+#define KERNEL_LRU_H
+
+#include "PagingEngine.h"
+
+#define KERNEL_USAGE         "kernel <lackey|pin|csv|bin> <file> <frames[,frames...]> [scanRefs]"
+#define KERNEL_MAX_POINTS    16
+#define KERNEL_TWO_LIST      0
+#define KERNEL_MGLRU         1
+#define KERNEL_INACTIVE      0       /* two-list list numbers */
+#define KERNEL_ACTIVE        1
+#define KERNEL_DEACTIVATE    32      /* active pages moved per shrink, SWAP_CLUSTER_MAX */
+#define KERNEL_SHADOW_FACTOR 2       /* shadows kept per frame before stale ones are pruned */
+#define MGLRU_MAX_GENS       4       /* MAX_NR_GENS */
+#define MGLRU_MIN_GENS       2       /* MIN_NR_GENS, the youngest ones are never evicted */
+
+
+struct KernelStats
+{
+	unsigned long long refaults;            /* faults on pages with a shadow entry */
+	unsigned long long refaultActivations;  /* refaults placed straight in the working set */
+	unsigned long long activations;         /* to the active list or the youngest generation */
+	unsigned long long deactivations;       /* two-list: active pages moved to the inactive list */
+	unsigned long long agings;              /* MGLRU: generations created */
+	unsigned long long walkedPtes;          /* MGLRU: page table entries scanned by agings */
+};
+
+/* Lists are doubly linked through older/newer; list[frame] is the list number, the
+ * inactive or active list, or the generation's sequence modulo MGLRU_MAX_GENS. */
+
+struct KernelLru
+{
+	int                 mode;
+	int                 framesNum;
+	int                 usedFrames;
+	unsigned long long* framePage;
+	unsigned char*      accessed;       /* page table accessed bit */
+	unsigned char*      referenced;     /* two-list: PG_referenced */
+	unsigned char*      dirty;
+	unsigned char*      list;
+	int*                older;
+	int*                newer;
+	int                 newest[MGLRU_MAX_GENS];
+	int                 oldest[MGLRU_MAX_GENS];
+	int                 sizes[MGLRU_MAX_GENS];
+	unsigned long long  minSeq;         /* MGLRU: oldest generation */
+	unsigned long long  maxSeq;         /* MGLRU: youngest generation */
+	unsigned long long  scanRefs;       /* MGLRU: references between page table walks, 0: on demand */
+	unsigned long long  sinceScan;
+	unsigned long long  nonresidentAge; /* two-list: evictions and activations so far */
+	PageIndex           frames;         /* resident page -> frame */
+	PageIndex           shadows;        /* evicted page -> nonresidentAge, or maxSeq for MGLRU */
+	size_t              shadowLimit;    /* shadow count that triggers pruning */
+	unsigned long long* stale;          /* framesNum shadows being pruned */
+	EngineStats         stats;
+	KernelStats         kernel;
+};
+
+const char* kernelModeName(int mode);
+
+int  kernelLruCreate(KernelLru* lru, int mode, int framesNum, unsigned long long scanRefs);
+void kernelLruDestroy(KernelLru* lru);
+
+/* Returns 1 on a page fault, like engineAccess, and -1 when a shadow entry does not fit. */
+
+int  kernelLruAccess(KernelLru* lru, const PageRef* ref, AccessResult* result);
+
+int  runKernelCommand(int argCount, char* args[]);
+
+#endif // !KERNEL_LRU_H
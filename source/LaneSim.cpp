@@ -0,0 +1,606 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: LaneSim.cpp contains the lane kernel and the exhaustive and random batch runs.
+ *
+ * Kernel: state is kept per lane in byte arrays indexed [frame][lane] (resident page and
+ * a policy key: last use for LRU, use count for LFU, next use for OPT). A step finds the
+ * hit frame and the best victim of every lane with compare and select loops over the
+ * frames, then writes the loaded frame back the same way; there are no per-lane branches
+ * and no gathers, so the lane loops vectorize at whatever width the target offers.
+ * Replacement is the engines' own: frames fill in order, the FIFO hand starts at frame 0,
+ * LFU counts are never reset and ties in LFU and OPT go to the lower frame.
+ *
+ * Exhaustive runs: only canonical strings (pages first used in the order 0, 1, 2, ...) are
+ * simulated, each counted pages * (pages - 1) * ... once per distinct page it uses; the
+ * canonical prefixes of LANES_PREFIX_LENGTH references are the work items of the threads.
+*/
+
+
+
+#include "LaneSim.h"
+#include "PagingEngine.h"
+#include "PageIndex.h"
+#include "TraceParser.h"
+#include <string.h>
+#include <stdio.h>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+
+
+/* LANES_NUM strings of one length; refs[t][lane] is reference t of a lane's string. */
+
+struct LaneBatch
+{
+	unsigned char      refs[LANES_MAX_LENGTH][LANES_NUM];
+	unsigned long long weight[LANES_NUM];
+	int                filled;
+};
+
+struct LaneJob
+{
+	int                             policies[POLICY_COUNT];
+	int                             policiesNum;
+	int                             pages;
+	int                             length;
+	int                             framesNum;
+	unsigned long long              samples;           /* 0: exhaustive */
+	unsigned long long              seed;
+	unsigned long long              weights[LANES_MAX_PAGES + 1];  /* by distinct pages */
+	unsigned char*                  prefixes;
+	int                             prefixLength;
+	size_t                          prefixesNum;
+	std::atomic<size_t>             next;
+	std::atomic<unsigned long long> simulated;
+	std::mutex                      lock;
+	unsigned long long              strings[POLICY_COUNT][LANES_MAX_LENGTH + 1];  /* by fault count */
+};
+
+
+static void laneSimulate(int policy, int framesNum, int pages, int length,
+	const unsigned char refs[][LANES_NUM], unsigned char faults[LANES_NUM]);
+static void flushBatch(const LaneJob* job, LaneBatch* batch, unsigned long long strings[][LANES_MAX_LENGTH + 1]);
+static void addString(const LaneJob* job, LaneBatch* batch, unsigned long long strings[][LANES_MAX_LENGTH + 1],
+	const unsigned char* refs, unsigned long long weight);
+static void mergeStrings(LaneJob* job, unsigned long long strings[][LANES_MAX_LENGTH + 1]);
+static void listPrefixes(LaneJob* job, unsigned char* prefix, int depth, int distinct);
+static int  nextSuffix(const LaneJob* job, unsigned char* refs, unsigned char* distinct);
+static void exhaustiveWorker(LaneJob* job);
+static void randomWorker(LaneJob* job);
+
+
+/*************************************************************************
+*   @ Lane kernel                                                         *
+*                                                                         *
+*  Every loop over lanes is branch free; the policy and frame loops sit   *
+*  outside them.                                                          *
+ *************************************************************************/
+
+static void laneSimulate(int policy, int framesNum, int pages, int length,
+	const unsigned char refs[][LANES_NUM], unsigned char faults[LANES_NUM])
+{
+	unsigned char page[LANES_MAX_FRAMES][LANES_NUM];
+	unsigned char key[LANES_MAX_FRAMES][LANES_NUM];
+	unsigned char count[LANES_MAX_PAGES][LANES_NUM];       /* LFU use counts, OPT next uses */
+	unsigned char nextUse[LANES_MAX_LENGTH][LANES_NUM];
+	unsigned char used[LANES_NUM];
+	unsigned char hand[LANES_NUM];
+	unsigned char target[LANES_NUM];
+	unsigned char best[LANES_NUM];
+	unsigned char bestKey[LANES_NUM];
+	unsigned char newKey[LANES_NUM];
+
+	memset(page, LANES_NONE, sizeof(page));
+	memset(key, 0, sizeof(key));
+	memset(used, 0, sizeof(used));
+	memset(hand, 0, sizeof(hand));
+	memset(faults, 0, LANES_NUM);
+
+	/* OPT: position of the next reference to the same page, LANES_NONE when there is none. */
+
+	if (policy == POLICY_OPT)
+	{
+		memset(count, LANES_NONE, sizeof(count));
+
+		for (int t = length - 1; t >= 0; t--)
+		{
+			for (int v = 0; v < pages; v++)
+			{
+				for (int l = 0; l < LANES_NUM; l++)
+				{
+					unsigned char match = refs[t][l] == v;
+
+					nextUse[t][l] = match ? count[v][l] : nextUse[t][l];
+					count[v][l]   = match ? (unsigned char)t : count[v][l];
+				}
+			}
+		}
+	}
+	memset(count, 0, sizeof(count));
+
+	for (int t = 0; t < length; t++)
+	{
+		const unsigned char* ref = refs[t];
+
+		/* Hit frame, or LANES_NONE on a fault. */
+
+		memset(target, LANES_NONE, sizeof(target));
+
+		for (int j = 0; j < framesNum; j++)
+		{
+			for (int l = 0; l < LANES_NUM; l++)
+			{
+				target[l] = page[j][l] == ref[l] ? (unsigned char)j : target[l];
+			}
+		}
+
+		/* Victim once the frames are full: the hand, or the lowest (OPT: highest) key. */
+
+		if (policy == POLICY_FIFO)
+		{
+			memcpy(best, hand, sizeof(best));
+		}
+		else
+		{
+			memset(best, 0, sizeof(best));
+			memcpy(bestKey, key[0], sizeof(bestKey));
+
+			for (int j = 1; j < framesNum; j++)
+			{
+				if (policy == POLICY_OPT)
+				{
+					for (int l = 0; l < LANES_NUM; l++)
+					{
+						unsigned char take = key[j][l] > bestKey[l];
+
+						best[l]    = take ? (unsigned char)j : best[l];
+						bestKey[l] = take ? key[j][l] : bestKey[l];
+					}
+				}
+				else
+				{
+					for (int l = 0; l < LANES_NUM; l++)
+					{
+						unsigned char take = key[j][l] < bestKey[l];
+
+						best[l]    = take ? (unsigned char)j : best[l];
+						bestKey[l] = take ? key[j][l] : bestKey[l];
+					}
+				}
+			}
+		}
+
+		for (int l = 0; l < LANES_NUM; l++)
+		{
+			unsigned char miss  = target[l] == LANES_NONE;
+			unsigned char fill  = used[l] < framesNum;
+			unsigned char load  = fill ? used[l] : best[l];
+			unsigned char step  = hand[l] + 1 == framesNum ? 0 : (unsigned char)(hand[l] + 1);
+			unsigned char evict = miss & (fill ^ 1);
+
+			target[l]  = miss ? load : target[l];
+			hand[l]    = evict ? step : hand[l];
+			used[l]   += miss & fill;
+			faults[l] += miss;
+		}
+
+		/* Key of the referenced frame. */
+
+		if (policy == POLICY_LFU)
+		{
+			memset(newKey, 0, sizeof(newKey));
+
+			for (int v = 0; v < pages; v++)
+			{
+				for (int l = 0; l < LANES_NUM; l++)
+				{
+					unsigned char match = ref[l] == v;
+
+					count[v][l] += match;
+					newKey[l]    = match ? count[v][l] : newKey[l];
+				}
+			}
+		}
+		else if (policy == POLICY_OPT)
+		{
+			memcpy(newKey, nextUse[t], sizeof(newKey));
+		}
+		else
+		{
+			memset(newKey, t + 1, sizeof(newKey));
+		}
+
+		for (int j = 0; j < framesNum; j++)
+		{
+			for (int l = 0; l < LANES_NUM; l++)
+			{
+				unsigned char chosen = target[l] == j;
+				unsigned char loaded = ref[l];
+				unsigned char keyed  = newKey[l];
+
+				page[j][l] = chosen ? loaded : page[j][l];
+				key[j][l]  = chosen ? keyed : key[j][l];
+			}
+		}
+	}
+}
+
+/*************************************************************************
+*   @ End of Lane kernel                                                  *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Batches                                                             *
+*                                                                         *
+ *************************************************************************/
+
+static void flushBatch(const LaneJob* job, LaneBatch* batch, unsigned long long strings[][LANES_MAX_LENGTH + 1])
+{
+	unsigned char faults[LANES_NUM];
+
+	for (int p = 0; p < job->policiesNum; p++)
+	{
+		laneSimulate(job->policies[p], job->framesNum, job->pages, job->length, batch->refs, faults);
+
+		for (int l = 0; l < batch->filled; l++)
+		{
+			strings[p][faults[l]] += batch->weight[l];
+		}
+	}
+
+	batch->filled = 0;
+}
+
+static inline void addString(const LaneJob* job, LaneBatch* batch, unsigned long long strings[][LANES_MAX_LENGTH + 1],
+	const unsigned char* refs, unsigned long long weight)
+{
+	for (int t = 0; t < job->length; t++)
+	{
+		batch->refs[t][batch->filled] = refs[t];
+	}
+	batch->weight[batch->filled++] = weight;
+
+	if (batch->filled == LANES_NUM)
+	{
+		flushBatch(job, batch, strings);
+	}
+}
+
+static void mergeStrings(LaneJob* job, unsigned long long strings[][LANES_MAX_LENGTH + 1])
+{
+	std::lock_guard<std::mutex> guard(job->lock);
+
+	for (int p = 0; p < job->policiesNum; p++)
+	{
+		for (int f = 0; f <= job->length; f++)
+		{
+			job->strings[p][f] += strings[p][f];
+		}
+	}
+}
+
+/*************************************************************************
+*   @ End of Batches                                                      *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Exhaustive and random runs                                          *
+*                                                                         *
+ *************************************************************************/
+
+/* Appends the canonical prefixes in lexicographic order; with prefixes NULL only counts them. */
+
+static void listPrefixes(LaneJob* job, unsigned char* prefix, int depth, int distinct)
+{
+	if (depth == job->prefixLength)
+	{
+		if (job->prefixes != NULL)
+		{
+			memcpy(job->prefixes + job->prefixesNum * job->prefixLength, prefix, (size_t)depth);
+		}
+		job->prefixesNum++;
+		return;
+	}
+
+	for (int page = 0; page <= (distinct < job->pages ? distinct : job->pages - 1); page++)
+	{
+		prefix[depth] = (unsigned char)page;
+		listPrefixes(job, prefix, depth + 1, distinct + (page == distinct));
+	}
+}
+
+/* Next canonical string with the same prefix; distinct[i] is the pages used before i. */
+
+static int nextSuffix(const LaneJob* job, unsigned char* refs, unsigned char* distinct)
+{
+	for (int i = job->length - 1; i >= job->prefixLength; i--)
+	{
+		if ((refs[i] < distinct[i]) & (refs[i] + 1 < job->pages))
+		{
+			refs[i]++;
+
+			for (int k = i; k < job->length; k++)
+			{
+				refs[k]         = k > i ? 0 : refs[k];
+				distinct[k + 1] = (unsigned char)(distinct[k] + (refs[k] == distinct[k]));
+			}
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+static void exhaustiveWorker(LaneJob* job)
+{
+	LaneBatch*         batch = (LaneBatch*)calloc(1, sizeof(LaneBatch));
+	unsigned long long strings[POLICY_COUNT][LANES_MAX_LENGTH + 1];
+	unsigned char      refs[LANES_MAX_LENGTH];
+	unsigned char      distinct[LANES_MAX_LENGTH + 1];
+	unsigned long long simulated = 0;
+	size_t             item;
+
+	memset(strings, 0, sizeof(strings));
+
+	while ((batch != NULL) && ((item = job->next++) < job->prefixesNum))
+	{
+		memcpy(refs, job->prefixes + item * job->prefixLength, (size_t)job->prefixLength);
+		memset(refs + job->prefixLength, 0, (size_t)(job->length - job->prefixLength));
+		distinct[0] = 0;
+
+		for (int i = 0; i < job->length; i++)
+		{
+			distinct[i + 1] = (unsigned char)(distinct[i] + (refs[i] == distinct[i]));
+		}
+
+		do
+		{
+			addString(job, batch, strings, refs, job->weights[distinct[job->length]]);
+			simulated++;
+		} while (nextSuffix(job, refs, distinct));
+	}
+
+	if (batch != NULL)
+	{
+		flushBatch(job, batch, strings);
+		mergeStrings(job, strings);
+		job->simulated += simulated;
+	}
+	free(batch);
+}
+
+/* Sample i depends on the seed and i alone, as in the Belady search. */
+
+static void randomWorker(LaneJob* job)
+{
+	LaneBatch*         batch = (LaneBatch*)calloc(1, sizeof(LaneBatch));
+	unsigned long long strings[POLICY_COUNT][LANES_MAX_LENGTH + 1];
+	unsigned char      refs[LANES_MAX_LENGTH];
+	unsigned long long simulated = 0;
+	size_t             block;
+
+	memset(strings, 0, sizeof(strings));
+
+	while ((batch != NULL) && ((block = job->next++) * LANES_NUM < job->samples))
+	{
+		for (unsigned long long item = block * LANES_NUM; (item < (block + 1) * LANES_NUM) & (item < job->samples); item++)
+		{
+			unsigned long long state = job->seed ^ pageHash(item + 1);
+
+			for (int i = 0; i < job->length; i++)
+			{
+				state  += 0x9e3779b97f4a7c15ULL;
+				refs[i] = (unsigned char)(pageHash(state) % (unsigned long long)job->pages);
+			}
+
+			addString(job, batch, strings, refs, 1);
+			simulated++;
+		}
+	}
+
+	if (batch != NULL)
+	{
+		flushBatch(job, batch, strings);
+		mergeStrings(job, strings);
+		job->simulated += simulated;
+	}
+	free(batch);
+}
+
+/*************************************************************************
+*   @ End of Exhaustive and random runs                                   *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Lanes command                                                       *
+*                                                                         *
+ *************************************************************************/
+
+static void printDistribution(const LaneJob* job, unsigned long long total)
+{
+	int low  = job->length;
+	int high = 0;
+
+	for (int p = 0; p < job->policiesNum; p++)
+	{
+		for (int f = 0; f <= job->length; f++)
+		{
+			if (job->strings[p][f] != 0)
+			{
+				low  = f < low ? f : low;
+				high = f > high ? f : high;
+			}
+		}
+	}
+
+	printf(" ");
+	for (int i = 0; i < 8 + 18 * job->policiesNum; i++)
+	{
+		printf("-");
+	}
+	printf("\n| Faults ");
+	for (int p = 0; p < job->policiesNum; p++)
+	{
+		printf("| %15s ", policyName(job->policies[p]));
+	}
+	printf("|\n ");
+	for (int i = 0; i < 8 + 18 * job->policiesNum; i++)
+	{
+		printf("-");
+	}
+	printf("\n");
+
+	for (int f = low; f <= high; f++)
+	{
+		printf("| %6d ", f);
+		for (int p = 0; p < job->policiesNum; p++)
+		{
+			printf("| %15llu ", job->strings[p][f]);
+		}
+		printf("|\n");
+	}
+
+	printf(" ");
+	for (int i = 0; i < 8 + 18 * job->policiesNum; i++)
+	{
+		printf("-");
+	}
+	printf("\n| Mean   ");
+	for (int p = 0; p < job->policiesNum; p++)
+	{
+		double sum = 0.0;
+
+		for (int f = 0; f <= job->length; f++)
+		{
+			sum += (double)f * (double)job->strings[p][f];
+		}
+		printf("| %15.4f ", total > 0 ? sum / (double)total : 0.0);
+	}
+	printf("|\n ");
+	for (int i = 0; i < 8 + 18 * job->policiesNum; i++)
+	{
+		printf("-");
+	}
+	printf("\n");
+}
+
+int runLanesCommand(int argCount, char* args[])
+{
+	LaneJob            job;
+	std::thread        workers[TRACE_MAX_THREADS];
+	unsigned char      prefix[LANES_MAX_LENGTH];
+	unsigned long long total = 1;
+
+	if (argCount < 5)
+	{
+		printf("Usage: %s\n", LANES_USAGE);
+		return -1;
+	}
+
+	job.policiesNum = 0;
+	job.pages       = atoi(args[2]);
+	job.length      = atoi(args[3]);
+	job.framesNum   = atoi(args[4]);
+	job.samples     = argCount > 6 ? strtoull(args[6], NULL, 10) : 0;
+	job.seed        = argCount > 7 ? strtoull(args[7], NULL, 10) : 1;
+	job.prefixes    = NULL;
+	job.prefixesNum = 0;
+	job.next        = 0;
+	job.simulated   = 0;
+	memset(job.strings, 0, sizeof(job.strings));
+
+	int threads = argCount > 5 ? atoi(args[5]) : 0;
+	int policy  = policyFromName(args[1]);
+
+	for (int p = 0; p < POLICY_COUNT; p++)
+	{
+		if ((p != POLICY_CLOCK) & ((p == policy) | (strcmp(args[1], "all") == 0)))
+		{
+			job.policies[job.policiesNum++] = p;
+		}
+	}
+
+	if (threads <= 0)
+	{
+		threads = (int)std::thread::hardware_concurrency();
+	}
+	threads = threads < 1 ? 1 : threads > TRACE_MAX_THREADS ? TRACE_MAX_THREADS : threads;
+
+	if ((job.policiesNum == 0) | (job.pages < 1) | (job.pages > LANES_MAX_PAGES) | (job.length < 1) |
+		(job.length > LANES_MAX_LENGTH) | (job.framesNum < 1) | (job.framesNum > LANES_MAX_FRAMES))
+	{
+		printf("Usage: %s\n", LANES_USAGE);
+		return -1;
+	}
+
+	/* Every string of the length, or the samples, each counted once. */
+
+	for (int i = 0; (i < job.length) & (job.samples == 0); i++)
+	{
+		if (total > ~0ULL / (unsigned long long)job.pages)
+		{
+			printf("%d^%d strings are too many to count, give a number of samples!\n", job.pages, job.length);
+			return -1;
+		}
+		total *= (unsigned long long)job.pages;
+	}
+	total = job.samples > 0 ? job.samples : total;
+
+	job.weights[0] = 1;
+
+	for (int d = 1; d <= job.pages; d++)
+	{
+		job.weights[d] = job.weights[d - 1] * (unsigned long long)(job.pages - d + 1);
+	}
+
+	if (job.samples == 0)
+	{
+		job.prefixLength = job.length < LANES_PREFIX_LENGTH ? job.length : LANES_PREFIX_LENGTH;
+		listPrefixes(&job, prefix, 0, 0);
+		job.prefixes     = (unsigned char*)malloc(job.prefixesNum * job.prefixLength);
+
+		if (job.prefixes == NULL)
+		{
+			return -1;
+		}
+		job.prefixesNum = 0;
+		listPrefixes(&job, prefix, 0, 0);
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for (int t = 1; t < threads; t++)
+	{
+		workers[t] = std::thread(job.samples > 0 ? randomWorker : exhaustiveWorker, &job);
+	}
+	(job.samples > 0 ? randomWorker : exhaustiveWorker)(&job);
+
+	for (int t = 1; t < threads; t++)
+	{
+		workers[t].join();
+	}
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	free(job.prefixes);
+
+	printf("\n Lanes: %d references over %d pages, %d frames, %s %llu strings, %d lanes, %d threads\n",
+		job.length, job.pages, job.framesNum, job.samples > 0 ? "random" : "all", total, LANES_NUM, threads);
+	printf(" Simulated %llu strings in %.2f s\n\n", (unsigned long long)job.simulated, seconds);
+
+	printDistribution(&job, total);
+
+	return 0;
+}
+
+/*************************************************************************
+*   @ End of Lanes command                                                *
+*                                                                         *
+ *************************************************************************/
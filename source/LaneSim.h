@@ -0,0 +1,26 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: Fault distributions over very many short reference strings. LANES_NUM strings
+ * are simulated at once, one per lane, by a FIFO / LRU / LFU / OPT kernel that keeps every
+ * piece of state as a [frame][lane] array of bytes, so each step is a handful of loops
+ * over lanes that the compiler turns into vector instructions. Strings are either all
+ * strings of a length (pages renamed in order of first use are simulated once and
+ * counted with their multiplicity) or random samples.
+*/
+
+
+#ifndef LANE_SIM_H
+#define LANE_SIM_H
+
+#define LANES_USAGE         "lanes <fifo|lru|lfu|opt|all> <pages> <length> <frames> [threads] [samples] [seed]"
+#define LANES_NUM           64
+#define LANES_MAX_PAGES     16
+#define LANES_MAX_FRAMES    8
+#define LANES_MAX_LENGTH    32
+#define LANES_PREFIX_LENGTH 6
+#define LANES_NONE          0xFF
+
+
+int runLanesCommand(int argCount, char* args[]);
+
+#endif // !LANE_SIM_H
@@ -8,10 +8,13 @@
 
 #include "MemoryManager.h"
 #include <time.h>
+#include <limits.h>
+#include <string.h>
+#include <chrono>
+#include <thread>
+#include "KernelLru.h"
 
-#define FRAMES_MEMORY_WIDTH 30
-#define REF_STRING_MAX_LEN  30
-#define MAX_PHYSICAL_FRAMES 8
+#define REF_STRING_START_LEN 30
 
 
 /* Menu functions. */
@@ -20,6 +23,9 @@ static void simulateFIFO(int physicalFramesNum);
 static void simulateOPT(int  physicalFramesNum);
 static void simulateLRU(int  physicalFramesNum);
 static void simulateLFU(int  physicalFramesNum);
+static void simulateKernel(int physicalFramesNum, int mode);
+static void clearScreen();
+static void stepDelay(int milliseconds);
 static void printFrames(int  physicalFramesNum);
 static void DisplayCurrentReferenceString();
 static void GenerateReferenceString();
@@ -30,14 +36,27 @@ static void initPhysicalFrames();
 static void initRefString();
 static void printVictims();
 static void printFaults();
+static void printLine();
+static int  reserveRefString(int length);
 
 
-/* Reference string  and physical frames. */
+/* Reference string and physical frames, sized at run time. Every buffer holds refCapacity
+ * steps (the string and its -1 terminator); physicalFrames has one row per frame. */
 
-static int faults[FRAMES_MEMORY_WIDTH];
-static int victims[FRAMES_MEMORY_WIDTH];
-static int reference_string[REF_STRING_MAX_LEN];
-static int physicalFrames[MAX_PHYSICAL_FRAMES * FRAMES_MEMORY_WIDTH];
+static int*    faults;
+static int*    victims;
+static int*    reference_string;
+static int*    physicalFrames;
+static int     refCapacity;
+static int     refLength;
+static int     physicalFramesCount;
+
+
+/* Per frame scratch state of the simulations. */
+
+static int*    tmpFramesBuffer;
+static int*    nextCallBuffer;
+static time_t* timesBuffer;
 
 
 /* Simulation menu. */
@@ -47,7 +66,21 @@ void startMenu(int physicalFramesNum)
 	char option = -1;
 	char nop;
 
-	initRefString();
+	physicalFramesCount = physicalFramesNum;
+	tmpFramesBuffer     = (int*)malloc(physicalFramesNum * sizeof(int));
+	nextCallBuffer      = (int*)malloc(physicalFramesNum * sizeof(int));
+	timesBuffer         = (time_t*)malloc(physicalFramesNum * sizeof(time_t));
+
+	if ((tmpFramesBuffer == NULL) | (nextCallBuffer == NULL) | (timesBuffer == NULL) ||
+		(reserveRefString(REF_STRING_START_LEN) != 0))
+	{
+		printf("Not enough memory for %d physical frames!\n", physicalFramesNum);
+		option = '0';
+	}
+	else
+	{
+		initRefString();
+	}
 	srand((int)time(0));
 
 	while (option != '0')
@@ -59,19 +92,21 @@ void startMenu(int physicalFramesNum)
 		printf(" 4 - Simulate FIFO\n");
 		printf(" 5 - Simulate OPT\n");
 		printf(" 6 - Simulate LRU\n");
-		printf(" 7 - Simulate LFU\n\n");
+		printf(" 7 - Simulate LFU\n");
+		printf(" 8 - Simulate Linux active/inactive lists\n");
+		printf(" 9 - Simulate Linux MGLRU\n\n");
 		printf(" 0 - Exit simulation\n\n");
 		
 		nop = scanf("%c", &option);
 		fseek(stdin, 0, SEEK_END);
 
-		while ((option < '0') | (option > '7'))
+		while ((option < '0') | (option > '9'))
 		{
 			printf("'%c' is invalid option, try again!\n\n", option);
 			nop = scanf("%c", &option);
 			fseek(stdin, 0, SEEK_END);
 		}
-		system("cls");
+		clearScreen();
 
 		switch (option)
 		{
@@ -96,10 +131,24 @@ void startMenu(int physicalFramesNum)
 		case '7':
 			simulateLFU(physicalFramesNum);
 			break;
+		case '8':
+			simulateKernel(physicalFramesNum, KERNEL_TWO_LIST);
+			break;
+		case '9':
+			simulateKernel(physicalFramesNum, KERNEL_MGLRU);
+			break;
 		case '0':
 			printf("Exiting program!\n\n");
 		}
 	}
+
+	free(faults);
+	free(victims);
+	free(reference_string);
+	free(physicalFrames);
+	free(tmpFramesBuffer);
+	free(nextCallBuffer);
+	free(timesBuffer);
 }
 
 
@@ -133,16 +182,17 @@ static void ReadReferenceString()
 		}
 		else if ((page != 's') & (page != 'S'))
 		{
+			if (reserveRefString(i + 1) != 0)
+			{
+				printf("\n\nNot enough memory for a longer reference string!\n");
+				break;
+			}
+
 			reference_string[i] = (int)page - 48;
 			i++;
+			refLength = i;
 			printf(" %c - ACCEPTED!", page);
 		}
-
-		if (i == REF_STRING_MAX_LEN)
-		{
-			printf("\n\nReference string max length reached!\n");
-			break;
-		}
 	}
 
 	if (i > 0)
@@ -157,7 +207,7 @@ static void ReadReferenceString()
 	printf(" Press any key to continue ...");
 	nop = getchar();
 	fseek(stdin, 0, SEEK_END);
-	system("cls");
+	clearScreen();
 }
 
 /*************************************************************************
@@ -182,13 +232,13 @@ static void GenerateReferenceString()
 	char nop;
 
 	initRefString();
-	printf("Enter length for random reference string (30 or less):\n");
+	printf("Enter length for random reference string:\n");
 
-	while ((length < 0) | (length > REF_STRING_MAX_LEN))
+	while (length < 0)
 	{
 		nop = scanf("%d", &length);
 
-		if ((length < 0) | (length > REF_STRING_MAX_LEN))
+		if (length < 0)
 		{
 			printf(" Not valid lenght. Try again!\n");
 		}
@@ -199,6 +249,10 @@ static void GenerateReferenceString()
 	{
 		printf("\nReference string not saved!\n\n");
 	}
+	else if (reserveRefString(length) != 0)
+	{
+		printf("\nNot enough memory for %d references, reference string not saved!\n\n", length);
+	}
 	else
 	{
 		for (i = 0; i < length; i++)
@@ -207,13 +261,14 @@ static void GenerateReferenceString()
 		}
 
 		reference_string[length] = -1;
+		refLength                = length;
 		printf("\nReference string saved!\n\n");
 	}
 
 	printf(" Press any key to continue ...");
 	nop = getchar();
 	fseek(stdin, 0, SEEK_END);
-	system("cls");
+	clearScreen();
 }
 
 /*************************************************************************
@@ -243,7 +298,7 @@ static void DisplayCurrentReferenceString()
 	else
 	{
 		printf(" [ ");
-		while ((reference_string[i] != -1) & (i < FRAMES_MEMORY_WIDTH))
+		while ((reference_string[i] != -1) & (i < refLength))
 		{
 			printf("%d ", reference_string[i]);
 			i++;
@@ -255,7 +310,7 @@ static void DisplayCurrentReferenceString()
 	printf("\nPress any key to continue ...");
 	nop = getchar();
 	fseek(stdin, 0, SEEK_END);
-	system("cls");
+	clearScreen();
 }
 
 /*************************************************************************
@@ -278,7 +333,7 @@ static void simulateFIFO(int physicalFramesNum)
 {
 	if (reference_string[0] != -1)
 	{
-		int tmpFrames[MAX_PHYSICAL_FRAMES];
+		int* tmpFrames    = tmpFramesBuffer;
 		int FirstPosition = 0;
 		int cntFaults     = 0;
 		int i             = 0;
@@ -289,12 +344,12 @@ static void simulateFIFO(int physicalFramesNum)
 		initPhysicalFrames();
 		initVictimsAndFaults();
 
-		for (int j = 0; j < MAX_PHYSICAL_FRAMES; j++)
+		for (int j = 0; j < physicalFramesNum; j++)
 		{
 			tmpFrames[j] = -1;
 		}
 
-		system("cls");
+		clearScreen();
 		printf("\n\t##########  Simulating FIFO  ##########\n\n");
 
 		printReferenceString();
@@ -306,7 +361,7 @@ static void simulateFIFO(int physicalFramesNum)
 		char nop = getchar();
 		fseek(stdin, 0, SEEK_END);
 
-		while (reference_string[i] != -1 & (i < FRAMES_MEMORY_WIDTH))
+		while (reference_string[i] != -1 & (i < refLength))
 		{
 			int foundEmpty  = 0;
 			int victimFrame =-1;
@@ -349,13 +404,13 @@ static void simulateFIFO(int physicalFramesNum)
 
 			for (int j = 0; j < physicalFramesNum; j++)
 			{
-				physicalFrames[j * FRAMES_MEMORY_WIDTH + i] = tmpFrames[j];
+				physicalFrames[j * refCapacity + i] = tmpFrames[j];
 			}
 
 			victims[i] = victimFrame;
 			faults [i] = cntFaults;
 
-			system("cls");
+			clearScreen();
 			printf("\n\t##########  Simulating FIFO  ##########\n\n");
 
 			printReferenceString();
@@ -365,7 +420,7 @@ static void simulateFIFO(int physicalFramesNum)
 
 			i++;
 
-			if ((reference_string[i] == -1) | (i == FRAMES_MEMORY_WIDTH))
+			if ((reference_string[i] == -1) | (i == refLength))
 			{
 				break;
 			}
@@ -383,7 +438,7 @@ static void simulateFIFO(int physicalFramesNum)
 	printf("\nPress any key to continue ...");
 	char nop = getchar();
 	fseek(stdin, 0, SEEK_END);
-	system("cls");
+	clearScreen();
 }
 
 /*************************************************************************
@@ -407,8 +462,8 @@ static void simulateOPT(int physicalFramesNum)
 
 	if (reference_string[0] != -1)
 	{
-		int tmpFrames [MAX_PHYSICAL_FRAMES];
-		int nextCallIn[MAX_PHYSICAL_FRAMES];
+		int* tmpFrames  = tmpFramesBuffer;
+		int* nextCallIn = nextCallBuffer;
 		int cntFaults = 0;
 		int i         = 0;
 
@@ -418,13 +473,13 @@ static void simulateOPT(int physicalFramesNum)
 		initPhysicalFrames();
 		initVictimsAndFaults();
 
-		for (int j = 0; j < MAX_PHYSICAL_FRAMES; j++)
+		for (int j = 0; j < physicalFramesNum; j++)
 		{
 			tmpFrames [j] = -1;
 			nextCallIn[j] = -1;
 		}
 
-		system("cls");
+		clearScreen();
 		printf("\n\t##########  Simulating OPT  ##########\n\n");
 
 		printReferenceString();
@@ -435,7 +490,7 @@ static void simulateOPT(int physicalFramesNum)
 		printf("\nPress ENTER to start!");
 		nop = getchar();
 		fseek(stdin, 0, SEEK_END);
-		system("cls");
+		clearScreen();
 
 		while (reference_string[i] != -1)
 		{
@@ -512,13 +567,13 @@ static void simulateOPT(int physicalFramesNum)
 
 			for (int j = 0; j < physicalFramesNum; j++)
 			{
-				physicalFrames[j * FRAMES_MEMORY_WIDTH + i] = tmpFrames[j];
+				physicalFrames[j * refCapacity + i] = tmpFrames[j];
 			}
 
 			victims[i] = victimFrame;
 			faults[i]  = cntFaults;
 
-			system("cls");
+			clearScreen();
 			printf("\n\t##########  Simulating OPT  ##########\n\n");
 
 			printReferenceString();
@@ -533,7 +588,7 @@ static void simulateOPT(int physicalFramesNum)
 
 			i++;
 
-			if ((reference_string[i] == -1) | (i == FRAMES_MEMORY_WIDTH))
+			if ((reference_string[i] == -1) | (i == refLength))
 			{
 				break;
 			}
@@ -551,7 +606,7 @@ static void simulateOPT(int physicalFramesNum)
 	printf("\nPress any key to continue ...");
 	nop = getchar();
 	fseek(stdin, 0, SEEK_END);
-	system("cls");
+	clearScreen();
 }
 
 /*************************************************************************
@@ -575,8 +630,8 @@ static void simulateLRU(int const physicalFramesNum)
 
 	if (reference_string[0] != -1)
 	{
-		int tmpFrames[FRAMES_MEMORY_WIDTH];
-		time_t Times[MAX_PHYSICAL_FRAMES];
+		int* tmpFrames = tmpFramesBuffer;
+		time_t* Times  = timesBuffer;
 		int cntFaults = 0;
 		int i         = 0;
 	
@@ -586,13 +641,13 @@ static void simulateLRU(int const physicalFramesNum)
 		initPhysicalFrames();
 		initVictimsAndFaults();
 
-		for (int j = 0; j < MAX_PHYSICAL_FRAMES; j++)
+		for (int j = 0; j < physicalFramesNum; j++)
 		{
 			tmpFrames[j] = -1;
 			Times[j]     = (time_t)0;
 		}
 
-		system("cls");
+		clearScreen();
 		printf("\n\t##########  Simulating LRU  ##########\n\n");
 
 		printReferenceString();
@@ -603,7 +658,7 @@ static void simulateLRU(int const physicalFramesNum)
 		printf("\nPress ENTER to start!");
 		nop = getchar();
 		fseek(stdin, 0, SEEK_END);
-		system("cls");
+		clearScreen();
 
 		while (reference_string[i] != -1)
 		{
@@ -669,13 +724,13 @@ static void simulateLRU(int const physicalFramesNum)
 
 			for (int j = 0; j < physicalFramesNum; j++)
 			{
-				physicalFrames[j * FRAMES_MEMORY_WIDTH + i] = tmpFrames[j];
+				physicalFrames[j * refCapacity + i] = tmpFrames[j];
 			}
 
 			victims[i] = victimFrame;
 			faults[i]  = cntFaults;
 
-			system("cls");
+			clearScreen();
 			printf("\n\t##########  Simulating LRU  ##########\n\n");
 
 			printReferenceString();
@@ -688,9 +743,9 @@ static void simulateLRU(int const physicalFramesNum)
 			/*Test Data End*/
 
 			i++;
-			Sleep(100);
+			stepDelay(100);
 
-			if ((reference_string[i] == -1) | (i == FRAMES_MEMORY_WIDTH))
+			if ((reference_string[i] == -1) | (i == refLength))
 			{
 				break;
 			}
@@ -709,7 +764,7 @@ static void simulateLRU(int const physicalFramesNum)
 	printf("\nPress any key to continue ...");
 	nop = getchar();
 	fseek(stdin, 0, SEEK_END);
-	system("cls");
+	clearScreen();
 }
 
 /*************************************************************************
@@ -733,7 +788,7 @@ static void simulateLFU(int physicalFramesNum)
 
 	if (reference_string[0] != -1)
 	{
-		int tmpFrames[MAX_PHYSICAL_FRAMES];
+		int* tmpFrames    = tmpFramesBuffer;
 		int usageFreq[10] = {0};
 		int cntFaults = 0;
 		int i         = 0;
@@ -743,12 +798,12 @@ static void simulateLFU(int physicalFramesNum)
 		initPhysicalFrames();
 		initVictimsAndFaults();
 
-		for (int s = 0; s < MAX_PHYSICAL_FRAMES; s++)
+		for (int s = 0; s < physicalFramesNum; s++)
 		{
 			tmpFrames[s] = -1;
 		}
 
-		system("cls");
+		clearScreen();
 		printf("\n\t##########  Simulating LFU  ##########\n\n");
 
 		printReferenceString();
@@ -759,7 +814,7 @@ static void simulateLFU(int physicalFramesNum)
 		printf("\nPress ENTER to start!");
 		nop = getchar();
 		fseek(stdin, 0, SEEK_END);
-		system("cls");
+		clearScreen();
 
 		while (reference_string[i] != -1)
 		{
@@ -815,13 +870,13 @@ static void simulateLFU(int physicalFramesNum)
 
 			for (int j = 0; j < physicalFramesNum; j++)
 			{
-				physicalFrames[j * FRAMES_MEMORY_WIDTH + i] = tmpFrames[j];
+				physicalFrames[j * refCapacity + i] = tmpFrames[j];
 			}
 
 			victims[i] = victimFrame;
 			faults[i]  = cntFaults;
 
-			system("cls");
+			clearScreen();
 			printf("\n\t##########  Simulating LFU  ##########\n\n");
 
 			printReferenceString();
@@ -837,7 +892,7 @@ static void simulateLFU(int physicalFramesNum)
 
 			i++;
 
-			if ((reference_string[i] == -1) | (i == FRAMES_MEMORY_WIDTH))
+			if ((reference_string[i] == -1) | (i == refLength))
 			{
 				break;
 			}
@@ -856,7 +911,7 @@ static void simulateLFU(int physicalFramesNum)
 	printf("\nPress any key to continue ...");
 	nop = getchar();
 	fseek(stdin, 0, SEEK_END);
-	system("cls");
+	clearScreen();
 }
 
 /*************************************************************************
@@ -865,6 +920,145 @@ static void simulateLFU(int physicalFramesNum)
  *************************************************************************/
 
 
+/*************************************************************************
+*   @ 8 / 9 – Simulate Linux two-list and MGLRU reclaim                   *
+*																		  *
+*  Will simulate the step by step execution of the Linux active/inactive  *
+*  lists (option 8) or of the multi-generational LRU (option 9) using the *
+*  stored reference string, through the KernelLru engines. Every step is  *
+*  displayed like the LRU simulation. MGLRU walks the page tables every   *
+*  physicalFramesNum references.                                          *
+ *************************************************************************/
+
+static void simulateKernel(int physicalFramesNum, int mode)
+{
+	char nop;
+
+	if (reference_string[0] != -1)
+	{
+		KernelLru    lru;
+		PageRef      ref;
+		AccessResult result;
+		int          i = 0;
+
+		if (kernelLruCreate(&lru, mode, physicalFramesNum, (unsigned long long)physicalFramesNum) != 0)
+		{
+			printf("\nNot enough memory for %d physical frames!\n\n", physicalFramesNum);
+			printf("\nPress any key to continue ...");
+			nop = getchar();
+			fseek(stdin, 0, SEEK_END);
+			clearScreen();
+			return;
+		}
+
+		/* Initializing physical frames */
+
+		initPhysicalFrames();
+		initVictimsAndFaults();
+		memset(&ref, 0, sizeof(ref));
+
+		clearScreen();
+		printf("\n\t##########  Simulating %s  ##########\n\n", kernelModeName(mode));
+
+		printReferenceString();
+		printFrames(physicalFramesNum);
+		printVictims();
+		printFaults();
+
+		printf("\nPress ENTER to start!");
+		nop = getchar();
+		fseek(stdin, 0, SEEK_END);
+		clearScreen();
+
+		while (reference_string[i] != -1)
+		{
+			ref.page   = (unsigned long long)reference_string[i];
+			ref.time   = (unsigned long long)i;
+			ref.access = ACCESS_READ;
+
+			if (kernelLruAccess(&lru, &ref, &result) < 0)
+			{
+				printf("\nNot enough memory for the shadow entries!\n");
+				break;
+			}
+
+			for (int j = 0; j < physicalFramesNum; j++)
+			{
+				physicalFrames[j * refCapacity + i] = j < lru.usedFrames ? (int)lru.framePage[j] : -1;
+			}
+
+			victims[i] = result.evicted ? (int)result.victimPage : -1;
+			faults[i]  = (int)lru.stats.faults;
+
+			clearScreen();
+			printf("\n\t##########  Simulating %s  ##########\n\n", kernelModeName(mode));
+
+			printReferenceString();
+			printFrames(physicalFramesNum);
+			printVictims();
+			printFaults();
+
+			i++;
+			stepDelay(100);
+
+			if ((reference_string[i] == -1) | (i == refLength))
+			{
+				break;
+			}
+
+			printf("\nPress ENTER for next step ...");
+			nop = getchar();
+			fseek(stdin, 0, SEEK_END);
+		}
+		printf("\nEnd of reference string!\n");
+
+		kernelLruDestroy(&lru);
+	}
+	else
+	{
+		printf("\nNo reference string available!\n\n");
+	}
+
+	printf("\nPress any key to continue ...");
+	nop = getchar();
+	fseek(stdin, 0, SEEK_END);
+	clearScreen();
+}
+
+/*************************************************************************
+*   @ End of Simulate Linux reclaim                                       *
+*																		  *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Portable screen clear and step delay                                *
+*																		  *
+*  Every menu simulation clears and paces its steps through these, so     *
+*  the menu builds and runs on Windows and POSIX alike.                   *
+ *************************************************************************/
+
+static void clearScreen()
+{
+#ifdef _WIN32
+	system("cls");
+#else
+	printf("\033[2J\033[H");
+	fflush(stdout);
+#endif
+}
+
+static void stepDelay(int milliseconds)
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+}
+
+/*************************************************************************
+*   @ End of Portable screen clear and step delay                         *
+*																		  *
+ *************************************************************************/
+
+
 /*************************************************************************
 *   @ Set all physical frames fields to -1                                *
 *																		  *
@@ -872,11 +1066,11 @@ static void simulateLFU(int physicalFramesNum)
 
 static void initPhysicalFrames()
 {
-	for (int i = 0; i < 8; i++)
+	for (int i = 0; i < physicalFramesCount; i++)
 	{
-		for (int j = 0; j < FRAMES_MEMORY_WIDTH; j++)
+		for (int j = 0; j < refCapacity; j++)
 		{
-			physicalFrames[i * FRAMES_MEMORY_WIDTH + j] = -1;
+			physicalFrames[i * refCapacity + j] = -1;
 		}
 	}
 }
@@ -896,10 +1090,10 @@ static void printReferenceString()
 {
 	int i = 0;
 
-	printf(" ----------------------------------------------------------------------------------------------------------");
+	printLine();
 	printf("\n|Reference_string|");
 
-	for (int i = 0; i < FRAMES_MEMORY_WIDTH; i++)
+	for (int i = 0; i < refLength; i++)
 	{
 		if (reference_string[i] != -1)
 		{
@@ -929,17 +1123,24 @@ static void printFrames(int physicalFramesNum)
 	int i = 0;
 	int j = 0;
 
-	printf(" ----------------------------------------------------------------------------------------------------------");
+	printLine();
 
 	for (i = 0; i < physicalFramesNum; i++)
 	{
-		printf("\n|Physical_Frame_%d|", i);
+		if (i < 10)
+		{
+			printf("\n|Physical_Frame_%d|", i);
+		}
+		else
+		{
+			printf("\n|Frame_%-10d|", i);
+		}
 
-		for (j = 0; j < FRAMES_MEMORY_WIDTH; j++)
+		for (j = 0; j < refLength; j++)
 		{
-			if (physicalFrames[i * FRAMES_MEMORY_WIDTH + j] != -1)
+			if (physicalFrames[i * refCapacity + j] != -1)
 			{
-				printf("%2d|", physicalFrames[i * FRAMES_MEMORY_WIDTH + j]);
+				printf("%2d|", physicalFrames[i * refCapacity + j]);
 			}
 			else
 			{
@@ -947,7 +1148,9 @@ static void printFrames(int physicalFramesNum)
 			}
 		}
 	}
-	printf("\n ----------------------------------------------------------------------------------------------------------\n");
+	printf("\n");
+	printLine();
+	printf("\n");
 }
 
 /*************************************************************************
@@ -963,10 +1166,11 @@ static void printFrames(int physicalFramesNum)
 
 static void initRefString()
 {
-	for (int i = 0; i < FRAMES_MEMORY_WIDTH; i++)
+	for (int i = 0; i < refCapacity; i++)
 	{
 		reference_string[i] = -1;
 	}
+	refLength = 0;
 }
 
 /*************************************************************************
@@ -982,7 +1186,7 @@ static void initRefString()
 
 static void initVictimsAndFaults()
 {
-	for (int i = 0; i < FRAMES_MEMORY_WIDTH; i++)
+	for (int i = 0; i < refCapacity; i++)
 	{
 		victims[i] = -1;
 		faults[i]  = -1;
@@ -1003,7 +1207,7 @@ static void initVictimsAndFaults()
 static void printFaults()
 {
 	printf("|    Faults      |");
-	for (int i = 0; i < FRAMES_MEMORY_WIDTH; i++)
+	for (int i = 0; i < refLength; i++)
 	{
 		if (faults[i] != -1)
 		{
@@ -1014,7 +1218,9 @@ static void printFaults()
 			printf("  |");
 		}
 	}
-	printf("\n ----------------------------------------------------------------------------------------------------------\n");
+	printf("\n");
+	printLine();
+	printf("\n");
 }
 
 /*************************************************************************
@@ -1031,7 +1237,7 @@ static void printFaults()
 static void printVictims()
 {
 	printf("| Victim_frames  |");
-	for (int i = 0; i < FRAMES_MEMORY_WIDTH; i++)
+	for (int i = 0; i < refLength; i++)
 	{
 		if (victims[i] != -1)
 		{
@@ -1042,10 +1248,106 @@ static void printVictims()
 			printf("  |");
 		}
 	}
-	printf("\n ----------------------------------------------------------------------------------------------------------\n");
+	printf("\n");
+	printLine();
+	printf("\n");
 }
 
 /*************************************************************************
 *   @ End of printVictims()                                               *
+*																		  *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Prints a table rule as wide as the reference string                 *
+*																		  *
+ *************************************************************************/
+
+static void printLine()
+{
+	printf(" ");
+
+	for (int i = 0; i < 16 + 3 * refLength; i++)
+	{
+		printf("-");
+	}
+}
+
+/*************************************************************************
+*   @ End of printLine()                                                  *
+*																		  *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Grows the step buffers to hold length references                    *
+*																		  *
+*  Keeps the reference string, fills the new steps with -1 and returns    *
+*  -1 when memory runs out, leaving the old buffers in place: all four    *
+*  buffers are allocated first and swapped in only when all succeeded.    *
+*  The frame table starts empty, every simulation fills it again.         *
+ *************************************************************************/
+
+static int reserveRefString(int length)
+{
+	int capacity = refCapacity > 0 ? refCapacity : REF_STRING_START_LEN + 1;
+
+	if ((length < 0) | (length >= INT_MAX))
+	{
+		return -1;
+	}
+
+	if (length + 1 <= refCapacity)
+	{
+		return 0;
+	}
+
+	while (capacity < length + 1)
+	{
+		capacity = capacity > INT_MAX / 2 ? length + 1 : capacity * 2;
+	}
+
+	int* frames     = (int*)malloc((size_t)physicalFramesCount * capacity * sizeof(int));
+	int* newFaults  = (int*)malloc((size_t)capacity * sizeof(int));
+	int* newVictims = (int*)malloc((size_t)capacity * sizeof(int));
+	int* newString  = (int*)malloc((size_t)capacity * sizeof(int));
+
+	if ((frames == NULL) | (newFaults == NULL) | (newVictims == NULL) | (newString == NULL))
+	{
+		free(frames);
+		free(newFaults);
+		free(newVictims);
+		free(newString);
+		return -1;
+	}
+
+	for (int i = 0; i < capacity; i++)
+	{
+		newFaults[i]  = i < refCapacity ? faults[i] : -1;
+		newVictims[i] = i < refCapacity ? victims[i] : -1;
+		newString[i]  = i < refCapacity ? reference_string[i] : -1;
+	}
+
+	for (size_t i = 0; i < (size_t)physicalFramesCount * capacity; i++)
+	{
+		frames[i] = -1;
+	}
+
+	free(physicalFrames);
+	free(faults);
+	free(victims);
+	free(reference_string);
+	physicalFrames   = frames;
+	faults           = newFaults;
+	victims          = newVictims;
+	reference_string = newString;
+	refCapacity      = capacity;
+
+	return 0;
+}
+
+/*************************************************************************
+*   @ End of reserveRefString()                                           *
 *																		  *
  *************************************************************************/
\ No newline at end of file
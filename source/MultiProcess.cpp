@@ -0,0 +1,520 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: MultiProcess.cpp contains the multi-process simulation. Each trace file is one
+ * process; a single trace file is split into processes by the pid of its references.
+ *
+ * The processes are first interleaved into one schedule (round robin with a quantum of
+ * references, or merged by timestamp). Global replacement runs that schedule through one
+ * engine whose pages are keyed by process; local replacement gives every process its own
+ * engine with an equal share of the frames.
+*/
+
+
+
+#include "MultiProcess.h"
+#include "TraceParser.h"
+#include "PagingEngine.h"
+#include <string.h>
+
+#define SCHEDULE_TIME -1
+
+
+struct Process
+{
+	TraceBuffer        refs;
+	unsigned int       pid;
+	EngineStats        stats;
+	unsigned long long stolen;     /* frames taken from it by other processes */
+	unsigned long long resident;
+};
+
+struct ProcessSet
+{
+	Process* procs;
+	int      procsNum;
+	int      splitByPid;
+	int      lastProcess;
+};
+
+
+static int  loadProcesses(ProcessSet* set, int format, char* files[], int filesNum);
+static int  scheduleRoundRobin(const ProcessSet* set, size_t quantum, TraceBuffer* schedule);
+static int  scheduleByTime(const ProcessSet* set, TraceBuffer* schedule);
+static int  simulateGlobal(ProcessSet* set, const TraceBuffer* schedule, int policy, int framesNum);
+static int  simulateLocal(ProcessSet* set, int policy, int framesNum);
+
+
+/*************************************************************************
+*   @ Load processes                                                      *
+*                                                                         *
+*  Traces are loaded into memory because both schedulers need to pull     *
+*  references from several processes in an order the files do not have.   *
+ *************************************************************************/
+
+static int processSink(void* context, const PageRef* refs, size_t count)
+{
+	ProcessSet* set = (ProcessSet*)context;
+
+	if (!set->splitByPid)
+	{
+		return traceBufferAppend(&set->procs[set->procsNum - 1].refs, refs, count);
+	}
+
+	for (size_t i = 0; i < count; i++)
+	{
+		int p = set->lastProcess;
+
+		if ((p >= set->procsNum) || (set->procs[p].pid != refs[i].pid))
+		{
+			p = 0;
+
+			while ((p < set->procsNum) && (set->procs[p].pid != refs[i].pid))
+			{
+				p++;
+			}
+		}
+		set->lastProcess = p;
+
+		if (p == set->procsNum)
+		{
+			if (p == MULTI_MAX_PROCESSES)
+			{
+				return -1;
+			}
+			memset(&set->procs[p], 0, sizeof(Process));
+			traceBufferInit(&set->procs[p].refs);
+			set->procs[p].pid = refs[i].pid;
+			set->procsNum++;
+		}
+
+		if (traceBufferAppend(&set->procs[p].refs, &refs[i], 1) != 0)
+		{
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int loadProcesses(ProcessSet* set, int format, char* files[], int filesNum)
+{
+	set->procs      = (Process*)calloc(MULTI_MAX_PROCESSES, sizeof(Process));
+	set->procsNum   = 0;
+	set->splitByPid = filesNum == 1;
+	set->lastProcess = 0;
+
+	if ((set->procs == NULL) | (filesNum > MULTI_MAX_PROCESSES))
+	{
+		return -1;
+	}
+
+	for (int f = 0; f < filesNum; f++)
+	{
+		if (!set->splitByPid)
+		{
+			traceBufferInit(&set->procs[set->procsNum].refs);
+			set->procs[set->procsNum].pid = (unsigned int)f;
+			set->procsNum++;
+		}
+
+		if (loadTrace(files[f], format, 0, processSink, set) != 0)
+		{
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/*************************************************************************
+*   @ End of Load processes                                               *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Schedulers                                                          *
+*                                                                         *
+*  Both produce one reference sequence whose pages are process keys.      *
+*  Round robin runs quantum references of each unfinished process in      *
+*  turn; the time scheduler always picks the earliest pending reference   *
+*  (lowest process on ties).                                              *
+ *************************************************************************/
+
+static int appendKeyed(TraceBuffer* schedule, const PageRef* ref, int process)
+{
+	PageRef keyed = *ref;
+
+	if (ref->page >> MULTI_PAGE_BITS)
+	{
+		printf("Page %#llx does not fit in the %d page bits of a process key!\n", ref->page, MULTI_PAGE_BITS);
+		return -1;
+	}
+
+	keyed.page = MULTI_KEY(process, ref->page);
+
+	return traceBufferAppend(schedule, &keyed, 1);
+}
+
+static int scheduleRoundRobin(const ProcessSet* set, size_t quantum, TraceBuffer* schedule)
+{
+	size_t* next    = (size_t*)calloc(set->procsNum, sizeof(size_t));
+	int     pending = set->procsNum;
+
+	if (next == NULL)
+	{
+		return -1;
+	}
+
+	while (pending > 0)
+	{
+		pending = 0;
+
+		for (int p = 0; p < set->procsNum; p++)
+		{
+			const TraceBuffer* refs = &set->procs[p].refs;
+
+			for (size_t q = 0; (q < quantum) & (next[p] < refs->count); q++)
+			{
+				if (appendKeyed(schedule, &refs->refs[next[p]++], p) != 0)
+				{
+					free(next);
+					return -1;
+				}
+			}
+
+			pending += next[p] < refs->count;
+		}
+	}
+
+	free(next);
+
+	return 0;
+}
+
+static int headBefore(const ProcessSet* set, const size_t* next, int a, int b)
+{
+	unsigned long long timeA = set->procs[a].refs.refs[next[a]].time;
+	unsigned long long timeB = set->procs[b].refs.refs[next[b]].time;
+
+	return timeA != timeB ? timeA < timeB : a < b;
+}
+
+static int scheduleByTime(const ProcessSet* set, TraceBuffer* schedule)
+{
+	size_t* next  = (size_t*)calloc(set->procsNum, sizeof(size_t));
+	int*    heap  = (int*)malloc(set->procsNum * sizeof(int));
+	int     heads = 0;
+
+	if ((next == NULL) | (heap == NULL))
+	{
+		free(next);
+		free(heap);
+		return -1;
+	}
+
+	/* Min-heap of processes keyed by the time of their next reference. */
+
+	for (int p = 0; p < set->procsNum; p++)
+	{
+		if (set->procs[p].refs.count > 0)
+		{
+			int slot = heads++;
+
+			while ((slot > 0) && headBefore(set, next, p, heap[(slot - 1) / 2]))
+			{
+				heap[slot] = heap[(slot - 1) / 2];
+				slot = (slot - 1) / 2;
+			}
+			heap[slot] = p;
+		}
+	}
+
+	while (heads > 0)
+	{
+		int p = heap[0];
+
+		if (appendKeyed(schedule, &set->procs[p].refs.refs[next[p]++], p) != 0)
+		{
+			free(next);
+			free(heap);
+			return -1;
+		}
+
+		if (next[p] == set->procs[p].refs.count)
+		{
+			p = heap[--heads];
+		}
+
+		for (int slot = 0;;)
+		{
+			int child = slot * 2 + 1;
+
+			if ((child + 1 < heads) && headBefore(set, next, heap[child + 1], heap[child]))
+			{
+				child++;
+			}
+			if ((child >= heads) || !headBefore(set, next, heap[child], p))
+			{
+				if (heads > 0)
+				{
+					heap[slot] = p;
+				}
+				break;
+			}
+			heap[slot] = heap[child];
+			slot = child;
+		}
+	}
+
+	free(next);
+	free(heap);
+
+	return 0;
+}
+
+/*************************************************************************
+*   @ End of Schedulers                                                   *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Global replacement                                                  *
+*                                                                         *
+*  One engine over all frames; a victim may belong to any process. A      *
+*  fault that evicts another process's page counts as a stolen frame      *
+*  for the owner of the victim.                                           *
+ *************************************************************************/
+
+static int simulateGlobal(ProcessSet* set, const TraceBuffer* schedule, int policy, int framesNum)
+{
+	PagingEngine        engine;
+	AccessResult        result;
+	unsigned long long* nextUse = NULL;
+
+	if (engineCreate(&engine, policy, framesNum) != 0)
+	{
+		return -1;
+	}
+
+	if (policy == POLICY_OPT)
+	{
+		nextUse = (unsigned long long*)malloc((schedule->count + 1) * sizeof(unsigned long long));
+
+		if ((nextUse == NULL) || (computeNextUse(schedule->refs, schedule->count, nextUse) != 0))
+		{
+			free(nextUse);
+			engineDestroy(&engine);
+			return -1;
+		}
+		engineSetFuture(&engine, nextUse);
+	}
+
+	for (size_t i = 0; i < schedule->count; i++)
+	{
+		int      process = MULTI_KEY_PROCESS(schedule->refs[i].page);
+		Process* owner   = &set->procs[process];
+
+		engineAccess(&engine, &schedule->refs[i], &result);
+		owner->stats.references++;
+
+		if (result.fault)
+		{
+			owner->stats.faults++;
+			owner->resident++;
+		}
+
+		if (result.evicted)
+		{
+			Process* victim = &set->procs[MULTI_KEY_PROCESS(result.victimPage)];
+
+			victim->stats.evictions++;
+			victim->resident--;
+
+			if (victim != owner)
+			{
+				victim->stolen++;
+			}
+		}
+	}
+
+	engineDestroy(&engine);
+	free(nextUse);
+
+	return 0;
+}
+
+/*************************************************************************
+*   @ End of Global replacement                                           *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Local replacement                                                   *
+*                                                                         *
+*  Each process only replaces within its own equal share of the frames,   *
+*  so the interleaving does not change its faults and every process is    *
+*  simulated on its own reference sequence.                               *
+ *************************************************************************/
+
+static int simulateLocal(ProcessSet* set, int policy, int framesNum)
+{
+	for (int p = 0; p < set->procsNum; p++)
+	{
+		PagingEngine        engine;
+		AccessResult        result;
+		Process*            proc    = &set->procs[p];
+		unsigned long long* nextUse = NULL;
+		int                 share   = framesNum / set->procsNum + (p < framesNum % set->procsNum);
+
+		if (share < 1)
+		{
+			printf("%d frames cannot be shared by %d processes!\n", framesNum, set->procsNum);
+			return -1;
+		}
+
+		if (engineCreate(&engine, policy, share) != 0)
+		{
+			return -1;
+		}
+
+		if (policy == POLICY_OPT)
+		{
+			nextUse = (unsigned long long*)malloc((proc->refs.count + 1) * sizeof(unsigned long long));
+
+			if ((nextUse == NULL) || (computeNextUse(proc->refs.refs, proc->refs.count, nextUse) != 0))
+			{
+				free(nextUse);
+				engineDestroy(&engine);
+				return -1;
+			}
+			engineSetFuture(&engine, nextUse);
+		}
+
+		for (size_t i = 0; i < proc->refs.count; i++)
+		{
+			engineAccess(&engine, &proc->refs.refs[i], &result);
+		}
+
+		proc->stats    = engine.stats;
+		proc->resident = (unsigned long long)engine.usedFrames;
+
+		engineDestroy(&engine);
+		free(nextUse);
+	}
+
+	return 0;
+}
+
+/*************************************************************************
+*   @ End of Local replacement                                            *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Multi command                                                       *
+*                                                                         *
+ *************************************************************************/
+
+int runMultiCommand(int argCount, char* args[])
+{
+	ProcessSet  set;
+	TraceBuffer schedule;
+	long        quantum = SCHEDULE_TIME;
+	int         status  = 0;
+
+	if (argCount < 7)
+	{
+		printf("Usage: %s\n", MULTI_USAGE);
+		return -1;
+	}
+
+	int global    = strcmp(args[1], "global") == 0;
+	int framesNum = atoi(args[2]);
+	int policy    = policyFromName(args[4]);
+	int format    = traceFormatFromName(args[5]);
+
+	if (strncmp(args[3], "rr:", 3) == 0)
+	{
+		quantum = atol(args[3] + 3);
+	}
+	else if (strcmp(args[3], "time") != 0)
+	{
+		quantum = 0;
+	}
+
+	if ((!global & (strcmp(args[1], "local") != 0)) | (framesNum < 1) | (quantum == 0) |
+		(policy < 0) | (format == TRACE_FORMAT_UNKNOWN))
+	{
+		printf("Usage: %s\n", MULTI_USAGE);
+		return -1;
+	}
+
+	traceBufferInit(&schedule);
+
+	if (loadProcesses(&set, format, args + 6, argCount - 6) != 0)
+	{
+		printf("Cannot load process traces!\n");
+		status = -1;
+	}
+	else if (global)
+	{
+		status = quantum == SCHEDULE_TIME ? scheduleByTime(&set, &schedule) :
+			scheduleRoundRobin(&set, (size_t)quantum, &schedule);
+
+		if (status == 0)
+		{
+			status = simulateGlobal(&set, &schedule, policy, framesNum);
+		}
+	}
+	else
+	{
+		status = simulateLocal(&set, policy, framesNum);
+	}
+
+	if (status == 0)
+	{
+		EngineStats total;
+
+		memset(&total, 0, sizeof(total));
+
+		printf("\n %s %s replacement, %d frames, %d processes\n\n", policyName(policy),
+			global ? "global" : "local", framesNum, set.procsNum);
+		printf(" ---------------------------------------------------------------------------\n");
+		printf("| Process |   References   |     Faults     | Rate  |   Stolen   | Resident |\n");
+		printf(" ---------------------------------------------------------------------------\n");
+
+		for (int p = 0; p < set.procsNum; p++)
+		{
+			Process* proc = &set.procs[p];
+
+			printf("| %7u | %14llu | %14llu |%5.1f%% | %10llu | %8llu |\n", proc->pid,
+				proc->stats.references, proc->stats.faults,
+				proc->stats.references ? 100.0 * (double)proc->stats.faults / (double)proc->stats.references : 0.0,
+				proc->stolen, proc->resident);
+
+			total.references += proc->stats.references;
+			total.faults     += proc->stats.faults;
+		}
+		printf(" ---------------------------------------------------------------------------\n");
+		printf("|  Total  | %14llu | %14llu |%5.1f%% |\n", total.references, total.faults,
+			total.references ? 100.0 * (double)total.faults / (double)total.references : 0.0);
+	}
+
+	for (int p = 0; p < set.procsNum; p++)
+	{
+		traceBufferFree(&set.procs[p].refs);
+	}
+	free(set.procs);
+	traceBufferFree(&schedule);
+
+	return status;
+}
+
+/*************************************************************************
+*   @ End of Multi command                                                *
+*                                                                         *
+ *************************************************************************/
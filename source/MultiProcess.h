@@ -0,0 +1,26 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: Several processes, each with its own trace and page table, interleaved by a
+ * scheduler and sharing one pool of physical frames under global or local replacement.
+*/
+
+
+#ifndef MULTI_PROCESS_H
+#define MULTI_PROCESS_H
+
+#include "Trace.h"
+
+#define MULTI_USAGE          "multi <global|local> <frames> <rr:quantum|time> <policy> <format> <trace> [trace...]"
+#define MULTI_MAX_PROCESSES  256
+#define MULTI_PAGE_BITS      48
+
+
+/* Page key of a process page in a shared (global) engine; the schedulers reject wider pages. */
+
+#define MULTI_KEY(process, page) (((unsigned long long)(process) << MULTI_PAGE_BITS) | (page))
+#define MULTI_KEY_PROCESS(key)   ((int)((key) >> MULTI_PAGE_BITS))
+
+
+int runMultiCommand(int argCount, char* args[]);
+
+#endif // !MULTI_PROCESS_H
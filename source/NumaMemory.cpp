@@ -0,0 +1,469 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: NumaMemory.cpp contains the NUMA simulation and the numa command.
+ *
+ * Threads are the pid streams of the trace; the n-th thread to appear runs on node
+ * n % nodes. Each node replaces its own pages in LRU order. A fault places the page on
+ * the node chosen by the policy, falls back to the next node with a free frame like the
+ * kernel's zone fallback, and only reclaims on the chosen node when every node is full.
+ *
+ * AutoNUMA is modelled by its scanner: every scanRefs references all pages are marked,
+ * and the first reference to a marked page is a NUMA hinting fault. A page whose last two
+ * hinting faults came from the same remote node is migrated there: into a free frame when
+ * the node has one, otherwise by exchanging it with the node's LRU page, which moves to the
+ * cold end of the page's old node. Both pages of an exchange count as migrations.
+*/
+
+
+
+#include "NumaMemory.h"
+#include "PageIndex.h"
+#include "TraceParser.h"
+#include <string.h>
+
+
+struct NumaStats
+{
+	unsigned long long references;
+	unsigned long long faults;
+	unsigned long long remote;
+	unsigned long long hintingFaults;
+	unsigned long long migrations;
+	unsigned long long latencyNs;
+};
+
+struct NumaSim
+{
+	int                 policy;
+	int                 nodesNum;
+	int                 framesPerNode;
+	int                 interleaveNext;
+
+	unsigned long long* framePage;
+	unsigned long long* frameScan;       /* scan epoch of the last hinting fault */
+	unsigned char*      frameLastNode;   /* node of the last hinting fault */
+	int*                older;
+	int*                newer;
+	int                 mru[NUMA_MAX_NODES];
+	int                 lru[NUMA_MAX_NODES];
+	int*                freeFrames;      /* per node stack, framesPerNode entries each */
+	int                 freeNum[NUMA_MAX_NODES];
+	PageIndex           pages;           /* resident page -> frame */
+
+	NumaStats           stats;
+};
+
+struct NumaRun
+{
+	NumaSim             sims[NUMA_POLICY_COUNT];
+	PageIndex           threads;         /* pid -> thread number */
+	unsigned long long  threadsNum;
+	unsigned long long  scanRefs;
+	unsigned long long  localNs;
+	unsigned long long  remoteNs;
+};
+
+
+static int  numaSimCreate(NumaSim* sim, int policy, int nodesNum, int framesPerNode);
+static void numaSimDestroy(NumaSim* sim);
+static void numaSimAccess(NumaSim* sim, const NumaRun* run, unsigned long long page, int node);
+
+static int  takeFrame(NumaSim* sim, int node);
+static void lruUnlink(NumaSim* sim, int frame);
+static void lruPushMru(NumaSim* sim, int frame);
+static void lruPushLru(NumaSim* sim, int frame);
+
+static const char* numaPolicyNames[NUMA_POLICY_COUNT] = { "first-touch", "interleave", "autonuma" };
+
+
+/*************************************************************************
+*   @ Create / destroy                                                    *
+*                                                                         *
+*  Frame f belongs to node f / framesPerNode.                             *
+ *************************************************************************/
+
+static int numaSimCreate(NumaSim* sim, int policy, int nodesNum, int framesPerNode)
+{
+	size_t framesNum = (size_t)nodesNum * framesPerNode;
+
+	memset(sim, 0, sizeof(*sim));
+
+	sim->policy        = policy;
+	sim->nodesNum      = nodesNum;
+	sim->framesPerNode = framesPerNode;
+	sim->framePage     = (unsigned long long*)malloc(framesNum * sizeof(unsigned long long));
+	sim->frameScan     = (unsigned long long*)malloc(framesNum * sizeof(unsigned long long));
+	sim->frameLastNode = (unsigned char*)malloc(framesNum);
+	sim->older         = (int*)malloc(framesNum * sizeof(int));
+	sim->newer         = (int*)malloc(framesNum * sizeof(int));
+	sim->freeFrames    = (int*)malloc(framesNum * sizeof(int));
+
+	if ((sim->framePage == NULL) | (sim->frameScan == NULL) | (sim->frameLastNode == NULL) | (sim->older == NULL) |
+		(sim->newer == NULL) | (sim->freeFrames == NULL) | (pageIndexInit(&sim->pages, framesNum) != 0))
+	{
+		numaSimDestroy(sim);
+		return -1;
+	}
+
+	for (int node = 0; node < nodesNum; node++)
+	{
+		sim->mru[node]     = -1;
+		sim->lru[node]     = -1;
+		sim->freeNum[node] = framesPerNode;
+
+		for (int i = 0; i < framesPerNode; i++)
+		{
+			sim->freeFrames[node * framesPerNode + i] = (node + 1) * framesPerNode - 1 - i;
+		}
+	}
+
+	return 0;
+}
+
+static void numaSimDestroy(NumaSim* sim)
+{
+	free(sim->framePage);
+	free(sim->frameScan);
+	free(sim->frameLastNode);
+	free(sim->older);
+	free(sim->newer);
+	free(sim->freeFrames);
+	pageIndexFree(&sim->pages);
+	memset(sim, 0, sizeof(*sim));
+}
+
+/*************************************************************************
+*   @ End of Create / destroy                                             *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Access                                                              *
+*                                                                         *
+*  One reference by a thread running on node: placement on a fault,       *
+*  hinting fault and migration for AutoNUMA, then the latency of the      *
+*  reference from wherever its page ends up.                              *
+ *************************************************************************/
+
+static void numaSimAccess(NumaSim* sim, const NumaRun* run, unsigned long long page, int node)
+{
+	unsigned long long slot;
+	unsigned long long scan = run->scanRefs ? sim->stats.references / run->scanRefs + 1 : 0;
+	int                frame;
+	int                home;
+
+	sim->stats.references++;
+
+	if (pageIndexFind(&sim->pages, page, &slot))
+	{
+		frame = (int)slot;
+		home  = frame / sim->framesPerNode;
+
+		if ((sim->policy == NUMA_AUTONUMA) && (sim->frameScan[frame] != scan))
+		{
+			int target;
+
+			sim->frameScan[frame] = scan;
+			sim->stats.hintingFaults++;
+
+			if ((home != node) && (sim->frameLastNode[frame] == node) &&
+				((sim->freeNum[node] > 0) || (sim->lru[node] != -1)))
+			{
+				lruUnlink(sim, frame);
+
+				if (sim->freeNum[node] > 0)
+				{
+					target = sim->freeFrames[node * sim->framesPerNode + --sim->freeNum[node]];
+					sim->freeFrames[home * sim->framesPerNode + sim->freeNum[home]++] = frame;
+				}
+				else
+				{
+					target = sim->lru[node];
+					lruUnlink(sim, target);
+
+					sim->framePage[frame]     = sim->framePage[target];
+					sim->frameScan[frame]     = sim->frameScan[target];
+					sim->frameLastNode[frame] = sim->frameLastNode[target];
+					lruPushLru(sim, frame);
+					pageIndexSet(&sim->pages, sim->framePage[frame], (unsigned long long)frame);
+					sim->stats.migrations++;
+				}
+
+				sim->framePage[target] = page;
+				sim->frameScan[target] = scan;
+				lruPushMru(sim, target);
+				pageIndexSet(&sim->pages, page, (unsigned long long)target);
+				sim->stats.migrations++;
+
+				frame = target;
+				home  = node;
+			}
+			sim->frameLastNode[frame] = (unsigned char)node;
+		}
+
+		lruUnlink(sim, frame);
+		lruPushMru(sim, frame);
+	}
+	else
+	{
+		int preferred = node;
+
+		if (sim->policy == NUMA_INTERLEAVE)
+		{
+			preferred           = sim->interleaveNext;
+			sim->interleaveNext = (sim->interleaveNext + 1) % sim->nodesNum;
+		}
+
+		frame = takeFrame(sim, preferred);
+		home  = frame / sim->framesPerNode;
+
+		sim->framePage[frame]     = page;
+		sim->frameScan[frame]     = scan;
+		sim->frameLastNode[frame] = (unsigned char)node;
+		lruPushMru(sim, frame);
+		pageIndexSet(&sim->pages, page, (unsigned long long)frame);
+		sim->stats.faults++;
+	}
+
+	if (home != node)
+	{
+		sim->stats.remote++;
+		sim->stats.latencyNs += run->remoteNs;
+	}
+	else
+	{
+		sim->stats.latencyNs += run->localNs;
+	}
+}
+
+/* Free frame on preferred, else on the next node with one, else the LRU frame of preferred. */
+
+static int takeFrame(NumaSim* sim, int preferred)
+{
+	int frame;
+
+	for (int i = 0; i < sim->nodesNum; i++)
+	{
+		int node = (preferred + i) % sim->nodesNum;
+
+		if (sim->freeNum[node] > 0)
+		{
+			return sim->freeFrames[node * sim->framesPerNode + --sim->freeNum[node]];
+		}
+	}
+
+	frame = sim->lru[preferred];
+	lruUnlink(sim, frame);
+	pageIndexRemove(&sim->pages, sim->framePage[frame]);
+
+	return frame;
+}
+
+/*************************************************************************
+*   @ End of Access                                                       *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ LRU lists                                                           *
+*                                                                         *
+*  One list per node, from the most to the least recently used frame.     *
+ *************************************************************************/
+
+static void lruUnlink(NumaSim* sim, int frame)
+{
+	int node  = frame / sim->framesPerNode;
+	int older = sim->older[frame];
+	int newer = sim->newer[frame];
+
+	if (newer != -1)
+	{
+		sim->older[newer] = older;
+	}
+	else
+	{
+		sim->mru[node] = older;
+	}
+
+	if (older != -1)
+	{
+		sim->newer[older] = newer;
+	}
+	else
+	{
+		sim->lru[node] = newer;
+	}
+}
+
+static void lruPushMru(NumaSim* sim, int frame)
+{
+	int node = frame / sim->framesPerNode;
+
+	sim->older[frame] = sim->mru[node];
+	sim->newer[frame] = -1;
+
+	if (sim->mru[node] != -1)
+	{
+		sim->newer[sim->mru[node]] = frame;
+	}
+	else
+	{
+		sim->lru[node] = frame;
+	}
+	sim->mru[node] = frame;
+}
+
+static void lruPushLru(NumaSim* sim, int frame)
+{
+	int node = frame / sim->framesPerNode;
+
+	sim->newer[frame] = sim->lru[node];
+	sim->older[frame] = -1;
+
+	if (sim->lru[node] != -1)
+	{
+		sim->older[sim->lru[node]] = frame;
+	}
+	else
+	{
+		sim->mru[node] = frame;
+	}
+	sim->lru[node] = frame;
+}
+
+/*************************************************************************
+*   @ End of LRU lists                                                    *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Numa command                                                        *
+*                                                                         *
+*  Runs the three placement policies side by side over one pass of the    *
+*  trace. Migration traffic is the number of migrated pages times the     *
+*  page size.                                                             *
+ *************************************************************************/
+
+static int numaRunSink(void* context, const PageRef* refs, size_t count)
+{
+	NumaRun* run = (NumaRun*)context;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		int                 created;
+		unsigned long long* thread = pageIndexSlot(&run->threads, refs[i].pid, &created);
+		int                 node;
+
+		if (thread == NULL)
+		{
+			return -1;
+		}
+
+		if (created)
+		{
+			*thread = run->threadsNum++;
+		}
+		node = (int)(*thread % (unsigned long long)run->sims[0].nodesNum);
+
+		for (int p = 0; p < NUMA_POLICY_COUNT; p++)
+		{
+			numaSimAccess(&run->sims[p], run, refs[i].page, node);
+		}
+	}
+
+	return 0;
+}
+
+int runNumaCommand(int argCount, char* args[])
+{
+	NumaRun run;
+	int     format;
+	int     nodesNum;
+	int     framesPerNode;
+	int     status;
+
+	if (argCount < 5)
+	{
+		printf("Usage: %s\n", NUMA_USAGE);
+		return -1;
+	}
+
+	format        = traceFormatFromName(args[1]);
+	nodesNum      = atoi(args[3]);
+	framesPerNode = atoi(args[4]);
+	run.localNs   = 80;
+	run.remoteNs  = 140;
+	run.scanRefs  = argCount > 6 ? (unsigned long long)atoll(args[6]) : 1000000;
+	run.threadsNum = 0;
+
+	if (argCount > 5)
+	{
+		const char* split = strchr(args[5], ':');
+
+		run.localNs  = (unsigned long long)atoll(args[5]);
+		run.remoteNs = split != NULL ? (unsigned long long)atoll(split + 1) : run.localNs;
+	}
+
+	if ((format == TRACE_FORMAT_UNKNOWN) | (nodesNum < 1) | (nodesNum > NUMA_MAX_NODES) | (framesPerNode < 1) |
+		(run.scanRefs == 0))
+	{
+		printf("Usage: %s\n", NUMA_USAGE);
+		return -1;
+	}
+
+	memset(run.sims, 0, sizeof(run.sims));
+
+	status = pageIndexInit(&run.threads, 64);
+
+	for (int p = 0; (p < NUMA_POLICY_COUNT) & (status == 0); p++)
+	{
+		status = numaSimCreate(&run.sims[p], p, nodesNum, framesPerNode);
+	}
+
+	if (status != 0)
+	{
+		printf("Not enough memory for %d x %d frames!\n", nodesNum, framesPerNode);
+	}
+	else
+	{
+		status = loadTrace(args[2], format, 0, numaRunSink, &run);
+	}
+
+	if (status == 0)
+	{
+		printf("\n Trace %s: %llu references, %llu threads, %d nodes x %d frames, %llu/%llu ns, scan every %llu\n\n",
+			args[2], run.sims[0].stats.references, run.threadsNum, nodesNum, framesPerNode, run.localNs,
+			run.remoteNs, run.scanRefs);
+		printf(" ------------------------------------------------------------------------------------------------\n");
+		printf("|   Policy    |     Faults     | Remote |  Hinting faults  |   Migrations   | Migrated MiB | ns  |\n");
+		printf(" ------------------------------------------------------------------------------------------------\n");
+
+		for (int p = 0; p < NUMA_POLICY_COUNT; p++)
+		{
+			NumaStats* stats = &run.sims[p].stats;
+
+			printf("| %-11s | %14llu | %5.1f%% | %16llu | %14llu | %12.1f | %3.0f |\n", numaPolicyNames[p],
+				stats->faults, stats->references ? 100.0 * (double)stats->remote / (double)stats->references : 0.0,
+				stats->hintingFaults, stats->migrations,
+				(double)(stats->migrations << TRACE_PAGE_SHIFT) / (1024.0 * 1024.0),
+				stats->references ? (double)stats->latencyNs / (double)stats->references : 0.0);
+		}
+		printf(" ------------------------------------------------------------------------------------------------\n");
+	}
+
+	for (int p = 0; p < NUMA_POLICY_COUNT; p++)
+	{
+		numaSimDestroy(&run.sims[p]);
+	}
+	pageIndexFree(&run.threads);
+
+	return status == 0 ? 0 : -1;
+}
+
+/*************************************************************************
+*   @ End of Numa command                                                 *
+*                                                                         *
+ *************************************************************************/
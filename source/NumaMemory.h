@@ -0,0 +1,26 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: NUMA memory model. Physical memory is split into nodes with their own frame
+ * pools, every thread runs on one node, and a reference costs the local or the remote
+ * latency depending on where its page was placed by first-touch, interleave or an
+ * AutoNUMA-like policy that migrates pages towards the threads using them.
+*/
+
+
+#ifndef NUMA_MEMORY_H
+#define NUMA_MEMORY_H
+
+#include "Trace.h"
+
+#define NUMA_USAGE           "numa <lackey|pin|csv|bin> <file> <nodes> <framesPerNode> [localNs:remoteNs] [scanRefs]"
+#define NUMA_MAX_NODES       8
+
+#define NUMA_FIRST_TOUCH     0
+#define NUMA_INTERLEAVE      1
+#define NUMA_AUTONUMA        2
+#define NUMA_POLICY_COUNT    3
+
+
+int runNumaCommand(int argCount, char* args[]);
+
+#endif // !NUMA_MEMORY_H
@@ -0,0 +1,596 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: PageCache.cpp contains the sharded page cache and the cachebench command.
+ *
+ * A reader probes the shard's resident table between two reads of its version and trusts
+ * the answer only when the version was even and did not change; otherwise, and on every
+ * miss, it takes the lock. Under the lock the engine makes the replacement decision as in
+ * the simulations, and the evicted and loaded pages are written to the resident table
+ * while the version is odd. Buffered hits are replayed only for pages still resident, so
+ * a late update never reloads a page. FIFO ignores hits and buffers nothing. The page hash
+ * picks the shard by its top bits, the resident slot by its middle bits and the engine's
+ * bucket by its low bits, so none of them clusters the others.
+*/
+
+
+
+#include "PageCache.h"
+#include "TraceParser.h"
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <thread>
+
+
+static int  residentFind(CacheShard* shard, unsigned long long page, unsigned long long hash);
+static void residentInsert(CacheShard* shard, unsigned long long page);
+static void residentRemove(CacheShard* shard, unsigned long long page);
+static void cacheFlush(CacheThread* thread, int shard);
+
+
+/*************************************************************************
+*   @ Create / destroy                                                    *
+*                                                                         *
+*  The frames are divided evenly over the shards; the first ones get one  *
+*  more when they do not divide.                                          *
+ *************************************************************************/
+
+int pageCacheCreate(PageCache* cache, int policy, int framesNum, int shardsNum, int optimistic)
+{
+	int status = 0;
+
+	if ((policy < 0) | (policy >= POLICY_COUNT) | (policy == POLICY_OPT) | (framesNum < 1) | (shardsNum < 1))
+	{
+		return -1;
+	}
+
+	cache->policy     = policy;
+	cache->optimistic = optimistic;
+	cache->shardsNum  = 1;
+
+	while ((cache->shardsNum * 2 <= shardsNum) & (cache->shardsNum * 2 <= framesNum) &
+		(cache->shardsNum * 2 <= CACHE_MAX_SHARDS))
+	{
+		cache->shardsNum *= 2;
+	}
+
+	for (int s = 0; s < cache->shardsNum; s++)
+	{
+		CacheShard* shard  = &cache->shards[s];
+		int         frames = framesNum / cache->shardsNum + (s < framesNum % cache->shardsNum);
+		unsigned int slots = 16;
+
+		while (slots < 2 * (unsigned int)frames)
+		{
+			slots *= 2;
+		}
+
+		shard->version.store(0);
+		shard->mask     = slots - 1;
+		shard->resident = (std::atomic<unsigned long long>*)calloc(slots, sizeof(std::atomic<unsigned long long>));
+
+		memset(&shard->engine, 0, sizeof(shard->engine));
+
+		if ((status != 0) || (shard->resident == NULL) || (engineCreate(&shard->engine, policy, frames) != 0))
+		{
+			status = -1;
+		}
+	}
+
+	if (status != 0)
+	{
+		pageCacheDestroy(cache);
+	}
+
+	return status;
+}
+
+void pageCacheDestroy(PageCache* cache)
+{
+	for (int s = 0; s < cache->shardsNum; s++)
+	{
+		free(cache->shards[s].resident);
+		cache->shards[s].resident = NULL;
+		engineDestroy(&cache->shards[s].engine);
+	}
+	cache->shardsNum = 0;
+}
+
+int cacheThreadInit(CacheThread* thread, PageCache* cache)
+{
+	memset(thread, 0, sizeof(*thread));
+
+	thread->cache      = cache;
+	thread->pending    = (unsigned long long*)malloc((size_t)cache->shardsNum * CACHE_BATCH_MAX *
+		sizeof(unsigned long long));
+	thread->pendingNum = (int*)calloc(cache->shardsNum, sizeof(int));
+
+	if ((thread->pending == NULL) | (thread->pendingNum == NULL))
+	{
+		cacheThreadFree(thread);
+		return -1;
+	}
+
+	return 0;
+}
+
+void cacheThreadFree(CacheThread* thread)
+{
+	for (int s = 0; (thread->pendingNum != NULL) && (s < thread->cache->shardsNum); s++)
+	{
+		if (thread->pendingNum[s] > 0)
+		{
+			std::lock_guard<std::mutex> guard(thread->cache->shards[s].lock);
+			cacheFlush(thread, s);
+		}
+	}
+
+	free(thread->pending);
+	free(thread->pendingNum);
+	thread->pending    = NULL;
+	thread->pendingNum = NULL;
+}
+
+/*************************************************************************
+*   @ End of Create / destroy                                             *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Resident table                                                      *
+*                                                                         *
+*  Linear probing over page + 1, at most half full. Removal shifts the    *
+*  following entries back instead of leaving tombstones, so a probe      *
+*  always ends at an empty slot.                                          *
+ *************************************************************************/
+
+/* Returns 1 if page is resident, 0 if not, -1 if the table changed under the probe. */
+
+static int residentFind(CacheShard* shard, unsigned long long page, unsigned long long hash)
+{
+	unsigned int version = shard->version.load(std::memory_order_acquire);
+	unsigned int slot    = (unsigned int)(hash >> 32) & shard->mask;
+	int          found   = 0;
+
+	if (version & 1)
+	{
+		return -1;
+	}
+
+	for (unsigned int probes = 0; probes <= shard->mask; probes++)
+	{
+		unsigned long long key = shard->resident[slot].load(std::memory_order_relaxed);
+
+		if ((key == 0) | (key == page + 1))
+		{
+			found = key != 0;
+			break;
+		}
+		slot = (slot + 1) & shard->mask;
+	}
+
+	std::atomic_thread_fence(std::memory_order_acquire);
+
+	return shard->version.load(std::memory_order_relaxed) == version ? found : -1;
+}
+
+static void residentInsert(CacheShard* shard, unsigned long long page)
+{
+	unsigned int slot = (unsigned int)(pageHash(page) >> 32) & shard->mask;
+
+	while (shard->resident[slot].load(std::memory_order_relaxed) != 0)
+	{
+		slot = (slot + 1) & shard->mask;
+	}
+	shard->resident[slot].store(page + 1, std::memory_order_relaxed);
+}
+
+static void residentRemove(CacheShard* shard, unsigned long long page)
+{
+	unsigned int       hole = (unsigned int)(pageHash(page) >> 32) & shard->mask;
+	unsigned long long key;
+
+	while ((key = shard->resident[hole].load(std::memory_order_relaxed)) != page + 1)
+	{
+		if (key == 0)
+		{
+			return;
+		}
+		hole = (hole + 1) & shard->mask;
+	}
+
+	/* An entry moves into the hole unless its home slot lies after the hole. */
+
+	for (unsigned int slot = (hole + 1) & shard->mask; ; slot = (slot + 1) & shard->mask)
+	{
+		key = shard->resident[slot].load(std::memory_order_relaxed);
+
+		if (key == 0)
+		{
+			break;
+		}
+
+		unsigned int home = (unsigned int)(pageHash(key - 1) >> 32) & shard->mask;
+
+		if (((slot - home) & shard->mask) >= ((slot - hole) & shard->mask))
+		{
+			shard->resident[hole].store(key, std::memory_order_relaxed);
+			hole = slot;
+		}
+	}
+	shard->resident[hole].store(0, std::memory_order_relaxed);
+}
+
+/*************************************************************************
+*   @ End of Resident table                                               *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Cache access                                                        *
+*                                                                         *
+ *************************************************************************/
+
+int pageCacheAccess(CacheThread* thread, unsigned long long page)
+{
+	PageCache*         cache = thread->cache;
+	unsigned long long hash  = pageHash(page);
+	int                s     = (int)(hash >> 56) & (cache->shardsNum - 1);
+	CacheShard*        shard = &cache->shards[s];
+	AccessResult       result;
+	PageRef            ref;
+
+	if (cache->optimistic && (residentFind(shard, page, hash) == 1))
+	{
+		thread->hits++;
+
+		if (cache->policy != POLICY_FIFO)
+		{
+			int pending = thread->pendingNum[s]++;
+
+			thread->pending[s * CACHE_BATCH_MAX + pending] = page;
+
+			if (pending + 1 >= CACHE_BATCH_MAX)
+			{
+				std::lock_guard<std::mutex> guard(shard->lock);
+				cacheFlush(thread, s);
+			}
+			else if ((pending + 1 >= CACHE_BATCH) && shard->lock.try_lock())
+			{
+				cacheFlush(thread, s);
+				shard->lock.unlock();
+			}
+		}
+
+		return 0;
+	}
+
+	ref.page   = page;
+	ref.time   = 0;
+	ref.pid    = 0;
+	ref.access = ACCESS_READ;
+
+	{
+		std::lock_guard<std::mutex> guard(shard->lock);
+
+		if (cache->optimistic)
+		{
+			cacheFlush(thread, s);
+		}
+
+		engineAccess(&shard->engine, &ref, &result);
+
+		if (cache->optimistic & result.fault)
+		{
+			unsigned int version = shard->version.load(std::memory_order_relaxed);
+
+			shard->version.store(version + 1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+
+			if (result.evicted)
+			{
+				residentRemove(shard, result.victimPage);
+			}
+			residentInsert(shard, page);
+
+			shard->version.store(version + 2, std::memory_order_release);
+		}
+	}
+
+	thread->hits   += !result.fault;
+	thread->misses += result.fault;
+
+	return result.fault;
+}
+
+/* Replays the buffered hits of one shard; the caller holds its lock. */
+
+static void cacheFlush(CacheThread* thread, int s)
+{
+	PagingEngine*       engine  = &thread->cache->shards[s].engine;
+	unsigned long long* pending = &thread->pending[s * CACHE_BATCH_MAX];
+	unsigned long long  frame;
+	AccessResult        result;
+	PageRef             ref;
+
+	ref.time   = 0;
+	ref.pid    = 0;
+	ref.access = ACCESS_READ;
+
+	for (int i = 0; i < thread->pendingNum[s]; i++)
+	{
+		if (pageIndexFind(&engine->frames, pending[i], &frame))
+		{
+			ref.page = pending[i];
+			engineAccess(engine, &ref, &result);
+		}
+	}
+	thread->pendingNum[s] = 0;
+}
+
+/*************************************************************************
+*   @ End of Cache access                                                 *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Cache benchmark                                                     *
+*                                                                         *
+*  Every thread replays its own Zipf distributed keys against one shared  *
+*  cache, first one engine behind a single lock (what the simulation      *
+*  would be with a mutex around it), then the sharded optimistic cache.   *
+ *************************************************************************/
+
+struct BenchWorker
+{
+	PageCache*                cache;
+	const unsigned long long* keys;
+	unsigned long long        ops;
+	std::atomic<int>*         ready;
+	std::atomic<int>*         go;
+	unsigned long long        hits;
+	unsigned long long        misses;
+	int                       status;
+};
+
+static void benchWorker(BenchWorker* worker)
+{
+	CacheThread thread;
+
+	worker->status = cacheThreadInit(&thread, worker->cache);
+	worker->ready->fetch_add(1);
+
+	while (worker->go->load() == 0)
+	{
+		std::this_thread::yield();
+	}
+
+	for (unsigned long long i = 0; (i < worker->ops) & (worker->status == 0); i++)
+	{
+		pageCacheAccess(&thread, worker->keys[i & (CACHEBENCH_KEYS - 1)]);
+	}
+
+	worker->hits   = thread.hits;
+	worker->misses = thread.misses;
+
+	if (worker->status == 0)
+	{
+		cacheThreadFree(&thread);
+	}
+}
+
+/* Runs threads workers against a new cache; returns millions of accesses per second, or -1. */
+
+static double benchRun(int policy, int framesNum, int shardsNum, int optimistic, int threads,
+	unsigned long long ops, unsigned long long* const* keys, double* hitRate)
+{
+	PageCache          cache;
+	BenchWorker        workers[TRACE_MAX_THREADS];
+	std::thread        handles[TRACE_MAX_THREADS];
+	std::atomic<int>   ready(0);
+	std::atomic<int>   go(0);
+	unsigned long long hits   = 0;
+	unsigned long long misses = 0;
+	int                status = 0;
+
+	if (pageCacheCreate(&cache, policy, framesNum, shardsNum, optimistic) != 0)
+	{
+		return -1.0;
+	}
+
+	for (int t = 0; t < threads; t++)
+	{
+		workers[t].cache = &cache;
+		workers[t].keys  = keys[t];
+		workers[t].ops   = ops;
+		workers[t].ready = &ready;
+		workers[t].go    = &go;
+		handles[t]       = std::thread(benchWorker, &workers[t]);
+	}
+
+	while (ready.load() < threads)
+	{
+		std::this_thread::yield();
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	go.store(1);
+
+	for (int t = 0; t < threads; t++)
+	{
+		handles[t].join();
+		hits   += workers[t].hits;
+		misses += workers[t].misses;
+		status |= workers[t].status;
+	}
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	pageCacheDestroy(&cache);
+
+	*hitRate = hits + misses ? 100.0 * hits / (double)(hits + misses) : 0.0;
+
+	return status == 0 ? (double)(hits + misses) / seconds / 1e6 : -1.0;
+}
+
+/* Draws the keys of every thread: page of rank r has weight 1 / (r + 1)^zipf. */
+
+static int benchKeys(unsigned long long** keys, int threads, unsigned long long pages, double zipf)
+{
+	double* cdf = (double*)malloc(pages * sizeof(double));
+	double  sum = 0.0;
+
+	if (cdf == NULL)
+	{
+		return -1;
+	}
+
+	for (unsigned long long r = 0; r < pages; r++)
+	{
+		sum   += pow((double)(r + 1), -zipf);
+		cdf[r] = sum;
+	}
+
+	for (int t = 0; t < threads; t++)
+	{
+		unsigned long long state = pageHash((unsigned long long)t + 1);
+
+		for (size_t i = 0; i < CACHEBENCH_KEYS; i++)
+		{
+			state += 0x9e3779b97f4a7c15ULL;
+
+			double             u    = (double)(pageHash(state) >> 11) / 9007199254740992.0 * sum;
+			unsigned long long low  = 0;
+			unsigned long long high = pages - 1;
+
+			while (low < high)
+			{
+				unsigned long long middle = (low + high) / 2;
+
+				if (cdf[middle] < u)
+				{
+					low = middle + 1;
+				}
+				else
+				{
+					high = middle;
+				}
+			}
+			keys[t][i] = low;
+		}
+	}
+
+	free(cdf);
+
+	return 0;
+}
+
+int runCacheBenchCommand(int argCount, char* args[])
+{
+	unsigned long long* keys[TRACE_MAX_THREADS];
+	int                 selected = POLICY_COUNT;
+	int                 status   = 0;
+
+	if (argCount < 4)
+	{
+		printf("Usage: %s\n", CACHEBENCH_USAGE);
+		return -1;
+	}
+
+	if (strcmp(args[1], "all") != 0)
+	{
+		selected = policyFromName(args[1]);
+	}
+
+	int                framesNum = atoi(args[2]);
+	unsigned long long pages     = strtoull(args[3], NULL, 10);
+	int                threads   = argCount > 4 ? atoi(args[4]) : 0;
+	unsigned long long ops       = argCount > 5 ? strtoull(args[5], NULL, 10) : 1000000;
+	int                shardsNum = argCount > 6 ? atoi(args[6]) : 64;
+	double             zipf      = argCount > 7 ? atof(args[7]) : 0.99;
+
+	if (threads <= 0)
+	{
+		threads = (int)std::thread::hardware_concurrency();
+	}
+	threads = threads < 1 ? 1 : threads > TRACE_MAX_THREADS ? TRACE_MAX_THREADS : threads;
+
+	if ((selected < 0) | (selected == POLICY_OPT) | (framesNum < 1) | (pages < 1) | (ops < 1) | (shardsNum < 1) |
+		(zipf < 0.0))
+	{
+		printf("Usage: %s\n", CACHEBENCH_USAGE);
+		return -1;
+	}
+
+	for (int t = 0; t < threads; t++)
+	{
+		keys[t] = (unsigned long long*)malloc(CACHEBENCH_KEYS * sizeof(unsigned long long));
+		status |= keys[t] == NULL ? -1 : 0;
+	}
+
+	if ((status != 0) || (benchKeys(keys, threads, pages, zipf) != 0))
+	{
+		printf("Not enough memory for %llu pages!\n", pages);
+		status = -1;
+	}
+
+	if (status == 0)
+	{
+		printf("\n %d frames, %llu pages, Zipf %.2f, %llu accesses per thread, up to %d shards\n\n", framesNum, pages,
+			zipf, ops, shardsNum);
+		printf(" -------------------------------------------------------------------------------------\n");
+		printf("| Policy    | Threads |  Single lock  | Hit rate |    Sharded    | Hit rate | Speedup |\n");
+		printf("|           |         |   M acc / s   |          |   M acc / s   |          |         |\n");
+		printf(" -------------------------------------------------------------------------------------\n");
+	}
+
+	for (int policy = 0; (policy < POLICY_OPT) & (status == 0); policy++)
+	{
+		if ((selected != POLICY_COUNT) & (selected != policy))
+		{
+			continue;
+		}
+
+		/* 1, 2, 4, ... threads, and the maximum. */
+
+		for (int count = 1; (count <= threads) & (status == 0); count = count < threads && count * 2 > threads ?
+			threads : count * 2)
+		{
+			double lockedHits;
+			double shardedHits;
+			double locked  = benchRun(policy, framesNum, 1, 0, count, ops, keys, &lockedHits);
+			double sharded = benchRun(policy, framesNum, shardsNum, 1, count, ops, keys, &shardedHits);
+
+			if ((locked < 0.0) | (sharded < 0.0))
+			{
+				printf("Not enough memory for %d frames!\n", framesNum);
+				status = -1;
+				break;
+			}
+
+			printf("| %-9s | %7d | %13.2f | %7.2f%% | %13.2f | %7.2f%% | %6.2fx |\n", policyName(policy), count, locked,
+				lockedHits, sharded, shardedHits, sharded / locked);
+		}
+	}
+
+	if (status == 0)
+	{
+		printf(" -------------------------------------------------------------------------------------\n");
+	}
+
+	for (int t = 0; t < threads; t++)
+	{
+		free(keys[t]);
+	}
+
+	return status;
+}
+
+/*************************************************************************
+*   @ End of Cache benchmark                                              *
+*                                                                         *
+ *************************************************************************/
@@ -0,0 +1,67 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: Thread safe page cache running the simulated replacement policies in a real
+ * process. Pages are spread over shards, each a paging engine behind its own lock plus a
+ * lock-free copy of its resident set guarded by a sequence counter, so a hit is found
+ * without taking any lock. The recency updates of hits are buffered per thread and shard
+ * and replayed into the engine in batches, when the lock is free or the batch is full.
+*/
+
+
+#ifndef PAGE_CACHE_H
+#define PAGE_CACHE_H
+
+#include "PagingEngine.h"
+#include <atomic>
+#include <mutex>
+
+#define CACHEBENCH_USAGE     "cachebench <fifo|lru|lfu|clock|all> <frames> <pages> [threads] [ops] [shards] [zipf]"
+#define CACHE_MAX_SHARDS     256
+#define CACHE_BATCH          32      /* buffered hits before the lock is tried */
+#define CACHE_BATCH_MAX      128     /* buffered hits before the lock is waited for */
+#define CACHEBENCH_KEYS      262144  /* keys drawn per thread, replayed in a loop */
+
+
+struct alignas(64) CacheShard
+{
+	std::mutex                       lock;        /* owns engine and the writes to resident */
+	std::atomic<unsigned int>        version;     /* odd while resident changes */
+	std::atomic<unsigned long long>* resident;    /* open addressing of page + 1, 0 empty */
+	unsigned int                     mask;
+	PagingEngine                     engine;
+};
+
+struct PageCache
+{
+	int        policy;
+	int        shardsNum;
+	int        optimistic;                        /* 0: every access locks and runs the engine */
+	CacheShard shards[CACHE_MAX_SHARDS];
+};
+
+/* Per thread handle; its buffered hits are flushed by cacheThreadFree. */
+
+struct CacheThread
+{
+	PageCache*          cache;
+	unsigned long long* pending;                  /* CACHE_BATCH_MAX pages per shard */
+	int*                pendingNum;
+	unsigned long long  hits;
+	unsigned long long  misses;
+};
+
+/* Any policy but OPT; shardsNum is rounded down to a power of two of at most framesNum. */
+
+int  pageCacheCreate(PageCache* cache, int policy, int framesNum, int shardsNum, int optimistic);
+void pageCacheDestroy(PageCache* cache);
+
+int  cacheThreadInit(CacheThread* thread, PageCache* cache);
+void cacheThreadFree(CacheThread* thread);
+
+/* Returns 1 when page was missing and has been loaded, 0 on a hit. */
+
+int  pageCacheAccess(CacheThread* thread, unsigned long long page);
+
+int  runCacheBenchCommand(int argCount, char* args[]);
+
+#endif // !PAGE_CACHE_H
@@ -0,0 +1,345 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: PageIndex.cpp contains an open addressing hash table keyed by page number. Pages,
+ * values and one control byte per slot live in three flat arrays: a lookup reads control
+ * bytes until the tag matches, and lookups and updates of a sized table never allocate.
+*/
+
+
+
+#include "PageIndex.h"
+#include <string.h>
+
+
+static int   pageIndexGrow(PageIndex* index);
+static void* indexAlloc(PageIndex* index, size_t bytes);
+
+
+/*************************************************************************
+*   @ Page hash                                                           *
+*                                                                         *
+*  64-bit finalizer; page numbers are dense and need their bits mixed     *
+*  before masking.                                                        *
+ *************************************************************************/
+
+unsigned long long pageHash(unsigned long long page)
+{
+	page ^= page >> 33;
+	page *= 0xff51afd7ed558ccdULL;
+	page ^= page >> 33;
+	page *= 0xc4ceb9fe1a85ec53ULL;
+	page ^= page >> 33;
+
+	return page;
+}
+
+/*************************************************************************
+*   @ End of Page hash                                                    *
+*                                                                         *
+ *************************************************************************/
+
+
+static void* indexAlloc(PageIndex* index, size_t bytes)
+{
+	return index->arena != NULL ? arenaAlloc(index->arena, bytes) : malloc(bytes);
+}
+
+static inline unsigned char indexTag(unsigned long long hash)
+{
+	return (unsigned char)(0x80 | ((hash >> 40) & 0x7F));
+}
+
+
+/*************************************************************************
+*   @ Init / free / clear                                                 *
+*                                                                         *
+ *************************************************************************/
+
+int pageIndexInit(PageIndex* index, size_t expected)
+{
+	return pageIndexInitIn(index, NULL, expected);
+}
+
+/* With an arena, the tables (and their growth) come from it and are never freed one by one.
+ * expected entries fit without growing. */
+
+int pageIndexInitIn(PageIndex* index, Arena* arena, size_t expected)
+{
+	size_t slots = 16;
+
+	while (slots * PAGE_INDEX_LOAD_PCT / 100 < expected)
+	{
+		slots *= 2;
+	}
+
+	index->arena   = arena;
+	index->control = (unsigned char*)indexAlloc(index, slots);
+	index->pages   = (unsigned long long*)indexAlloc(index, slots * sizeof(unsigned long long));
+	index->values  = (unsigned long long*)indexAlloc(index, slots * sizeof(unsigned long long));
+	index->mask    = slots - 1;
+	index->limit   = slots * PAGE_INDEX_LOAD_PCT / 100;
+
+	if ((index->control == NULL) | (index->pages == NULL) | (index->values == NULL))
+	{
+		pageIndexFree(index);
+		return -1;
+	}
+
+	pageIndexClear(index);
+
+	return 0;
+}
+
+void pageIndexFree(PageIndex* index)
+{
+	if (index->arena == NULL)
+	{
+		free(index->control);
+		free(index->pages);
+		free(index->values);
+	}
+	index->control = NULL;
+	index->pages   = NULL;
+	index->values  = NULL;
+	index->mask    = 0;
+	index->limit   = 0;
+	index->count   = 0;
+}
+
+void pageIndexClear(PageIndex* index)
+{
+	memset(index->control, 0, index->mask + 1);
+	index->count = 0;
+}
+
+/*************************************************************************
+*   @ End of Init / free / clear                                          *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Grow                                                                *
+*                                                                         *
+*  Doubles the slots and reinserts every entry. Only reached by tables    *
+*  that keep one entry per distinct page (LFU counters, OPT, reuse).      *
+ *************************************************************************/
+
+static int pageIndexGrow(PageIndex* index)
+{
+	size_t              slots   = (index->mask + 1) * 2;
+	unsigned char*      control = (unsigned char*)indexAlloc(index, slots);
+	unsigned long long* pages   = (unsigned long long*)indexAlloc(index, slots * sizeof(unsigned long long));
+	unsigned long long* values  = (unsigned long long*)indexAlloc(index, slots * sizeof(unsigned long long));
+
+	if ((control == NULL) | (pages == NULL) | (values == NULL))
+	{
+		if (index->arena == NULL)
+		{
+			free(control);
+			free(pages);
+			free(values);
+		}
+		return -1;
+	}
+
+	memset(control, 0, slots);
+
+	for (size_t i = 0; i <= index->mask; i++)
+	{
+		if (index->control[i] != 0)
+		{
+			size_t slot = (size_t)pageHash(index->pages[i]) & (slots - 1);
+
+			while (control[slot] != 0)
+			{
+				slot = (slot + 1) & (slots - 1);
+			}
+			control[slot] = index->control[i];
+			pages[slot]   = index->pages[i];
+			values[slot]  = index->values[i];
+		}
+	}
+
+	if (index->arena == NULL)
+	{
+		free(index->control);
+		free(index->pages);
+		free(index->values);
+	}
+	index->control = control;
+	index->pages   = pages;
+	index->values  = values;
+	index->mask    = slots - 1;
+	index->limit   = slots * PAGE_INDEX_LOAD_PCT / 100;
+
+	return 0;
+}
+
+/*************************************************************************
+*   @ End of Grow                                                         *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Lookup and update                                                   *
+*                                                                         *
+*  A probe runs from the page's home slot to the first empty slot.        *
+*  Remove shifts the rest of the run back into the hole instead of        *
+*  leaving a tombstone, so runs never fill up with deleted entries.       *
+*  Slots returned by pageIndexSlot stay valid until the next insert or    *
+*  remove.                                                                *
+ *************************************************************************/
+
+int pageIndexFind(const PageIndex* index, unsigned long long page, unsigned long long* value)
+{
+	unsigned long long hash = pageHash(page);
+	unsigned char      tag  = indexTag(hash);
+	size_t             slot = (size_t)hash & index->mask;
+
+	while (index->control[slot] != 0)
+	{
+		if ((index->control[slot] == tag) && (index->pages[slot] == page))
+		{
+			if (value != NULL)
+			{
+				*value = index->values[slot];
+			}
+			return 1;
+		}
+		slot = (slot + 1) & index->mask;
+	}
+
+	return 0;
+}
+
+unsigned long long* pageIndexSlot(PageIndex* index, unsigned long long page, int* created)
+{
+	unsigned long long hash = pageHash(page);
+	unsigned char      tag  = indexTag(hash);
+	size_t             slot = (size_t)hash & index->mask;
+
+	while (index->control[slot] != 0)
+	{
+		if ((index->control[slot] == tag) && (index->pages[slot] == page))
+		{
+			if (created != NULL)
+			{
+				*created = 0;
+			}
+			return &index->values[slot];
+		}
+		slot = (slot + 1) & index->mask;
+	}
+
+	if (index->count >= index->limit)
+	{
+		if (pageIndexGrow(index) != 0)
+		{
+			return NULL;
+		}
+
+		slot = (size_t)hash & index->mask;
+
+		while (index->control[slot] != 0)
+		{
+			slot = (slot + 1) & index->mask;
+		}
+	}
+
+	index->control[slot] = tag;
+	index->pages[slot]   = page;
+	index->values[slot]  = 0;
+	index->count++;
+
+	if (created != NULL)
+	{
+		*created = 1;
+	}
+	return &index->values[slot];
+}
+
+int pageIndexSet(PageIndex* index, unsigned long long page, unsigned long long value)
+{
+	unsigned long long* slot = pageIndexSlot(index, page, NULL);
+
+	if (slot == NULL)
+	{
+		return -1;
+	}
+	*slot = value;
+
+	return 0;
+}
+
+int pageIndexRemove(PageIndex* index, unsigned long long page)
+{
+	unsigned long long hash = pageHash(page);
+	unsigned char      tag  = indexTag(hash);
+	size_t             hole = (size_t)hash & index->mask;
+
+	while ((index->control[hole] != tag) || (index->pages[hole] != page))
+	{
+		if (index->control[hole] == 0)
+		{
+			return 0;
+		}
+		hole = (hole + 1) & index->mask;
+	}
+
+	/* An entry of the run moves into the hole unless its home slot lies after the hole. */
+
+	for (size_t slot = (hole + 1) & index->mask; index->control[slot] != 0; slot = (slot + 1) & index->mask)
+	{
+		size_t home = (size_t)pageHash(index->pages[slot]) & index->mask;
+
+		if (((slot - home) & index->mask) >= ((slot - hole) & index->mask))
+		{
+			index->control[hole] = index->control[slot];
+			index->pages[hole]   = index->pages[slot];
+			index->values[hole]  = index->values[slot];
+			hole                 = slot;
+		}
+	}
+
+	index->control[hole] = 0;
+	index->count--;
+
+	return 1;
+}
+
+/*************************************************************************
+*   @ End of Lookup and update                                            *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Iterate                                                             *
+*                                                                         *
+*  Visits every entry in slot order; start with *cursor = 0. Returns 0    *
+*  when there are no more entries.                                        *
+ *************************************************************************/
+
+int pageIndexNext(const PageIndex* index, size_t* cursor, unsigned long long* page, unsigned long long* value)
+{
+	while ((index->control != NULL) && (*cursor <= index->mask))
+	{
+		size_t slot = (*cursor)++;
+
+		if (index->control[slot] != 0)
+		{
+			*page  = index->pages[slot];
+			*value = index->values[slot];
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+/*************************************************************************
+*   @ End of Iterate                                                      *
+*                                                                         *
+ *************************************************************************/
@@ -0,0 +1,47 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: Hash index from page numbers to a 64-bit value (frame number, counter or trace
+ * position) used by the trace driven engines in place of linear frame scans. Sized by
+ * size_t throughout, so one index can hold the distinct pages of a multi-billion
+ * reference trace.
+*/
+
+
+#ifndef PAGE_INDEX_H
+#define PAGE_INDEX_H
+
+#include <stdlib.h>
+#include "Arena.h"
+
+#define PAGE_INDEX_LOAD_PCT  75      /* tables grow beyond this share of used slots */
+
+
+/* Open addressing with linear probing; control[slot] is 0 for an empty slot, otherwise
+ * 0x80 plus 7 bits of the page hash, so most probes never touch a page that differs. */
+
+struct PageIndex
+{
+	unsigned char*      control;
+	unsigned long long* pages;
+	unsigned long long* values;
+	size_t              mask;         /* slots - 1 */
+	size_t              count;
+	size_t              limit;        /* count at which the table grows */
+	Arena*              arena;        /* owner of the slot arrays, NULL for malloc */
+};
+
+int  pageIndexInit(PageIndex* index, size_t expected);
+int  pageIndexInitIn(PageIndex* index, Arena* arena, size_t expected);
+void pageIndexFree(PageIndex* index);
+void pageIndexClear(PageIndex* index);
+
+int                 pageIndexFind(const PageIndex* index, unsigned long long page, unsigned long long* value);
+int                 pageIndexSet(PageIndex* index, unsigned long long page, unsigned long long value);
+unsigned long long* pageIndexSlot(PageIndex* index, unsigned long long page, int* created);
+int                 pageIndexRemove(PageIndex* index, unsigned long long page);
+int                 pageIndexNext(const PageIndex* index, size_t* cursor, unsigned long long* page,
+	unsigned long long* value);
+
+unsigned long long  pageHash(unsigned long long page);
+
+#endif // !PAGE_INDEX_H
@@ -0,0 +1,866 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: PageTables.cpp contains the translation back ends and the pagetable command.
+ *
+ * All back ends hold the translations of resident pages only, so their memory is what
+ * translating the engine's frames costs; where a page lives while it is out is left to
+ * the swap model. Radix nodes are freed when their last entry goes, hashed entries when
+ * their last page goes, and the inverted table is sized by the frames alone.
+ *
+ * Cost: every entry read during a lookup is a probe, and the lookup touches the distinct
+ * 64 byte lines of those entries at their real addresses. A radix walk reads one entry
+ * per level and stops at the first empty one. A hashed lookup reads the bucket and the
+ * tag of every entry of its chain, plus the page's slot in the matching cluster. An
+ * inverted lookup reads the anchor and then the frame entries of its chain. There is no
+ * TLB in front, so the costs are those of every reference missing it.
+*/
+
+
+
+#include "PageTables.h"
+#include "TraceParser.h"
+#include <string.h>
+
+#define PAGETABLE_NONE       -1
+
+
+/* Lines of the lookup in progress; lines past PAGETABLE_MAX_LINES all count as new. */
+
+struct LookupProbe
+{
+	size_t             lines[PAGETABLE_MAX_LINES];
+	int                linesNum;
+	unsigned long long probes;
+	unsigned long long overflow;
+};
+
+struct PageTableRun
+{
+	PagingEngine       engine;
+	PageTables         tables;
+	unsigned long long spreadPages;
+	unsigned long long mismatches;   /* back end translations that disagree with the engine */
+	int                status;
+};
+
+static const char* backendNames[BACKEND_COUNT] = { "Radix", "Hashed", "Clustered", "Inverted" };
+
+
+const char* backendName(int backend)
+{
+	return (backend >= 0) & (backend < BACKEND_COUNT) ? backendNames[backend] : "?";
+}
+
+static inline void probeTouch(LookupProbe* probe, const void* address)
+{
+	size_t line = (size_t)address >> PAGETABLE_LINE_SHIFT;
+
+	probe->probes++;
+
+	for (int i = 0; i < probe->linesNum; i++)
+	{
+		if (probe->lines[i] == line)
+		{
+			return;
+		}
+	}
+
+	if (probe->linesNum < PAGETABLE_MAX_LINES)
+	{
+		probe->lines[probe->linesNum++] = line;
+	}
+	else
+	{
+		probe->overflow++;
+	}
+}
+
+static void costBytes(TranslationCost* cost, long long bytes)
+{
+	cost->bytes += (unsigned long long)bytes;
+
+	if (cost->bytes > cost->peakBytes)
+	{
+		cost->peakBytes = cost->bytes;
+	}
+}
+
+
+/*************************************************************************
+*   @ Radix tree                                                          *
+*                                                                         *
+*  levels nodes of RADIX_BITS page bits each, root first. A page above    *
+*  the tree's reach adds a root level over the old root.                  *
+ *************************************************************************/
+
+/* Freed nodes are empty, so they are kept on a list (through entries[0]) and reused as they are. */
+
+static RadixNode* radixAlloc(PageTables* tables)
+{
+	RadixNode* node = tables->freeNodes;
+
+	if (node == NULL)
+	{
+		node = (RadixNode*)calloc(1, sizeof(RadixNode));
+	}
+	else
+	{
+		tables->freeNodes = (RadixNode*)(size_t)node->entries[0];
+		node->entries[0]  = 0;
+	}
+
+	if (node != NULL)
+	{
+		costBytes(&tables->costs[BACKEND_RADIX], RADIX_NODE_BYTES);
+	}
+	return node;
+}
+
+static void radixRelease(PageTables* tables, RadixNode* node)
+{
+	node->entries[0]  = (unsigned long long)(size_t)tables->freeNodes;
+	tables->freeNodes = node;
+	costBytes(&tables->costs[BACKEND_RADIX], -RADIX_NODE_BYTES);
+}
+
+static inline int radixSlot(unsigned long long page, int level, int levels)
+{
+	return (int)((page >> (RADIX_BITS * (levels - 1 - level))) & (RADIX_FANOUT - 1));
+}
+
+static int radixLookup(const ProcessTables* process, unsigned long long page, LookupProbe* probe)
+{
+	const RadixNode* node = process->root;
+
+	if ((node == NULL) || ((process->levels * RADIX_BITS < 64) && ((page >> (process->levels * RADIX_BITS)) != 0)))
+	{
+		return PAGETABLE_NONE;
+	}
+
+	for (int level = 0; level < process->levels; level++)
+	{
+		const unsigned long long* entry = &node->entries[radixSlot(page, level, process->levels)];
+
+		probeTouch(probe, entry);
+
+		if (*entry == 0)
+		{
+			return PAGETABLE_NONE;
+		}
+		if (level == process->levels - 1)
+		{
+			return (int)(*entry - 1);
+		}
+		node = (const RadixNode*)(size_t)*entry;
+	}
+
+	return PAGETABLE_NONE;
+}
+
+static int radixMap(PageTables* tables, ProcessTables* process, unsigned long long page, int frame)
+{
+	RadixNode* node;
+
+	if (process->root == NULL)
+	{
+		process->root   = radixAlloc(tables);
+		process->levels = RADIX_MIN_LEVELS;
+
+		if (process->root == NULL)
+		{
+			return -1;
+		}
+	}
+
+	while ((process->levels * RADIX_BITS < 64) && ((page >> (process->levels * RADIX_BITS)) != 0))
+	{
+		RadixNode* root = radixAlloc(tables);
+
+		if (root == NULL)
+		{
+			return -1;
+		}
+		root->entries[0] = (unsigned long long)(size_t)process->root;
+		root->used       = 1;
+		process->root    = root;
+		process->levels++;
+	}
+
+	node = process->root;
+
+	for (int level = 0; level < process->levels - 1; level++)
+	{
+		unsigned long long* entry = &node->entries[radixSlot(page, level, process->levels)];
+
+		if (*entry == 0)
+		{
+			RadixNode* child = radixAlloc(tables);
+
+			if (child == NULL)
+			{
+				return -1;
+			}
+			*entry = (unsigned long long)(size_t)child;
+			node->used++;
+		}
+		node = (RadixNode*)(size_t)*entry;
+	}
+
+	unsigned long long* leaf = &node->entries[radixSlot(page, process->levels - 1, process->levels)];
+
+	node->used += *leaf == 0;
+	*leaf       = (unsigned long long)frame + 1;
+
+	return 0;
+}
+
+static void radixUnmap(PageTables* tables, ProcessTables* process, unsigned long long page)
+{
+	RadixNode* path[64 / RADIX_BITS + 1];
+	RadixNode* node = process->root;
+	int        level;
+
+	if ((node == NULL) || ((process->levels * RADIX_BITS < 64) && ((page >> (process->levels * RADIX_BITS)) != 0)))
+	{
+		return;
+	}
+
+	for (level = 0; level < process->levels; level++)
+	{
+		path[level] = node;
+
+		if (level < process->levels - 1)
+		{
+			node = (RadixNode*)(size_t)node->entries[radixSlot(page, level, process->levels)];
+
+			if (node == NULL)
+			{
+				return;
+			}
+		}
+	}
+
+	/* Clears the leaf entry, then frees the nodes left empty below the root. */
+
+	for (level = process->levels - 1; level >= 0; level--)
+	{
+		unsigned long long* entry = &path[level]->entries[radixSlot(page, level, process->levels)];
+
+		if (*entry == 0)
+		{
+			return;
+		}
+		*entry = 0;
+
+		if ((--path[level]->used > 0) | (level == 0))
+		{
+			return;
+		}
+		radixRelease(tables, path[level]);
+	}
+}
+
+static void radixFree(RadixNode* node, int levels)
+{
+	for (int slot = 0; (levels > 1) & (slot < RADIX_FANOUT); slot++)
+	{
+		if (node->entries[slot] != 0)
+		{
+			radixFree((RadixNode*)(size_t)node->entries[slot], levels - 1);
+		}
+	}
+	free(node);
+}
+
+/*************************************************************************
+*   @ End of Radix tree                                                   *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Hashed page tables                                                  *
+*                                                                         *
+*  Chains of entries per bucket, newest first. An entry holds the tag     *
+*  and chain pointer (16 bytes) and 8 bytes per page of its cluster.      *
+ *************************************************************************/
+
+static inline long long hashedNodeBytes(int clusterPages)
+{
+	return 16 + 8 * (long long)clusterPages;
+}
+
+static int hashedInit(HashedTable* table, TranslationCost* cost)
+{
+	table->buckets = (HashedNode**)calloc(HASHED_MIN_BUCKETS, sizeof(HashedNode*));
+	table->mask    = HASHED_MIN_BUCKETS - 1;
+	table->nodes   = 0;
+
+	if (table->buckets == NULL)
+	{
+		return -1;
+	}
+	costBytes(cost, HASHED_MIN_BUCKETS * (long long)sizeof(HashedNode*));
+
+	return 0;
+}
+
+static int hashedLookup(const HashedTable* table, int clusterPages, unsigned long long page, LookupProbe* probe)
+{
+	unsigned long long  tag    = page / (unsigned long long)clusterPages;
+	HashedNode* const*  bucket = &table->buckets[(size_t)pageHash(tag) & table->mask];
+
+	probeTouch(probe, bucket);
+
+	for (const HashedNode* node = *bucket; node != NULL; node = node->next)
+	{
+		probeTouch(probe, node);
+
+		if (node->tag == tag)
+		{
+			const unsigned long long* entry = &node->frames[page % (unsigned long long)clusterPages];
+
+			if (entry != node->frames)
+			{
+				probeTouch(probe, entry);
+			}
+			return *entry != 0 ? (int)(*entry - 1) : PAGETABLE_NONE;
+		}
+	}
+
+	return PAGETABLE_NONE;
+}
+
+static int hashedGrow(HashedTable* table, TranslationCost* cost)
+{
+	size_t       buckets = (table->mask + 1) * 2;
+	HashedNode** grown   = (HashedNode**)calloc(buckets, sizeof(HashedNode*));
+
+	if (grown == NULL)
+	{
+		return -1;
+	}
+
+	for (size_t b = 0; b <= table->mask; b++)
+	{
+		while (table->buckets[b] != NULL)
+		{
+			HashedNode* node  = table->buckets[b];
+			size_t      slot  = (size_t)pageHash(node->tag) & (buckets - 1);
+
+			table->buckets[b] = node->next;
+			node->next        = grown[slot];
+			grown[slot]       = node;
+		}
+	}
+
+	costBytes(cost, (long long)((buckets - table->mask - 1) * sizeof(HashedNode*)));
+	free(table->buckets);
+	table->buckets = grown;
+	table->mask    = buckets - 1;
+
+	return 0;
+}
+
+static int hashedMap(HashedTable* table, TranslationCost* cost, int clusterPages, unsigned long long page, int frame)
+{
+	unsigned long long tag    = page / (unsigned long long)clusterPages;
+	HashedNode**       bucket = &table->buckets[(size_t)pageHash(tag) & table->mask];
+	HashedNode*        node   = *bucket;
+
+	while ((node != NULL) && (node->tag != tag))
+	{
+		node = node->next;
+	}
+
+	if (node == NULL)
+	{
+		node = (HashedNode*)calloc(1, sizeof(HashedNode) + (size_t)(clusterPages - 1) * sizeof(unsigned long long));
+
+		if (node == NULL)
+		{
+			return -1;
+		}
+		node->tag  = tag;
+		node->next = *bucket;
+		*bucket    = node;
+		table->nodes++;
+		costBytes(cost, hashedNodeBytes(clusterPages));
+
+		if ((table->nodes > table->mask + 1) && (hashedGrow(table, cost) != 0))
+		{
+			return -1;
+		}
+	}
+
+	unsigned long long* entry = &node->frames[page % (unsigned long long)clusterPages];
+
+	node->valid += *entry == 0;
+	*entry       = (unsigned long long)frame + 1;
+
+	return 0;
+}
+
+static void hashedUnmap(HashedTable* table, TranslationCost* cost, int clusterPages, unsigned long long page)
+{
+	unsigned long long tag  = page / (unsigned long long)clusterPages;
+	HashedNode**       link = &table->buckets[(size_t)pageHash(tag) & table->mask];
+
+	while ((*link != NULL) && ((*link)->tag != tag))
+	{
+		link = &(*link)->next;
+	}
+
+	HashedNode* node = *link;
+
+	if ((node == NULL) || (node->frames[page % (unsigned long long)clusterPages] == 0))
+	{
+		return;
+	}
+
+	node->frames[page % (unsigned long long)clusterPages] = 0;
+
+	if (--node->valid == 0)
+	{
+		*link = node->next;
+		free(node);
+		table->nodes--;
+		costBytes(cost, -hashedNodeBytes(clusterPages));
+	}
+}
+
+static void hashedFree(HashedTable* table)
+{
+	for (size_t b = 0; (table->buckets != NULL) && (b <= table->mask); b++)
+	{
+		while (table->buckets[b] != NULL)
+		{
+			HashedNode* node  = table->buckets[b];
+
+			table->buckets[b] = node->next;
+			free(node);
+		}
+	}
+	free(table->buckets);
+	table->buckets = NULL;
+}
+
+/*************************************************************************
+*   @ End of Hashed page tables                                           *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Inverted page table                                                 *
+*                                                                         *
+*  Entry f describes frame f (16 bytes); a hash anchor table of at least  *
+*  as many 4 byte anchors as frames starts the chain of every hash.       *
+ *************************************************************************/
+
+static inline size_t invertedAnchor(const PageTables* tables, int process, unsigned long long page)
+{
+	return (size_t)pageHash(page ^ ((unsigned long long)process << PAGETABLE_VPN_BITS)) & tables->anchorMask;
+}
+
+static int invertedLookup(const PageTables* tables, int process, unsigned long long page, LookupProbe* probe)
+{
+	const int* anchor = &tables->anchors[invertedAnchor(tables, process, page)];
+
+	probeTouch(probe, anchor);
+
+	for (int frame = *anchor; frame != PAGETABLE_NONE; frame = tables->inverted[frame].next)
+	{
+		const InvertedEntry* entry = &tables->inverted[frame];
+
+		probeTouch(probe, entry);
+
+		if ((entry->page == page) & (entry->process == (unsigned int)process))
+		{
+			return frame;
+		}
+	}
+
+	return PAGETABLE_NONE;
+}
+
+static void invertedMap(PageTables* tables, int process, unsigned long long page, int frame)
+{
+	int* anchor = &tables->anchors[invertedAnchor(tables, process, page)];
+
+	tables->inverted[frame].page    = page;
+	tables->inverted[frame].process = (unsigned int)process;
+	tables->inverted[frame].next    = *anchor;
+	*anchor                         = frame;
+}
+
+static void invertedUnmap(PageTables* tables, int process, unsigned long long page, int frame)
+{
+	int* link = &tables->anchors[invertedAnchor(tables, process, page)];
+
+	while ((*link != PAGETABLE_NONE) && (*link != frame))
+	{
+		link = &tables->inverted[*link].next;
+	}
+
+	if (*link == frame)
+	{
+		*link = tables->inverted[frame].next;
+	}
+}
+
+/*************************************************************************
+*   @ End of Inverted page table                                          *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Page tables                                                         *
+*                                                                         *
+ *************************************************************************/
+
+int pageTablesCreate(PageTables* tables, int framesNum, int clusterPages)
+{
+	size_t anchors = 16;
+
+	memset(tables, 0, sizeof(*tables));
+
+	if ((framesNum < 1) | (clusterPages < 1))
+	{
+		return -1;
+	}
+
+	while (anchors < (size_t)framesNum)
+	{
+		anchors *= 2;
+	}
+
+	tables->framesNum    = framesNum;
+	tables->clusterPages = clusterPages;
+	tables->anchorMask   = anchors - 1;
+	tables->processes    = (ProcessTables*)calloc(PAGETABLE_PROCESSES, sizeof(ProcessTables));
+	tables->anchors      = (int*)malloc(anchors * sizeof(int));
+	tables->inverted     = (InvertedEntry*)calloc((size_t)framesNum, sizeof(InvertedEntry));
+
+	if ((tables->processes == NULL) | (tables->anchors == NULL) | (tables->inverted == NULL) ||
+		(pageIndexInit(&tables->processIndex, 16) != 0))
+	{
+		pageTablesDestroy(tables);
+		return -1;
+	}
+
+	memset(tables->anchors, 0xFF, anchors * sizeof(int));
+	costBytes(&tables->costs[BACKEND_INVERTED], (long long)(anchors * sizeof(int) +
+		(size_t)framesNum * sizeof(InvertedEntry)));
+
+	return 0;
+}
+
+void pageTablesDestroy(PageTables* tables)
+{
+	for (int p = 0; (tables->processes != NULL) && (p < tables->processesNum); p++)
+	{
+		if (tables->processes[p].root != NULL)
+		{
+			radixFree(tables->processes[p].root, tables->processes[p].levels);
+		}
+		hashedFree(&tables->processes[p].hashed);
+		hashedFree(&tables->processes[p].clustered);
+	}
+
+	while (tables->freeNodes != NULL)
+	{
+		RadixNode* node   = tables->freeNodes;
+
+		tables->freeNodes = (RadixNode*)(size_t)node->entries[0];
+		free(node);
+	}
+
+	free(tables->processes);
+	free(tables->anchors);
+	free(tables->inverted);
+	pageIndexFree(&tables->processIndex);
+	memset(tables, 0, sizeof(*tables));
+}
+
+int pageTablesProcess(PageTables* tables, unsigned int pid)
+{
+	unsigned long long process;
+
+	if (pageIndexFind(&tables->processIndex, pid, &process))
+	{
+		return (int)process;
+	}
+
+	if (tables->processesNum == PAGETABLE_PROCESSES)
+	{
+		return PAGETABLE_NONE;
+	}
+
+	ProcessTables* tablesOf = &tables->processes[tables->processesNum];
+
+	if ((hashedInit(&tablesOf->hashed, &tables->costs[BACKEND_HASHED]) != 0) ||
+		(hashedInit(&tablesOf->clustered, &tables->costs[BACKEND_CLUSTERED]) != 0) ||
+		(pageIndexSet(&tables->processIndex, pid, (unsigned long long)tables->processesNum) != 0))
+	{
+		hashedFree(&tablesOf->hashed);
+		hashedFree(&tablesOf->clustered);
+		return PAGETABLE_NONE;
+	}
+
+	return tables->processesNum++;
+}
+
+int pageTablesLookup(PageTables* tables, int backend, int process, unsigned long long page)
+{
+	LookupProbe      probe;
+	TranslationCost* cost = &tables->costs[backend];
+	int              frame;
+
+	probe.linesNum = 0;
+	probe.probes   = 0;
+	probe.overflow = 0;
+
+	switch (backend)
+	{
+	case BACKEND_RADIX:
+		frame = radixLookup(&tables->processes[process], page, &probe);
+		break;
+	case BACKEND_HASHED:
+		frame = hashedLookup(&tables->processes[process].hashed, 1, page, &probe);
+		break;
+	case BACKEND_CLUSTERED:
+		frame = hashedLookup(&tables->processes[process].clustered, tables->clusterPages, page, &probe);
+		break;
+	default:
+		frame = invertedLookup(tables, process, page, &probe);
+		break;
+	}
+
+	cost->lookups++;
+	cost->probes += probe.probes;
+	cost->lines  += (unsigned long long)probe.linesNum + probe.overflow;
+
+	if (probe.probes > cost->maxProbes)
+	{
+		cost->maxProbes = probe.probes;
+	}
+
+	return frame;
+}
+
+int pageTablesMap(PageTables* tables, int process, unsigned long long page, int frame)
+{
+	ProcessTables* tablesOf = &tables->processes[process];
+
+	if ((radixMap(tables, tablesOf, page, frame) != 0) ||
+		(hashedMap(&tablesOf->hashed, &tables->costs[BACKEND_HASHED], 1, page, frame) != 0) ||
+		(hashedMap(&tablesOf->clustered, &tables->costs[BACKEND_CLUSTERED], tables->clusterPages, page, frame) != 0))
+	{
+		return -1;
+	}
+	invertedMap(tables, process, page, frame);
+
+	return 0;
+}
+
+void pageTablesUnmap(PageTables* tables, int process, unsigned long long page, int frame)
+{
+	ProcessTables* tablesOf = &tables->processes[process];
+
+	radixUnmap(tables, tablesOf, page);
+	hashedUnmap(&tablesOf->hashed, &tables->costs[BACKEND_HASHED], 1, page);
+	hashedUnmap(&tablesOf->clustered, &tables->costs[BACKEND_CLUSTERED], tables->clusterPages, page);
+	invertedUnmap(tables, process, page, frame);
+}
+
+/*************************************************************************
+*   @ End of Page tables                                                  *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Pagetable command                                                   *
+*                                                                         *
+*  Every reference is looked up in all back ends, then run through the    *
+*  engine, whose faults map the page into the victim's frame. Engine      *
+*  keys carry the process number above the page bits.                    *
+ *************************************************************************/
+
+/* With spreadPages, every aligned group of that many pages moves to a hashed place of the
+ * whole 64-bit address space, keeping the locality inside the group. */
+
+static inline unsigned long long spreadPage(unsigned long long page, unsigned long long spreadPages)
+{
+	unsigned long long groups = (1ULL << PAGETABLE_VPN_BITS) / spreadPages;
+
+	return (pageHash(page / spreadPages) % groups) * spreadPages + page % spreadPages;
+}
+
+static int pageTableSink(void* context, const PageRef* refs, size_t count)
+{
+	PageTableRun* run = (PageTableRun*)context;
+
+	for (size_t i = 0; (i < count) & (run->status == 0); i++)
+	{
+		PageRef            ref     = refs[i];
+		AccessResult       result;
+		int                frames[BACKEND_COUNT];
+		int                process = pageTablesProcess(&run->tables, ref.pid);
+		unsigned long long page    = ref.page & ((1ULL << PAGETABLE_VPN_BITS) - 1);
+
+		if (process == PAGETABLE_NONE)
+		{
+			printf("More than %d processes in the trace!\n", PAGETABLE_PROCESSES);
+			run->status = -1;
+			break;
+		}
+
+		if (run->spreadPages != 0)
+		{
+			page = spreadPage(page, run->spreadPages);
+		}
+
+		for (int backend = 0; backend < BACKEND_COUNT; backend++)
+		{
+			frames[backend] = pageTablesLookup(&run->tables, backend, process, page);
+		}
+
+		ref.page = ((unsigned long long)process << PAGETABLE_VPN_BITS) | page;
+
+		engineAccess(&run->engine, &ref, &result);
+
+		for (int backend = 0; backend < BACKEND_COUNT; backend++)
+		{
+			run->mismatches += frames[backend] != (result.fault ? PAGETABLE_NONE : result.frame);
+		}
+
+		if (result.fault)
+		{
+			if (result.evicted)
+			{
+				pageTablesUnmap(&run->tables, (int)(result.victimPage >> PAGETABLE_VPN_BITS),
+					result.victimPage & ((1ULL << PAGETABLE_VPN_BITS) - 1), result.frame);
+			}
+
+			if (pageTablesMap(&run->tables, process, page, result.frame) != 0)
+			{
+				printf("Not enough memory for the page tables!\n");
+				run->status = -1;
+			}
+		}
+	}
+
+	return run->status;
+}
+
+int runPageTableCommand(int argCount, char* args[])
+{
+	PageTableRun* run;
+	int           format       = argCount > 3 ? traceFormatFromName(args[1]) : TRACE_FORMAT_UNKNOWN;
+	int           framesNum    = argCount > 3 ? atoi(args[3]) : 0;
+	int           policy       = argCount > 4 ? policyFromName(args[4]) : POLICY_LRU;
+	long long     spreadPages  = argCount > 5 ? atoll(args[5]) : 0;
+	int           clusterPages = argCount > 6 ? atoi(args[6]) : CLUSTER_PAGES;
+	int           status;
+
+	if ((format == TRACE_FORMAT_UNKNOWN) | (framesNum < 1) | (policy < 0) | (spreadPages < 0) |
+		(spreadPages > (1LL << 40)) | (clusterPages < 1) | (clusterPages > RADIX_FANOUT))
+	{
+		printf("Usage: %s\n", PAGETABLE_USAGE);
+		return -1;
+	}
+
+	if (policy == POLICY_OPT)
+	{
+		printf("OPT needs the whole trace ahead, the page tables are fed one reference at a time!\n");
+		return -1;
+	}
+
+	run = (PageTableRun*)calloc(1, sizeof(PageTableRun));
+
+	if ((run == NULL) || (engineCreate(&run->engine, policy, framesNum) != 0))
+	{
+		printf("Not enough memory for %d frames!\n", framesNum);
+		free(run);
+		return -1;
+	}
+
+	if (pageTablesCreate(&run->tables, framesNum, clusterPages) != 0)
+	{
+		printf("Not enough memory for %d frames!\n", framesNum);
+		engineDestroy(&run->engine);
+		free(run);
+		return -1;
+	}
+
+	run->spreadPages = (unsigned long long)spreadPages;
+	status           = loadTrace(args[2], format, 0, pageTableSink, run);
+
+	if ((status == 0) & (run->status == 0))
+	{
+		int levels = 0;
+
+		for (int p = 0; p < run->tables.processesNum; p++)
+		{
+			if (run->tables.processes[p].levels > levels)
+			{
+				levels = run->tables.processes[p].levels;
+			}
+		}
+
+		printf("\n Trace %s: %llu references, %llu faults, %s, %d frames, %d processes, ", args[2],
+			run->engine.stats.references, run->engine.stats.faults, policyName(policy), framesNum,
+			run->tables.processesNum);
+
+		if (spreadPages != 0)
+		{
+			printf("groups of %lld pages spread over 64 bits\n", spreadPages);
+		}
+		else
+		{
+			printf("addresses as traced\n");
+		}
+		printf(" Radix trees of up to %d levels, clusters of %d pages\n\n", levels, clusterPages);
+
+		printf(" --------------------------------------------------------------------------------------\n");
+		printf("| Back end  |  Probes  |  Lines   |   Max    |   Peak KiB   |  Final KiB   | Bytes per |\n");
+		printf("|           | / lookup | / lookup |  probes  |              |              | resident  |\n");
+		printf(" --------------------------------------------------------------------------------------\n");
+
+		for (int backend = 0; backend < BACKEND_COUNT; backend++)
+		{
+			const TranslationCost* cost     = &run->tables.costs[backend];
+			double                 lookups  = cost->lookups ? (double)cost->lookups : 1.0;
+			int                    resident = run->engine.usedFrames > 0 ? run->engine.usedFrames : 1;
+
+			printf("| %-9s | %8.2f | %8.2f | %8llu | %12.1f | %12.1f | %9.1f |\n", backendName(backend),
+				cost->probes / lookups, cost->lines / lookups, cost->maxProbes, cost->peakBytes / 1024.0,
+				cost->bytes / 1024.0, (double)cost->bytes / resident);
+		}
+		printf(" --------------------------------------------------------------------------------------\n");
+
+		if (run->mismatches != 0)
+		{
+			printf(" %llu translations disagreed with the engine!\n", run->mismatches);
+		}
+	}
+
+	if (run->status != 0)
+	{
+		status = -1;
+	}
+
+	pageTablesDestroy(&run->tables);
+	engineDestroy(&run->engine);
+	free(run);
+
+	return status == 0 ? 0 : -1;
+}
+
+/*************************************************************************
+*   @ End of Pagetable command                                            *
+*                                                                         *
+ *************************************************************************/
@@ -0,0 +1,120 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: Address translation back ends for the pages a paging engine keeps resident: a
+ * per-process radix tree as in x86-64, per-process hashed page tables with one page per
+ * entry or a cluster of neighbouring pages per entry, and one global inverted page table
+ * with an entry per frame. Every lookup counts its memory probes and the cache lines they
+ * touch, and every table counts its memory, so sparse 64-bit address spaces can be
+ * compared where the frame-only model says nothing about translation.
+*/
+
+
+#ifndef PAGE_TABLES_H
+#define PAGE_TABLES_H
+
+#include "PagingEngine.h"
+
+#define PAGETABLE_USAGE      "pagetable <lackey|pin|csv|bin> <file> <frames> [policy] [spreadPages] [clusterPages]"
+#define PAGETABLE_PROCESSES  4096
+#define PAGETABLE_VPN_BITS   52      /* 64-bit virtual addresses of 4 KiB pages */
+#define PAGETABLE_LINE_SHIFT 6       /* 64 byte cache lines */
+#define PAGETABLE_MAX_LINES  64      /* distinct lines remembered per lookup */
+
+#define RADIX_BITS           9       /* 512 eight byte entries per 4 KiB node */
+#define RADIX_FANOUT         (1 << RADIX_BITS)
+#define RADIX_MIN_LEVELS     4       /* grown by a level when a higher page appears */
+#define RADIX_NODE_BYTES     4096
+
+#define HASHED_MIN_BUCKETS   64      /* doubled when there are more entries than buckets */
+#define CLUSTER_PAGES        16
+
+#define BACKEND_RADIX        0
+#define BACKEND_HASHED       1
+#define BACKEND_CLUSTERED    2
+#define BACKEND_INVERTED     3
+#define BACKEND_COUNT        4
+
+
+struct TranslationCost
+{
+	unsigned long long lookups;
+	unsigned long long probes;        /* entries read */
+	unsigned long long lines;         /* distinct cache lines of each lookup, summed */
+	unsigned long long maxProbes;
+	unsigned long long bytes;         /* table memory now */
+	unsigned long long peakBytes;
+};
+
+/* Interior entries point to the next level, leaf entries hold frame + 1; used counts the
+ * entries in use, so empty nodes are freed. */
+
+struct RadixNode
+{
+	unsigned long long entries[RADIX_FANOUT];
+	int                used;
+};
+
+/* One entry maps clusterPages aligned pages; the chained hashed table is a cluster of 1. */
+
+struct HashedNode
+{
+	unsigned long long tag;           /* page / clusterPages */
+	HashedNode*        next;
+	int                valid;
+	unsigned long long frames[1];     /* clusterPages entries of frame + 1 */
+};
+
+struct HashedTable
+{
+	HashedNode** buckets;
+	size_t       mask;
+	size_t       nodes;
+};
+
+struct InvertedEntry
+{
+	unsigned long long page;
+	unsigned int       process;
+	int                next;          /* next frame of the hash chain, -1 at the end */
+};
+
+struct ProcessTables
+{
+	RadixNode*  root;
+	int         levels;
+	HashedTable hashed;
+	HashedTable clustered;
+};
+
+struct PageTables
+{
+	int             framesNum;
+	int             clusterPages;
+	int             processesNum;
+	ProcessTables*  processes;
+	RadixNode*      freeNodes;        /* emptied radix nodes kept for reuse */
+	PageIndex       processIndex;     /* pid -> process number */
+	int*            anchors;          /* inverted table: first frame of each hash chain */
+	InvertedEntry*  inverted;         /* one entry per frame */
+	size_t          anchorMask;
+	TranslationCost costs[BACKEND_COUNT];
+};
+
+const char* backendName(int backend);
+
+int  pageTablesCreate(PageTables* tables, int framesNum, int clusterPages);
+void pageTablesDestroy(PageTables* tables);
+
+/* Number of the process with this pid, -1 beyond PAGETABLE_PROCESSES processes. */
+
+int  pageTablesProcess(PageTables* tables, unsigned int pid);
+
+/* Looks page up in one back end; returns its frame, or -1 when it is not mapped. */
+
+int  pageTablesLookup(PageTables* tables, int backend, int process, unsigned long long page);
+int  pageTablesMap(PageTables* tables, int process, unsigned long long page, int frame);
+void pageTablesUnmap(PageTables* tables, int process, unsigned long long page, int frame);
+
+int  runPageTableCommand(int argCount, char* args[]);
+
+#endif // !PAGE_TABLES_H
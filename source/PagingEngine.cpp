@@ -0,0 +1,709 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: PagingEngine.cpp contains the trace driven FIFO, LRU, LFU, CLOCK and OPT
+ * engines. Frames are filled in order like the menu simulations and victims are chosen
+ * with the same rules, but every step is O(1) or O(log frames).
+*/
+
+
+
+#include "PagingEngine.h"
+#include <string.h>
+
+
+/* Policy helpers. */
+
+static int  loadPage(PagingEngine* engine, unsigned long long page, AccessResult* result, int* filled);
+static int  chooseFrame(PagingEngine* engine);
+static void touchFrame(PagingEngine* engine, int frame, unsigned long long page, int filled);
+static void lruUnlink(PagingEngine* engine, int frame);
+static void lruPushMru(PagingEngine* engine, int frame);
+static void heapSiftUp(PagingEngine* engine, int slot);
+static void heapSiftDown(PagingEngine* engine, int slot);
+static int  heapBefore(const PagingEngine* engine, int a, int b);
+static void* engineAlloc(PagingEngine* engine, size_t bytes);
+
+static const char* policyNames[POLICY_COUNT] = { "FIFO", "LRU", "LFU", "CLOCK", "OPT" };
+
+
+/*************************************************************************
+*   @ Policy names                                                        *
+*                                                                         *
+ *************************************************************************/
+
+const char* policyName(int policy)
+{
+	return ((policy >= 0) & (policy < POLICY_COUNT)) ? policyNames[policy] : "?";
+}
+
+int policyFromName(const char* name)
+{
+	for (int policy = 0; policy < POLICY_COUNT; policy++)
+	{
+		const char* p = policyNames[policy];
+		const char* q = name;
+
+		while ((*p != '\0') && ((*q | 0x20) == (*p | 0x20)))
+		{
+			p++;
+			q++;
+		}
+
+		if ((*p == '\0') & (*q == '\0'))
+		{
+			return policy;
+		}
+	}
+
+	return -1;
+}
+
+/*************************************************************************
+*   @ End of Policy names                                                 *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Create / destroy                                                    *
+*                                                                         *
+*  Everything is allocated up front for framesNum frames; only the LFU    *
+*  usage table grows with the number of distinct pages, and inside an     *
+*  arena that growth is served from its blocks as well.                   *
+ *************************************************************************/
+
+/* Zeroed memory from the engine's arena or the heap. */
+
+static void* engineAlloc(PagingEngine* engine, size_t bytes)
+{
+	void* memory;
+
+	if (engine->arena == NULL)
+	{
+		return calloc(bytes, 1);
+	}
+
+	memory = arenaAlloc(engine->arena, bytes);
+
+	if (memory != NULL)
+	{
+		memset(memory, 0, bytes);
+	}
+
+	return memory;
+}
+
+int engineCreate(PagingEngine* engine, int policy, int framesNum)
+{
+	return engineCreateIn(engine, NULL, policy, framesNum);
+}
+
+/* Carves all engine state from arena when given; destroying such an engine frees nothing,
+ * the memory returns with the next arenaReset. */
+
+int engineCreateIn(PagingEngine* engine, Arena* arena, int policy, int framesNum)
+{
+	memset(engine, 0, sizeof(*engine));
+
+	if ((framesNum < 1) | (policy < 0) | (policy >= POLICY_COUNT))
+	{
+		return -1;
+	}
+
+	engine->policy     = policy;
+	engine->framesNum  = framesNum;
+	engine->mru        = -1;
+	engine->lru        = -1;
+	engine->arena      = arena;
+	engine->framePage  = (unsigned long long*)engineAlloc(engine, framesNum * sizeof(unsigned long long));
+	engine->referenced = (unsigned char*)engineAlloc(engine, framesNum);
+	engine->dirty      = (unsigned char*)engineAlloc(engine, framesNum);
+	engine->older      = (int*)engineAlloc(engine, framesNum * sizeof(int));
+	engine->newer      = (int*)engineAlloc(engine, framesNum * sizeof(int));
+	engine->heap       = (int*)engineAlloc(engine, framesNum * sizeof(int));
+	engine->heapSlot   = (int*)engineAlloc(engine, framesNum * sizeof(int));
+	engine->heapKey    = (unsigned long long*)engineAlloc(engine, framesNum * sizeof(unsigned long long));
+
+	if ((engine->framePage == NULL) | (engine->referenced == NULL) | (engine->dirty == NULL) |
+		(engine->older == NULL) |
+		(engine->newer == NULL) | (engine->heap == NULL) | (engine->heapSlot == NULL) |
+		(engine->heapKey == NULL) | (pageIndexInitIn(&engine->frames, arena, framesNum) != 0))
+	{
+		engineDestroy(engine);
+		return -1;
+	}
+
+	if ((policy == POLICY_LFU) && (pageIndexInitIn(&engine->usageFreq, arena, 1024) != 0))
+	{
+		engineDestroy(engine);
+		return -1;
+	}
+
+	return 0;
+}
+
+void engineDestroy(PagingEngine* engine)
+{
+	if (engine->arena == NULL)
+	{
+		free(engine->framePage);
+		free(engine->referenced);
+		free(engine->dirty);
+		free(engine->older);
+		free(engine->newer);
+		free(engine->heap);
+		free(engine->heapSlot);
+		free(engine->heapKey);
+	}
+	pageIndexFree(&engine->frames);
+	pageIndexFree(&engine->usageFreq);
+	memset(engine, 0, sizeof(*engine));
+}
+
+void engineSetFuture(PagingEngine* engine, const unsigned long long* nextUse)
+{
+	engine->nextUse = nextUse;
+}
+
+/* OPT resumed at trace position base: refs and nextUse start there, and the next use of
+ * every resident page is looked up again since the state saved earlier could not see it. */
+
+int engineResumeFuture(PagingEngine* engine, const PageRef* refs, size_t count, const unsigned long long* nextUse,
+	unsigned long long base)
+{
+	PageIndex pending;
+	size_t    i;
+
+	engine->nextUse    = nextUse;
+	engine->futureBase = base;
+
+	if (engine->policy != POLICY_OPT)
+	{
+		return 0;
+	}
+
+	if (pageIndexInit(&pending, engine->usedFrames) != 0)
+	{
+		return -1;
+	}
+
+	for (int frame = 0; frame < engine->usedFrames; frame++)
+	{
+		engine->heapKey[frame] = NEVER_USED;
+		pageIndexSet(&pending, engine->framePage[frame], (unsigned long long)frame);
+	}
+
+	for (i = 0; (i < count) && (pending.count > 0); i++)
+	{
+		unsigned long long frame;
+
+		if (pageIndexFind(&pending, refs[i].page, &frame))
+		{
+			engine->heapKey[frame] = i;
+			pageIndexRemove(&pending, refs[i].page);
+		}
+	}
+
+	for (int slot = engine->usedFrames / 2 - 1; slot >= 0; slot--)
+	{
+		heapSiftDown(engine, slot);
+	}
+
+	pageIndexFree(&pending);
+
+	return 0;
+}
+
+/*************************************************************************
+*   @ End of Create / destroy                                             *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Engine access                                                       *
+*                                                                         *
+*  One reference: hit -> policy bookkeeping only; miss -> fill the next   *
+*  empty frame, or evict the policy's victim once all frames are used.    *
+*  A write marks the frame dirty; a dirty victim counts as a write-back.  *
+*  Returns 1 on a page fault.                                             *
+ *************************************************************************/
+
+int engineAccess(PagingEngine* engine, const PageRef* ref, AccessResult* result)
+{
+	unsigned long long slot;
+	unsigned long long page = ref->page;
+	int                frame;
+	int                fault;
+	int                filled = 0;
+
+	if (engine->policy == POLICY_LFU)
+	{
+		unsigned long long* count = pageIndexSlot(&engine->usageFreq, page, NULL);
+
+		if (count != NULL)
+		{
+			(*count)++;
+		}
+	}
+
+	if (pageIndexFind(&engine->frames, page, &slot))
+	{
+		result->evicted     = 0;
+		result->victimPage  = 0;
+		result->victimDirty = 0;
+
+		frame = (int)slot;
+		fault = 0;
+	}
+	else
+	{
+		frame = loadPage(engine, page, result, &filled);
+		fault = 1;
+		engine->stats.faults++;
+	}
+
+	touchFrame(engine, frame, page, filled);
+	engine->dirty[frame] |= (ref->access == ACCESS_WRITE);
+	engine->stats.references++;
+
+	result->fault = fault;
+	result->frame = frame;
+
+	return fault;
+}
+
+/*************************************************************************
+*   @ End of Engine access                                                *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Engine insert                                                       *
+*                                                                         *
+*  Speculative load of a page that has not been referenced (prefetch).    *
+*  It takes a frame like a fault, but is neither a reference nor a fault  *
+*  and does not count as a use: CLOCK leaves it unreferenced, LFU keeps   *
+*  its usage count. OPT has no next use for it and should not be used.    *
+*  Returns 1 when the page was loaded, 0 when it was already resident.    *
+ *************************************************************************/
+
+int engineInsert(PagingEngine* engine, unsigned long long page, AccessResult* result)
+{
+	unsigned long long slot;
+	int                frame;
+	int                filled = 0;
+
+	result->fault = 0;
+
+	if (pageIndexFind(&engine->frames, page, &slot))
+	{
+		result->evicted     = 0;
+		result->victimPage  = 0;
+		result->victimDirty = 0;
+		result->frame       = (int)slot;
+		return 0;
+	}
+
+	frame = loadPage(engine, page, result, &filled);
+	touchFrame(engine, frame, page, filled);
+	engine->referenced[frame] = 0;
+
+	result->frame = frame;
+
+	return 1;
+}
+
+/*************************************************************************
+*   @ End of Engine insert                                                *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Engine admission                                                    *
+*                                                                         *
+*  engineVictim tells an admission filter which frame the next fault      *
+*  would take without changing any state (CLOCK's hand is not moved and   *
+*  no referenced bit is cleared): -1 while a frame is free. A rejected    *
+*  page goes through engineBypass, a fault that loads nothing; OPT's      *
+*  next uses stay in step since it still counts as a reference.           *
+ *************************************************************************/
+
+int engineVictim(const PagingEngine* engine)
+{
+	if (engine->usedFrames < engine->framesNum)
+	{
+		return -1;
+	}
+
+	switch (engine->policy)
+	{
+	case POLICY_FIFO:
+		return engine->hand;
+
+	case POLICY_CLOCK:
+		for (int i = 0; i < engine->framesNum; i++)
+		{
+			int frame = (engine->hand + i) % engine->framesNum;
+
+			if (!engine->referenced[frame])
+			{
+				return frame;
+			}
+		}
+		return engine->hand;
+
+	case POLICY_LRU:
+		return engine->lru;
+
+	default:
+		return engine->heap[0];
+	}
+}
+
+void engineBypass(PagingEngine* engine, const PageRef* ref)
+{
+	if (engine->policy == POLICY_LFU)
+	{
+		unsigned long long* count = pageIndexSlot(&engine->usageFreq, ref->page, NULL);
+
+		if (count != NULL)
+		{
+			(*count)++;
+		}
+	}
+
+	engine->stats.references++;
+	engine->stats.faults++;
+}
+
+/*************************************************************************
+*   @ End of Engine admission                                             *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Load page                                                           *
+*                                                                         *
+*  Puts a page that is not resident into the frame chosen by the policy,  *
+*  evicting its page first when all frames are used.                      *
+ *************************************************************************/
+
+static int loadPage(PagingEngine* engine, unsigned long long page, AccessResult* result, int* filled)
+{
+	int frame = chooseFrame(engine);
+
+	result->evicted     = 0;
+	result->victimPage  = 0;
+	result->victimDirty = 0;
+
+	if (frame < engine->usedFrames)
+	{
+		result->evicted     = 1;
+		result->victimPage  = engine->framePage[frame];
+		result->victimDirty = engine->dirty[frame];
+		pageIndexRemove(&engine->frames, engine->framePage[frame]);
+		engine->stats.evictions++;
+		engine->stats.writebacks += engine->dirty[frame];
+	}
+	else
+	{
+		engine->usedFrames++;
+		*filled = 1;
+	}
+
+	engine->framePage[frame] = page;
+	engine->dirty[frame]     = 0;
+	pageIndexSet(&engine->frames, page, (unsigned long long)frame);
+
+	return frame;
+}
+
+/*************************************************************************
+*   @ End of Load page                                                    *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Choose frame                                                        *
+*                                                                         *
+*  Returns usedFrames while an empty frame is left, otherwise the frame   *
+*  of the victim page. FIFO advances the same circular pointer as         *
+*  simulateFIFO; CLOCK gives referenced pages a second chance.            *
+ *************************************************************************/
+
+static int chooseFrame(PagingEngine* engine)
+{
+	int frame;
+
+	if (engine->usedFrames < engine->framesNum)
+	{
+		return engine->usedFrames;
+	}
+
+	switch (engine->policy)
+	{
+	case POLICY_FIFO:
+		frame        = engine->hand;
+		engine->hand = (engine->hand + 1) % engine->framesNum;
+		break;
+
+	case POLICY_CLOCK:
+		while (engine->referenced[engine->hand])
+		{
+			engine->referenced[engine->hand] = 0;
+			engine->hand = (engine->hand + 1) % engine->framesNum;
+		}
+		frame        = engine->hand;
+		engine->hand = (engine->hand + 1) % engine->framesNum;
+		break;
+
+	case POLICY_LRU:
+		frame = engine->lru;
+		break;
+
+	default:
+		frame = engine->heap[0];
+		break;
+	}
+
+	return frame;
+}
+
+/*************************************************************************
+*   @ End of Choose frame                                                 *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Touch frame                                                         *
+*                                                                         *
+*  Policy bookkeeping after page has been referenced in frame. A frame    *
+*  that was just filled is not yet in the LRU list or the heap.           *
+ *************************************************************************/
+
+static void touchFrame(PagingEngine* engine, int frame, unsigned long long page, int filled)
+{
+	unsigned long long key = 0;
+	int                slot;
+
+	switch (engine->policy)
+	{
+	case POLICY_CLOCK:
+		engine->referenced[frame] = 1;
+		break;
+
+	case POLICY_LRU:
+		if (engine->mru != frame)
+		{
+			if (!filled)
+			{
+				lruUnlink(engine, frame);
+			}
+			lruPushMru(engine, frame);
+		}
+		break;
+
+	case POLICY_LFU:
+	case POLICY_OPT:
+		if (engine->policy == POLICY_LFU)
+		{
+			pageIndexFind(&engine->usageFreq, page, &key);
+		}
+		else if (engine->nextUse != NULL)
+		{
+			key = engine->nextUse[engine->stats.references - engine->futureBase];
+		}
+
+		if (filled)
+		{
+			slot = engine->usedFrames - 1;
+			engine->heap[slot]      = frame;
+			engine->heapSlot[frame] = slot;
+		}
+		engine->heapKey[frame] = key;
+		heapSiftUp(engine, engine->heapSlot[frame]);
+		heapSiftDown(engine, engine->heapSlot[frame]);
+		break;
+	}
+}
+
+/*************************************************************************
+*   @ End of Touch frame                                                  *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ LRU list                                                            *
+*                                                                         *
+*  Frames linked from the most to the least recently used page.           *
+ *************************************************************************/
+
+static void lruUnlink(PagingEngine* engine, int frame)
+{
+	int older = engine->older[frame];
+	int newer = engine->newer[frame];
+
+	if (newer != -1)
+	{
+		engine->older[newer] = older;
+	}
+	else
+	{
+		engine->mru = older;
+	}
+
+	if (older != -1)
+	{
+		engine->newer[older] = newer;
+	}
+	else
+	{
+		engine->lru = newer;
+	}
+}
+
+static void lruPushMru(PagingEngine* engine, int frame)
+{
+	engine->older[frame] = engine->mru;
+	engine->newer[frame] = -1;
+
+	if (engine->mru != -1)
+	{
+		engine->newer[engine->mru] = frame;
+	}
+	else
+	{
+		engine->lru = frame;
+	}
+	engine->mru = frame;
+}
+
+/*************************************************************************
+*   @ End of LRU list                                                     *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Victim heap                                                         *
+*                                                                         *
+*  LFU keeps the least used page on top, OPT the page used farthest in    *
+*  the future. Ties go to the lowest frame, as in the menu simulations.   *
+ *************************************************************************/
+
+static int heapBefore(const PagingEngine* engine, int a, int b)
+{
+	unsigned long long keyA = engine->heapKey[a];
+	unsigned long long keyB = engine->heapKey[b];
+
+	if (keyA != keyB)
+	{
+		return engine->policy == POLICY_LFU ? keyA < keyB : keyA > keyB;
+	}
+	return a < b;
+}
+
+static void heapSiftUp(PagingEngine* engine, int slot)
+{
+	int frame = engine->heap[slot];
+
+	while (slot > 0)
+	{
+		int parent = (slot - 1) / 2;
+
+		if (!heapBefore(engine, frame, engine->heap[parent]))
+		{
+			break;
+		}
+		engine->heap[slot] = engine->heap[parent];
+		engine->heapSlot[engine->heap[slot]] = slot;
+		slot = parent;
+	}
+
+	engine->heap[slot]      = frame;
+	engine->heapSlot[frame] = slot;
+}
+
+static void heapSiftDown(PagingEngine* engine, int slot)
+{
+	int frame = engine->heap[slot];
+	int size  = engine->usedFrames;
+
+	for (;;)
+	{
+		int child = slot * 2 + 1;
+
+		if (child >= size)
+		{
+			break;
+		}
+		if ((child + 1 < size) && heapBefore(engine, engine->heap[child + 1], engine->heap[child]))
+		{
+			child++;
+		}
+		if (!heapBefore(engine, engine->heap[child], frame))
+		{
+			break;
+		}
+		engine->heap[slot] = engine->heap[child];
+		engine->heapSlot[engine->heap[slot]] = slot;
+		slot = child;
+	}
+
+	engine->heap[slot]      = frame;
+	engine->heapSlot[frame] = slot;
+}
+
+/*************************************************************************
+*   @ End of Victim heap                                                  *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Compute next use                                                    *
+*                                                                         *
+*  Backward pass over an in-memory trace: nextUse[i] is the position of   *
+*  the next reference to the page of refs[i], or NEVER_USED.              *
+ *************************************************************************/
+
+int computeNextUse(const PageRef* refs, size_t count, unsigned long long* nextUse)
+{
+	PageIndex lastSeen;
+
+	if (pageIndexInit(&lastSeen, 1024) != 0)
+	{
+		return -1;
+	}
+
+	for (size_t i = count; i-- > 0;)
+	{
+		int                 created;
+		unsigned long long* seen = pageIndexSlot(&lastSeen, refs[i].page, &created);
+
+		if (seen == NULL)
+		{
+			pageIndexFree(&lastSeen);
+			return -1;
+		}
+
+		nextUse[i] = created ? NEVER_USED : *seen;
+		*seen      = i;
+	}
+
+	pageIndexFree(&lastSeen);
+
+	return 0;
+}
+
+/*************************************************************************
+*   @ End of Compute next use                                             *
+*                                                                         *
+ *************************************************************************/
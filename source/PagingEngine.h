@@ -0,0 +1,82 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: Trace driven paging engines. Unlike the step by step simulations of the menu,
+ * an engine consumes one page reference at a time, has no limit on page numbers or trace
+ * length and only keeps the per-frame state its policy needs.
+*/
+
+
+#ifndef PAGING_ENGINE_H
+#define PAGING_ENGINE_H
+
+#include "Trace.h"
+#include "PageIndex.h"
+
+#define POLICY_FIFO   0
+#define POLICY_LRU    1
+#define POLICY_LFU    2
+#define POLICY_CLOCK  3
+#define POLICY_OPT    4
+#define POLICY_COUNT  5
+
+#define NEVER_USED    0xFFFFFFFFFFFFFFFFULL
+
+
+struct EngineStats
+{
+	unsigned long long references;
+	unsigned long long faults;
+	unsigned long long evictions;
+	unsigned long long writebacks;    /* evicted pages that were dirty */
+};
+
+struct AccessResult
+{
+	int                fault;
+	int                frame;
+	int                evicted;
+	unsigned long long victimPage;
+	int                victimDirty;
+};
+
+struct PagingEngine
+{
+	int                       policy;
+	int                       framesNum;
+	int                       usedFrames;
+	int                       hand;          /* FIFO / CLOCK */
+	unsigned long long*       framePage;
+	unsigned char*            referenced;    /* CLOCK */
+	unsigned char*            dirty;         /* written since it was loaded */
+	int*                      older;         /* LRU: neighbour towards the LRU end */
+	int*                      newer;         /* LRU: neighbour towards the MRU end */
+	int                       mru;
+	int                       lru;
+	int*                      heap;          /* LFU / OPT: frames ordered by heapKey */
+	int*                      heapSlot;
+	unsigned long long*       heapKey;       /* LFU: usage count, OPT: next use */
+	PageIndex                 frames;        /* resident page -> frame */
+	PageIndex                 usageFreq;     /* LFU: page -> usage count, never reset */
+	const unsigned long long* nextUse;       /* OPT: next position of each reference */
+	unsigned long long        futureBase;    /* OPT: trace position of nextUse[0] */
+	EngineStats               stats;
+	Arena*                    arena;         /* owner of the arrays, NULL for malloc */
+};
+
+const char* policyName(int policy);
+int         policyFromName(const char* name);
+
+int  engineCreate(PagingEngine* engine, int policy, int framesNum);
+int  engineCreateIn(PagingEngine* engine, Arena* arena, int policy, int framesNum);
+void engineDestroy(PagingEngine* engine);
+void engineSetFuture(PagingEngine* engine, const unsigned long long* nextUse);
+int  engineResumeFuture(PagingEngine* engine, const PageRef* refs, size_t count, const unsigned long long* nextUse,
+	unsigned long long base);
+int  engineAccess(PagingEngine* engine, const PageRef* ref, AccessResult* result);
+int  engineInsert(PagingEngine* engine, unsigned long long page, AccessResult* result);
+int  engineVictim(const PagingEngine* engine);
+void engineBypass(PagingEngine* engine, const PageRef* ref);
+
+int  computeNextUse(const PageRef* refs, size_t count, unsigned long long* nextUse);
+
+#endif // !PAGING_ENGINE_H
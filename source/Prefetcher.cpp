@@ -0,0 +1,459 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: Prefetcher.cpp contains the sequential readahead, stride and Markov prefetchers
+ * and the prefetch command.
+ *
+ * Prefetchers are trained on trigger events: demand faults and the first reference to a
+ * page they loaded (a fault the prefetch avoided), so a stream that is fully covered by
+ * prefetching keeps being followed. Prefetched pages are tracked until they are either
+ * referenced (useful) or evicted unreferenced (wasted).
+*/
+
+
+
+#include "Prefetcher.h"
+#include "TraceParser.h"
+#include <string.h>
+
+
+static void prefetchTrigger(Prefetcher* prefetcher, PagingEngine* engine, unsigned long long page, int covered);
+static void prefetchLoad(Prefetcher* prefetcher, PagingEngine* engine, unsigned long long page);
+static void prefetchForget(Prefetcher* prefetcher, unsigned long long page);
+static void markovLearn(Prefetcher* prefetcher, unsigned long long from, unsigned long long page);
+
+static const char* prefetcherNames[PREFETCH_COUNT] = { "none", "seq", "stride", "markov" };
+static const int   defaultDegrees[PREFETCH_COUNT]  = { 0, 32, 4, 2 };
+
+
+/* Engines fed by one pass over a trace, one per prefetcher. */
+
+struct PrefetchRun
+{
+	PagingEngine engines[PREFETCH_COUNT];
+	Prefetcher   prefetchers[PREFETCH_COUNT];
+	int          runsNum;
+};
+
+
+/*************************************************************************
+*   @ Create / destroy                                                    *
+*                                                                         *
+ *************************************************************************/
+
+const char* prefetcherName(int kind)
+{
+	return ((kind >= 0) & (kind < PREFETCH_COUNT)) ? prefetcherNames[kind] : "?";
+}
+
+int prefetcherCreate(Prefetcher* prefetcher, int kind, int degree)
+{
+	memset(prefetcher, 0, sizeof(*prefetcher));
+
+	if ((kind < 0) | (kind >= PREFETCH_COUNT))
+	{
+		return -1;
+	}
+
+	prefetcher->kind   = kind;
+	prefetcher->degree = degree > 0 ? degree : defaultDegrees[kind];
+
+	if ((kind == PREFETCH_MARKOV) && (prefetcher->degree > PREFETCH_MARKOV_WAYS))
+	{
+		prefetcher->degree = PREFETCH_MARKOV_WAYS;
+	}
+
+	if ((pageIndexInit(&prefetcher->pending, 64) != 0) |
+		((kind == PREFETCH_MARKOV) && (pageIndexInit(&prefetcher->entries, 1024) != 0)))
+	{
+		prefetcherDestroy(prefetcher);
+		return -1;
+	}
+
+	return 0;
+}
+
+void prefetcherDestroy(Prefetcher* prefetcher)
+{
+	pageIndexFree(&prefetcher->pending);
+	pageIndexFree(&prefetcher->entries);
+	free(prefetcher->successors);
+	memset(prefetcher, 0, sizeof(*prefetcher));
+}
+
+/*************************************************************************
+*   @ End of Create / destroy                                             *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Prefetcher access                                                   *
+*                                                                         *
+*  Demand reference through the engine, then prefetching when the        *
+*  reference was a trigger event. Returns 1 on a page fault.              *
+ *************************************************************************/
+
+int prefetcherAccess(Prefetcher* prefetcher, PagingEngine* engine, const PageRef* ref)
+{
+	AccessResult result;
+	int          covered = 0;
+
+	engineAccess(engine, ref, &result);
+
+	if (result.evicted)
+	{
+		prefetchForget(prefetcher, result.victimPage);
+	}
+
+	if (!result.fault && (prefetcher->pending.count > 0) && pageIndexRemove(&prefetcher->pending, ref->page))
+	{
+		prefetcher->stats.useful++;
+		covered = 1;
+	}
+
+	if ((result.fault | covered) && (prefetcher->kind != PREFETCH_NONE))
+	{
+		prefetchTrigger(prefetcher, engine, ref->page, covered);
+	}
+
+	return result.fault;
+}
+
+static void prefetchLoad(Prefetcher* prefetcher, PagingEngine* engine, unsigned long long page)
+{
+	AccessResult result;
+
+	if (engineInsert(engine, page, &result))
+	{
+		prefetcher->stats.issued++;
+		pageIndexSet(&prefetcher->pending, page, 1);
+
+		if (result.evicted)
+		{
+			prefetcher->stats.extraEvictions++;
+			prefetchForget(prefetcher, result.victimPage);
+		}
+	}
+}
+
+static void prefetchForget(Prefetcher* prefetcher, unsigned long long page)
+{
+	if ((prefetcher->pending.count > 0) && pageIndexRemove(&prefetcher->pending, page))
+	{
+		prefetcher->stats.wasted++;
+	}
+}
+
+/*************************************************************************
+*   @ End of Prefetcher access                                            *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Trigger                                                             *
+*                                                                         *
+*  seq:    a fault right after the previous trigger starts a readahead    *
+*          window, which doubles up to degree pages while the stream is   *
+*          followed; once half of it has been used the next window is     *
+*          read ahead. A fault elsewhere ends the stream.                 *
+*  stride: the same distance between three triggers in a row prefetches   *
+*          degree pages further along that stride.                        *
+*  markov: prefetches the pages that followed this page the last times    *
+*          it was a trigger.                                              *
+ *************************************************************************/
+
+static void prefetchTrigger(Prefetcher* prefetcher, PagingEngine* engine, unsigned long long page, int covered)
+{
+	unsigned long long last = prefetcher->lastTrigger;
+	int                first = !prefetcher->triggered;
+
+	prefetcher->lastTrigger = page;
+	prefetcher->triggered   = 1;
+
+	switch (prefetcher->kind)
+	{
+	case PREFETCH_SEQUENTIAL:
+		if (!covered)
+		{
+			if (first || (page != last + 1))
+			{
+				prefetcher->window = 0;
+				break;
+			}
+			prefetcher->window = prefetcher->window * 2 > PREFETCH_MIN_WINDOW ? prefetcher->window * 2 : PREFETCH_MIN_WINDOW;
+			prefetcher->next   = page + 1;
+		}
+		else if ((prefetcher->window == 0) || (page + prefetcher->window / 2 < prefetcher->next))
+		{
+			break;
+		}
+		else
+		{
+			prefetcher->window *= 2;
+		}
+
+		if (prefetcher->window > prefetcher->degree)
+		{
+			prefetcher->window = prefetcher->degree;
+		}
+
+		for (int i = 0; i < prefetcher->window; i++)
+		{
+			prefetchLoad(prefetcher, engine, prefetcher->next++);
+		}
+		break;
+
+	case PREFETCH_STRIDE:
+		if (!first && (page != last))
+		{
+			long long stride = (long long)(page - last);
+
+			if (stride == prefetcher->stride)
+			{
+				prefetcher->confidence++;
+			}
+			else
+			{
+				prefetcher->stride     = stride;
+				prefetcher->confidence = 0;
+			}
+		}
+
+		if (prefetcher->confidence > 0)
+		{
+			unsigned long long target = page;
+
+			for (int i = 0; i < prefetcher->degree; i++)
+			{
+				target += (unsigned long long)prefetcher->stride;
+
+				if ((prefetcher->stride < 0) ? (target > page) : (target < page))
+				{
+					break;
+				}
+				prefetchLoad(prefetcher, engine, target);
+			}
+		}
+		break;
+
+	case PREFETCH_MARKOV:
+	{
+		unsigned long long entry;
+
+		if (!first && (page != last))
+		{
+			markovLearn(prefetcher, last, page);
+		}
+
+		if (pageIndexFind(&prefetcher->entries, page, &entry))
+		{
+			unsigned long long* ways = &prefetcher->successors[entry * PREFETCH_MARKOV_WAYS];
+
+			for (int i = 0; (i < prefetcher->degree) && (ways[i] != NEVER_USED); i++)
+			{
+				prefetchLoad(prefetcher, engine, ways[i]);
+			}
+		}
+		break;
+	}
+	}
+}
+
+/* Moves page to the front of the successors of from. */
+
+static void markovLearn(Prefetcher* prefetcher, unsigned long long from, unsigned long long page)
+{
+	int                 created;
+	unsigned long long* entry = pageIndexSlot(&prefetcher->entries, from, &created);
+	unsigned long long* ways;
+	int                 i;
+
+	if (entry == NULL)
+	{
+		return;
+	}
+
+	if (created)
+	{
+		if (prefetcher->entriesNum == prefetcher->entriesCapacity)
+		{
+			size_t              capacity = prefetcher->entriesCapacity ? prefetcher->entriesCapacity * 2 : 1024;
+			unsigned long long* grown    = (unsigned long long*)realloc(prefetcher->successors,
+				capacity * PREFETCH_MARKOV_WAYS * sizeof(unsigned long long));
+
+			if (grown == NULL)
+			{
+				pageIndexRemove(&prefetcher->entries, from);
+				return;
+			}
+			prefetcher->successors      = grown;
+			prefetcher->entriesCapacity = capacity;
+		}
+
+		*entry = prefetcher->entriesNum++;
+		ways   = &prefetcher->successors[*entry * PREFETCH_MARKOV_WAYS];
+
+		for (i = 0; i < PREFETCH_MARKOV_WAYS; i++)
+		{
+			ways[i] = NEVER_USED;
+		}
+	}
+
+	ways = &prefetcher->successors[*entry * PREFETCH_MARKOV_WAYS];
+
+	for (i = 0; (i < PREFETCH_MARKOV_WAYS - 1) && (ways[i] != page); i++)
+	{
+	}
+
+	for (; i > 0; i--)
+	{
+		ways[i] = ways[i - 1];
+	}
+	ways[0] = page;
+}
+
+/*************************************************************************
+*   @ End of Trigger                                                      *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Prefetch command                                                    *
+*                                                                         *
+*  Runs the policy without prefetching and with each selected prefetcher  *
+*  side by side over one pass of the trace. Accuracy is the share of      *
+*  prefetched pages that were used, coverage the share of the misses      *
+*  (faults plus used prefetches) that prefetching served. Degrees are     *
+*  capped at half of the frames.                                          *
+ *************************************************************************/
+
+static int prefetchRunSink(void* context, const PageRef* refs, size_t count)
+{
+	PrefetchRun* run = (PrefetchRun*)context;
+
+	for (int r = 0; r < run->runsNum; r++)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			prefetcherAccess(&run->prefetchers[r], &run->engines[r], &refs[i]);
+		}
+	}
+
+	return 0;
+}
+
+int runPrefetchCommand(int argCount, char* args[])
+{
+	PrefetchRun run;
+	int         format;
+	int         framesNum;
+	int         policy;
+	int         selected = PREFETCH_COUNT;
+	int         degree;
+	int         status;
+
+	if (argCount < 5)
+	{
+		printf("Usage: %s\n", PREFETCH_USAGE);
+		return -1;
+	}
+
+	format    = traceFormatFromName(args[1]);
+	framesNum = atoi(args[3]);
+	policy    = policyFromName(args[4]);
+	degree    = argCount > 6 ? atoi(args[6]) : 0;
+
+	if ((argCount > 5) && (strcmp(args[5], "all") != 0))
+	{
+		selected = -1;
+
+		for (int kind = PREFETCH_SEQUENTIAL; kind < PREFETCH_COUNT; kind++)
+		{
+			if (strcmp(args[5], prefetcherNames[kind]) == 0)
+			{
+				selected = kind;
+			}
+		}
+	}
+
+	if ((format == TRACE_FORMAT_UNKNOWN) | (framesNum < 1) | (policy < 0) | (selected < 0))
+	{
+		printf("Usage: %s\n", PREFETCH_USAGE);
+		return -1;
+	}
+
+	if (policy == POLICY_OPT)
+	{
+		printf("OPT knows no future for prefetched pages; choose another policy!\n");
+		return -1;
+	}
+
+	run.runsNum = 0;
+
+	for (int kind = 0; kind < PREFETCH_COUNT; kind++)
+	{
+		if ((kind != PREFETCH_NONE) & (selected != PREFETCH_COUNT) & (selected != kind))
+		{
+			continue;
+		}
+
+		int kindDegree = degree > 0 ? degree : defaultDegrees[kind];
+
+		if (kindDegree > framesNum / 2)
+		{
+			kindDegree = framesNum / 2 > 0 ? framesNum / 2 : 1;
+		}
+
+		if ((engineCreate(&run.engines[run.runsNum], policy, framesNum) != 0) |
+			(prefetcherCreate(&run.prefetchers[run.runsNum], kind, kindDegree) != 0))
+		{
+			printf("Not enough memory for %d frames!\n", framesNum);
+
+			for (int r = 0; r <= run.runsNum; r++)
+			{
+				engineDestroy(&run.engines[r]);
+				prefetcherDestroy(&run.prefetchers[r]);
+			}
+			return -1;
+		}
+		run.runsNum++;
+	}
+
+	status = loadTrace(args[2], format, 0, prefetchRunSink, &run);
+
+	if (status == 0)
+	{
+		printf("\n Trace %s: %llu references, %d frames, %s\n\n", args[2], run.engines[0].stats.references,
+			framesNum, policyName(policy));
+		printf(" ------------------------------------------------------------------------------------\n");
+		printf("| Prefetch |     Faults     |     Issued     | Accuracy | Coverage | Extra evictions |\n");
+		printf(" ------------------------------------------------------------------------------------\n");
+
+		for (int r = 0; r < run.runsNum; r++)
+		{
+			PrefetchStats*     stats  = &run.prefetchers[r].stats;
+			unsigned long long faults = run.engines[r].stats.faults;
+
+			printf("| %-8s | %14llu | %14llu | %7.1f%% | %7.1f%% | %15llu |\n", prefetcherName(run.prefetchers[r].kind),
+				faults, stats->issued, stats->issued ? 100.0 * (double)stats->useful / (double)stats->issued : 0.0,
+				faults + stats->useful ? 100.0 * (double)stats->useful / (double)(faults + stats->useful) : 0.0,
+				stats->extraEvictions);
+		}
+		printf(" ------------------------------------------------------------------------------------\n");
+	}
+
+	for (int r = 0; r < run.runsNum; r++)
+	{
+		engineDestroy(&run.engines[r]);
+		prefetcherDestroy(&run.prefetchers[r]);
+	}
+
+	return status == 0 ? 0 : -1;
+}
+
+/*************************************************************************
+*   @ End of Prefetch command                                             *
+*                                                                         *
+ *************************************************************************/
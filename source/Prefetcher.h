@@ -0,0 +1,67 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: Prefetchers layered on the paging engines. A prefetcher watches the faults
+ * (and the first use of pages it loaded itself) and issues speculative loads into the
+ * engine, whatever its replacement policy.
+*/
+
+
+#ifndef PREFETCHER_H
+#define PREFETCHER_H
+
+#include "PagingEngine.h"
+
+#define PREFETCH_USAGE        "prefetch <lackey|pin|csv|bin> <file> <frames> <policy> [seq|stride|markov|all] [degree]"
+
+#define PREFETCH_NONE         0
+#define PREFETCH_SEQUENTIAL   1
+#define PREFETCH_STRIDE       2
+#define PREFETCH_MARKOV       3
+#define PREFETCH_COUNT        4
+
+#define PREFETCH_MIN_WINDOW   4
+#define PREFETCH_MARKOV_WAYS  4
+
+
+struct PrefetchStats
+{
+	unsigned long long issued;
+	unsigned long long useful;            /* prefetched pages referenced before eviction */
+	unsigned long long wasted;            /* prefetched pages evicted without a reference */
+	unsigned long long extraEvictions;    /* evictions caused by prefetched pages */
+};
+
+struct Prefetcher
+{
+	int                 kind;
+	int                 degree;           /* sequential: largest window, others: pages per trigger */
+	PageIndex           pending;          /* prefetched pages not referenced yet */
+	unsigned long long  lastTrigger;
+	int                 triggered;
+
+	/* Sequential readahead. */
+	unsigned long long  next;             /* first page after the current window */
+	int                 window;
+
+	/* Stride. */
+	long long           stride;
+	int                 confidence;
+
+	/* Markov: page -> entry of its most recent successors, newest first. */
+	PageIndex           entries;
+	unsigned long long* successors;
+	size_t              entriesNum;
+	size_t              entriesCapacity;
+
+	PrefetchStats       stats;
+};
+
+const char* prefetcherName(int kind);
+
+int  prefetcherCreate(Prefetcher* prefetcher, int kind, int degree);
+void prefetcherDestroy(Prefetcher* prefetcher);
+int  prefetcherAccess(Prefetcher* prefetcher, PagingEngine* engine, const PageRef* ref);
+
+int  runPrefetchCommand(int argCount, char* args[]);
+
+#endif // !PREFETCHER_H
@@ -0,0 +1,544 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: Replay.cpp contains the time driven replay and the replay command.
+ *
+ * Every thread issues its references in trace order, each one at its arrival time or,
+ * while the thread was blocked, as soon as its previous reference completed. The threads
+ * sit in a heap by issue time, so the engine sees the references in simulated time order
+ * and a thread stalled on a fault lets the others run ahead. A fault first writes back a
+ * dirty victim and reads its page once that write-back completed, each on the device that
+ * frees first; a hit on a page that is still being read waits for that read.
+*/
+
+
+
+#include "Replay.h"
+#include "TraceParser.h"
+#include <string.h>
+
+#define REPLAY_NONE          ((size_t)-1)
+
+
+/* Per run scheduling state; threads are numbered from 0. */
+
+struct ReplayState
+{
+	const PageRef*      refs;
+	size_t              count;
+	int                 clocked;      /* arrivals from the trace timestamps, else gapNs apart */
+	unsigned long long  base;         /* earliest timestamp */
+	unsigned long long  gapNs;
+	int                 threadsNum;
+	size_t*             next;         /* next reference of the same thread */
+	size_t*             head;         /* next reference of each thread to issue */
+	size_t*             tail;
+	unsigned long long* issueAt;      /* issue time of each thread's head */
+	int*                heap;         /* threads by issue time */
+	unsigned long long* deviceFree;   /* min-heap of the times the devices free */
+	unsigned long long* frameReady;   /* completion of the read that loaded each frame */
+};
+
+
+static void               replayLink(ReplayState* state, const PageIndex* pids, int streams);
+static void               replaySchedule(ReplayState* state, PagingEngine* engine, const ReplayConfig* config,
+	ReplayStats* stats);
+static void               replayHeapDown(ReplayState* state, int count, int position);
+static unsigned long long replayDevice(unsigned long long* deviceFree, int devices, unsigned long long issue,
+	unsigned long long serviceNs);
+static unsigned long long replayPercentile(const unsigned long long* sorted, unsigned long long count, double share);
+static int                compareLatencies(const void* a, const void* b);
+
+
+/*************************************************************************
+*   @ Replay                                                              *
+*                                                                         *
+ *************************************************************************/
+
+void replayConfigDefaults(ReplayConfig* config)
+{
+	config->readNs  = 100000;
+	config->writeNs = 100000;
+	config->devices = 4;
+	config->gapNs   = 1000;
+	config->hitNs   = 100;
+	config->threads = 0;
+	config->sloNs   = 1000000;
+}
+
+int replayRun(const TraceBuffer* buffer, int policy, int framesNum, const ReplayConfig* config,
+	ReplayStats* stats)
+{
+	ReplayState  state;
+	PagingEngine engine;
+	PageIndex    pids;
+	int          threadsNum = config->threads;
+	int          created;
+	int          status     = 0;
+
+	memset(stats, 0, sizeof(*stats));
+	memset(&state, 0, sizeof(state));
+	memset(&pids, 0, sizeof(pids));
+
+	if ((policy == POLICY_OPT) | (config->devices < 1) | (config->devices > REPLAY_MAX_DEVICES) ||
+		(engineCreate(&engine, policy, framesNum) != 0))
+	{
+		return -1;
+	}
+
+	/* Threads: round robin streams, or one per pid in order of first appearance. */
+
+	if (threadsNum < 1)
+	{
+		status = pageIndexInit(&pids, 64);
+
+		for (size_t i = 0; (i < buffer->count) & (status == 0); i++)
+		{
+			unsigned long long* slot = pageIndexSlot(&pids, buffer->refs[i].pid, &created);
+
+			if (slot == NULL)
+			{
+				status = -1;
+			}
+			else if (created)
+			{
+				*slot = (unsigned long long)threadsNum++;
+			}
+		}
+	}
+
+	state.refs       = buffer->refs;
+	state.count      = buffer->count;
+	state.base       = NEVER_USED;
+	state.gapNs      = config->gapNs;
+	state.threadsNum = threadsNum;
+
+	for (size_t i = 0; i < buffer->count; i++)
+	{
+		state.clocked |= buffer->refs[i].time != 0;
+		state.base     = buffer->refs[i].time < state.base ? buffer->refs[i].time : state.base;
+	}
+
+	state.next       = (size_t*)malloc((buffer->count + 1) * sizeof(size_t));
+	state.head       = (size_t*)malloc((threadsNum + 1) * sizeof(size_t));
+	state.tail       = (size_t*)malloc((threadsNum + 1) * sizeof(size_t));
+	state.issueAt    = (unsigned long long*)calloc(threadsNum + 1, sizeof(unsigned long long));
+	state.heap       = (int*)malloc((threadsNum + 1) * sizeof(int));
+	state.deviceFree = (unsigned long long*)calloc(config->devices, sizeof(unsigned long long));
+	state.frameReady = (unsigned long long*)calloc(framesNum, sizeof(unsigned long long));
+
+	stats->faultLatency = (unsigned long long*)malloc((buffer->count + 1) * sizeof(unsigned long long));
+	stats->response     = (unsigned long long*)malloc((buffer->count + 1) * sizeof(unsigned long long));
+
+	if ((status != 0) | (state.next == NULL) | (state.head == NULL) | (state.tail == NULL) |
+		(state.issueAt == NULL) | (state.heap == NULL) | (state.deviceFree == NULL) | (state.frameReady == NULL) |
+		(stats->faultLatency == NULL) | (stats->response == NULL))
+	{
+		status = -1;
+	}
+	else
+	{
+		replayLink(&state, &pids, config->threads);
+		replaySchedule(&state, &engine, config, stats);
+
+		qsort(stats->faultLatency, stats->faults, sizeof(unsigned long long), compareLatencies);
+		qsort(stats->response, stats->references, sizeof(unsigned long long), compareLatencies);
+	}
+
+	free(state.next);
+	free(state.head);
+	free(state.tail);
+	free(state.issueAt);
+	free(state.heap);
+	free(state.deviceFree);
+	free(state.frameReady);
+	pageIndexFree(&pids);
+	engineDestroy(&engine);
+
+	if (status != 0)
+	{
+		replayStatsFree(stats);
+	}
+
+	return status;
+}
+
+static inline unsigned long long replayArrival(const ReplayState* state, size_t i)
+{
+	return state->clocked ? state->refs[i].time - state->base : i * state->gapNs;
+}
+
+/* Links every reference to the next one of its thread. */
+
+static void replayLink(ReplayState* state, const PageIndex* pids, int streams)
+{
+	unsigned long long thread;
+
+	for (int t = 0; t < state->threadsNum; t++)
+	{
+		state->head[t] = REPLAY_NONE;
+	}
+
+	for (size_t i = 0; i < state->count; i++)
+	{
+		if (streams > 0)
+		{
+			thread = i % (size_t)streams;
+		}
+		else
+		{
+			pageIndexFind(pids, state->refs[i].pid, &thread);
+		}
+
+		state->next[i] = REPLAY_NONE;
+
+		if (state->head[thread] == REPLAY_NONE)
+		{
+			state->head[thread] = i;
+		}
+		else
+		{
+			state->next[state->tail[thread]] = i;
+		}
+		state->tail[thread] = i;
+	}
+}
+
+/* The heap holds the threads with references left, earliest issue time on top. */
+
+static void replaySchedule(ReplayState* state, PagingEngine* engine, const ReplayConfig* config, ReplayStats* stats)
+{
+	AccessResult result;
+	int          heapNum = 0;
+
+	for (int t = 0; t < state->threadsNum; t++)
+	{
+		if (state->head[t] != REPLAY_NONE)
+		{
+			state->issueAt[t]      = replayArrival(state, state->head[t]);
+			state->heap[heapNum++] = t;
+		}
+	}
+
+	for (int position = heapNum / 2 - 1; position >= 0; position--)
+	{
+		replayHeapDown(state, heapNum, position);
+	}
+
+	stats->threads = (unsigned long long)heapNum;
+
+	while (heapNum > 0)
+	{
+		int                t       = state->heap[0];
+		size_t             i       = state->head[t];
+		unsigned long long arrival = replayArrival(state, i);
+		unsigned long long issue   = state->issueAt[t];
+		unsigned long long done;
+
+		engineAccess(engine, &state->refs[i], &result);
+
+		if (result.fault)
+		{
+			unsigned long long start = issue;
+
+			/* The frame is free to refill only once its dirty victim reached the device. */
+
+			if (result.victimDirty)
+			{
+				start = replayDevice(state->deviceFree, config->devices, issue, config->writeNs);
+
+				stats->busyNs  += config->writeNs;
+				stats->queueNs += start - config->writeNs - issue;
+				stats->writes++;
+			}
+
+			done = replayDevice(state->deviceFree, config->devices, start, config->readNs);
+
+			stats->busyNs                        += config->readNs;
+			stats->queueNs                       += done - config->readNs - start;
+			stats->faultLatency[stats->faults++]  = done - issue;
+			state->frameReady[result.frame]       = done;
+		}
+		else if (state->frameReady[result.frame] > issue)
+		{
+			done = state->frameReady[result.frame];
+			stats->inflightWaits++;
+		}
+		else
+		{
+			done = issue;
+		}
+
+		done += config->hitNs;
+
+		stats->response[stats->references++]  = done - arrival;
+		stats->blockedNs                     += issue - arrival;
+		stats->sloMisses                     += done - arrival > config->sloNs;
+		stats->spanNs                         = done > stats->spanNs ? done : stats->spanNs;
+
+		/* The thread's next reference waits for both its arrival and this completion. */
+
+		state->head[t] = state->next[i];
+
+		if (state->head[t] == REPLAY_NONE)
+		{
+			state->heap[0] = state->heap[--heapNum];
+		}
+		else
+		{
+			arrival           = replayArrival(state, state->head[t]);
+			state->issueAt[t] = arrival > done ? arrival : done;
+		}
+
+		replayHeapDown(state, heapNum, 0);
+	}
+}
+
+void replayStatsFree(ReplayStats* stats)
+{
+	free(stats->faultLatency);
+	free(stats->response);
+	memset(stats, 0, sizeof(*stats));
+}
+
+/* Serves one request on the device that frees first (the top of a min-heap) and returns its completion. */
+
+static unsigned long long replayDevice(unsigned long long* deviceFree, int devices, unsigned long long issue,
+	unsigned long long serviceNs)
+{
+	unsigned long long done     = (deviceFree[0] > issue ? deviceFree[0] : issue) + serviceNs;
+	int                position = 0;
+
+	for (;;)
+	{
+		int child = 2 * position + 1;
+
+		if (child >= devices)
+		{
+			break;
+		}
+		if ((child + 1 < devices) && (deviceFree[child + 1] < deviceFree[child]))
+		{
+			child++;
+		}
+		if (deviceFree[child] >= done)
+		{
+			break;
+		}
+
+		deviceFree[position] = deviceFree[child];
+		position             = child;
+	}
+	deviceFree[position] = done;
+
+	return done;
+}
+
+/* Threads with equal issue times go in trace order, so one thread replays the trace as is. */
+
+static void replayHeapDown(ReplayState* state, int count, int position)
+{
+	const unsigned long long* issueAt = state->issueAt;
+	const size_t*             head    = state->head;
+	int*                      heap    = state->heap;
+	int                       moved   = heap[position];
+
+	for (;;)
+	{
+		int child = 2 * position + 1;
+
+		if (child >= count)
+		{
+			break;
+		}
+		if ((child + 1 < count) && ((issueAt[heap[child + 1]] < issueAt[heap[child]]) ||
+			((issueAt[heap[child + 1]] == issueAt[heap[child]]) && (head[heap[child + 1]] < head[heap[child]]))))
+		{
+			child++;
+		}
+		if ((issueAt[heap[child]] > issueAt[moved]) ||
+			((issueAt[heap[child]] == issueAt[moved]) && (head[heap[child]] > head[moved])))
+		{
+			break;
+		}
+
+		heap[position] = heap[child];
+		position       = child;
+	}
+	heap[position] = moved;
+}
+
+static int compareLatencies(const void* a, const void* b)
+{
+	unsigned long long left  = *(const unsigned long long*)a;
+	unsigned long long right = *(const unsigned long long*)b;
+
+	return (left > right) - (left < right);
+}
+
+static unsigned long long replayPercentile(const unsigned long long* sorted, unsigned long long count, double share)
+{
+	unsigned long long rank;
+
+	if (count == 0)
+	{
+		return 0;
+	}
+
+	rank = (unsigned long long)(share * (double)count);
+
+	return sorted[rank < count ? rank : count - 1];
+}
+
+/*************************************************************************
+*   @ End of Replay                                                       *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Replay command                                                      *
+*                                                                         *
+*  Latencies are in microseconds; Queue is the mean wait of a fault for   *
+*  a free device and Blocked the mean delay of a reference behind the     *
+*  earlier faults of its thread.                                          *
+ *************************************************************************/
+
+int runReplayCommand(int argCount, char* args[])
+{
+	ReplayConfig       config;
+	ReplayStats        stats;
+	TraceBuffer        buffer;
+	const char*        split;
+	int                selected = POLICY_COUNT;
+	int                status   = 0;
+	int                clocked  = 0;
+	unsigned long long threads  = 0;
+
+	if (argCount < 4)
+	{
+		printf("Usage: %s\n", REPLAY_USAGE);
+		return -1;
+	}
+
+	replayConfigDefaults(&config);
+
+	int format    = traceFormatFromName(args[1]);
+	int framesNum = atoi(args[3]);
+
+	if ((argCount > 4) && (strcmp(args[4], "all") != 0))
+	{
+		selected = policyFromName(args[4]);
+	}
+	if (argCount > 5)
+	{
+		split          = strchr(args[5], ':');
+		config.readNs  = (unsigned long long)(atof(args[5]) * 1000.0);
+		config.writeNs = split != NULL ? (unsigned long long)(atof(split + 1) * 1000.0) : config.readNs;
+	}
+	if (argCount > 6)
+	{
+		config.devices = atoi(args[6]);
+	}
+	if (argCount > 7)
+	{
+		config.gapNs = (unsigned long long)atoll(args[7]);
+	}
+	if (argCount > 8)
+	{
+		config.threads = atoi(args[8]);
+	}
+	if (argCount > 9)
+	{
+		config.sloNs = (unsigned long long)(atof(args[9]) * 1000.0);
+	}
+
+	if ((format == TRACE_FORMAT_UNKNOWN) | (framesNum < 1) | (selected < 0) | (config.devices < 1) |
+		(config.devices > REPLAY_MAX_DEVICES) | (config.threads < 0))
+	{
+		printf("Usage: %s\n", REPLAY_USAGE);
+		return -1;
+	}
+
+	if (selected == POLICY_OPT)
+	{
+		printf("OPT cannot be replayed, the order of the references depends on its own faults!\n");
+		return -1;
+	}
+
+	traceBufferInit(&buffer);
+
+	if (loadTrace(args[2], format, 0, traceBufferSink, &buffer) != 0)
+	{
+		traceBufferFree(&buffer);
+		return -1;
+	}
+
+	for (size_t i = 0; i < buffer.count; i++)
+	{
+		clocked |= buffer.refs[i].time != 0;
+	}
+
+	printf("\n Trace %s: %llu references, %d frames, %d devices, read %.1f us, write %.1f us, ", args[2],
+		(unsigned long long)buffer.count, framesNum, config.devices, config.readNs / 1000.0,
+		config.writeNs / 1000.0);
+
+	if (clocked)
+	{
+		printf("trace timestamps, SLO %.1f us\n\n", config.sloNs / 1000.0);
+	}
+	else
+	{
+		printf("one arrival every %llu ns, SLO %.1f us\n\n", config.gapNs, config.sloNs / 1000.0);
+	}
+
+	printf(" --------------------------------------------------------------------------------------------------------------------------------------------\n");
+	printf("| Policy    | In-flight |    Faults    |  Refs / s  | Device |  Queue   |   Blocked  |  Fault   |  Fault   |  Fault   |  Response  |  Over   |\n");
+	printf("|           |   hits    |              |            |  busy  |   mean   |    mean    |   p50    |   p99    |  p99.9   |     p99    |   SLO   |\n");
+	printf(" --------------------------------------------------------------------------------------------------------------------------------------------\n");
+
+	for (int policy = 0; (policy < POLICY_OPT) & (status == 0); policy++)
+	{
+		if ((selected != POLICY_COUNT) & (selected != policy))
+		{
+			continue;
+		}
+
+		if (replayRun(&buffer, policy, framesNum, &config, &stats) != 0)
+		{
+			printf("Not enough memory for %d frames!\n", framesNum);
+			status = -1;
+			break;
+		}
+
+		double seconds = stats.spanNs / 1e9;
+
+		printf("| %-9s | %9llu | %12llu | %10.0f | %5.1f%% | %8.1f | %10.1f | %8.1f | %8.1f | %8.1f | %10.1f | %6.2f%% |\n",
+			policyName(policy), stats.inflightWaits, stats.faults, seconds > 0.0 ? stats.references / seconds : 0.0,
+			stats.spanNs ? 100.0 * stats.busyNs / ((double)stats.spanNs * config.devices) : 0.0,
+			stats.faults ? stats.queueNs / 1000.0 / stats.faults : 0.0,
+			stats.references ? stats.blockedNs / 1000.0 / stats.references : 0.0,
+			replayPercentile(stats.faultLatency, stats.faults, 0.50) / 1000.0,
+			replayPercentile(stats.faultLatency, stats.faults, 0.99) / 1000.0,
+			replayPercentile(stats.faultLatency, stats.faults, 0.999) / 1000.0,
+			replayPercentile(stats.response, stats.references, 0.99) / 1000.0,
+			stats.references ? 100.0 * stats.sloMisses / stats.references : 0.0);
+
+		threads = stats.threads;
+		replayStatsFree(&stats);
+	}
+
+	if (status == 0)
+	{
+		printf(" --------------------------------------------------------------------------------------------------------------------------------------------\n");
+		printf(" Threads: %llu. In-flight hits waited for another thread's fault; latencies are in us.\n", threads);
+	}
+
+	traceBufferFree(&buffer);
+
+	return status;
+}
+
+/*************************************************************************
+*   @ End of Replay command                                               *
+*                                                                         *
+ *************************************************************************/
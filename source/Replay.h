@@ -0,0 +1,58 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: Time driven replay of a trace. References arrive at their trace timestamps, or a
+ * fixed gap apart when the trace has no clock, and are issued by threads (the processes
+ * of the trace, or round robin streams) that block while their page fault is served. The
+ * faults queue for an I/O device that serves a limited number of them at once, so the
+ * replay reports throughput, fault service latency percentiles, queueing delays and the
+ * share of references that miss a response time SLO.
+*/
+
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "PagingEngine.h"
+
+#define REPLAY_USAGE         "replay <lackey|pin|csv|bin> <file> <frames> [policy|all] [readUs[:writeUs]] [devices] [gapNs] [threads] [sloUs]"
+#define REPLAY_MAX_DEVICES   1024
+
+
+struct ReplayConfig
+{
+	unsigned long long readNs;        /* service time of one fault */
+	unsigned long long writeNs;       /* service time of one dirty write-back */
+	int                devices;       /* faults served in parallel */
+	unsigned long long gapNs;         /* inter-arrival gap when the trace has no clock */
+	unsigned long long hitNs;         /* CPU time of one reference */
+	int                threads;       /* round robin streams; 0 gives each pid a thread */
+	unsigned long long sloNs;         /* response time objective of one reference */
+};
+
+struct ReplayStats
+{
+	unsigned long long  references;
+	unsigned long long  faults;
+	unsigned long long  writes;
+	unsigned long long  inflightWaits;  /* hits on pages whose fault was still being served */
+	unsigned long long  threads;
+	unsigned long long  spanNs;         /* first arrival to last completion */
+	unsigned long long  busyNs;         /* device time of all requests */
+	unsigned long long  queueNs;        /* faults waiting for a free device */
+	unsigned long long  blockedNs;      /* references issued after their arrival */
+	unsigned long long  sloMisses;
+	unsigned long long* faultLatency;   /* issue to completion, per fault */
+	unsigned long long* response;       /* arrival to completion, per reference */
+};
+
+void replayConfigDefaults(ReplayConfig* config);
+
+/* Policies other than OPT; the replay order depends on the policy's own faults. */
+
+int  replayRun(const TraceBuffer* buffer, int policy, int framesNum, const ReplayConfig* config,
+	ReplayStats* stats);
+void replayStatsFree(ReplayStats* stats);
+
+int  runReplayCommand(int argCount, char* args[]);
+
+#endif // !REPLAY_H
@@ -0,0 +1,692 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: ResultCache.cpp contains the trace digest and the result cache file.
+ *
+ * Layout: the cache file is a plain sequence of fixed size records, results (key,
+ * statistics) and aliases (file identity, digest), each with a check word. Records are
+ * appended with a single write on an O_APPEND descriptor, so concurrent processes can
+ * share one file; a record whose check word does not match (a torn write) is ignored, and
+ * when a key appears twice the last record wins. Each process indexes the file in memory
+ * and only reads what was appended since, and once superseded and torn records outnumber
+ * the live ones, the file is rewritten with the live records only. The file is shared
+ * with pread, flock and rename, so the cache is only kept on Linux.
+*/
+
+
+
+#include "ResultCache.h"
+#include "PageIndex.h"
+#include <stddef.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#define RESULT_CACHE_SUPPORTED
+#endif
+
+#define CACHE_READ_RECORDS 1024
+#define CACHE_COMPACT_MIN  1024     /* stale records tolerated before any rewrite */
+
+
+struct CacheRecord
+{
+	int                kind;        /* CACHE_RECORD_ value */
+	int                reserved;
+	ResultKey          key;         /* alias: the digest and size of the trace */
+	TraceIdentity      identity;    /* alias only */
+	EngineStats        stats;       /* result only */
+	unsigned long long check;
+};
+
+/* This process's view of the cache file: the live records, indexed by the hash of their
+ * key, and how far the file has been read. */
+
+struct CacheIndex
+{
+	CacheRecord*       records;
+	size_t             count;
+	size_t             capacity;
+	size_t             stale;       /* superseded or torn records read from the file */
+	PageIndex          index;       /* recordHash -> slot in records */
+	unsigned long long readBytes;
+	unsigned long long inode;
+	int                loaded;
+};
+
+
+static CacheIndex cache;
+
+
+static const char* cachePath();
+
+
+/*************************************************************************
+*   @ Trace digest                                                        *
+*                                                                         *
+*  Two lanes mixed over the 8 byte words of the data; the tail and the    *
+*  length are folded in at the end. Not cryptographic, only meant to      *
+*  tell traces apart.                                                     *
+ *************************************************************************/
+
+void traceDigestInit(TraceDigest* digest)
+{
+	memset(digest, 0, sizeof(*digest));
+	digest->lanes[0] = 0x9e3779b97f4a7c15ULL;
+	digest->lanes[1] = 0x6a09e667f3bcc909ULL;
+}
+
+static void digestWord(TraceDigest* digest, unsigned long long word)
+{
+	digest->lanes[0] = (digest->lanes[0] ^ pageHash(word)) * 0x100000001b3ULL;
+	digest->lanes[1] = ((digest->lanes[1] + word * 0xc2b2ae3d27d4eb4fULL) << 31 |
+		(digest->lanes[1] + word * 0xc2b2ae3d27d4eb4fULL) >> 33) * 0x9e3779b185ebca87ULL;
+}
+
+void traceDigestUpdate(TraceDigest* digest, const void* data, size_t bytes)
+{
+	const unsigned char* next = (const unsigned char*)data;
+	unsigned long long   word;
+
+	digest->bytes += bytes;
+
+	while ((digest->tailUsed > 0) & (bytes > 0))
+	{
+		digest->tail[digest->tailUsed++] = *next++;
+		bytes--;
+
+		if (digest->tailUsed == 8)
+		{
+			memcpy(&word, digest->tail, 8);
+			digestWord(digest, word);
+			digest->tailUsed = 0;
+		}
+	}
+
+	for (; bytes >= 8; bytes -= 8, next += 8)
+	{
+		memcpy(&word, next, 8);
+		digestWord(digest, word);
+	}
+
+	memcpy(digest->tail, next, bytes);
+	digest->tailUsed += bytes;
+}
+
+void traceDigestFinal(const TraceDigest* digest, unsigned long long result[2])
+{
+	TraceDigest        last = *digest;
+	unsigned long long word = 0;
+
+	memcpy(&word, last.tail, last.tailUsed);
+	digestWord(&last, word);
+	digestWord(&last, last.bytes);
+
+	result[0] = pageHash(last.lanes[0] ^ last.lanes[1]);
+	result[1] = pageHash(last.lanes[1] + result[0]);
+}
+
+/* Digests references field by field, so the padding of PageRef never counts. */
+
+void traceDigestRefs(TraceDigest* digest, const PageRef* refs, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		unsigned long long words[3];
+
+		words[0] = refs[i].page;
+		words[1] = refs[i].time;
+		words[2] = (unsigned long long)refs[i].pid << 8 | refs[i].access;
+
+		if (digest->tailUsed == 0)
+		{
+			digestWord(digest, words[0]);
+			digestWord(digest, words[1]);
+			digestWord(digest, words[2]);
+			digest->bytes += sizeof(words);
+		}
+		else
+		{
+			traceDigestUpdate(digest, words, sizeof(words));
+		}
+	}
+}
+
+/*************************************************************************
+*   @ End of Trace digest                                                 *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Result cache                                                        *
+*                                                                         *
+ *************************************************************************/
+
+/* PAGE_CACHE, else CACHE_FILE_NAME in $XDG_CACHE_HOME or ~/.cache, never the working
+ * directory; "off" when there is no home to keep it in. */
+
+static const char* cachePath()
+{
+	static char defaultPath[4096];
+	const char* path = getenv(CACHE_ENV);
+	const char* xdg  = getenv("XDG_CACHE_HOME");
+	const char* home = getenv("HOME");
+
+	if ((path != NULL) && (*path != '\0'))
+	{
+		return path;
+	}
+
+	if (defaultPath[0] == '\0')
+	{
+		char directory[4000];
+
+		if ((xdg != NULL) && (xdg[0] == '/'))
+		{
+			snprintf(directory, sizeof(directory), "%s", xdg);
+		}
+		else if ((home != NULL) && (home[0] != '\0'))
+		{
+			snprintf(directory, sizeof(directory), "%s/.cache", home);
+		}
+		else
+		{
+			snprintf(defaultPath, sizeof(defaultPath), "off");
+			return defaultPath;
+		}
+
+#ifdef RESULT_CACHE_SUPPORTED
+		mkdir(directory, 0700);     /* usually there already */
+#endif
+		snprintf(defaultPath, sizeof(defaultPath), "%s/%s", directory, CACHE_FILE_NAME);
+	}
+
+	return defaultPath;
+}
+
+int resultCacheEnabled()
+{
+#ifdef RESULT_CACHE_SUPPORTED
+	return strcmp(cachePath(), "off") != 0;
+#else
+	static int warned = 0;
+
+	if (!warned && (getenv(CACHE_ENV) != NULL) && (strcmp(cachePath(), "off") != 0))
+	{
+		printf("The result cache needs Linux, results are not cached!\n");
+		warned = 1;
+	}
+
+	return 0;
+#endif
+}
+
+/* Results are told apart by their key, aliases by the path alone, so a newer alias of a
+ * file replaces the older one. */
+
+static unsigned long long recordHash(const CacheRecord* record)
+{
+	TraceDigest        digest;
+	unsigned long long hash[2];
+
+	traceDigestInit(&digest);
+	traceDigestUpdate(&digest, &record->kind, sizeof(record->kind));
+
+	if (record->kind == CACHE_RECORD_ALIAS)
+	{
+		traceDigestUpdate(&digest, &record->identity.path, sizeof(record->identity.path));
+	}
+	else
+	{
+		traceDigestUpdate(&digest, &record->key, sizeof(record->key));
+	}
+	traceDigestFinal(&digest, hash);
+
+	return hash[0];
+}
+
+static int sameRecord(const CacheRecord* a, const CacheRecord* b)
+{
+	if (a->kind != b->kind)
+	{
+		return 0;
+	}
+
+	return a->kind == CACHE_RECORD_ALIAS ? a->identity.path == b->identity.path :
+		memcmp(&a->key, &b->key, sizeof(a->key)) == 0;
+}
+
+/*************************************************************************
+*   @ End of Result cache                                                 *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Cache index                                                         *
+*                                                                         *
+*  cacheRefresh reads the records appended since the last call; a file    *
+*  that was replaced (compacted by another process) or truncated is read  *
+*  again from the start.                                                  *
+ *************************************************************************/
+
+#ifdef RESULT_CACHE_SUPPORTED
+
+static unsigned long long recordCheck(const CacheRecord* record)
+{
+	TraceDigest        digest;
+	unsigned long long check[2];
+
+	traceDigestInit(&digest);
+	traceDigestUpdate(&digest, record, offsetof(CacheRecord, check));
+	traceDigestFinal(&digest, check);
+
+	return check[0];
+}
+
+static void cacheReset()
+{
+	if (!cache.loaded)
+	{
+		memset(&cache, 0, sizeof(cache));
+		pageIndexInit(&cache.index, CACHE_READ_RECORDS);
+		cache.loaded = cache.index.control != NULL;
+	}
+	else
+	{
+		pageIndexClear(&cache.index);
+	}
+
+	cache.count     = 0;
+	cache.stale     = 0;
+	cache.readBytes = 0;
+}
+
+static int cacheInsert(const CacheRecord* record)
+{
+	unsigned long long  hash = recordHash(record);
+	unsigned long long* slot;
+	int                 created;
+
+	if (cache.count == cache.capacity)
+	{
+		size_t       capacity = cache.capacity > 0 ? cache.capacity * 2 : CACHE_READ_RECORDS;
+		CacheRecord* grown    = (CacheRecord*)realloc(cache.records, capacity * sizeof(CacheRecord));
+
+		if (grown == NULL)
+		{
+			return -1;
+		}
+		cache.records  = grown;
+		cache.capacity = capacity;
+	}
+
+	slot = pageIndexSlot(&cache.index, hash, &created);
+
+	if (slot == NULL)
+	{
+		return -1;
+	}
+
+	if (created)
+	{
+		*slot = cache.count++;
+	}
+	else
+	{
+		cache.stale++;
+	}
+	cache.records[*slot] = *record;
+
+	return 0;
+}
+
+static int cacheRead(int fd)
+{
+	struct stat  info;
+	CacheRecord* records;
+	ssize_t      got;
+
+	if (fstat(fd, &info) != 0)
+	{
+		return -1;
+	}
+
+	if (!cache.loaded || (cache.inode != (unsigned long long)info.st_ino) ||
+		((unsigned long long)info.st_size < cache.readBytes))
+	{
+		cacheReset();
+
+		if (!cache.loaded)
+		{
+			return -1;
+		}
+		cache.inode = (unsigned long long)info.st_ino;
+	}
+
+	records = (CacheRecord*)malloc(CACHE_READ_RECORDS * sizeof(CacheRecord));
+
+	while ((records != NULL) &&
+		((got = pread(fd, records, CACHE_READ_RECORDS * sizeof(CacheRecord), (off_t)cache.readBytes)) >=
+		(ssize_t)sizeof(CacheRecord)))
+	{
+		size_t whole = (size_t)got / sizeof(CacheRecord);
+
+		for (size_t i = 0; i < whole; i++)
+		{
+			if (records[i].check != recordCheck(&records[i]))
+			{
+				cache.stale++;
+			}
+			else if (cacheInsert(&records[i]) != 0)
+			{
+				free(records);
+				return -1;
+			}
+		}
+		cache.readBytes += whole * sizeof(CacheRecord);
+	}
+
+	free(records);
+
+	return records != NULL ? 0 : -1;
+}
+
+static int cacheRefresh()
+{
+	int fd = resultCacheEnabled() ? open(cachePath(), O_RDONLY) : -1;
+
+	if (fd < 0)
+	{
+		return -1;
+	}
+
+	int status = cacheRead(fd);
+
+	close(fd);
+
+	return status;
+}
+
+/* Rewrites the file with the live records, under an exclusive lock that appenders wait for. */
+
+static void cacheCompact()
+{
+	char tmpPath[4096];
+	int  fd = open(cachePath(), O_RDONLY);
+
+	if ((fd < 0) || (flock(fd, LOCK_EX) != 0) || (cacheRead(fd) != 0) || (cache.stale < cache.count + CACHE_COMPACT_MIN))
+	{
+		if (fd >= 0)
+		{
+			close(fd);
+		}
+		return;
+	}
+
+	snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", cachePath());
+
+	int    out   = open(tmpPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	size_t bytes = cache.count * sizeof(CacheRecord);
+
+	if ((out >= 0) && (write(out, cache.records, bytes) == (ssize_t)bytes) && (fsync(out) == 0) &&
+		(close(out) == 0) && (rename(tmpPath, cachePath()) == 0))
+	{
+		struct stat info;
+
+		cache.stale     = 0;
+		cache.readBytes = bytes;
+		cache.inode     = stat(cachePath(), &info) == 0 ? (unsigned long long)info.st_ino : 0;
+	}
+	else
+	{
+		if (out >= 0)
+		{
+			close(out);
+		}
+		remove(tmpPath);
+	}
+
+	close(fd);
+}
+
+#else
+
+static int cacheRefresh()
+{
+	return -1;
+}
+
+#endif
+
+static const CacheRecord* cacheLookup(const CacheRecord* probe)
+{
+	unsigned long long slot;
+
+	if ((cacheRefresh() != 0) || !pageIndexFind(&cache.index, recordHash(probe), &slot) ||
+		!sameRecord(&cache.records[slot], probe))
+	{
+		return NULL;
+	}
+
+	return &cache.records[slot];
+}
+
+/*************************************************************************
+*   @ End of Cache index                                                  *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Keys and records                                                    *
+*                                                                         *
+ *************************************************************************/
+
+int traceIdentityInit(TraceIdentity* identity, const char* path)
+{
+#ifdef _WIN32
+	struct _stat64     info;            /* the plain stat of Windows fails past 2 GiB */
+#else
+	struct stat        info;
+#endif
+	TraceDigest        digest;
+	unsigned long long hash[2];
+
+	memset(identity, 0, sizeof(*identity));
+
+#ifdef _WIN32
+	if (_stat64(path, &info) != 0)
+#else
+	if (stat(path, &info) != 0)
+#endif
+	{
+		return -1;
+	}
+
+	/* The cache is shared by every working directory, so the path is made absolute. */
+
+#ifdef __linux__
+	char*       full  = realpath(path, NULL);
+	const char* named = full != NULL ? full : path;
+#else
+	const char* named = path;
+#endif
+
+	traceDigestInit(&digest);
+	traceDigestUpdate(&digest, named, strlen(named));
+	traceDigestFinal(&digest, hash);
+#ifdef __linux__
+	free(full);
+#endif
+
+	identity->path    = hash[0];
+	identity->bytes   = (unsigned long long)info.st_size;
+#ifdef __linux__
+	identity->mtimeNs = (long long)info.st_mtim.tv_sec * 1000000000LL + info.st_mtim.tv_nsec;
+#else
+	identity->mtimeNs = (long long)info.st_mtime * 1000000000LL;
+#endif
+	identity->inode   = (unsigned long long)info.st_ino;
+
+	return 0;
+}
+
+/* Only stats the trace; policy and framesNum are left for the caller. */
+
+int resultKeyInit(ResultKey* key, TraceIdentity* identity, const char* path, int format)
+{
+	CacheRecord        probe;
+	const CacheRecord* alias;
+
+	memset(key, 0, sizeof(*key));
+
+	if (!resultCacheEnabled() || (traceIdentityInit(identity, path) != 0))
+	{
+		return -1;
+	}
+
+	key->bytes   = identity->bytes;
+	key->version = CACHE_ENGINE_VERSION;
+	key->format  = format;
+
+	memset(&probe, 0, sizeof(probe));
+	probe.kind     = CACHE_RECORD_ALIAS;
+	probe.identity = *identity;
+	alias          = cacheLookup(&probe);
+
+	if ((alias != NULL) && (memcmp(&alias->identity, identity, sizeof(*identity)) == 0))
+	{
+		key->digest[0] = alias->key.digest[0];
+		key->digest[1] = alias->key.digest[1];
+	}
+
+	return 0;
+}
+
+#ifdef RESULT_CACHE_SUPPORTED
+
+static int cacheAppend(CacheRecord* record)
+{
+	struct stat info;
+	struct stat opened;
+	int         fd = -1;
+
+	record->check = recordCheck(record);
+
+	/* A compaction may replace the file between open and lock; append to the new one then. */
+
+	for (int attempt = 0; attempt < 3; attempt++)
+	{
+		fd = open(cachePath(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+
+		if ((fd < 0) || (flock(fd, LOCK_SH) != 0) || (fstat(fd, &opened) != 0) || (stat(cachePath(), &info) != 0) ||
+			(opened.st_ino == info.st_ino))
+		{
+			break;
+		}
+		close(fd);
+		fd = -1;
+	}
+
+	if ((fd < 0) || (write(fd, record, sizeof(*record)) != (ssize_t)sizeof(*record)))
+	{
+		printf("Cannot write result cache '%s'!\n", cachePath());
+
+		if (fd >= 0)
+		{
+			close(fd);
+		}
+		return -1;
+	}
+	close(fd);
+
+	if ((cacheRefresh() == 0) && (cache.stale >= cache.count + CACHE_COMPACT_MIN))
+	{
+		cacheCompact();
+	}
+
+	return 0;
+}
+
+#else
+
+static int cacheAppend(CacheRecord* record)
+{
+	return -1;
+}
+
+#endif
+
+void resultKeyFinish(ResultKey* key, const TraceIdentity* identity, const unsigned long long digest[2])
+{
+	CacheRecord record;
+
+	if ((key->digest[0] == digest[0]) & (key->digest[1] == digest[1]))
+	{
+		return;
+	}
+
+	key->digest[0] = digest[0];
+	key->digest[1] = digest[1];
+
+	memset(&record, 0, sizeof(record));
+	record.kind          = CACHE_RECORD_ALIAS;
+	record.key.digest[0] = digest[0];
+	record.key.digest[1] = digest[1];
+	record.key.bytes     = key->bytes;
+	record.identity      = *identity;
+
+	cacheAppend(&record);
+}
+
+/* Returns 1 and the statistics when the key is cached, 0 otherwise. */
+
+int resultCacheFind(const ResultKey* key, EngineStats* stats)
+{
+	CacheRecord        probe;
+	const CacheRecord* found;
+
+	if ((key->digest[0] == 0) & (key->digest[1] == 0))
+	{
+		return 0;
+	}
+
+	memset(&probe, 0, sizeof(probe));
+	probe.kind = CACHE_RECORD_RESULT;
+	probe.key  = *key;
+	found      = cacheLookup(&probe);
+
+	if (found == NULL)
+	{
+		return 0;
+	}
+	*stats = found->stats;
+
+	return 1;
+}
+
+int resultCacheStore(const ResultKey* key, const EngineStats* stats)
+{
+	CacheRecord record;
+
+	if (!resultCacheEnabled() || ((key->digest[0] == 0) & (key->digest[1] == 0)))
+	{
+		return 0;
+	}
+
+	memset(&record, 0, sizeof(record));
+	record.kind  = CACHE_RECORD_RESULT;
+	record.key   = *key;
+	record.stats = *stats;
+
+	return cacheAppend(&record);
+}
+
+/*************************************************************************
+*   @ End of Keys and records                                             *
+*                                                                         *
+ *************************************************************************/
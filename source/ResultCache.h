@@ -0,0 +1,73 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: On-disk cache of simulation results. A result is keyed by a content digest of
+ * the trace's references, the trace format, the policy, the frame count, a hash of any
+ * further parameters and the engine version, so an unchanged sweep point is read back
+ * instead of simulated again. The digest is computed while a simulation streams the trace;
+ * an alias record maps the path, size and modification time of the file to it, so a later
+ * run finds its results without reading the trace. The cache file is PAGE_CACHE, or
+ * CACHE_FILE_NAME in $XDG_CACHE_HOME (~/.cache by default); PAGE_CACHE=off disables it.
+*/
+
+
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include "PagingEngine.h"
+
+#define CACHE_ENV            "PAGE_CACHE"
+#define CACHE_FILE_NAME      "demand-paging-results"
+#define CACHE_ENGINE_VERSION 2      /* bump whenever an engine's results change */
+#define CACHE_RECORD_RESULT  0
+#define CACHE_RECORD_ALIAS   1
+
+
+/* Incremental 128-bit content digest. */
+
+struct TraceDigest
+{
+	unsigned long long lanes[2];
+	unsigned long long bytes;
+	unsigned char      tail[8];
+	size_t             tailUsed;
+};
+
+/* Identity of a trace file that costs a stat, not a read. */
+
+struct TraceIdentity
+{
+	unsigned long long path;        /* hash of the path */
+	unsigned long long bytes;
+	long long          mtimeNs;
+	unsigned long long inode;
+};
+
+/* digest is { 0, 0 } until it is known from an alias or from streaming the trace. */
+
+struct ResultKey
+{
+	unsigned long long digest[2];
+	unsigned long long bytes;       /* trace file size */
+	unsigned int       version;     /* CACHE_ENGINE_VERSION */
+	int                format;
+	int                policy;
+	int                framesNum;
+	unsigned long long params;      /* hash of further parameters, 0 for a plain run */
+};
+
+void traceDigestInit(TraceDigest* digest);
+void traceDigestUpdate(TraceDigest* digest, const void* data, size_t bytes);
+void traceDigestFinal(const TraceDigest* digest, unsigned long long result[2]);
+void traceDigestRefs(TraceDigest* digest, const PageRef* refs, size_t count);
+int  traceIdentityInit(TraceIdentity* identity, const char* path);
+
+/* resultKeyInit fills the identity and, if an alias knows it, the digest; once the trace
+ * has been streamed, resultKeyFinish sets the digest and records the alias. */
+
+int  resultCacheEnabled();
+int  resultKeyInit(ResultKey* key, TraceIdentity* identity, const char* path, int format);
+void resultKeyFinish(ResultKey* key, const TraceIdentity* identity, const unsigned long long digest[2]);
+int  resultCacheFind(const ResultKey* key, EngineStats* stats);
+int  resultCacheStore(const ResultKey* key, const EngineStats* stats);
+
+#endif // !RESULT_CACHE_H
@@ -0,0 +1,452 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: ReuseDistance.cpp contains the chunk parallel reuse distance computation and
+ * the reuse command.
+ *
+ * Chunk pass (one thread per chunk): a Fenwick tree over the chunk positions holds a 1 at
+ * the last use of every page seen so far, so the distance of a reuse inside the chunk is
+ * the number of ones between the two uses. Pages used for the first time in the chunk are
+ * recorded in order of first use, and all pages of the chunk in order of last use.
+ *
+ * Merge pass (in trace order): a second Fenwick tree holds the last use of every page over
+ * the chunks merged so far, one slot per (chunk, page). The j-th new page of a chunk has
+ * seen j distinct pages inside the chunk, plus every page used after its previous use in
+ * the earlier chunks that is not one of those j; its own mark is removed once it is
+ * counted. The pages of the chunk are then appended in order of last use.
+*/
+
+
+
+#include "ReuseDistance.h"
+#include "TraceParser.h"
+#include "PageIndex.h"
+#include <string.h>
+#include <thread>
+#include <chrono>
+
+
+struct ReuseChunk
+{
+	const PageRef*      refs;
+	size_t              count;
+	unsigned long long* counts;        /* reuses inside the chunk by distance */
+	size_t              countsSize;
+	unsigned long long* firstPages;    /* distinct pages in order of first use */
+	unsigned long long* lastPages;     /* distinct pages in order of last use */
+	size_t              distinct;
+	int                 failed;
+};
+
+
+static void         fenwickAdd(unsigned int* tree, size_t size, size_t position, int delta);
+static unsigned int fenwickSum(const unsigned int* tree, size_t end);
+static void         chunkPass(ReuseChunk* chunk);
+static int          mergeChunks(ReuseChunk* chunks, int chunksNum, ReuseHistogram* histogram);
+
+
+/*************************************************************************
+*   @ Fenwick tree                                                        *
+*                                                                         *
+*  tree has size + 1 entries; positions are 0 based.                      *
+ *************************************************************************/
+
+static void fenwickAdd(unsigned int* tree, size_t size, size_t position, int delta)
+{
+	for (size_t i = position + 1; i <= size; i += i & (0 - i))
+	{
+		tree[i] += (unsigned int)delta;
+	}
+}
+
+/* Sum of the positions [0, end). */
+
+static unsigned int fenwickSum(const unsigned int* tree, size_t end)
+{
+	unsigned int sum = 0;
+
+	for (size_t i = end; i > 0; i -= i & (0 - i))
+	{
+		sum += tree[i];
+	}
+
+	return sum;
+}
+
+/*************************************************************************
+*   @ End of Fenwick tree                                                 *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Chunk pass                                                          *
+*                                                                         *
+ *************************************************************************/
+
+static void chunkPass(ReuseChunk* chunk)
+{
+	PageIndex          last;
+	unsigned int*      tree  = (unsigned int*)calloc(chunk->count + 1, sizeof(unsigned int));
+	unsigned long long position;
+
+	chunk->countsSize = 64;
+	chunk->counts     = (unsigned long long*)calloc(chunk->countsSize, sizeof(unsigned long long));
+	chunk->firstPages = (unsigned long long*)malloc((chunk->count + 1) * sizeof(unsigned long long));
+
+	if ((tree == NULL) || (chunk->counts == NULL) || (chunk->firstPages == NULL) ||
+		(pageIndexInit(&last, chunk->count < 65536 ? chunk->count : 65536) != 0))
+	{
+		free(tree);
+		chunk->failed = 1;
+		return;
+	}
+
+	for (size_t i = 0; i < chunk->count; i++)
+	{
+		int                 created;
+		unsigned long long* slot = pageIndexSlot(&last, chunk->refs[i].page, &created);
+
+		if (slot == NULL)
+		{
+			chunk->failed = 1;
+			break;
+		}
+
+		if (created)
+		{
+			chunk->firstPages[chunk->distinct++] = chunk->refs[i].page;
+
+			if (chunk->distinct == chunk->countsSize)
+			{
+				unsigned long long* grown = (unsigned long long*)realloc(chunk->counts,
+					chunk->countsSize * 2 * sizeof(unsigned long long));
+
+				if (grown == NULL)
+				{
+					chunk->failed = 1;
+					break;
+				}
+				memset(grown + chunk->countsSize, 0, chunk->countsSize * sizeof(unsigned long long));
+				chunk->counts      = grown;
+				chunk->countsSize *= 2;
+			}
+		}
+		else
+		{
+			chunk->counts[fenwickSum(tree, i) - fenwickSum(tree, (size_t)*slot + 1)]++;
+			fenwickAdd(tree, chunk->count, (size_t)*slot, -1);
+		}
+		*slot = i;
+		fenwickAdd(tree, chunk->count, i, 1);
+	}
+
+	/* The positions still marked are the last uses, already in trace order. */
+
+	chunk->lastPages = chunk->failed ? NULL : (unsigned long long*)malloc((chunk->distinct + 1) * sizeof(unsigned long long));
+
+	if (chunk->lastPages == NULL)
+	{
+		chunk->failed = 1;
+	}
+
+	for (size_t i = 0, n = 0; (i < chunk->count) & !chunk->failed; i++)
+	{
+		if ((pageIndexFind(&last, chunk->refs[i].page, &position) != 0) && (position == i))
+		{
+			chunk->lastPages[n++] = chunk->refs[i].page;
+		}
+	}
+
+	pageIndexFree(&last);
+	free(tree);
+}
+
+/*************************************************************************
+*   @ End of Chunk pass                                                   *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Merge                                                               *
+*                                                                         *
+ *************************************************************************/
+
+static int mergeChunks(ReuseChunk* chunks, int chunksNum, ReuseHistogram* histogram)
+{
+	PageIndex          stamps;
+	size_t             slots = 0;
+	size_t             base  = 0;
+	unsigned int       live  = 0;
+	unsigned int*      tree;
+	unsigned long long stamp;
+
+	for (int c = 0; c < chunksNum; c++)
+	{
+		slots += chunks[c].distinct;
+	}
+
+	tree               = (unsigned int*)calloc(slots + 1, sizeof(unsigned int));
+	histogram->size    = slots + 1;
+	histogram->counts  = (unsigned long long*)calloc(histogram->size, sizeof(unsigned long long));
+
+	if ((tree == NULL) || (histogram->counts == NULL) || (pageIndexInit(&stamps, chunks[0].distinct) != 0))
+	{
+		free(tree);
+		return -1;
+	}
+
+	for (int c = 0; c < chunksNum; c++)
+	{
+		ReuseChunk* chunk = &chunks[c];
+
+		for (size_t j = 0; j < chunk->distinct; j++)
+		{
+			if (pageIndexFind(&stamps, chunk->firstPages[j], &stamp))
+			{
+				histogram->counts[j + live - fenwickSum(tree, (size_t)stamp + 1)]++;
+				fenwickAdd(tree, slots, (size_t)stamp, -1);
+				live--;
+			}
+			else
+			{
+				histogram->cold++;
+			}
+		}
+
+		for (size_t d = 0; d < chunk->distinct; d++)
+		{
+			histogram->counts[d] += chunk->counts[d];
+		}
+
+		for (size_t j = 0; j < chunk->distinct; j++)
+		{
+			if (pageIndexSet(&stamps, chunk->lastPages[j], base + j) != 0)
+			{
+				pageIndexFree(&stamps);
+				free(tree);
+				return -1;
+			}
+			fenwickAdd(tree, slots, base + j, 1);
+			live++;
+		}
+		base += chunk->distinct;
+	}
+
+	histogram->distinct = stamps.count;
+	pageIndexFree(&stamps);
+	free(tree);
+
+	return 0;
+}
+
+/*************************************************************************
+*   @ End of Merge                                                        *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Reuse histogram                                                     *
+*                                                                         *
+*  threads is the number of chunks; 1 is the plain sequential pass.       *
+ *************************************************************************/
+
+int computeReuseHistogram(const PageRef* refs, size_t count, int threads, ReuseHistogram* histogram)
+{
+	ReuseChunk  chunks[TRACE_MAX_THREADS];
+	std::thread workers[TRACE_MAX_THREADS];
+	int         status = 0;
+
+	memset(histogram, 0, sizeof(*histogram));
+	histogram->references = count;
+
+	if ((size_t)threads > count / 1024)
+	{
+		threads = (int)(count / 1024);
+	}
+	if (threads < 1)
+	{
+		threads = 1;
+	}
+
+	memset(chunks, 0, sizeof(chunks));
+
+	for (int c = 0; c < threads; c++)
+	{
+		size_t begin = count * c / threads;
+
+		chunks[c].refs  = refs + begin;
+		chunks[c].count = count * (c + 1) / threads - begin;
+	}
+
+	for (int c = 1; c < threads; c++)
+	{
+		workers[c] = std::thread(chunkPass, &chunks[c]);
+	}
+	chunkPass(&chunks[0]);
+
+	for (int c = 0; c < threads; c++)
+	{
+		if (c > 0)
+		{
+			workers[c].join();
+		}
+		status |= chunks[c].failed;
+	}
+
+	if ((status == 0) && (mergeChunks(chunks, threads, histogram) != 0))
+	{
+		status = 1;
+	}
+
+	for (int c = 0; c < threads; c++)
+	{
+		free(chunks[c].counts);
+		free(chunks[c].firstPages);
+		free(chunks[c].lastPages);
+	}
+
+	if (status != 0)
+	{
+		reuseHistogramFree(histogram);
+		return -1;
+	}
+
+	return 0;
+}
+
+void reuseHistogramFree(ReuseHistogram* histogram)
+{
+	free(histogram->counts);
+	histogram->counts = NULL;
+	histogram->size   = 0;
+}
+
+/*************************************************************************
+*   @ End of Reuse histogram                                              *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Reuse command                                                       *
+*                                                                         *
+*  A reference hits in an LRU memory of n frames when its distance is     *
+*  below n, so the faults of every size follow from one histogram.        *
+ *************************************************************************/
+
+int runReuseCommand(int argCount, char* args[])
+{
+	TraceBuffer        buffer;
+	ReuseHistogram     histogram;
+	unsigned long long points[REUSE_MAX_POINTS];
+	int                pointsNum = 0;
+	int                threads   = argCount > 3 ? atoi(args[3]) : 0;
+	int                format;
+	int                status;
+
+	if (argCount < 3)
+	{
+		printf("Usage: %s\n", REUSE_USAGE);
+		return -1;
+	}
+
+	format = traceFormatFromName(args[1]);
+
+	if (format == TRACE_FORMAT_UNKNOWN)
+	{
+		printf("Usage: %s\n", REUSE_USAGE);
+		return -1;
+	}
+
+	if (threads <= 0)
+	{
+		threads = (int)std::thread::hardware_concurrency();
+	}
+	if (threads < 1)
+	{
+		threads = 1;
+	}
+	if (threads > TRACE_MAX_THREADS)
+	{
+		threads = TRACE_MAX_THREADS;
+	}
+
+	for (char* frames = argCount > 4 ? args[4] : (char*)""; (*frames != '\0') & (pointsNum < REUSE_MAX_POINTS);)
+	{
+		long long framesNum = strtoll(frames, &frames, 10);
+
+		if (framesNum < 1)
+		{
+			printf("Usage: %s\n", REUSE_USAGE);
+			return -1;
+		}
+		points[pointsNum++] = (unsigned long long)framesNum;
+
+		if (*frames == ',')
+		{
+			frames++;
+		}
+	}
+
+	traceBufferInit(&buffer);
+	status = loadTrace(args[2], format, threads, traceBufferSink, &buffer);
+
+	if (status != 0)
+	{
+		traceBufferFree(&buffer);
+		return -1;
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	status = computeReuseHistogram(buffer.refs, buffer.count, threads, &histogram);
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	traceBufferFree(&buffer);
+
+	if (status != 0)
+	{
+		printf("Not enough memory for the reuse distances!\n");
+		return -1;
+	}
+
+	/* Default points: powers of two up to the number of distinct pages. */
+
+	for (unsigned long long frames = 1; (argCount <= 4) & (frames < histogram.distinct * 2) & (pointsNum < REUSE_MAX_POINTS);
+		frames *= 2)
+	{
+		points[pointsNum++] = frames;
+	}
+
+	printf("\n Trace %s: %llu references, %llu distinct pages, %d threads, %.2f s\n\n", args[2],
+		histogram.references, histogram.distinct, threads, seconds);
+	printf(" -----------------------------------------\n");
+	printf("|     Frames     |     Faults     | Rate  |\n");
+	printf(" -----------------------------------------\n");
+
+	for (int p = 0; p < pointsNum; p++)
+	{
+		unsigned long long faults = histogram.cold;
+
+		for (size_t d = (size_t)points[p]; d < histogram.size; d++)
+		{
+			faults += histogram.counts[d];
+		}
+
+		printf("| %14llu | %14llu |%5.1f%% |\n", points[p], faults,
+			histogram.references ? 100.0 * (double)faults / (double)histogram.references : 0.0);
+	}
+	printf(" -----------------------------------------\n");
+
+	reuseHistogramFree(&histogram);
+
+	return 0;
+}
+
+/*************************************************************************
+*   @ End of Reuse command                                                *
+*                                                                         *
+ *************************************************************************/
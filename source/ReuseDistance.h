@@ -0,0 +1,35 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: Exact LRU reuse (stack) distances of a trace computed on several threads. The
+ * trace is split into chunks whose internal reuses are measured in parallel; references
+ * to pages last used in an earlier chunk are repaired in a merge pass, giving the same
+ * histogram as a sequential pass and with it the LRU fault count of every memory size.
+*/
+
+
+#ifndef REUSE_DISTANCE_H
+#define REUSE_DISTANCE_H
+
+#include "Trace.h"
+
+#define REUSE_USAGE          "reuse <lackey|pin|csv|bin> <file> [threads] [frames[,frames...]]"
+#define REUSE_MAX_POINTS     64
+
+
+/* Histogram of reuse distances: counts[d] references had d distinct pages since their last use. */
+
+struct ReuseHistogram
+{
+	unsigned long long* counts;
+	size_t              size;
+	unsigned long long  cold;        /* first references, infinite distance */
+	unsigned long long  references;
+	unsigned long long  distinct;
+};
+
+int  computeReuseHistogram(const PageRef* refs, size_t count, int threads, ReuseHistogram* histogram);
+void reuseHistogramFree(ReuseHistogram* histogram);
+
+int runReuseCommand(int argCount, char* args[]);
+
+#endif // !REUSE_DISTANCE_H
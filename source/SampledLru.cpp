@@ -0,0 +1,400 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: SampledLru.cpp contains the sampled LRU cache and the sampled command.
+ *
+ * Frames are filled in order like the engines, so the resident pages always sit in the
+ * dense prefix framePage[0..usedFrames - 1] and a random frame is a random resident page.
+ * Without a pool a fault evicts the oldest of the sampled frames. With a pool, sampled
+ * pages are merged into a small list sorted by last use (duplicates and pages newer than
+ * every entry of a full pool are dropped) and the oldest entry is evicted; unlike Redis,
+ * an entry whose page has been evicted or used since it was sampled is discarded instead
+ * of evicted.
+*/
+
+
+
+#include "SampledLru.h"
+#include "TraceParser.h"
+#include <string.h>
+#include <chrono>
+
+
+static int  sampledVictim(SampledLru* cache);
+static int  randomFrame(SampledLru* cache);
+static void poolInsert(SampledLru* cache, unsigned long long page, unsigned long long lastUse);
+
+
+/*************************************************************************
+*   @ Create / destroy                                                    *
+*                                                                         *
+ *************************************************************************/
+
+int sampledCreate(SampledLru* cache, int framesNum, int samples, int poolSize)
+{
+	memset(cache, 0, sizeof(*cache));
+
+	if ((framesNum < 1) | (samples < 1) | (poolSize < 0) | (poolSize > SAMPLED_MAX_POOL))
+	{
+		return -1;
+	}
+
+	cache->framesNum = framesNum;
+	cache->samples   = samples;
+	cache->poolSize  = poolSize;
+	cache->random    = 0x853c49e6748fea9bULL;
+	cache->framePage = (unsigned long long*)malloc(framesNum * sizeof(unsigned long long));
+	cache->lastUse   = (unsigned long long*)malloc(framesNum * sizeof(unsigned long long));
+	cache->dirty     = (unsigned char*)calloc(framesNum, 1);
+	cache->pool      = (SampledCandidate*)malloc((poolSize + 1) * sizeof(SampledCandidate));
+
+	if ((cache->framePage == NULL) | (cache->lastUse == NULL) | (cache->dirty == NULL) | (cache->pool == NULL) ||
+		(pageIndexInit(&cache->frames, (size_t)framesNum) != 0))
+	{
+		sampledDestroy(cache);
+		return -1;
+	}
+
+	return 0;
+}
+
+void sampledDestroy(SampledLru* cache)
+{
+	free(cache->framePage);
+	free(cache->lastUse);
+	free(cache->dirty);
+	free(cache->pool);
+	pageIndexFree(&cache->frames);
+	memset(cache, 0, sizeof(*cache));
+}
+
+/*************************************************************************
+*   @ End of Create / destroy                                             *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Sampled access                                                      *
+*                                                                         *
+*  A hit is one index lookup and one store; the work of keeping the      *
+*  order is moved to the faults.                                          *
+ *************************************************************************/
+
+int sampledAccess(SampledLru* cache, const PageRef* ref)
+{
+	unsigned long long slot;
+	int                frame;
+	int                fault = 0;
+
+	cache->clock++;
+	cache->stats.references++;
+
+	if (pageIndexFind(&cache->frames, ref->page, &slot))
+	{
+		frame = (int)slot;
+	}
+	else
+	{
+		if (cache->usedFrames < cache->framesNum)
+		{
+			frame = cache->usedFrames++;
+		}
+		else
+		{
+			frame = sampledVictim(cache);
+
+			cache->stats.evictions++;
+			cache->stats.writebacks += cache->dirty[frame];
+			pageIndexRemove(&cache->frames, cache->framePage[frame]);
+		}
+
+		if (pageIndexSet(&cache->frames, ref->page, (unsigned long long)frame) != 0)
+		{
+			return -1;
+		}
+
+		cache->framePage[frame] = ref->page;
+		cache->dirty[frame]     = 0;
+		cache->stats.faults++;
+		fault = 1;
+	}
+
+	cache->lastUse[frame]  = cache->clock;
+	cache->dirty[frame]   |= (ref->access == ACCESS_WRITE);
+
+	return fault;
+}
+
+static int randomFrame(SampledLru* cache)
+{
+	cache->random += 0x9e3779b97f4a7c15ULL;
+	cache->sampled++;
+
+	return (int)(pageHash(cache->random) % (unsigned long long)cache->usedFrames);
+}
+
+static int sampledVictim(SampledLru* cache)
+{
+	unsigned long long slot;
+	int                best = randomFrame(cache);
+
+	if (cache->poolSize == 0)
+	{
+		for (int s = 1; s < cache->samples; s++)
+		{
+			int frame = randomFrame(cache);
+
+			best = cache->lastUse[frame] < cache->lastUse[best] ? frame : best;
+		}
+		return best;
+	}
+
+	/* A refill puts fresh entries into a pool emptied of stale ones, so this ends. */
+
+	for (;;)
+	{
+		for (int s = 0; s < cache->samples; s++)
+		{
+			int frame = s == 0 ? best : randomFrame(cache);
+
+			poolInsert(cache, cache->framePage[frame], cache->lastUse[frame]);
+		}
+
+		while (cache->poolUsed > 0)
+		{
+			SampledCandidate* candidate = &cache->pool[--cache->poolUsed];
+
+			if (pageIndexFind(&cache->frames, candidate->page, &slot) &&
+				(cache->lastUse[(int)slot] == candidate->lastUse))
+			{
+				return (int)slot;
+			}
+		}
+
+		best = randomFrame(cache);
+	}
+}
+
+static void poolInsert(SampledLru* cache, unsigned long long page, unsigned long long lastUse)
+{
+	int slot = 0;
+
+	for (int i = 0; i < cache->poolUsed; i++)
+	{
+		if (cache->pool[i].page == page)
+		{
+			return;
+		}
+		slot += cache->pool[i].lastUse > lastUse;
+	}
+
+	if (cache->poolUsed == cache->poolSize)
+	{
+		if (slot == 0)
+		{
+			return;
+		}
+
+		/* Full: the newest entry makes room. */
+
+		memmove(&cache->pool[0], &cache->pool[1], (size_t)(slot - 1) * sizeof(SampledCandidate));
+		slot--;
+	}
+	else
+	{
+		memmove(&cache->pool[slot + 1], &cache->pool[slot], (size_t)(cache->poolUsed - slot) * sizeof(SampledCandidate));
+		cache->poolUsed++;
+	}
+
+	cache->pool[slot].page    = page;
+	cache->pool[slot].lastUse = lastUse;
+}
+
+/*************************************************************************
+*   @ End of Sampled access                                               *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Sampled command                                                     *
+*                                                                         *
+*  The trace is read into memory first, then exact LRU and every sampled  *
+*  configuration replay it in turn, so the times compare the policies     *
+*  and not the parser.                                                    *
+ *************************************************************************/
+
+/* Nanoseconds per hit: the resident pages are referenced again in a scattered order, so
+ * every access hits and only the hit path is timed. */
+
+static double hitNanos(PagingEngine* engine, SampledLru* cache)
+{
+	const unsigned long long* pages = engine != NULL ? engine->framePage : cache->framePage;
+	int                       used  = engine != NULL ? engine->usedFrames : cache->usedFrames;
+	PageRef*                  refs  = used > 0 ? (PageRef*)calloc((size_t)used, sizeof(PageRef)) : NULL;
+	AccessResult              result;
+	unsigned long long        hits  = 0;
+
+	if (refs == NULL)
+	{
+		return 0.0;
+	}
+
+	for (int i = 0; i < used; i++)
+	{
+		refs[i].page   = pages[pageHash((unsigned long long)i) % (unsigned long long)used];
+		refs[i].access = ACCESS_READ;
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	while (hits < SAMPLED_HIT_PASS)
+	{
+		for (int i = 0; i < used; i++)
+		{
+			if (engine != NULL)
+			{
+				engineAccess(engine, &refs[i], &result);
+			}
+			else
+			{
+				sampledAccess(cache, &refs[i]);
+			}
+		}
+		hits += (unsigned long long)used;
+	}
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	free(refs);
+
+	return 1e9 * seconds / (double)hits;
+}
+
+static void printSampledRow(const char* name, const EngineStats* stats, const EngineStats* lru, double seconds,
+	double hitCost, double sampledPerEviction)
+{
+	printf("| %-16s | %14llu | %8.3f%% | %+7.2f%% | %8.1f | %8.1f | %9.1f |\n", name, stats->faults,
+		stats->references ? 100.0 * (double)stats->faults / (double)stats->references : 0.0,
+		lru->faults ? 100.0 * ((double)stats->faults - (double)lru->faults) / (double)lru->faults : 0.0,
+		stats->references ? 1e9 * seconds / (double)stats->references : 0.0, hitCost, sampledPerEviction);
+}
+
+int runSampledCommand(int argCount, char* args[])
+{
+	TraceBuffer  buffer;
+	PagingEngine lru;
+	SampledLru   cache;
+	AccessResult result;
+	int          points[SAMPLED_MAX_POINTS] = { 1, 3, 5, 10 };
+	int          pointsNum                  = 4;
+	int          status;
+
+	if (argCount < 4)
+	{
+		printf("Usage: %s\n", SAMPLED_USAGE);
+		return -1;
+	}
+
+	int format    = traceFormatFromName(args[1]);
+	int framesNum = atoi(args[3]);
+	int poolSize  = argCount > 5 ? atoi(args[5]) : SAMPLED_POOL_SIZE;
+
+	if ((format == TRACE_FORMAT_UNKNOWN) | (framesNum < 1) | (poolSize < 0) | (poolSize > SAMPLED_MAX_POOL))
+	{
+		printf("Usage: %s\n", SAMPLED_USAGE);
+		return -1;
+	}
+
+	if (argCount > 4)
+	{
+		pointsNum = 0;
+
+		for (char* samples = args[4]; (*samples != '\0') & (pointsNum < SAMPLED_MAX_POINTS);)
+		{
+			long samplesNum = strtol(samples, &samples, 10);
+
+			if (samplesNum < 1)
+			{
+				printf("Usage: %s\n", SAMPLED_USAGE);
+				return -1;
+			}
+			points[pointsNum++] = (int)samplesNum;
+
+			if (*samples == ',')
+			{
+				samples++;
+			}
+		}
+	}
+
+	traceBufferInit(&buffer);
+
+	if ((loadTrace(args[2], format, 0, traceBufferSink, &buffer) != 0) | (engineCreate(&lru, POLICY_LRU, framesNum) != 0))
+	{
+		traceBufferFree(&buffer);
+		engineDestroy(&lru);
+		return -1;
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for (size_t i = 0; i < buffer.count; i++)
+	{
+		engineAccess(&lru, &buffer.refs[i], &result);
+	}
+
+	double      lruSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	EngineStats lruStats   = lru.stats;
+
+	printf("\n Trace %s: %llu references, %d frames, eviction pool of %d\n\n", args[2], lruStats.references,
+		framesNum, poolSize);
+	printf(" --------------------------------------------------------------------------------------------\n");
+	printf("| Policy           |     Faults     | Miss rate |   Gap    | ns / ref | ns / hit | Samples / |\n");
+	printf("|                  |                |           |          |          |          | eviction  |\n");
+	printf(" --------------------------------------------------------------------------------------------\n");
+	printSampledRow("LRU", &lruStats, &lruStats, lruSeconds, hitNanos(&lru, NULL), 0.0);
+
+	status = 0;
+
+	for (int p = 0; (p < pointsNum) & (status == 0); p++)
+	{
+		for (int pooled = 0; (pooled <= (poolSize > 0)) & (status == 0); pooled++)
+		{
+			char name[32];
+
+			if (sampledCreate(&cache, framesNum, points[p], pooled ? poolSize : 0) != 0)
+			{
+				printf("Not enough memory for %d frames!\n", framesNum);
+				status = -1;
+				break;
+			}
+
+			start = std::chrono::steady_clock::now();
+
+			for (size_t i = 0; (i < buffer.count) & (status == 0); i++)
+			{
+				status = sampledAccess(&cache, &buffer.refs[i]) < 0 ? -1 : 0;
+			}
+
+			double      seconds     = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			EngineStats stats       = cache.stats;
+			double      perEviction = stats.evictions ? (double)cache.sampled / (double)stats.evictions : 0.0;
+
+			snprintf(name, sizeof(name), pooled ? "sampled %d+pool" : "sampled %d", points[p]);
+			printSampledRow(name, &stats, &lruStats, seconds, hitNanos(NULL, &cache), perEviction);
+			sampledDestroy(&cache);
+		}
+	}
+	printf(" --------------------------------------------------------------------------------------------\n");
+
+	engineDestroy(&lru);
+	traceBufferFree(&buffer);
+
+	return status;
+}
+
+/*************************************************************************
+*   @ End of Sampled command                                              *
+*                                                                         *
+ *************************************************************************/
@@ -0,0 +1,55 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: Approximate LRU by random sampling, as in Redis. A hit only stamps the frame
+ * with the current time; a fault evicts the oldest of N frames picked at random from the
+ * dense array of resident pages, optionally through an eviction pool that keeps the
+ * oldest candidates of earlier samples. The command compares it with the exact LRU
+ * engine: faults, miss ratio gap and time per reference.
+*/
+
+
+#ifndef SAMPLED_LRU_H
+#define SAMPLED_LRU_H
+
+#include "PagingEngine.h"
+
+#define SAMPLED_USAGE        "sampled <lackey|pin|csv|bin> <file> <frames> [samples[,samples...]] [pool]"
+#define SAMPLED_MAX_POINTS   16
+#define SAMPLED_POOL_SIZE    16      /* Redis EVPOOL_SIZE */
+#define SAMPLED_MAX_POOL     64
+#define SAMPLED_HIT_PASS     (1 << 22)  /* references of the hit timing pass */
+
+
+/* Eviction pool candidate; stale once its page is evicted or used again. */
+
+struct SampledCandidate
+{
+	unsigned long long page;
+	unsigned long long lastUse;
+};
+
+struct SampledLru
+{
+	int                 framesNum;
+	int                 usedFrames;    /* frames 0..usedFrames - 1 hold pages */
+	int                 samples;
+	int                 poolSize;      /* 0: no pool */
+	int                 poolUsed;
+	unsigned long long* framePage;
+	unsigned long long* lastUse;
+	unsigned char*      dirty;
+	SampledCandidate*   pool;          /* newest first, the next victim last */
+	PageIndex           frames;        /* resident page -> frame */
+	unsigned long long  clock;
+	unsigned long long  random;
+	unsigned long long  sampled;       /* frames looked at by evictions */
+	EngineStats         stats;
+};
+
+int  sampledCreate(SampledLru* cache, int framesNum, int samples, int poolSize);
+void sampledDestroy(SampledLru* cache);
+int  sampledAccess(SampledLru* cache, const PageRef* ref);
+
+int  runSampledCommand(int argCount, char* args[]);
+
+#endif // !SAMPLED_LRU_H
@@ -0,0 +1,761 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: Snapshot.cpp contains the engine snapshot format and the snapshot and resume
+ * commands.
+ *
+ * Layout: a fixed header (magic, version, engine scalars, trace offset, statistics and a
+ * table of sections) followed by the engine arrays, each starting on an 8 byte boundary,
+ * so a snapshot can be read in one piece and used in place. The resident page index is rebuilt from
+ * the frame pages on load; the LFU usage counts are stored as (page, count) pairs.
+ * Snapshots are written to a temporary file, synced and renamed, so a checkpoint is never
+ * torn, not even by a crash of the machine. Resuming checks that the trace is the one the
+ * snapshot was taken from.
+*/
+
+
+
+#include "Snapshot.h"
+#include "TraceParser.h"
+#include <string.h>
+#include <chrono>
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#define SECTION_FRAME_PAGE   0
+#define SECTION_REFERENCED   1
+#define SECTION_DIRTY        2
+#define SECTION_OLDER        3
+#define SECTION_NEWER        4
+#define SECTION_HEAP         5
+#define SECTION_HEAP_SLOT    6
+#define SECTION_HEAP_KEY     7
+#define SECTION_USAGE        8
+#define SNAPSHOT_SECTIONS    9
+
+
+struct SnapshotSection
+{
+	unsigned long long offset;
+	unsigned long long bytes;
+};
+
+struct SnapshotHeader
+{
+	char               magic[8];
+	unsigned int       version;
+	unsigned int       pageShift;
+	int                policy;
+	int                framesNum;
+	int                usedFrames;
+	int                hand;
+	int                mru;
+	int                lru;
+	SnapshotTrace      trace;
+	EngineStats        stats;
+	SnapshotSection    sections[SNAPSHOT_SECTIONS];
+};
+
+/* A run from a trace position, with optional checkpoints. */
+
+struct SnapshotJob
+{
+	PagingEngine*      engine;
+	SnapshotTrace      trace;        /* offset: references of the trace consumed so far */
+	unsigned long long end;          /* stop before this position, 0: end of trace */
+	unsigned long long every;
+	const char*        outPath;
+	int                failed;
+};
+
+
+static int runSnapshotJob(PagingEngine* engine, const char* tracePath, const SnapshotTrace* start,
+	unsigned long long limit, const char* outPath, unsigned long long every);
+static int syncFile(FILE* file);
+static int replaceFile(const char* from, const char* to);
+static int checkEngineState(const PagingEngine* engine);
+
+
+/*************************************************************************
+*   @ Save                                                                *
+*                                                                         *
+ *************************************************************************/
+
+static int writeSection(FILE* file, SnapshotSection* section, unsigned long long* offset, const void* data,
+	unsigned long long bytes)
+{
+	static const char padding[8] = { 0 };
+	size_t            padded      = (size_t)((bytes + 7) & ~7ULL);
+
+	section->offset = *offset;
+	section->bytes  = bytes;
+	*offset        += padded;
+
+	/* An empty section, like the usage counts of most policies, may have no array at all. */
+
+	if ((bytes > 0) &&
+		((fwrite(data, 1, (size_t)bytes, file) != bytes) || (fwrite(padding, 1, padded - (size_t)bytes, file) != padded - bytes)))
+	{
+		return -1;
+	}
+
+	return 0;
+}
+
+int engineSave(const PagingEngine* engine, const SnapshotTrace* trace, const char* path)
+{
+	SnapshotHeader      header;
+	unsigned long long  offset   = sizeof(header);
+	unsigned long long* usage    = NULL;
+	size_t              usageNum = 0;
+	size_t              frames   = (size_t)engine->framesNum;
+	char                tmpPath[4096];
+	int                 status   = 0;
+	FILE*               file;
+
+	if (engine->usageFreq.control != NULL)
+	{
+		unsigned long long page;
+		unsigned long long count;
+		size_t             cursor = 0;
+
+		usage = (unsigned long long*)malloc((engine->usageFreq.count + 1) * 2 * sizeof(unsigned long long));
+
+		if (usage == NULL)
+		{
+			return -1;
+		}
+
+		while (pageIndexNext(&engine->usageFreq, &cursor, &page, &count))
+		{
+			usage[usageNum * 2]     = page;
+			usage[usageNum * 2 + 1] = count;
+			usageNum++;
+		}
+	}
+
+	snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+	file = fopen(tmpPath, "wb");
+
+	if (file == NULL)
+	{
+		printf("Cannot create snapshot '%s'!\n", tmpPath);
+		free(usage);
+		return -1;
+	}
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+	header.version     = SNAPSHOT_VERSION;
+	header.pageShift   = TRACE_PAGE_SHIFT;
+	header.policy      = engine->policy;
+	header.framesNum   = engine->framesNum;
+	header.usedFrames  = engine->usedFrames;
+	header.hand        = engine->hand;
+	header.mru         = engine->mru;
+	header.lru         = engine->lru;
+	header.trace       = *trace;
+	header.stats       = engine->stats;
+
+	/* The header is written twice: first as a placeholder, then with the section table. */
+
+	status |= fwrite(&header, sizeof(header), 1, file) != 1 ? -1 : 0;
+	status |= writeSection(file, &header.sections[SECTION_FRAME_PAGE], &offset, engine->framePage,
+		frames * sizeof(unsigned long long));
+	status |= writeSection(file, &header.sections[SECTION_REFERENCED], &offset, engine->referenced, frames);
+	status |= writeSection(file, &header.sections[SECTION_DIRTY], &offset, engine->dirty, frames);
+	status |= writeSection(file, &header.sections[SECTION_OLDER], &offset, engine->older, frames * sizeof(int));
+	status |= writeSection(file, &header.sections[SECTION_NEWER], &offset, engine->newer, frames * sizeof(int));
+	status |= writeSection(file, &header.sections[SECTION_HEAP], &offset, engine->heap, frames * sizeof(int));
+	status |= writeSection(file, &header.sections[SECTION_HEAP_SLOT], &offset, engine->heapSlot, frames * sizeof(int));
+	status |= writeSection(file, &header.sections[SECTION_HEAP_KEY], &offset, engine->heapKey,
+		frames * sizeof(unsigned long long));
+	status |= writeSection(file, &header.sections[SECTION_USAGE], &offset, usage,
+		usageNum * 2 * sizeof(unsigned long long));
+
+	if ((fseek(file, 0, SEEK_SET) != 0) || (fwrite(&header, sizeof(header), 1, file) != 1) || (syncFile(file) != 0))
+	{
+		status = -1;
+	}
+
+	if (fclose(file) != 0)
+	{
+		status = -1;
+	}
+	free(usage);
+
+	if ((status != 0) || (replaceFile(tmpPath, path) != 0))
+	{
+		printf("Writing snapshot '%s' failed!\n", path);
+		remove(tmpPath);
+		return -1;
+	}
+
+	return 0;
+}
+
+/* Flushes the stream and the operating system's cache, so the data is on disk before the rename. */
+
+static int syncFile(FILE* file)
+{
+	if (fflush(file) != 0)
+	{
+		return -1;
+	}
+
+#ifdef _WIN32
+	return _commit(_fileno(file));
+#else
+	return fsync(fileno(file));
+#endif
+}
+
+/* Replaces to with from in one step; rename does not overwrite an existing file on Windows. */
+
+static int replaceFile(const char* from, const char* to)
+{
+#ifdef _WIN32
+	return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) ? 0 : -1;
+#else
+	return rename(from, to);
+#endif
+}
+
+/*************************************************************************
+*   @ End of Save                                                         *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Load                                                                *
+*                                                                         *
+*  Reads the snapshot, checks every section against the header and        *
+*  copies it into a new engine. The copied state is checked before it is  *
+*  used: every frame index must lie within the used frames, the LRU list  *
+*  and the heap must each hold every used frame once, and no page may be  *
+*  resident twice.                                                        *
+ *************************************************************************/
+
+static int checkEngineState(const PagingEngine* engine)
+{
+	int            used   = engine->usedFrames;
+	int            status = 0;
+	unsigned char* seen;
+
+	if ((engine->hand < 0) | (engine->hand >= engine->framesNum))
+	{
+		return -1;
+	}
+
+	for (int frame = 0; frame < used; frame++)
+	{
+		if ((engine->referenced[frame] > 1) | (engine->dirty[frame] > 1))
+		{
+			return -1;
+		}
+	}
+
+	seen = (unsigned char*)calloc((size_t)used + 1, 1);
+
+	if (seen == NULL)
+	{
+		return -1;
+	}
+
+	if (engine->policy == POLICY_LRU)
+	{
+		/* Walk from the MRU end: each frame once, linked both ways, ending at the LRU end. */
+
+		int frame = engine->mru;
+		int newer = -1;
+		int count = 0;
+
+		if ((used == 0) != (frame == -1))
+		{
+			status = -1;
+		}
+
+		while ((frame != -1) & (status == 0))
+		{
+			if ((frame < 0) || (frame >= used) || seen[frame] || (engine->newer[frame] != newer))
+			{
+				status = -1;
+				break;
+			}
+			seen[frame] = 1;
+			count++;
+			newer = frame;
+			frame = engine->older[frame];
+		}
+
+		if ((status == 0) & ((count != used) | (engine->lru != newer)))
+		{
+			status = -1;
+		}
+	}
+	else if ((engine->mru != -1) | (engine->lru != -1))
+	{
+		status = -1;
+	}
+
+	if ((engine->policy == POLICY_LFU) | (engine->policy == POLICY_OPT))
+	{
+		for (int slot = 0; (slot < used) & (status == 0); slot++)
+		{
+			int frame = engine->heap[slot];
+
+			if ((frame < 0) || (frame >= used) || seen[frame] || (engine->heapSlot[frame] != slot))
+			{
+				status = -1;
+			}
+			else
+			{
+				seen[frame] = 1;
+			}
+		}
+	}
+
+	free(seen);
+
+	return status;
+}
+
+
+int engineLoad(PagingEngine* engine, SnapshotTrace* trace, const char* path)
+{
+	const SnapshotHeader* header;
+	unsigned char*        base;
+	long                  size;
+	size_t                frames;
+	int                   status  = -1;
+	int                   damaged = 0;
+	FILE*                 file    = fopen(path, "rb");
+
+	memset(engine, 0, sizeof(*engine));
+
+	if (file == NULL)
+	{
+		printf("Cannot open snapshot '%s'!\n", path);
+		return -1;
+	}
+
+	if ((fseek(file, 0, SEEK_END) != 0) || ((size = ftell(file)) < (long)sizeof(SnapshotHeader)) ||
+		(fseek(file, 0, SEEK_SET) != 0))
+	{
+		printf("'%s' is not a snapshot!\n", path);
+		fclose(file);
+		return -1;
+	}
+
+	base = (unsigned char*)malloc((size_t)size);
+
+	if ((base == NULL) || (fread(base, 1, (size_t)size, file) != (size_t)size))
+	{
+		printf("Cannot read snapshot '%s'!\n", path);
+		free(base);
+		fclose(file);
+		return -1;
+	}
+	fclose(file);
+
+	header = (const SnapshotHeader*)base;
+	frames = (size_t)(header->framesNum > 0 ? header->framesNum : 0);
+
+	static const unsigned long long entrySize[SNAPSHOT_SECTIONS] =
+	{
+		sizeof(unsigned long long), 1, 1, sizeof(int), sizeof(int), sizeof(int), sizeof(int), sizeof(unsigned long long), 0
+	};
+
+	if ((memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) | (header->version != SNAPSHOT_VERSION) |
+		(header->pageShift != TRACE_PAGE_SHIFT) | (header->usedFrames < 0) | (header->usedFrames > header->framesNum))
+	{
+		printf("'%s' is not a version %d snapshot!\n", path, SNAPSHOT_VERSION);
+		free(base);
+		return -1;
+	}
+
+	/* The engine saw every reference of the trace prefix once. */
+
+	if ((header->stats.references != header->trace.offset) | (header->stats.faults > header->stats.references) |
+		(header->stats.evictions > header->stats.faults) | (header->stats.writebacks > header->stats.evictions) |
+		(header->trace.digest.tailUsed >= sizeof(header->trace.digest.tail)))
+	{
+		printf("Snapshot '%s' is damaged!\n", path);
+		free(base);
+		return -1;
+	}
+
+	for (int s = 0; s < SNAPSHOT_SECTIONS; s++)
+	{
+		const SnapshotSection* section = &header->sections[s];
+
+		if ((section->offset > (unsigned long long)size) |
+			(section->bytes > (unsigned long long)size - section->offset) | (section->offset % 8 != 0) |
+			((entrySize[s] != 0) & (section->bytes != entrySize[s] * frames)) |
+			((s == SECTION_USAGE) & (section->bytes % (2 * sizeof(unsigned long long)) != 0)))
+		{
+			printf("Snapshot '%s' is damaged!\n", path);
+			free(base);
+			return -1;
+		}
+	}
+
+	if (engineCreate(engine, header->policy, header->framesNum) == 0)
+	{
+		const SnapshotSection*    sections = header->sections;
+		const unsigned long long* usage    = (const unsigned long long*)(base + sections[SECTION_USAGE].offset);
+		size_t                    usageNum = (size_t)(sections[SECTION_USAGE].bytes / (2 * sizeof(unsigned long long)));
+
+		memcpy(engine->framePage, base + sections[SECTION_FRAME_PAGE].offset, sections[SECTION_FRAME_PAGE].bytes);
+		memcpy(engine->referenced, base + sections[SECTION_REFERENCED].offset, sections[SECTION_REFERENCED].bytes);
+		memcpy(engine->dirty, base + sections[SECTION_DIRTY].offset, sections[SECTION_DIRTY].bytes);
+		memcpy(engine->older, base + sections[SECTION_OLDER].offset, sections[SECTION_OLDER].bytes);
+		memcpy(engine->newer, base + sections[SECTION_NEWER].offset, sections[SECTION_NEWER].bytes);
+		memcpy(engine->heap, base + sections[SECTION_HEAP].offset, sections[SECTION_HEAP].bytes);
+		memcpy(engine->heapSlot, base + sections[SECTION_HEAP_SLOT].offset, sections[SECTION_HEAP_SLOT].bytes);
+		memcpy(engine->heapKey, base + sections[SECTION_HEAP_KEY].offset, sections[SECTION_HEAP_KEY].bytes);
+
+		engine->usedFrames = header->usedFrames;
+		engine->hand       = header->hand;
+		engine->mru        = header->mru;
+		engine->lru        = header->lru;
+		engine->stats      = header->stats;
+		*trace             = header->trace;
+		status             = checkEngineState(engine);
+		damaged            = status != 0;
+
+		for (int frame = 0; (frame < engine->usedFrames) & (status == 0); frame++)
+		{
+			unsigned long long other;
+
+			if (pageIndexFind(&engine->frames, engine->framePage[frame], &other))
+			{
+				damaged = 1;
+				status  = -1;
+				break;
+			}
+			status = pageIndexSet(&engine->frames, engine->framePage[frame], (unsigned long long)frame);
+		}
+
+		for (size_t i = 0; (i < usageNum) & (status == 0) & (engine->policy == POLICY_LFU); i++)
+		{
+			status = pageIndexSet(&engine->usageFreq, usage[i * 2], usage[i * 2 + 1]);
+		}
+
+		if (status != 0)
+		{
+			engineDestroy(engine);
+		}
+	}
+
+	free(base);
+
+	if (status != 0)
+	{
+		printf(damaged ? "Snapshot '%s' is damaged!\n" : "Cannot restore snapshot '%s'!\n", path);
+	}
+
+	return status;
+}
+
+/*************************************************************************
+*   @ End of Load                                                         *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Snapshot job                                                        *
+*                                                                         *
+*  Feeds the engine from trace position start for limit references (0:    *
+*  to the end), writes a checkpoint every `every` references and a final  *
+*  snapshot. OPT loads the rest of the trace for its future knowledge.    *
+ *************************************************************************/
+
+static int snapshotJobSink(void* context, const PageRef* refs, size_t count)
+{
+	SnapshotJob* job = (SnapshotJob*)context;
+	AccessResult result;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		if ((job->end != 0) && (job->trace.offset == job->end))
+		{
+			return 1;
+		}
+
+		engineAccess(job->engine, &refs[i], &result);
+		traceDigestRefs(&job->trace.digest, &refs[i], 1);
+		job->trace.offset++;
+
+		if ((job->every != 0) && (job->trace.offset % job->every == 0) &&
+			(engineSave(job->engine, &job->trace, job->outPath) != 0))
+		{
+			job->failed = 1;
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+static int runSnapshotJob(PagingEngine* engine, const char* tracePath, const SnapshotTrace* start,
+	unsigned long long limit, const char* outPath, unsigned long long every)
+{
+	SnapshotJob        job;
+	int                format = start->format;
+	unsigned long long first  = start->offset;
+	int                status;
+
+	job.engine  = engine;
+	job.trace   = *start;
+	job.end     = limit != 0 ? first + limit : 0;
+	job.every   = outPath != NULL ? every : 0;
+	job.outPath = outPath;
+	job.failed  = 0;
+
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+
+	if (engine->policy == POLICY_OPT)
+	{
+		TraceBuffer         buffer;
+		unsigned long long* nextUse = NULL;
+
+		traceBufferInit(&buffer);
+		status = loadTraceFrom(tracePath, format, 0, first, traceBufferSink, &buffer);
+
+		if (status == 0)
+		{
+			nextUse = (unsigned long long*)malloc((buffer.count + 1) * sizeof(unsigned long long));
+			status  = (nextUse == NULL) || (computeNextUse(buffer.refs, buffer.count, nextUse) != 0) ||
+				(engineResumeFuture(engine, buffer.refs, buffer.count, nextUse, first) != 0) ? -1 : 0;
+		}
+
+		if (status == 0)
+		{
+			status = snapshotJobSink(&job, buffer.refs, buffer.count);
+		}
+		engineSetFuture(engine, NULL);
+		traceBufferFree(&buffer);
+		free(nextUse);
+	}
+	else
+	{
+		status = loadTraceFrom(tracePath, format, 0, first, snapshotJobSink, &job);
+	}
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+	if ((status < 0) | job.failed)
+	{
+		return -1;
+	}
+
+	if ((outPath != NULL) && (engineSave(engine, &job.trace, outPath) != 0))
+	{
+		return -1;
+	}
+
+	EngineStats* stats = &engine->stats;
+
+	printf("\n Trace %s: references %llu to %llu, %d frames, %.2f s\n\n", tracePath, first, job.trace.offset,
+		engine->framesNum, seconds);
+	printf(" --------------------------------------------------\n");
+	printf("| Policy |     Faults     |   Evictions    | Rate  |\n");
+	printf(" --------------------------------------------------\n");
+	printf("| %-6s | %14llu | %14llu |%5.1f%% |\n", policyName(engine->policy), stats->faults, stats->evictions,
+		stats->references ? 100.0 * (double)stats->faults / (double)stats->references : 0.0);
+	printf(" --------------------------------------------------\n");
+
+	if (outPath != NULL)
+	{
+		printf("Snapshot at reference %llu written to %s\n", job.trace.offset, outPath);
+	}
+
+	return 0;
+}
+
+/*************************************************************************
+*   @ End of Snapshot job                                                 *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Trace check                                                         *
+*                                                                         *
+*  A resumed trace must have the format and size the snapshot saved. If   *
+*  its file was modified since, the references before the saved position  *
+*  are digested again and must match the saved digest.                    *
+ *************************************************************************/
+
+struct PrefixCheck
+{
+	TraceDigest        digest;
+	unsigned long long left;
+};
+
+static int prefixCheckSink(void* context, const PageRef* refs, size_t count)
+{
+	PrefixCheck* check = (PrefixCheck*)context;
+	size_t       taken = count < check->left ? count : (size_t)check->left;
+
+	traceDigestRefs(&check->digest, refs, taken);
+	check->left -= taken;
+
+	return check->left == 0;
+}
+
+static int checkSnapshotTrace(SnapshotTrace* trace, int format, const char* path)
+{
+	TraceIdentity      identity;
+	PrefixCheck        check;
+	unsigned long long saved[2];
+	unsigned long long found[2];
+
+	if (traceIdentityInit(&identity, path) != 0)
+	{
+		printf("Cannot open trace file '%s'!\n", path);
+		return -1;
+	}
+
+	if ((format == trace->format) & (identity.bytes == trace->bytes) & (identity.mtimeNs == trace->mtimeNs))
+	{
+		return 0;
+	}
+
+	traceDigestInit(&check.digest);
+	check.left = trace->offset;
+
+	if ((format == trace->format) & (identity.bytes == trace->bytes) &&
+		((check.left == 0) || (loadTrace(path, format, 0, prefixCheckSink, &check) >= 0)))
+	{
+		traceDigestFinal(&check.digest, found);
+		traceDigestFinal(&trace->digest, saved);
+
+		if ((check.left == 0) & (found[0] == saved[0]) & (found[1] == saved[1]))
+		{
+			trace->mtimeNs = identity.mtimeNs;
+			return 0;
+		}
+	}
+
+	printf("'%s' is not the trace the snapshot was taken from!\n", path);
+
+	return -1;
+}
+
+/*************************************************************************
+*   @ End of Trace check                                                  *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Snapshot / resume commands                                          *
+*                                                                         *
+*  Counts are cumulative: a resumed run reports the faults of the whole   *
+*  trace so far, not only of the references it simulated.                 *
+ *************************************************************************/
+
+int runSnapshotCommand(int argCount, char* args[])
+{
+	PagingEngine  engine;
+	SnapshotTrace start;
+	TraceIdentity identity;
+	int           format;
+	int           framesNum;
+	int           policy;
+	int           status;
+
+	if (argCount < 6)
+	{
+		printf("Usage: %s\n", SNAPSHOT_USAGE);
+		return -1;
+	}
+
+	format    = traceFormatFromName(args[1]);
+	framesNum = atoi(args[3]);
+	policy    = policyFromName(args[4]);
+
+	if ((format == TRACE_FORMAT_UNKNOWN) | (framesNum < 1) | (policy < 0))
+	{
+		printf("Usage: %s\n", SNAPSHOT_USAGE);
+		return -1;
+	}
+
+	if (traceIdentityInit(&identity, args[2]) != 0)
+	{
+		printf("Cannot open trace file '%s'!\n", args[2]);
+		return -1;
+	}
+
+	memset(&start, 0, sizeof(start));
+	start.format  = format;
+	start.bytes   = identity.bytes;
+	start.mtimeNs = identity.mtimeNs;
+	traceDigestInit(&start.digest);
+
+	if (engineCreate(&engine, policy, framesNum) != 0)
+	{
+		printf("Not enough memory for %d frames!\n", framesNum);
+		return -1;
+	}
+
+	status = runSnapshotJob(&engine, args[2], &start, argCount > 6 ? (unsigned long long)atoll(args[6]) : 0,
+		args[5], argCount > 7 ? (unsigned long long)atoll(args[7]) : 0);
+
+	engineDestroy(&engine);
+
+	return status;
+}
+
+int runResumeCommand(int argCount, char* args[])
+{
+	PagingEngine  engine;
+	SnapshotTrace start;
+	int           format;
+	int           status;
+
+	if (argCount < 4)
+	{
+		printf("Usage: %s\n", RESUME_USAGE);
+		return -1;
+	}
+
+	format = traceFormatFromName(args[2]);
+
+	if (format == TRACE_FORMAT_UNKNOWN)
+	{
+		printf("Usage: %s\n", RESUME_USAGE);
+		return -1;
+	}
+
+	if (engineLoad(&engine, &start, args[1]) != 0)
+	{
+		return -1;
+	}
+
+	if (checkSnapshotTrace(&start, format, args[3]) != 0)
+	{
+		engineDestroy(&engine);
+		return -1;
+	}
+
+	status = runSnapshotJob(&engine, args[3], &start, argCount > 4 ? (unsigned long long)atoll(args[4]) : 0,
+		argCount > 5 ? args[5] : NULL, argCount > 6 ? (unsigned long long)atoll(args[6]) : 0);
+
+	engineDestroy(&engine);
+
+	return status;
+}
+
+/*************************************************************************
+*   @ End of Snapshot / resume commands                                   *
+*                                                                         *
+ *************************************************************************/
@@ -0,0 +1,39 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: Engine snapshots. The state of a paging engine is saved together with the
+ * number of trace references it has consumed and the identity of that trace, so a long
+ * simulation can be resumed and many runs can be branched from one warmed-up state.
+*/
+
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "PagingEngine.h"
+#include "ResultCache.h"
+
+#define SNAPSHOT_USAGE       "snapshot <lackey|pin|csv|bin> <file> <frames> <policy> <out.snap> [refs] [every]"
+#define RESUME_USAGE         "resume <in.snap> <lackey|pin|csv|bin> <file> [refs] [out.snap] [every]"
+#define SNAPSHOT_MAGIC       "PGSNAP"
+#define SNAPSHOT_VERSION     2
+
+
+/* Where a snapshot stands in its trace. The digest covers the references consumed, so a
+ * trace whose file was touched or copied can still be proven the same. */
+
+struct SnapshotTrace
+{
+	int                format;
+	unsigned long long offset;      /* references consumed */
+	unsigned long long bytes;       /* size of the trace file */
+	long long          mtimeNs;     /* modification time of the trace file */
+	TraceDigest        digest;
+};
+
+int engineSave(const PagingEngine* engine, const SnapshotTrace* trace, const char* path);
+int engineLoad(PagingEngine* engine, SnapshotTrace* trace, const char* path);
+
+int runSnapshotCommand(int argCount, char* args[]);
+int runResumeCommand(int argCount, char* args[]);
+
+#endif // !SNAPSHOT_H
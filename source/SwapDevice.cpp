@@ -0,0 +1,205 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: SwapDevice.cpp contains the swap device cost model and the swap command.
+ *
+ * The device serves up to queueDepth requests at once. Their latencies overlap, but the
+ * pages themselves go one after the other through a single data channel at the device
+ * bandwidth. The simulated program runs referenceNs per reference and stops on a fault
+ * until its page has been read. The dirty victim is queued for write-back just before
+ * that read, so the program never waits for the write itself, only for the queue slot
+ * and the channel time it takes away from the read.
+*/
+
+
+
+#include "SwapDevice.h"
+#include "TraceCommands.h"
+#include "TraceParser.h"
+#include <string.h>
+
+
+static int                swapEarliestSlot(const SwapDevice* device);
+static unsigned long long swapSubmit(SwapDevice* device, int slot, unsigned long long latencyNs);
+
+
+/*************************************************************************
+*   @ Create / destroy                                                    *
+*                                                                         *
+*  Defaults describe a mid-range SSD used as swap.                        *
+ *************************************************************************/
+
+void swapConfigDefaults(SwapConfig* config)
+{
+	config->readLatencyNs  = 100000;
+	config->writeLatencyNs = 100000;
+	config->bytesPerSecond = 500000000ULL;
+	config->queueDepth     = 32;
+	config->referenceNs    = 100;
+}
+
+int swapDeviceCreate(SwapDevice* device, const SwapConfig* config)
+{
+	memset(device, 0, sizeof(*device));
+
+	if ((config->queueDepth < 1) | (config->queueDepth > SWAP_MAX_QUEUE_DEPTH) | (config->bytesPerSecond == 0))
+	{
+		return -1;
+	}
+
+	device->config     = *config;
+	device->transferNs = ((1ULL << TRACE_PAGE_SHIFT) * 1000000000ULL + config->bytesPerSecond - 1) /
+		config->bytesPerSecond;
+	device->slotFree   = (unsigned long long*)calloc(config->queueDepth, sizeof(unsigned long long));
+
+	return device->slotFree != NULL ? 0 : -1;
+}
+
+void swapDeviceDestroy(SwapDevice* device)
+{
+	free(device->slotFree);
+	memset(device, 0, sizeof(*device));
+}
+
+/*************************************************************************
+*   @ End of Create / destroy                                             *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Device access                                                       *
+*                                                                         *
+*  Advances the simulated clock by one reference of engine result. A      *
+*  fault queues the write-back of a dirty victim, then waits for the read *
+*  of the missing page, which may sit behind earlier write-backs. Any     *
+*  wait beyond the read latency and one page transfer is charged to       *
+*  write-back.                                                            *
+ *************************************************************************/
+
+void swapDeviceAccess(SwapDevice* device, const AccessResult* result)
+{
+	int                slot;
+	unsigned long long done;
+
+	device->now += device->config.referenceNs;
+
+	if (!result->fault)
+	{
+		return;
+	}
+
+	if (result->victimDirty)
+	{
+		swapSubmit(device, swapEarliestSlot(device), device->config.writeLatencyNs);
+		device->stats.writes++;
+	}
+
+	slot = swapEarliestSlot(device);
+	done = swapSubmit(device, slot, device->config.readLatencyNs);
+
+	device->stats.stallNs         += done - device->now;
+	device->stats.writebackWaitNs += done - device->now - device->config.readLatencyNs - device->transferNs;
+	device->stats.reads++;
+	device->now                    = done;
+}
+
+static int swapEarliestSlot(const SwapDevice* device)
+{
+	int slot = 0;
+
+	for (int i = 1; i < device->config.queueDepth; i++)
+	{
+		if (device->slotFree[i] < device->slotFree[slot])
+		{
+			slot = i;
+		}
+	}
+
+	return slot;
+}
+
+/* Queues one page in slot at the current time and returns its completion time. */
+
+static unsigned long long swapSubmit(SwapDevice* device, int slot, unsigned long long latencyNs)
+{
+	unsigned long long start    = device->slotFree[slot] > device->now ? device->slotFree[slot] : device->now;
+	unsigned long long transfer = start + latencyNs;
+
+	if (transfer < device->transferFree)
+	{
+		transfer = device->transferFree;
+	}
+
+	device->transferFree   = transfer + device->transferNs;
+	device->slotFree[slot] = device->transferFree;
+	device->stats.busyNs  += device->transferNs;
+
+	return device->transferFree;
+}
+
+/*************************************************************************
+*   @ End of Device access                                                *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Swap command                                                        *
+*                                                                         *
+*  Same run as the trace command, with every engine attached to its own   *
+*  swap device.                                                           *
+ *************************************************************************/
+
+int runSwapCommand(int argCount, char* args[])
+{
+	SwapConfig  config;
+	const char* split;
+	int         format;
+	int         framesNum;
+	int         selected;
+
+	if (argCount < 4)
+	{
+		printf("Usage: %s\n", SWAP_USAGE);
+		return -1;
+	}
+
+	swapConfigDefaults(&config);
+
+	format    = traceFormatFromName(args[1]);
+	framesNum = atoi(args[3]);
+	selected  = policySelectionFromName(argCount > 4 ? args[4] : NULL);
+
+	if (argCount > 5)
+	{
+		split = strchr(args[5], ':');
+		config.readLatencyNs  = (unsigned long long)(atof(args[5]) * 1000.0);
+		config.writeLatencyNs = split != NULL ? (unsigned long long)(atof(split + 1) * 1000.0) : config.readLatencyNs;
+	}
+	if (argCount > 6)
+	{
+		config.bytesPerSecond = (unsigned long long)(atof(args[6]) * 1000000.0);
+	}
+	if (argCount > 7)
+	{
+		config.queueDepth = atoi(args[7]);
+	}
+	if (argCount > 8)
+	{
+		config.referenceNs = (unsigned long long)atoll(args[8]);
+	}
+
+	if ((format == TRACE_FORMAT_UNKNOWN) | (framesNum < 1) | (selected < 0) | (config.bytesPerSecond == 0) |
+		(config.queueDepth < 1) | (config.queueDepth > SWAP_MAX_QUEUE_DEPTH))
+	{
+		printf("Usage: %s\n", SWAP_USAGE);
+		return -1;
+	}
+
+	return simulateTraceFile(args[2], format, framesNum, selected, 0, &config);
+}
+
+/*************************************************************************
+*   @ End of Swap command                                                 *
+*                                                                         *
+ *************************************************************************/
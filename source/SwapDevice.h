@@ -0,0 +1,55 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: Cost model of the swap (backing) device. Page faults read the missing page
+ * synchronously, dirty victims are written back asynchronously, and every request goes
+ * through a device with a latency, a bandwidth and a limited queue depth, so policies
+ * can be ranked by simulated stall time instead of by fault count alone.
+*/
+
+
+#ifndef SWAP_DEVICE_H
+#define SWAP_DEVICE_H
+
+#include "PagingEngine.h"
+
+#define SWAP_USAGE           "swap <lackey|pin|csv|bin> <file> <frames> [policy|streaming|all] [readUs[:writeUs]] [MBps] [queueDepth] [refNs]"
+#define SWAP_MAX_QUEUE_DEPTH 1024
+
+
+struct SwapConfig
+{
+	unsigned long long readLatencyNs;
+	unsigned long long writeLatencyNs;
+	unsigned long long bytesPerSecond;
+	int                queueDepth;
+	unsigned long long referenceNs;     /* CPU time of one reference */
+};
+
+struct SwapStats
+{
+	unsigned long long reads;
+	unsigned long long writes;
+	unsigned long long stallNs;         /* waiting for faulting pages */
+	unsigned long long writebackWaitNs; /* part of stallNs spent behind write-backs */
+	unsigned long long busyNs;          /* time spent transferring pages */
+};
+
+struct SwapDevice
+{
+	SwapConfig          config;
+	unsigned long long* slotFree;       /* completion time of the request in each slot */
+	unsigned long long  transferFree;   /* the data channel is free from this time on */
+	unsigned long long  transferNs;     /* one page at the configured bandwidth */
+	unsigned long long  now;            /* simulated time of the faulting program */
+	SwapStats           stats;
+};
+
+void swapConfigDefaults(SwapConfig* config);
+
+int  swapDeviceCreate(SwapDevice* device, const SwapConfig* config);
+void swapDeviceDestroy(SwapDevice* device);
+void swapDeviceAccess(SwapDevice* device, const AccessResult* result);
+
+int  runSwapCommand(int argCount, char* args[]);
+
+#endif // !SWAP_DEVICE_H
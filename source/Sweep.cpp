@@ -0,0 +1,1062 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: Sweep.cpp contains the shard runner, the forked local sweep and the TCP
+ * coordinator and worker.
+ *
+ * Local sweep: the results table lives in an anonymous shared mapping; forked workers claim
+ * pending shards with a compare-and-swap and the parent reaps them, returning the shards
+ * of a worker that did not exit cleanly to the pending state until they ran out of
+ * attempts, and forking a replacement.
+ *
+ * TCP protocol (text lines): the worker sends "HELLO <references>" and then receives
+ * "SHARD <index> <policy> <frames>" until "DONE"; each shard is answered with
+ * "RESULT <index> <references> <faults> <evictions> <writebacks> <digest> <digest>" (the
+ * two hex words of the worker's trace digest) or "FAIL <index>".
+ * The coordinator keeps the table in its own memory and takes back the shard of a
+ * connection that closes.
+*/
+
+
+
+#include "Sweep.h"
+#include "Trace.h"
+#include "TraceParser.h"
+#include "ResultCache.h"
+#include <string.h>
+#include <chrono>
+
+#ifdef __linux__
+#include <errno.h>
+#include <poll.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#define SWEEP_SUPPORTED
+#endif
+
+#define SWEEP_LINE_SIZE 256
+
+#ifdef SWEEP_SUPPORTED
+
+
+/* Per process state of a worker: the mapped trace, the arena its engines are carved from
+ * (reset between shards), once an OPT shard came, the future of the trace, and the digest
+ * of the trace for the result cache, taken while its first shard streams it. */
+
+struct SweepWorker
+{
+	TraceMap            map;
+	Arena               arena;
+	PageRef*            batch;
+	PageRef*            refs;
+	unsigned long long* nextUse;
+	unsigned long long  digest[2];
+	int                 digested;
+};
+
+struct SweepClient
+{
+	int    fd;
+	int    shard;
+	int    waiting;
+	size_t used;
+	char   line[SWEEP_LINE_SIZE];
+};
+
+
+static int  buildSweepTable(SweepTable* table, char* frames, const char* policyArg, int retries);
+static int  claimShard(SweepTable* table, int worker);
+static void releaseShards(SweepTable* table, int worker);
+static int  pendingShards(const SweepTable* table);
+static void printSweepTable(const SweepTable* table, const char* path, int workers, double seconds);
+static int  loadCachedShards(SweepTable* table, const char* path, ResultKey* key, TraceIdentity* identity);
+static void storeShards(const SweepTable* table, ResultKey* key, const TraceIdentity* identity);
+static int  sweepWorkerOpen(SweepWorker* worker, const char* path);
+static void sweepWorkerClose(SweepWorker* worker);
+static int  runShard(SweepWorker* worker, int policy, int framesNum, EngineStats* stats, unsigned long long digest[2]);
+static int  sendLine(int fd, const char* line);
+static int  runTcpWorker(const char* host, const char* port, const char* path);
+
+
+/*************************************************************************
+*   @ Results table                                                       *
+*                                                                         *
+*  Shards are ordered by frames, then policy; that order is the merge     *
+*  order, so the output does not depend on which worker ran what.         *
+ *************************************************************************/
+
+static int buildSweepTable(SweepTable* table, char* frames, const char* policyArg, int retries)
+{
+	int selected = POLICY_COUNT;
+
+	table->shardsNum   = 0;
+	table->maxAttempts = retries + 1;
+
+	if ((policyArg != NULL) && (strcmp(policyArg, "all") != 0))
+	{
+		selected = policyFromName(policyArg);
+
+		if (selected < 0)
+		{
+			return -1;
+		}
+	}
+
+	while (*frames != '\0')
+	{
+		int framesNum = (int)strtol(frames, &frames, 10);
+
+		if (framesNum < 1)
+		{
+			return -1;
+		}
+
+		for (int policy = 0; policy < POLICY_COUNT; policy++)
+		{
+			if ((selected == POLICY_COUNT) | (selected == policy))
+			{
+				if (table->shardsNum == SWEEP_MAX_SHARDS)
+				{
+					return -1;
+				}
+
+				SweepShard* shard = &table->shards[table->shardsNum++];
+
+				memset(shard, 0, sizeof(*shard));
+				shard->policy    = policy;
+				shard->framesNum = framesNum;
+				shard->state     = SHARD_PENDING;
+			}
+		}
+
+		if (*frames == ',')
+		{
+			frames++;
+		}
+	}
+
+	return table->shardsNum > 0 ? 0 : -1;
+}
+
+/* Claims the first pending shard for worker; returns its index or -1. */
+
+static int claimShard(SweepTable* table, int worker)
+{
+	for (int s = 0; s < table->shardsNum; s++)
+	{
+		SweepShard* shard = &table->shards[s];
+
+		if ((shard->state == SHARD_PENDING) && __sync_bool_compare_and_swap(&shard->state, SHARD_PENDING, SHARD_RUNNING))
+		{
+			shard->worker = worker;
+			shard->attempts++;
+			return s;
+		}
+	}
+
+	return -1;
+}
+
+/* Hands the running shards of a lost worker out again, or fails them after the last attempt. */
+
+static void releaseShards(SweepTable* table, int worker)
+{
+	for (int s = 0; s < table->shardsNum; s++)
+	{
+		SweepShard* shard = &table->shards[s];
+
+		if ((shard->state == SHARD_RUNNING) && (shard->worker == worker))
+		{
+			shard->state = shard->attempts < table->maxAttempts ? SHARD_PENDING : SHARD_FAILED;
+		}
+	}
+}
+
+/* Number of shards not finished yet, pending or running. */
+
+static int pendingShards(const SweepTable* table)
+{
+	int pending = 0;
+
+	for (int s = 0; s < table->shardsNum; s++)
+	{
+		pending += (table->shards[s].state == SHARD_PENDING) | (table->shards[s].state == SHARD_RUNNING);
+	}
+
+	return pending;
+}
+
+static void printSweepTable(const SweepTable* table, const char* path, int workers, double seconds)
+{
+	int retried = 0;
+	int cached  = 0;
+
+	for (int s = 0; s < table->shardsNum; s++)
+	{
+		retried += table->shards[s].attempts > 1 ? table->shards[s].attempts - 1 : 0;
+		cached  += (table->shards[s].state == SHARD_DONE) & (table->shards[s].attempts == 0);
+	}
+
+	printf("\n Sweep %s: %llu references, %d shards, %d cached, %d workers, %d retries, %.2f s\n\n", path,
+		table->references, table->shardsNum, cached, workers, retried, seconds);
+	printf(" ---------------------------------------------------------------------\n");
+	printf("|  Frames  | Policy |     Faults     |   Evictions    | Rate  | Tries |\n");
+	printf(" ---------------------------------------------------------------------\n");
+
+	for (int s = 0; s < table->shardsNum; s++)
+	{
+		const SweepShard* shard = &table->shards[s];
+
+		if (shard->state == SHARD_DONE)
+		{
+			printf("| %8d | %-6s | %14llu | %14llu |%5.1f%% | %5d |\n", shard->framesNum, policyName(shard->policy),
+				shard->stats.faults, shard->stats.evictions,
+				table->references ? 100.0 * (double)shard->stats.faults / (double)table->references : 0.0, shard->attempts);
+		}
+		else
+		{
+			printf("| %8d | %-6s | %14s | %14s |   -   | %5d |\n", shard->framesNum, policyName(shard->policy), "failed",
+				"-", shard->attempts);
+		}
+	}
+	printf(" ---------------------------------------------------------------------\n");
+}
+
+/* Marks the shards found in the result cache as done; they keep 0 attempts. */
+
+static int loadCachedShards(SweepTable* table, const char* path, ResultKey* key, TraceIdentity* identity)
+{
+	if (resultKeyInit(key, identity, path, TRACE_FORMAT_BINARY) != 0)
+	{
+		return -1;
+	}
+
+	for (int s = 0; s < table->shardsNum; s++)
+	{
+		SweepShard* shard = &table->shards[s];
+
+		key->policy    = shard->policy;
+		key->framesNum = shard->framesNum;
+
+		if (resultCacheFind(key, &shard->stats))
+		{
+			shard->state = SHARD_DONE;
+		}
+	}
+
+	return 0;
+}
+
+/* Stores the shards run now, keyed by the digest their workers took of the trace; workers
+ * that streamed different traces make every result suspect, so nothing is stored then. */
+
+static void storeShards(const SweepTable* table, ResultKey* key, const TraceIdentity* identity)
+{
+	const unsigned long long* digest = NULL;
+
+	for (int s = 0; s < table->shardsNum; s++)
+	{
+		const SweepShard* shard = &table->shards[s];
+
+		if ((shard->state != SHARD_DONE) | (shard->attempts == 0))
+		{
+			continue;
+		}
+
+		if (digest == NULL)
+		{
+			digest = shard->digest;
+		}
+		else if ((digest[0] != shard->digest[0]) | (digest[1] != shard->digest[1]))
+		{
+			printf("Workers streamed different traces, results not cached!\n");
+			return;
+		}
+	}
+
+	if (digest == NULL)
+	{
+		return;
+	}
+	resultKeyFinish(key, identity, digest);
+
+	for (int s = 0; s < table->shardsNum; s++)
+	{
+		const SweepShard* shard = &table->shards[s];
+
+		if ((shard->state == SHARD_DONE) & (shard->attempts > 0))
+		{
+			key->policy    = shard->policy;
+			key->framesNum = shard->framesNum;
+			resultCacheStore(key, &shard->stats);
+		}
+	}
+}
+
+/*************************************************************************
+*   @ End of Results table                                                *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Shard runner                                                        *
+*                                                                         *
+*  Non-OPT shards stream the mapped trace in batches; the first OPT shard *
+*  of a worker converts the whole trace once and derives its next uses.   *
+ *************************************************************************/
+
+static int sweepWorkerOpen(SweepWorker* worker, const char* path)
+{
+	memset(worker, 0, sizeof(*worker));
+	arenaInit(&worker->arena, 0);
+
+	if (traceMapOpen(&worker->map, path) != 0)
+	{
+		return -1;
+	}
+
+	worker->batch = (PageRef*)malloc(TRACE_BATCH_REFS * sizeof(PageRef));
+
+	if (worker->batch == NULL)
+	{
+		traceMapClose(&worker->map);
+		return -1;
+	}
+
+	return 0;
+}
+
+static void sweepWorkerClose(SweepWorker* worker)
+{
+	traceMapClose(&worker->map);
+	arenaFree(&worker->arena);
+	free(worker->batch);
+	free(worker->refs);
+	free(worker->nextUse);
+	memset(worker, 0, sizeof(*worker));
+}
+
+static int runShard(SweepWorker* worker, int policy, int framesNum, EngineStats* stats, unsigned long long digest[2])
+{
+	PagingEngine engine;
+	AccessResult result;
+	TraceDigest  streamed;
+	size_t       count = (size_t)worker->map.count;
+	size_t       got;
+
+	if ((policy == POLICY_OPT) && (worker->nextUse == NULL))
+	{
+		worker->refs    = (PageRef*)malloc((count + 1) * sizeof(PageRef));
+		worker->nextUse = (unsigned long long*)malloc((count + 1) * sizeof(unsigned long long));
+
+		if ((worker->refs == NULL) || (worker->nextUse == NULL) ||
+			(traceMapRead(&worker->map, 0, worker->refs, count) != count) ||
+			(computeNextUse(worker->refs, count, worker->nextUse) != 0))
+		{
+			free(worker->refs);
+			free(worker->nextUse);
+			worker->refs    = NULL;
+			worker->nextUse = NULL;
+			return -1;
+		}
+	}
+
+	arenaReset(&worker->arena);
+
+	if (engineCreateIn(&engine, &worker->arena, policy, framesNum) != 0)
+	{
+		return -1;
+	}
+	traceDigestInit(&streamed);
+
+	if (policy == POLICY_OPT)
+	{
+		engineSetFuture(&engine, worker->nextUse);
+
+		if (!worker->digested)
+		{
+			traceDigestRefs(&streamed, worker->refs, count);
+		}
+
+		for (size_t i = 0; i < count; i++)
+		{
+			engineAccess(&engine, &worker->refs[i], &result);
+		}
+	}
+	else
+	{
+		for (unsigned long long first = 0; (got = traceMapRead(&worker->map, first, worker->batch, TRACE_BATCH_REFS)) > 0;
+			first += got)
+		{
+			if (!worker->digested)
+			{
+				traceDigestRefs(&streamed, worker->batch, got);
+			}
+
+			for (size_t i = 0; i < got; i++)
+			{
+				engineAccess(&engine, &worker->batch[i], &result);
+			}
+		}
+	}
+
+	if (!worker->digested)
+	{
+		traceDigestFinal(&streamed, worker->digest);
+		worker->digested = 1;
+	}
+
+	*stats    = engine.stats;
+	digest[0] = worker->digest[0];
+	digest[1] = worker->digest[1];
+	engineDestroy(&engine);
+
+	return 0;
+}
+
+/*************************************************************************
+*   @ End of Shard runner                                                 *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Local sweep                                                         *
+*                                                                         *
+ *************************************************************************/
+
+static int forkLocalWorker(SweepTable* table, const char* path)
+{
+	fflush(stdout);
+
+	pid_t pid = fork();
+
+	if (pid != 0)
+	{
+		return (int)pid;
+	}
+
+	SweepWorker worker;
+	int         status = 0;
+	int         s;
+
+	if (sweepWorkerOpen(&worker, path) != 0)
+	{
+		_exit(1);
+	}
+
+	while ((status == 0) && ((s = claimShard(table, (int)getpid())) >= 0))
+	{
+		SweepShard* shard = &table->shards[s];
+
+		status = runShard(&worker, shard->policy, shard->framesNum, &shard->stats, shard->digest);
+
+		if (status == 0)
+		{
+			__sync_synchronize();
+			shard->state = SHARD_DONE;
+		}
+	}
+
+	sweepWorkerClose(&worker);
+	fflush(stdout);
+	_exit(status == 0 ? 0 : 1);
+}
+
+int runSweepCommand(int argCount, char* args[])
+{
+	SweepTable*   table;
+	TraceMap      map;
+	ResultKey     key;
+	TraceIdentity identity;
+	int           cacheable;
+	int           workers = argCount > 4 ? atoi(args[4]) : 0;
+	int           retries = argCount > 5 ? atoi(args[5]) : SWEEP_RETRIES;
+	int           pids[SWEEP_MAX_WORKERS];
+	int           alive   = 0;
+	int           status;
+
+	if (argCount < 3)
+	{
+		printf("Usage: %s\n", SWEEP_USAGE);
+		return -1;
+	}
+
+	if (workers <= 0)
+	{
+		workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	}
+	workers = workers < 1 ? 1 : workers > SWEEP_MAX_WORKERS ? SWEEP_MAX_WORKERS : workers;
+
+	table = (SweepTable*)mmap(NULL, sizeof(SweepTable), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+	if (table == (SweepTable*)MAP_FAILED)
+	{
+		printf("Cannot map the results table!\n");
+		return -1;
+	}
+
+	if ((retries < 0) || (buildSweepTable(table, args[2], argCount > 3 ? args[3] : NULL, retries) != 0))
+	{
+		printf("Usage: %s\n", SWEEP_USAGE);
+		munmap(table, sizeof(SweepTable));
+		return -1;
+	}
+
+	if (traceMapOpen(&map, args[1]) != 0)
+	{
+		munmap(table, sizeof(SweepTable));
+		return -1;
+	}
+	table->references = map.count;
+	traceMapClose(&map);
+	cacheable = loadCachedShards(table, args[1], &key, &identity) == 0;
+
+	if (workers > pendingShards(table))
+	{
+		workers = pendingShards(table);
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for (int w = 0; w < workers; w++)
+	{
+		pids[w] = forkLocalWorker(table, args[1]);
+		alive  += pids[w] > 0;
+	}
+
+	while (alive > 0)
+	{
+		int   code;
+		pid_t pid = waitpid(-1, &code, 0);
+
+		if (pid < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			break;
+		}
+
+		for (int w = 0; w < workers; w++)
+		{
+			if (pids[w] != pid)
+			{
+				continue;
+			}
+			alive--;
+
+			if (!WIFEXITED(code) || (WEXITSTATUS(code) != 0))
+			{
+				printf("Worker %d failed, retrying its shard\n", (int)pid);
+				releaseShards(table, (int)pid);
+			}
+
+			/* A replacement picks up shards a lost worker gave back. */
+
+			pids[w] = -1;
+
+			for (int s = 0; s < table->shardsNum; s++)
+			{
+				if (table->shards[s].state == SHARD_PENDING)
+				{
+					pids[w] = forkLocalWorker(table, args[1]);
+					alive  += pids[w] > 0;
+					break;
+				}
+			}
+		}
+	}
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	if (cacheable)
+	{
+		storeShards(table, &key, &identity);
+	}
+
+	printSweepTable(table, args[1], workers, seconds);
+	status = pendingShards(table) == 0 ? 0 : -1;
+
+	for (int s = 0; s < table->shardsNum; s++)
+	{
+		status |= table->shards[s].state == SHARD_FAILED ? -1 : 0;
+	}
+
+	munmap(table, sizeof(SweepTable));
+
+	return status;
+}
+
+/*************************************************************************
+*   @ End of Local sweep                                                  *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ TCP coordinator                                                     *
+*                                                                         *
+*  Single threaded poll loop; a worker asking for work while every shard  *
+*  is running waits until one finishes or comes back.                     *
+ *************************************************************************/
+
+static int sendLine(int fd, const char* line)
+{
+	size_t length = strlen(line);
+
+	return send(fd, line, length, MSG_NOSIGNAL) == (ssize_t)length ? 0 : -1;
+}
+
+static void closeClient(SweepTable* table, SweepClient* client)
+{
+	if (client->shard >= 0)
+	{
+		printf("Worker connection %d lost, retrying its shard\n", client->fd);
+		releaseShards(table, client->fd);
+	}
+	close(client->fd);
+	client->fd = -1;
+}
+
+static void handleClientLine(SweepTable* table, SweepClient* client, const char* line)
+{
+	unsigned long long values[6];
+	int                index;
+
+	if (sscanf(line, "HELLO %llu", &values[0]) == 1)
+	{
+		if (values[0] != table->references)
+		{
+			printf("Worker connection %d has a different trace (%llu references)!\n", client->fd, values[0]);
+			sendLine(client->fd, "DONE\n");
+			closeClient(table, client);
+			return;
+		}
+		client->waiting = 1;
+	}
+	else if (sscanf(line, "RESULT %d %llu %llu %llu %llu %llx %llx", &index, &values[0], &values[1], &values[2],
+		&values[3], &values[4], &values[5]) == 7)
+	{
+		if ((index == client->shard) && (index >= 0))
+		{
+			SweepShard* shard = &table->shards[index];
+
+			shard->stats.references = values[0];
+			shard->stats.faults     = values[1];
+			shard->stats.evictions  = values[2];
+			shard->stats.writebacks = values[3];
+			shard->digest[0]        = values[4];
+			shard->digest[1]        = values[5];
+			shard->state            = SHARD_DONE;
+		}
+		client->shard   = -1;
+		client->waiting = 1;
+	}
+	else if (sscanf(line, "FAIL %d", &index) == 1)
+	{
+		if ((index == client->shard) && (index >= 0))
+		{
+			releaseShards(table, client->fd);
+		}
+		client->shard   = -1;
+		client->waiting = 1;
+	}
+	else
+	{
+		closeClient(table, client);
+	}
+}
+
+static int listenOn(const char* port)
+{
+	struct sockaddr_in address;
+	int                yes = 1;
+	int                fd  = socket(AF_INET, SOCK_STREAM, 0);
+
+	if (fd < 0)
+	{
+		return -1;
+	}
+
+	memset(&address, 0, sizeof(address));
+	address.sin_family      = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_ANY);
+	address.sin_port        = htons((unsigned short)atoi(port));
+
+	setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+	if ((bind(fd, (struct sockaddr*)&address, sizeof(address)) != 0) || (listen(fd, SWEEP_MAX_WORKERS) != 0))
+	{
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+int runServeCommand(int argCount, char* args[])
+{
+	static SweepTable table;
+	SweepClient       clients[SWEEP_MAX_WORKERS];
+	struct pollfd     fds[SWEEP_MAX_WORKERS + 1];
+	TraceMap          map;
+	ResultKey         key;
+	TraceIdentity     identity;
+	int               cacheable;
+	int               locals  = argCount > 5 ? atoi(args[5]) : 0;
+	int               retries = argCount > 6 ? atoi(args[6]) : SWEEP_RETRIES;
+	int               workers = 0;
+	int               listener;
+	int               status;
+
+	if ((argCount < 4) || (atoi(args[1]) <= 0) || (locals < 0) || (locals > SWEEP_MAX_WORKERS) || (retries < 0) ||
+		(buildSweepTable(&table, args[3], argCount > 4 ? args[4] : NULL, retries) != 0))
+	{
+		printf("Usage: %s\n", SERVE_USAGE);
+		return -1;
+	}
+
+	if (traceMapOpen(&map, args[2]) != 0)
+	{
+		return -1;
+	}
+	table.references = map.count;
+	traceMapClose(&map);
+	cacheable = loadCachedShards(&table, args[2], &key, &identity) == 0;
+
+	if (locals > pendingShards(&table))
+	{
+		locals = pendingShards(&table);
+	}
+
+	listener = listenOn(args[1]);
+
+	if (listener < 0)
+	{
+		printf("Cannot listen on port %s!\n", args[1]);
+		return -1;
+	}
+
+	for (int c = 0; c < SWEEP_MAX_WORKERS; c++)
+	{
+		clients[c].fd = -1;
+	}
+
+	/* Local workers stand in for remote hosts and use the same protocol. */
+
+	for (int w = 0; w < locals; w++)
+	{
+		fflush(stdout);
+
+		if (fork() == 0)
+		{
+			close(listener);
+			_exit(runTcpWorker("127.0.0.1", args[1], args[2]) == 0 ? 0 : 1);
+		}
+	}
+
+	printf("Coordinator on port %s: %d shards\n", args[1], table.shardsNum);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	while (pendingShards(&table) > 0)
+	{
+		int polled = 0;
+
+		fds[polled].fd       = listener;
+		fds[polled++].events = POLLIN;
+
+		for (int c = 0; c < SWEEP_MAX_WORKERS; c++)
+		{
+			if (clients[c].fd >= 0)
+			{
+				fds[polled].fd       = clients[c].fd;
+				fds[polled++].events = POLLIN;
+			}
+		}
+
+		if ((poll(fds, (nfds_t)polled, -1) < 0) && (errno != EINTR))
+		{
+			break;
+		}
+
+		if (fds[0].revents & POLLIN)
+		{
+			int fd = accept(listener, NULL, NULL);
+
+			for (int c = 0; (c < SWEEP_MAX_WORKERS) & (fd >= 0); c++)
+			{
+				if (clients[c].fd < 0)
+				{
+					memset(&clients[c], 0, sizeof(clients[c]));
+					clients[c].fd    = fd;
+					clients[c].shard = -1;
+					fd               = -1;
+					workers++;
+				}
+			}
+
+			if (fd >= 0)
+			{
+				close(fd);
+			}
+		}
+
+		for (int p = 1; p < polled; p++)
+		{
+			SweepClient* client = NULL;
+
+			for (int c = 0; c < SWEEP_MAX_WORKERS; c++)
+			{
+				client = clients[c].fd == fds[p].fd ? &clients[c] : client;
+			}
+
+			if ((client == NULL) || !(fds[p].revents & (POLLIN | POLLHUP | POLLERR)))
+			{
+				continue;
+			}
+
+			ssize_t got = recv(client->fd, client->line + client->used, SWEEP_LINE_SIZE - 1 - client->used, 0);
+
+			if (got <= 0)
+			{
+				closeClient(&table, client);
+				continue;
+			}
+			client->used += (size_t)got;
+			client->line[client->used] = '\0';
+
+			char* end;
+
+			while ((client->fd >= 0) && ((end = strchr(client->line, '\n')) != NULL))
+			{
+				*end = '\0';
+				handleClientLine(&table, client, client->line);
+				client->used -= (size_t)(end + 1 - client->line);
+				memmove(client->line, end + 1, client->used + 1);
+			}
+
+			if ((client->fd >= 0) && (client->used == SWEEP_LINE_SIZE - 1))
+			{
+				closeClient(&table, client);
+			}
+		}
+
+		/* Hand out work to the workers asking for it. */
+
+		for (int c = 0; c < SWEEP_MAX_WORKERS; c++)
+		{
+			SweepClient* client = &clients[c];
+			char         line[SWEEP_LINE_SIZE];
+			int          s;
+
+			if ((client->fd < 0) || !client->waiting || ((s = claimShard(&table, client->fd)) < 0))
+			{
+				continue;
+			}
+
+			snprintf(line, sizeof(line), "SHARD %d %s %d\n", s, policyName(table.shards[s].policy),
+				table.shards[s].framesNum);
+			client->shard   = s;
+			client->waiting = 0;
+
+			if (sendLine(client->fd, line) != 0)
+			{
+				closeClient(&table, client);
+			}
+		}
+	}
+
+	for (int c = 0; c < SWEEP_MAX_WORKERS; c++)
+	{
+		if (clients[c].fd >= 0)
+		{
+			sendLine(clients[c].fd, "DONE\n");
+			close(clients[c].fd);
+		}
+	}
+	close(listener);
+
+	while ((locals > 0) && (wait(NULL) > 0))
+	{
+	}
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	if (cacheable)
+	{
+		storeShards(&table, &key, &identity);
+	}
+
+	printSweepTable(&table, args[2], workers, seconds);
+	status = 0;
+
+	for (int s = 0; s < table.shardsNum; s++)
+	{
+		status |= table.shards[s].state != SHARD_DONE ? -1 : 0;
+	}
+
+	return status;
+}
+
+/*************************************************************************
+*   @ End of TCP coordinator                                              *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ TCP worker                                                          *
+*                                                                         *
+ *************************************************************************/
+
+static int runTcpWorker(const char* host, const char* port, const char* path)
+{
+	struct addrinfo  hints;
+	struct addrinfo* found;
+	SweepWorker      worker;
+	char             line[SWEEP_LINE_SIZE];
+	char             reply[SWEEP_LINE_SIZE];
+	char             name[16];
+	size_t           used   = 0;
+	int              status = -1;
+	int              fd     = -1;
+
+	if (sweepWorkerOpen(&worker, path) != 0)
+	{
+		return -1;
+	}
+
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family   = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+
+	if (getaddrinfo(host, port, &hints, &found) == 0)
+	{
+		for (struct addrinfo* address = found; (address != NULL) & (fd < 0); address = address->ai_next)
+		{
+			fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+
+			if ((fd >= 0) && (connect(fd, address->ai_addr, address->ai_addrlen) != 0))
+			{
+				close(fd);
+				fd = -1;
+			}
+		}
+		freeaddrinfo(found);
+	}
+
+	if (fd < 0)
+	{
+		printf("Cannot connect to %s:%s!\n", host, port);
+		sweepWorkerClose(&worker);
+		return -1;
+	}
+
+	snprintf(reply, sizeof(reply), "HELLO %llu\n", worker.map.count);
+
+	while (sendLine(fd, reply) == 0)
+	{
+		EngineStats        stats;
+		unsigned long long digest[2];
+		char*       end;
+		int         index;
+		int         framesNum;
+		int         policy;
+		ssize_t     got = 1;
+
+		/* Wait for a whole line; anything after it stays in the buffer. */
+
+		while (((end = (char*)memchr(line, '\n', used)) == NULL) & (got > 0))
+		{
+			got   = used < sizeof(line) - 1 ? recv(fd, line + used, sizeof(line) - 1 - used, 0) : 0;
+			used += got > 0 ? (size_t)got : 0;
+		}
+
+		if (end == NULL)
+		{
+			break;
+		}
+		*end = '\0';
+
+		if (strcmp(line, "DONE") == 0)
+		{
+			status = 0;
+			break;
+		}
+
+		if (sscanf(line, "SHARD %d %15s %d", &index, name, &framesNum) != 3)
+		{
+			break;
+		}
+
+		used -= (size_t)(end + 1 - line);
+		memmove(line, end + 1, used);
+		policy = policyFromName(name);
+
+		if ((policy < 0) || (framesNum < 1) || (runShard(&worker, policy, framesNum, &stats, digest) != 0))
+		{
+			snprintf(reply, sizeof(reply), "FAIL %d\n", index);
+		}
+		else
+		{
+			snprintf(reply, sizeof(reply), "RESULT %d %llu %llu %llu %llu %llx %llx\n", index, stats.references,
+				stats.faults, stats.evictions, stats.writebacks, digest[0], digest[1]);
+		}
+	}
+
+	close(fd);
+	sweepWorkerClose(&worker);
+
+	return status;
+}
+
+int runWorkerCommand(int argCount, char* args[])
+{
+	char  host[256];
+	char* split;
+
+	if ((argCount < 3) || ((split = strrchr(args[1], ':')) == NULL) || ((size_t)(split - args[1]) >= sizeof(host)))
+	{
+		printf("Usage: %s\n", WORKER_USAGE);
+		return -1;
+	}
+
+	memcpy(host, args[1], (size_t)(split - args[1]));
+	host[split - args[1]] = '\0';
+
+	return runTcpWorker(host, split + 1, args[2]);
+}
+
+/*************************************************************************
+*   @ End of TCP worker                                                   *
+*                                                                         *
+ *************************************************************************/
+
+#else
+
+int runSweepCommand(int argCount, char* args[])
+{
+	printf("Sweep workers need Linux fork and sockets, unsupported on this platform!\n");
+	return -1;
+}
+
+int runServeCommand(int argCount, char* args[])
+{
+	printf("Sweep workers need Linux fork and sockets, unsupported on this platform!\n");
+	return -1;
+}
+
+int runWorkerCommand(int argCount, char* args[])
+{
+	printf("Sweep workers need Linux fork and sockets, unsupported on this platform!\n");
+	return -1;
+}
+
+#endif
@@ -0,0 +1,55 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: Policy / frame count sweeps spread over worker processes. Every (frames, policy)
+ * pair is a shard; workers forked on this host or connected over TCP from other hosts map
+ * the same binary trace, claim shards and write their results into one results table,
+ * which is printed in shard order whichever worker ran a shard. Shards of a worker that
+ * dies or disconnects are handed out again.
+*/
+
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include "PagingEngine.h"
+
+#define SWEEP_USAGE          "sweep <file.ptr> <frames[,frames...]> [policy|all] [workers] [retries]"
+#define SERVE_USAGE          "serve <port> <file.ptr> <frames[,frames...]> [policy|all] [localWorkers] [retries]"
+#define WORKER_USAGE         "worker <host:port> <file.ptr>"
+#define SWEEP_MAX_SHARDS     1024
+#define SWEEP_MAX_WORKERS    64
+#define SWEEP_RETRIES        2
+
+#define SHARD_PENDING        0
+#define SHARD_RUNNING        1
+#define SHARD_DONE           2
+#define SHARD_FAILED         3
+
+
+/* One entry of the results table. */
+
+struct SweepShard
+{
+	int                policy;
+	int                framesNum;
+	volatile int       state;          /* SHARD_ value */
+	int                attempts;
+	int                worker;         /* pid or connection of the last worker */
+	EngineStats        stats;
+	unsigned long long digest[2];      /* of the trace as the worker streamed it */
+};
+
+struct SweepTable
+{
+	int                shardsNum;
+	int                maxAttempts;
+	unsigned long long references;
+	SweepShard         shards[SWEEP_MAX_SHARDS];
+};
+
+
+int runSweepCommand(int argCount, char* args[]);
+int runServeCommand(int argCount, char* args[]);
+int runWorkerCommand(int argCount, char* args[]);
+
+#endif // !SWEEP_H
@@ -0,0 +1,545 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: TinyLfu.cpp contains the frequency sketch, the admission filter, W-TinyLFU
+ * and the tinylfu command.
+ *
+ * Sketch: each row has a power of two >= frames 4-bit counters, sixteen to a word; a
+ * page's counter in row i is picked by double hashing. The first reference of a page in
+ * a sample period only sets its doorkeeper bits, later ones increment its counters below
+ * 15, and the estimate is the row minimum plus one for the doorkeeper. After sampleSize
+ * references every counter is halved and the doorkeeper cleared, so old popularity fades.
+*/
+
+
+
+#include "TinyLfu.h"
+#include "TraceParser.h"
+#include <string.h>
+
+
+static void sketchIndexes(const FrequencySketch* sketch, unsigned long long page, unsigned int* indexes,
+	unsigned int* doorBits);
+static void sketchReset(FrequencySketch* sketch);
+static void segmentUnlink(WindowTinyLfu* cache, int frame);
+static void segmentPushMru(WindowTinyLfu* cache, int frame, int segment);
+static void segmentEvict(WindowTinyLfu* cache, int frame);
+
+
+/* Engines fed from memory, plain and behind the filter, and W-TinyLFU. */
+
+struct TinyLfuRun
+{
+	PagingEngine    plain[POLICY_COUNT];
+	PagingEngine    admitted[POLICY_COUNT];
+	int             policies[POLICY_COUNT];
+	int             policiesNum;
+	WindowTinyLfu   window;
+	FrequencySketch sketch;
+};
+
+
+/*************************************************************************
+*   @ Frequency sketch                                                    *
+*                                                                         *
+ *************************************************************************/
+
+int sketchCreate(FrequencySketch* sketch, int framesNum)
+{
+	unsigned int counters = 64;
+	unsigned int doorBits = 64;
+
+	memset(sketch, 0, sizeof(*sketch));
+
+	if (framesNum < 1)
+	{
+		return -1;
+	}
+
+	sketch->sampleSize = (unsigned long long)SKETCH_SAMPLE_FACTOR * (unsigned long long)framesNum;
+
+	while (counters < (unsigned int)framesNum)
+	{
+		counters *= 2;
+	}
+	while (doorBits < sketch->sampleSize)
+	{
+		doorBits *= 2;
+	}
+
+	sketch->rowMask    = counters - 1;
+	sketch->doorMask   = doorBits - 1;
+	sketch->bytes      = SKETCH_DEPTH * (size_t)counters / 2 + (size_t)doorBits / 8;
+	sketch->table      = (unsigned long long*)calloc(SKETCH_DEPTH * (size_t)counters / 16, sizeof(unsigned long long));
+	sketch->doorkeeper = (unsigned long long*)calloc((size_t)doorBits / 64, sizeof(unsigned long long));
+
+	if ((sketch->table == NULL) | (sketch->doorkeeper == NULL))
+	{
+		sketchDestroy(sketch);
+		return -1;
+	}
+
+	return 0;
+}
+
+void sketchDestroy(FrequencySketch* sketch)
+{
+	free(sketch->table);
+	free(sketch->doorkeeper);
+	memset(sketch, 0, sizeof(*sketch));
+}
+
+static inline void sketchIndexes(const FrequencySketch* sketch, unsigned long long page, unsigned int* indexes,
+	unsigned int* doorBits)
+{
+	unsigned long long hash = pageHash(page);
+	unsigned long long door = pageHash(hash ^ 0x94d049bb133111ebULL);
+	unsigned int       low  = (unsigned int)hash;
+	unsigned int       high = (unsigned int)(hash >> 32) | 1;
+
+	for (int row = 0; row < SKETCH_DEPTH; row++)
+	{
+		indexes[row] = (row * (sketch->rowMask + 1)) + ((low + (unsigned int)row * high) & sketch->rowMask);
+	}
+
+	doorBits[0] = (unsigned int)door & sketch->doorMask;
+	doorBits[1] = (unsigned int)(door >> 32) & sketch->doorMask;
+}
+
+void sketchIncrement(FrequencySketch* sketch, unsigned long long page)
+{
+	unsigned int indexes[SKETCH_DEPTH];
+	unsigned int doorBits[2];
+	int          seen = 1;
+
+	sketchIndexes(sketch, page, indexes, doorBits);
+
+	for (int b = 0; b < 2; b++)
+	{
+		unsigned long long bit = 1ULL << (doorBits[b] & 63);
+
+		seen &= (sketch->doorkeeper[doorBits[b] >> 6] & bit) != 0;
+		sketch->doorkeeper[doorBits[b] >> 6] |= bit;
+	}
+
+	for (int row = 0; seen & (row < SKETCH_DEPTH); row++)
+	{
+		unsigned long long* word  = &sketch->table[indexes[row] >> 4];
+		int                 shift = (int)(indexes[row] & 15) * 4;
+
+		if (((*word >> shift) & 15) < 15)
+		{
+			*word += 1ULL << shift;
+		}
+	}
+
+	if (++sketch->additions >= sketch->sampleSize)
+	{
+		sketchReset(sketch);
+	}
+}
+
+int sketchEstimate(const FrequencySketch* sketch, unsigned long long page)
+{
+	unsigned int indexes[SKETCH_DEPTH];
+	unsigned int doorBits[2];
+	int          estimate = 15;
+
+	sketchIndexes(sketch, page, indexes, doorBits);
+
+	for (int row = 0; row < SKETCH_DEPTH; row++)
+	{
+		int count = (int)(sketch->table[indexes[row] >> 4] >> ((indexes[row] & 15) * 4)) & 15;
+
+		estimate = count < estimate ? count : estimate;
+	}
+
+	for (int b = 0; b < 2; b++)
+	{
+		if ((sketch->doorkeeper[doorBits[b] >> 6] & (1ULL << (doorBits[b] & 63))) == 0)
+		{
+			return estimate;
+		}
+	}
+
+	return estimate + 1;
+}
+
+static void sketchReset(FrequencySketch* sketch)
+{
+	size_t words = SKETCH_DEPTH * ((size_t)sketch->rowMask + 1) / 16;
+
+	for (size_t i = 0; i < words; i++)
+	{
+		sketch->table[i] = (sketch->table[i] >> 1) & 0x7777777777777777ULL;
+	}
+
+	memset(sketch->doorkeeper, 0, ((size_t)sketch->doorMask + 1) / 8);
+	sketch->additions /= 2;
+	sketch->resets++;
+}
+
+/*************************************************************************
+*   @ End of Frequency sketch                                             *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Admission filter                                                    *
+*                                                                         *
+*  Ties keep the resident page, so a scan of new pages cannot flush a     *
+*  memory of pages that are used again.                                   *
+ *************************************************************************/
+
+int tinyLfuAccess(PagingEngine* engine, const FrequencySketch* sketch, const PageRef* ref, AccessResult* result)
+{
+	unsigned long long frame;
+	int                victim;
+
+	if (pageIndexFind(&engine->frames, ref->page, &frame) || ((victim = engineVictim(engine)) < 0) ||
+		(sketchEstimate(sketch, ref->page) > sketchEstimate(sketch, engine->framePage[victim])))
+	{
+		return engineAccess(engine, ref, result);
+	}
+
+	engineBypass(engine, ref);
+
+	result->fault       = 1;
+	result->frame       = -1;
+	result->evicted     = 0;
+	result->victimPage  = 0;
+	result->victimDirty = 0;
+
+	return 1;
+}
+
+/*************************************************************************
+*   @ End of Admission filter                                             *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ W-TinyLFU                                                           *
+*                                                                         *
+*  New pages enter an LRU window of WTLFU_WINDOW_PCT of the frames. The   *
+*  window's LRU page then competes with the probation LRU page of the     *
+*  main space and the more frequent one stays; a probation hit promotes   *
+*  a page to the protected segment, whose overflow is demoted back.       *
+ *************************************************************************/
+
+int windowCreate(WindowTinyLfu* cache, int framesNum)
+{
+	memset(cache, 0, sizeof(*cache));
+
+	if (framesNum < 1)
+	{
+		return -1;
+	}
+
+	cache->framesNum       = framesNum;
+	cache->windowFrames    = framesNum * WTLFU_WINDOW_PCT / 100 > 0 ? framesNum * WTLFU_WINDOW_PCT / 100 : 1;
+	cache->protectedFrames = (framesNum - cache->windowFrames) * WTLFU_PROTECTED_PCT / 100;
+	cache->framePage       = (unsigned long long*)malloc(framesNum * sizeof(unsigned long long));
+	cache->segment         = (unsigned char*)malloc(framesNum);
+	cache->dirty           = (unsigned char*)calloc(framesNum, 1);
+	cache->older           = (int*)malloc(framesNum * sizeof(int));
+	cache->newer           = (int*)malloc(framesNum * sizeof(int));
+
+	for (int s = 0; s < 3; s++)
+	{
+		cache->mru[s] = -1;
+		cache->lru[s] = -1;
+	}
+
+	if ((cache->framePage == NULL) | (cache->segment == NULL) | (cache->dirty == NULL) | (cache->older == NULL) |
+		(cache->newer == NULL) || (pageIndexInit(&cache->frames, (size_t)framesNum) != 0))
+	{
+		windowDestroy(cache);
+		return -1;
+	}
+
+	return 0;
+}
+
+void windowDestroy(WindowTinyLfu* cache)
+{
+	free(cache->framePage);
+	free(cache->segment);
+	free(cache->dirty);
+	free(cache->older);
+	free(cache->newer);
+	pageIndexFree(&cache->frames);
+	memset(cache, 0, sizeof(*cache));
+}
+
+int windowAccess(WindowTinyLfu* cache, const FrequencySketch* sketch, const PageRef* ref)
+{
+	unsigned long long slot;
+	int                frame;
+
+	cache->stats.references++;
+
+	if (pageIndexFind(&cache->frames, ref->page, &slot))
+	{
+		frame = (int)slot;
+
+		int segment = cache->segment[frame];
+
+		segmentUnlink(cache, frame);
+		segmentPushMru(cache, frame, segment == WTLFU_WINDOW ? WTLFU_WINDOW : WTLFU_PROTECTED);
+
+		if (cache->sizes[WTLFU_PROTECTED] > cache->protectedFrames)
+		{
+			int demoted = cache->lru[WTLFU_PROTECTED];
+
+			segmentUnlink(cache, demoted);
+			segmentPushMru(cache, demoted, WTLFU_PROBATION);
+		}
+
+		cache->dirty[frame] |= (ref->access == ACCESS_WRITE);
+		return 0;
+	}
+
+	cache->stats.faults++;
+
+	if (cache->usedFrames < cache->framesNum)
+	{
+		frame = cache->usedFrames++;
+	}
+	else
+	{
+		/* Full: the window's LRU page or the main victim leaves, and its frame is reused. */
+
+		int candidate = cache->lru[WTLFU_WINDOW];
+		int victim    = cache->lru[WTLFU_PROBATION] != -1 ? cache->lru[WTLFU_PROBATION] : cache->lru[WTLFU_PROTECTED];
+
+		if ((victim != -1) &&
+			(sketchEstimate(sketch, cache->framePage[candidate]) > sketchEstimate(sketch, cache->framePage[victim])))
+		{
+			segmentEvict(cache, victim);
+			segmentUnlink(cache, candidate);
+			segmentPushMru(cache, candidate, WTLFU_PROBATION);
+			frame = victim;
+		}
+		else
+		{
+			segmentEvict(cache, candidate);
+			frame = candidate;
+		}
+	}
+
+	if (pageIndexSet(&cache->frames, ref->page, (unsigned long long)frame) != 0)
+	{
+		return -1;
+	}
+
+	cache->framePage[frame] = ref->page;
+	cache->dirty[frame]     = (ref->access == ACCESS_WRITE);
+	segmentPushMru(cache, frame, WTLFU_WINDOW);
+
+	/* While frames are still free the window overflows into probation. */
+
+	if (cache->sizes[WTLFU_WINDOW] > cache->windowFrames)
+	{
+		int moved = cache->lru[WTLFU_WINDOW];
+
+		segmentUnlink(cache, moved);
+		segmentPushMru(cache, moved, WTLFU_PROBATION);
+	}
+
+	return 1;
+}
+
+static void segmentEvict(WindowTinyLfu* cache, int frame)
+{
+	segmentUnlink(cache, frame);
+	pageIndexRemove(&cache->frames, cache->framePage[frame]);
+	cache->stats.evictions++;
+	cache->stats.writebacks += cache->dirty[frame];
+}
+
+static void segmentUnlink(WindowTinyLfu* cache, int frame)
+{
+	int segment = cache->segment[frame];
+	int older   = cache->older[frame];
+	int newer   = cache->newer[frame];
+
+	if (newer != -1)
+	{
+		cache->older[newer] = older;
+	}
+	else
+	{
+		cache->mru[segment] = older;
+	}
+
+	if (older != -1)
+	{
+		cache->newer[older] = newer;
+	}
+	else
+	{
+		cache->lru[segment] = newer;
+	}
+	cache->sizes[segment]--;
+}
+
+static void segmentPushMru(WindowTinyLfu* cache, int frame, int segment)
+{
+	cache->segment[frame] = (unsigned char)segment;
+	cache->older[frame]   = cache->mru[segment];
+	cache->newer[frame]   = -1;
+
+	if (cache->mru[segment] != -1)
+	{
+		cache->newer[cache->mru[segment]] = frame;
+	}
+	else
+	{
+		cache->lru[segment] = frame;
+	}
+	cache->mru[segment] = frame;
+	cache->sizes[segment]++;
+}
+
+/*************************************************************************
+*   @ End of W-TinyLFU                                                    *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ TinyLFU command                                                     *
+*                                                                         *
+*  One sketch counts the references for every filter; it only depends on  *
+*  the trace, not on what the filters admitted.                           *
+ *************************************************************************/
+
+static void tinyLfuRunFree(TinyLfuRun* run)
+{
+	for (int p = 0; p < run->policiesNum; p++)
+	{
+		engineDestroy(&run->plain[p]);
+		engineDestroy(&run->admitted[p]);
+	}
+	windowDestroy(&run->window);
+	sketchDestroy(&run->sketch);
+}
+
+int runTinyLfuCommand(int argCount, char* args[])
+{
+	TinyLfuRun          run;
+	TraceBuffer         buffer;
+	AccessResult        result;
+	unsigned long long* nextUse  = NULL;
+	int                 selected = POLICY_COUNT;
+	int                 status   = 0;
+
+	if (argCount < 4)
+	{
+		printf("Usage: %s\n", TINYLFU_USAGE);
+		return -1;
+	}
+
+	int format    = traceFormatFromName(args[1]);
+	int framesNum = atoi(args[3]);
+
+	if ((argCount > 4) && (strcmp(args[4], "all") != 0))
+	{
+		selected = policyFromName(args[4]);
+	}
+
+	if ((format == TRACE_FORMAT_UNKNOWN) | (framesNum < 1) | (selected < 0))
+	{
+		printf("Usage: %s\n", TINYLFU_USAGE);
+		return -1;
+	}
+
+	memset(&run, 0, sizeof(run));
+	traceBufferInit(&buffer);
+
+	if (loadTrace(args[2], format, 0, traceBufferSink, &buffer) != 0)
+	{
+		traceBufferFree(&buffer);
+		return -1;
+	}
+
+	if ((selected == POLICY_COUNT) | (selected == POLICY_OPT))
+	{
+		nextUse = (unsigned long long*)malloc((buffer.count + 1) * sizeof(unsigned long long));
+		status  = (nextUse == NULL) || (computeNextUse(buffer.refs, buffer.count, nextUse) != 0) ? -1 : 0;
+	}
+
+	for (int policy = 0; (policy < POLICY_COUNT) & (status == 0); policy++)
+	{
+		if ((selected != POLICY_COUNT) & (selected != policy))
+		{
+			continue;
+		}
+
+		run.policies[run.policiesNum] = policy;
+		status = (engineCreate(&run.plain[run.policiesNum], policy, framesNum) != 0) |
+			(engineCreate(&run.admitted[run.policiesNum], policy, framesNum) != 0) ? -1 : 0;
+		engineSetFuture(&run.plain[run.policiesNum], nextUse);
+		engineSetFuture(&run.admitted[run.policiesNum], nextUse);
+		run.policiesNum++;
+	}
+
+	if ((status != 0) || (windowCreate(&run.window, framesNum) != 0) || (sketchCreate(&run.sketch, framesNum) != 0))
+	{
+		printf("Not enough memory for %d frames!\n", framesNum);
+		tinyLfuRunFree(&run);
+		free(nextUse);
+		traceBufferFree(&buffer);
+		return -1;
+	}
+
+	for (size_t i = 0; (i < buffer.count) & (status == 0); i++)
+	{
+		const PageRef* ref = &buffer.refs[i];
+
+		sketchIncrement(&run.sketch, ref->page);
+
+		for (int p = 0; p < run.policiesNum; p++)
+		{
+			engineAccess(&run.plain[p], ref, &result);
+			tinyLfuAccess(&run.admitted[p], &run.sketch, ref, &result);
+		}
+		status = windowAccess(&run.window, &run.sketch, ref) < 0 ? -1 : 0;
+	}
+
+	if (status == 0)
+	{
+		printf("\n Trace %s: %llu references, %d frames, sketch of %zu bytes (%.1f bits per frame), %llu resets\n\n",
+			args[2], (unsigned long long)buffer.count, framesNum, run.sketch.bytes,
+			8.0 * (double)run.sketch.bytes / (double)framesNum, run.sketch.resets);
+		printf(" ------------------------------------------------------------------\n");
+		printf("| Policy    |     Plain      |    TinyLFU     | Change  | Bypassed |\n");
+		printf(" ------------------------------------------------------------------\n");
+
+		for (int p = 0; p < run.policiesNum; p++)
+		{
+			EngineStats* plain    = &run.plain[p].stats;
+			EngineStats* admitted = &run.admitted[p].stats;
+
+			printf("| %-9s | %14llu | %14llu | %+6.1f%% | %7.1f%% |\n", policyName(run.policies[p]), plain->faults,
+				admitted->faults, plain->faults ? 100.0 * ((double)admitted->faults - (double)plain->faults) /
+				(double)plain->faults : 0.0, admitted->faults ? 100.0 * (double)(admitted->faults - admitted->evictions -
+				(unsigned long long)run.admitted[p].usedFrames) / (double)admitted->faults : 0.0);
+		}
+		printf("| %-9s | %14s | %14llu | %7s | %8s |\n", "W-TinyLFU", "", run.window.stats.faults, "", "");
+		printf(" ------------------------------------------------------------------\n");
+	}
+
+	tinyLfuRunFree(&run);
+	free(nextUse);
+	traceBufferFree(&buffer);
+
+	return status;
+}
+
+/*************************************************************************
+*   @ End of TinyLFU command                                              *
+*                                                                         *
+ *************************************************************************/
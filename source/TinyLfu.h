@@ -0,0 +1,73 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: TinyLFU admission. A 4-bit Count-Min Sketch behind a doorkeeper Bloom filter
+ * estimates how often every page was referenced recently, in a few bits per frame and
+ * with all counters halved every sample period. In front of any engine, a missing page
+ * is only loaded when it is estimated more frequent than the victim it would replace.
+ * W-TinyLFU adds a small LRU window in front of a segmented LRU main space, whose
+ * probation victim the window's victim has to beat.
+*/
+
+
+#ifndef TINY_LFU_H
+#define TINY_LFU_H
+
+#include "PagingEngine.h"
+
+#define TINYLFU_USAGE        "tinylfu <lackey|pin|csv|bin> <file> <frames> [policy|all]"
+#define SKETCH_DEPTH         4
+#define SKETCH_SAMPLE_FACTOR 10      /* counters are halved every 10 * frames references */
+#define WTLFU_WINDOW_PCT     1       /* window share of the frames */
+#define WTLFU_PROTECTED_PCT  80      /* protected share of the main space */
+
+#define WTLFU_WINDOW         0
+#define WTLFU_PROBATION      1
+#define WTLFU_PROTECTED      2
+
+
+struct FrequencySketch
+{
+	unsigned long long* table;       /* SKETCH_DEPTH rows of 16 counters per word */
+	unsigned long long* doorkeeper;  /* Bloom filter of pages seen once this period */
+	unsigned int        rowMask;     /* counters per row - 1 */
+	unsigned int        doorMask;    /* doorkeeper bits - 1 */
+	unsigned long long  additions;
+	unsigned long long  sampleSize;
+	unsigned long long  resets;
+	size_t              bytes;
+};
+
+struct WindowTinyLfu
+{
+	int                 framesNum;
+	int                 usedFrames;
+	int                 windowFrames;
+	int                 protectedFrames;
+	unsigned long long* framePage;
+	unsigned char*      segment;     /* WTLFU_ value of each frame */
+	unsigned char*      dirty;
+	int*                older;
+	int*                newer;
+	int                 mru[3];
+	int                 lru[3];
+	int                 sizes[3];
+	PageIndex           frames;      /* resident page -> frame */
+	EngineStats         stats;
+};
+
+int  sketchCreate(FrequencySketch* sketch, int framesNum);
+void sketchDestroy(FrequencySketch* sketch);
+void sketchIncrement(FrequencySketch* sketch, unsigned long long page);
+int  sketchEstimate(const FrequencySketch* sketch, unsigned long long page);
+
+/* The caller counts each reference in the sketch first; one sketch can serve many filters. */
+
+int  tinyLfuAccess(PagingEngine* engine, const FrequencySketch* sketch, const PageRef* ref, AccessResult* result);
+
+int  windowCreate(WindowTinyLfu* cache, int framesNum);
+void windowDestroy(WindowTinyLfu* cache);
+int  windowAccess(WindowTinyLfu* cache, const FrequencySketch* sketch, const PageRef* ref);
+
+int  runTinyLfuCommand(int argCount, char* args[]);
+
+#endif // !TINY_LFU_H
@@ -0,0 +1,492 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: Trace.cpp contains the in-memory reference buffer and the reader and writer
+ * for the binary page trace format.
+ *
+ * Layout: a 32 byte header (magic, version, record size, page shift, reference count)
+ * followed by fixed size little-endian records.
+*/
+
+
+
+#include "Trace.h"
+#include <stddef.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define TRACE_MAP_SUPPORTED
+#endif
+
+
+/* On-disk record, kept independent from PageRef so the file layout never drifts. */
+
+struct TraceRecord
+{
+	unsigned long long page;
+	unsigned long long time;
+	unsigned int       pid;
+	unsigned char      access;
+	unsigned char      reserved[3];
+};
+
+struct TraceHeader
+{
+	char               magic[8];
+	unsigned int       version;
+	unsigned int       recordSize;
+	unsigned int       pageShift;
+	unsigned int       reserved;
+	unsigned long long count;
+};
+
+
+/*************************************************************************
+*   @ Trace buffer                                                        *
+*                                                                         *
+*  Growable array of references used when a whole trace has to be kept    *
+*  in memory (OPT needs the future of every reference).                   *
+ *************************************************************************/
+
+void traceBufferInit(TraceBuffer* buffer)
+{
+	buffer->refs     = NULL;
+	buffer->count    = 0;
+	buffer->capacity = 0;
+}
+
+void traceBufferFree(TraceBuffer* buffer)
+{
+	free(buffer->refs);
+	traceBufferInit(buffer);
+}
+
+int traceBufferReserve(TraceBuffer* buffer, size_t capacity)
+{
+	if (capacity > buffer->capacity)
+	{
+		size_t grown = buffer->capacity ? buffer->capacity : 1024;
+
+		while (grown < capacity)
+		{
+			grown *= 2;
+		}
+
+		PageRef* refs = (PageRef*)realloc(buffer->refs, grown * sizeof(PageRef));
+
+		if (refs == NULL)
+		{
+			return -1;
+		}
+		buffer->refs     = refs;
+		buffer->capacity = grown;
+	}
+
+	return 0;
+}
+
+int traceBufferAppend(TraceBuffer* buffer, const PageRef* refs, size_t count)
+{
+	if (traceBufferReserve(buffer, buffer->count + count) != 0)
+	{
+		return -1;
+	}
+
+	memcpy(buffer->refs + buffer->count, refs, count * sizeof(PageRef));
+	buffer->count += count;
+
+	return 0;
+}
+
+int traceBufferSink(void* context, const PageRef* refs, size_t count)
+{
+	return traceBufferAppend((TraceBuffer*)context, refs, count);
+}
+
+/*************************************************************************
+*   @ End of Trace buffer                                                 *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Binary trace writer                                                 *
+*                                                                         *
+*  Records are converted in batches and written with one fwrite per       *
+*  batch. The header is written first with a zero count and patched       *
+*  when the writer is closed.                                             *
+ *************************************************************************/
+
+int traceWriterOpen(TraceWriter* writer, const char* path)
+{
+	TraceHeader header;
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+	header.version    = TRACE_VERSION;
+	header.recordSize = sizeof(TraceRecord);
+	header.pageShift  = TRACE_PAGE_SHIFT;
+
+	writer->count = 0;
+	writer->file  = fopen(path, "wb");
+
+	if (writer->file == NULL)
+	{
+		printf("Cannot create trace file '%s'!\n", path);
+		return -1;
+	}
+
+	if (fwrite(&header, sizeof(header), 1, writer->file) != 1)
+	{
+		fclose(writer->file);
+		writer->file = NULL;
+		return -1;
+	}
+
+	return 0;
+}
+
+int traceWriterAppend(TraceWriter* writer, const PageRef* refs, size_t count)
+{
+	TraceRecord records[1024];
+
+	while (count > 0)
+	{
+		size_t batch = count < 1024 ? count : 1024;
+
+		memset(records, 0, batch * sizeof(TraceRecord));
+
+		for (size_t i = 0; i < batch; i++)
+		{
+			records[i].page   = refs[i].page;
+			records[i].time   = refs[i].time;
+			records[i].pid    = refs[i].pid;
+			records[i].access = refs[i].access;
+		}
+
+		if (fwrite(records, sizeof(TraceRecord), batch, writer->file) != batch)
+		{
+			return -1;
+		}
+
+		writer->count += batch;
+		refs          += batch;
+		count         -= batch;
+	}
+
+	return 0;
+}
+
+int traceWriterSink(void* context, const PageRef* refs, size_t count)
+{
+	return traceWriterAppend((TraceWriter*)context, refs, count);
+}
+
+int traceWriterClose(TraceWriter* writer)
+{
+	int status = 0;
+
+	if (writer->file == NULL)
+	{
+		return -1;
+	}
+
+	if ((fseek(writer->file, offsetof(TraceHeader, count), SEEK_SET) != 0) |
+		(fwrite(&writer->count, sizeof(writer->count), 1, writer->file) != 1))
+	{
+		status = -1;
+	}
+
+	if (fclose(writer->file) != 0)
+	{
+		status = -1;
+	}
+	writer->file = NULL;
+
+	return status;
+}
+
+/*************************************************************************
+*   @ End of Binary trace writer                                          *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Binary trace reader                                                 *
+*                                                                         *
+*  Streams the records of a binary trace into a sink in batches of        *
+*  TRACE_BATCH_REFS references, optionally starting at reference first,   *
+*  which is a seek since records have a fixed size. Like the mapped       *
+*  trace, it stops after the header's count of records; a file holding    *
+*  fewer is reported as short.                                            *
+ *************************************************************************/
+
+int readBinaryTrace(const char* path, TraceSink sink, void* context)
+{
+	return readBinaryTraceFrom(path, 0, sink, context);
+}
+
+int readBinaryTraceFrom(const char* path, unsigned long long first, TraceSink sink, void* context)
+{
+	TraceHeader  header;
+	TraceRecord*       records;
+	PageRef*           refs;
+	size_t             got;
+	unsigned long long left;
+	int                status = 0;
+
+	FILE* file = fopen(path, "rb");
+
+	if (file == NULL)
+	{
+		printf("Cannot open trace file '%s'!\n", path);
+		return -1;
+	}
+
+	if ((fread(&header, sizeof(header), 1, file) != 1) |
+		(memcmp(header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0))
+	{
+		printf("'%s' is not a binary page trace!\n", path);
+		fclose(file);
+		return -1;
+	}
+
+	if ((header.version != TRACE_VERSION) | (header.recordSize != sizeof(TraceRecord)))
+	{
+		printf("Unsupported trace version %u!\n", header.version);
+		fclose(file);
+		return -1;
+	}
+
+	if ((first > 0) && (fseek(file, (long)(sizeof(header) + first * sizeof(TraceRecord)), SEEK_SET) != 0))
+	{
+		printf("Cannot seek to reference %llu of '%s'!\n", first, path);
+		fclose(file);
+		return -1;
+	}
+
+	left    = first < header.count ? header.count - first : 0;
+	records = (TraceRecord*)malloc(TRACE_BATCH_REFS * sizeof(TraceRecord));
+	refs    = (PageRef*)malloc(TRACE_BATCH_REFS * sizeof(PageRef));
+
+	if ((records == NULL) | (refs == NULL))
+	{
+		free(records);
+		free(refs);
+		fclose(file);
+		return -1;
+	}
+
+	while (left > 0)
+	{
+		got = fread(records, sizeof(TraceRecord), left < TRACE_BATCH_REFS ? (size_t)left : TRACE_BATCH_REFS, file);
+
+		if (got == 0)
+		{
+			break;
+		}
+		left -= got;
+
+		for (size_t i = 0; i < got; i++)
+		{
+			refs[i].page   = records[i].page;
+			refs[i].time   = records[i].time;
+			refs[i].pid    = records[i].pid;
+			refs[i].access = records[i].access;
+		}
+
+		if (sink(context, refs, got) != 0)
+		{
+			status = 1;
+			break;
+		}
+	}
+
+	if ((status == 0) & (left > 0))
+	{
+		printf("'%s' is short: %llu of its %llu references are missing!\n", path, left, header.count);
+		status = -1;
+	}
+
+	free(records);
+	free(refs);
+	fclose(file);
+
+	return status;
+}
+
+/*************************************************************************
+*   @ End of Binary trace reader                                          *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Mapped binary trace                                                 *
+*                                                                         *
+*  Maps a whole binary trace read-only, or loads it where mmap is not     *
+*  available. The header is checked like the streaming reader does, and   *
+*  records are converted on demand.                                       *
+ *************************************************************************/
+
+/* Maps the file where mmap is available and reads it whole with stdio elsewhere; either way
+ * the records end up at base, after the header. */
+
+static int traceMapLoad(TraceMap* map, const char* path)
+{
+#ifdef TRACE_MAP_SUPPORTED
+	struct stat info;
+	int         fd = open(path, O_RDONLY);
+
+	if (fd < 0)
+	{
+		printf("Cannot open trace file '%s'!\n", path);
+		return -1;
+	}
+
+	if ((fstat(fd, &info) != 0) || ((size_t)info.st_size < sizeof(TraceHeader)))
+	{
+		printf("'%s' is not a binary page trace!\n", path);
+		close(fd);
+		return -1;
+	}
+
+	map->bytes = (size_t)info.st_size;
+	map->base  = mmap(NULL, map->bytes, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (map->base == MAP_FAILED)
+	{
+		printf("Cannot map trace file '%s'!\n", path);
+		map->base = NULL;
+		return -1;
+	}
+#else
+	TraceHeader header;
+	FILE*       file = fopen(path, "rb");
+
+	if (file == NULL)
+	{
+		printf("Cannot open trace file '%s'!\n", path);
+		return -1;
+	}
+
+	if (fread(&header, sizeof(header), 1, file) != 1)
+	{
+		printf("'%s' is not a binary page trace!\n", path);
+		fclose(file);
+		return -1;
+	}
+
+	/* Only the committed records are read, so trailing garbage is never loaded. */
+
+	if ((header.recordSize == sizeof(TraceRecord)) &&
+		(header.count <= (((size_t)-1) - sizeof(TraceHeader)) / sizeof(TraceRecord)))
+	{
+		map->bytes = sizeof(TraceHeader) + (size_t)header.count * sizeof(TraceRecord);
+	}
+	else
+	{
+		map->bytes = sizeof(TraceHeader);
+	}
+	map->base = malloc(map->bytes);
+
+	if (map->base == NULL)
+	{
+		printf("Cannot load trace file '%s'!\n", path);
+		fclose(file);
+		return -1;
+	}
+
+	memcpy(map->base, &header, sizeof(header));
+	map->bytes = sizeof(TraceHeader) + fread((char*)map->base + sizeof(TraceHeader), 1, map->bytes - sizeof(TraceHeader), file);
+	fclose(file);
+#endif
+
+	return 0;
+}
+
+int traceMapOpen(TraceMap* map, const char* path)
+{
+	const TraceHeader* header;
+
+	memset(map, 0, sizeof(*map));
+
+	if (traceMapLoad(map, path) != 0)
+	{
+		return -1;
+	}
+
+	header = (const TraceHeader*)map->base;
+
+	if ((memcmp(header->magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0) | (header->version != TRACE_VERSION) |
+		(header->recordSize != sizeof(TraceRecord)))
+	{
+		printf("'%s' is not a version %d binary page trace!\n", path, TRACE_VERSION);
+		traceMapClose(map);
+		return -1;
+	}
+
+	/* The count is patched on close, so records past it were never committed. */
+
+	map->count = (map->bytes - sizeof(TraceHeader)) / sizeof(TraceRecord);
+
+	if (header->count > map->count)
+	{
+		printf("'%s' is short: %llu of its %llu references are missing!\n", path,
+			(unsigned long long)(header->count - map->count), (unsigned long long)header->count);
+		traceMapClose(map);
+		return -1;
+	}
+	map->count = header->count;
+
+	return 0;
+}
+
+void traceMapClose(TraceMap* map)
+{
+	if (map->base != NULL)
+	{
+#ifdef TRACE_MAP_SUPPORTED
+		munmap(map->base, map->bytes);
+#else
+		free(map->base);
+#endif
+	}
+	memset(map, 0, sizeof(*map));
+}
+
+/* Copies up to count references starting at reference first; returns the number copied. */
+
+size_t traceMapRead(const TraceMap* map, unsigned long long first, PageRef* refs, size_t count)
+{
+	const TraceRecord* records = (const TraceRecord*)((const char*)map->base + sizeof(TraceHeader));
+
+	if (first >= map->count)
+	{
+		return 0;
+	}
+	if (count > map->count - first)
+	{
+		count = (size_t)(map->count - first);
+	}
+
+	for (size_t i = 0; i < count; i++)
+	{
+		refs[i].page   = records[first + i].page;
+		refs[i].time   = records[first + i].time;
+		refs[i].pid    = records[first + i].pid;
+		refs[i].access = records[first + i].access;
+	}
+
+	return count;
+}
+
+/*************************************************************************
+*   @ End of Mapped binary trace                                          *
+*                                                                         *
+ *************************************************************************/
@@ -0,0 +1,86 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: Page reference records shared by the trace importers and the trace driven
+ * simulation engines, plus the binary page trace format (.ptr) they are stored in.
+*/
+
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TRACE_PAGE_SHIFT     12
+#define TRACE_MAGIC          "PGTRACE"
+#define TRACE_VERSION        1
+#define TRACE_BATCH_REFS     65536
+
+#define ACCESS_READ          0
+#define ACCESS_WRITE         1
+#define ACCESS_FETCH         2
+
+
+/* One page reference; time is in nanoseconds, 0 when the source has no clock. */
+
+struct PageRef
+{
+	unsigned long long page;
+	unsigned long long time;
+	unsigned int       pid;
+	unsigned char      access;
+};
+
+
+/* Growable in-memory reference buffer. */
+
+struct TraceBuffer
+{
+	PageRef* refs;
+	size_t   count;
+	size_t   capacity;
+};
+
+
+/* Receives parsed references in trace order; returning non-zero stops the producer. */
+
+typedef int (*TraceSink)(void* context, const PageRef* refs, size_t count);
+
+
+/* Binary trace writer; the reference count is patched into the header on close. */
+
+struct TraceWriter
+{
+	FILE*              file;
+	unsigned long long count;
+};
+
+/* Read-only mapping of a binary trace; processes mapping the same file share its pages.
+ * Without mmap the trace is read into memory instead. */
+
+struct TraceMap
+{
+	void*              base;
+	size_t             bytes;
+	unsigned long long count;
+};
+
+void traceBufferInit(TraceBuffer* buffer);
+void traceBufferFree(TraceBuffer* buffer);
+int  traceBufferReserve(TraceBuffer* buffer, size_t capacity);
+int  traceBufferAppend(TraceBuffer* buffer, const PageRef* refs, size_t count);
+int  traceBufferSink(void* context, const PageRef* refs, size_t count);
+
+int  traceWriterOpen(TraceWriter* writer, const char* path);
+int  traceWriterAppend(TraceWriter* writer, const PageRef* refs, size_t count);
+int  traceWriterSink(void* context, const PageRef* refs, size_t count);
+int  traceWriterClose(TraceWriter* writer);
+
+int  readBinaryTrace(const char* path, TraceSink sink, void* context);
+int  readBinaryTraceFrom(const char* path, unsigned long long first, TraceSink sink, void* context);
+
+int    traceMapOpen(TraceMap* map, const char* path);
+void   traceMapClose(TraceMap* map);
+size_t traceMapRead(const TraceMap* map, unsigned long long first, PageRef* refs, size_t count);
+
+#endif // !TRACE_H
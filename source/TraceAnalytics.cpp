@@ -0,0 +1,785 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: TraceAnalytics.cpp contains the sketches of the analytics pass and the analyze
+ * command.
+ *
+ * Windows: every window of windowRefs references has its own HyperLogLog; once all
+ * windows are used, neighbours are merged in pairs (register maximum) and windowRefs
+ * doubles, so the memory stays fixed however long the trace is. The similarity of two
+ * windows is their Jaccard index, the intersection taken from the sketch of the union.
+ *
+ * Reuse times: a page is sampled when its hash is below sampleLimit, so a page is either
+ * followed from its first reference or never. When more than ANALYZE_SAMPLES pages are
+ * sampled the limit halves, the pages above it are dropped, and every later sample counts
+ * twice as much (fixed size SHARDS). A few hot pages in or out of the sample move the
+ * weighted reference count far from the real one; the difference is credited to the
+ * shortest reuse times, where the references of hot pages are (SHARDS-adj).
+ *
+ * LRU prediction: with P(x) the share of references whose reuse time exceeds x, the
+ * average footprint of a window of w references is the sum of P(x) for x below w, and a
+ * reference misses in c frames when its reuse time exceeds the window whose footprint is
+ * c (footprint theory).
+*/
+
+
+
+#include "TraceAnalytics.h"
+#include "TraceParser.h"
+#include "Bits.h"
+#include <string.h>
+#include <math.h>
+#include <chrono>
+
+
+static void hllAdd(HyperLogLog* hll, unsigned long long hash);
+static void hllMerge(HyperLogLog* destination, const HyperLogLog* source);
+static double windowSimilarity(const AnalyticsWindow* first, const AnalyticsWindow* second);
+static AnalyticsWindow* analyticsNextWindow(TraceAnalytics* analytics);
+static void analyticsSample(TraceAnalytics* analytics, unsigned long long page);
+static void spaceSavingAdd(SpaceSaving* top, unsigned long long page);
+static double analyticsFootprintWindow(const TraceAnalytics* analytics, unsigned long long framesNum,
+	double* missRatio);
+
+
+/* One Space-Saving counter, for sorting. */
+
+struct TopPage
+{
+	unsigned long long page;
+	unsigned long long count;
+	unsigned long long error;
+};
+
+
+/*************************************************************************
+*   @ HyperLogLog                                                         *
+*                                                                         *
+*  The first HLL_PRECISION bits of the page hash pick a register, which   *
+*  keeps the longest run of leading zeros seen in the remaining bits.     *
+ *************************************************************************/
+
+static inline void hllAdd(HyperLogLog* hll, unsigned long long hash)
+{
+	unsigned int  slot = (unsigned int)(hash >> (64 - HLL_PRECISION));
+	unsigned char rank = (unsigned char)(countLeadingZeros((hash << HLL_PRECISION) | (1ULL << (HLL_PRECISION - 1))) + 1);
+
+	if (hll->registers[slot] < rank)
+	{
+		hll->registers[slot] = rank;
+	}
+}
+
+static void hllMerge(HyperLogLog* destination, const HyperLogLog* source)
+{
+	for (int i = 0; i < HLL_REGISTERS; i++)
+	{
+		if (destination->registers[i] < source->registers[i])
+		{
+			destination->registers[i] = source->registers[i];
+		}
+	}
+}
+
+/* Small cardinalities, with empty registers left, fall back to linear counting. */
+
+double hllEstimate(const HyperLogLog* hll)
+{
+	double registers = (double)HLL_REGISTERS;
+	double sum       = 0.0;
+	int    zeros     = 0;
+
+	for (int i = 0; i < HLL_REGISTERS; i++)
+	{
+		sum   += ldexp(1.0, -(int)hll->registers[i]);
+		zeros += hll->registers[i] == 0;
+	}
+
+	double estimate = 0.7213 / (1.0 + 1.079 / registers) * registers * registers / sum;
+
+	if ((estimate <= 2.5 * registers) & (zeros > 0))
+	{
+		estimate = registers * log(registers / zeros);
+	}
+
+	return estimate;
+}
+
+static double windowSimilarity(const AnalyticsWindow* first, const AnalyticsWindow* second)
+{
+	HyperLogLog both = first->pages;
+
+	hllMerge(&both, &second->pages);
+
+	double all    = hllEstimate(&both);
+	double common = hllEstimate(&first->pages) + hllEstimate(&second->pages) - all;
+
+	if (all <= 0.0)
+	{
+		return 1.0;
+	}
+
+	return common > 0.0 ? common / all : 0.0;
+}
+
+static int compareSimilarities(const void* first, const void* second)
+{
+	double a = *(const double*)first;
+	double b = *(const double*)second;
+
+	return (a > b) - (a < b);
+}
+
+/*************************************************************************
+*   @ End of HyperLogLog                                                  *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Analytics pass                                                      *
+*                                                                         *
+ *************************************************************************/
+
+int analyticsInit(TraceAnalytics* analytics, unsigned long long windowRefs)
+{
+	memset(analytics, 0, sizeof(*analytics));
+
+	if (windowRefs < 1)
+	{
+		return -1;
+	}
+
+	analytics->windowRefs  = windowRefs;
+	analytics->windowsNum  = 1;
+	analytics->sampleLimit = ~0ULL;
+
+	if (pageIndexInit(&analytics->sampled, ANALYZE_SAMPLES + 1) != 0)
+	{
+		return -1;
+	}
+	if (pageIndexInit(&analytics->top.slots, ANALYZE_COUNTERS) != 0)
+	{
+		pageIndexFree(&analytics->sampled);
+		return -1;
+	}
+
+	return 0;
+}
+
+void analyticsFree(TraceAnalytics* analytics)
+{
+	pageIndexFree(&analytics->sampled);
+	pageIndexFree(&analytics->top.slots);
+}
+
+static AnalyticsWindow* analyticsNextWindow(TraceAnalytics* analytics)
+{
+	if (analytics->windowsNum == ANALYZE_MAX_WINDOWS)
+	{
+		for (int w = 0; w < ANALYZE_MAX_WINDOWS / 2; w++)
+		{
+			AnalyticsWindow*       window = &analytics->windows[w];
+			const AnalyticsWindow* first  = &analytics->windows[2 * w];
+			const AnalyticsWindow* second = &analytics->windows[2 * w + 1];
+
+			window->references = first->references + second->references;
+			window->writes     = first->writes + second->writes;
+			window->pages      = first->pages;
+			hllMerge(&window->pages, &second->pages);
+		}
+
+		analytics->windowsNum = ANALYZE_MAX_WINDOWS / 2;
+		analytics->windowRefs *= 2;
+	}
+
+	AnalyticsWindow* window = &analytics->windows[analytics->windowsNum++];
+
+	memset(window, 0, sizeof(*window));
+
+	return window;
+}
+
+static void analyticsSample(TraceAnalytics* analytics, unsigned long long page)
+{
+	unsigned long long  position = analytics->references;
+	double              weight   = ldexp(1.0, analytics->sampleShift);
+	int                 created;
+	unsigned long long* last     = pageIndexSlot(&analytics->sampled, page, &created);
+
+	if (last == NULL)
+	{
+		return;
+	}
+
+	if (created)
+	{
+		analytics->cold += weight;
+	}
+	else
+	{
+		analytics->reuse[63 - countLeadingZeros(position - *last)] += weight;
+	}
+	*last = position;
+
+	while (analytics->sampled.count > ANALYZE_SAMPLES)
+	{
+		unsigned long long sampledPage;
+		unsigned long long sampledLast;
+		size_t             cursor  = 0;
+		size_t             dropped = 0;
+
+		analytics->sampleLimit >>= 1;
+		analytics->sampleShift++;
+
+		while ((dropped < ANALYZE_SAMPLES) && pageIndexNext(&analytics->sampled, &cursor, &sampledPage, &sampledLast))
+		{
+			if (pageHash(sampledPage ^ ANALYZE_SAMPLE_SALT) >= analytics->sampleLimit)
+			{
+				analytics->dropped[dropped++] = sampledPage;
+			}
+		}
+
+		for (size_t d = 0; d < dropped; d++)
+		{
+			pageIndexRemove(&analytics->sampled, analytics->dropped[d]);
+		}
+	}
+}
+
+void analyticsAccess(TraceAnalytics* analytics, const PageRef* ref)
+{
+	unsigned long long hash   = pageHash(ref->page);
+	AnalyticsWindow*   window = &analytics->windows[analytics->windowsNum - 1];
+
+	if (window->references == analytics->windowRefs)
+	{
+		window = analyticsNextWindow(analytics);
+	}
+
+	window->references++;
+	window->writes += ref->access == ACCESS_WRITE;
+	hllAdd(&window->pages, hash);
+
+	analytics->references++;
+	analytics->writes += ref->access == ACCESS_WRITE;
+
+	if (pageHash(ref->page ^ ANALYZE_SAMPLE_SALT) < analytics->sampleLimit)
+	{
+		analyticsSample(analytics, ref->page);
+	}
+
+	spaceSavingAdd(&analytics->top, ref->page);
+}
+
+int analyticsSink(void* context, const PageRef* refs, size_t count)
+{
+	TraceAnalytics* analytics = (TraceAnalytics*)context;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		analyticsAccess(analytics, &refs[i]);
+	}
+
+	return 0;
+}
+
+/* Credits the references the weighted sample misses to the shortest reuses, which never go below zero. */
+
+void analyticsFinish(TraceAnalytics* analytics)
+{
+	double sampled = analytics->cold;
+
+	for (int b = 0; b < ANALYZE_BUCKETS; b++)
+	{
+		sampled += analytics->reuse[b];
+	}
+
+	analytics->adjustment = (double)analytics->references - sampled;
+
+	if (analytics->reuse[0] + analytics->adjustment < 0.0)
+	{
+		analytics->adjustment = -analytics->reuse[0];
+	}
+	analytics->reuse[0] += analytics->adjustment;
+}
+
+/*************************************************************************
+*   @ End of Analytics pass                                               *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Space-Saving                                                        *
+*                                                                         *
+*  A page without a counter takes over the smallest one and inherits its  *
+*  count as the error, so every count is an upper bound and count minus   *
+*  error a lower bound of the page's references.                          *
+ *************************************************************************/
+
+static void spaceSavingSift(SpaceSaving* top, int at)
+{
+	for (;;)
+	{
+		int smallest = at;
+		int left     = 2 * at + 1;
+		int right    = left + 1;
+
+		if ((left < top->size) && (top->counts[top->heap[left]] < top->counts[top->heap[smallest]]))
+		{
+			smallest = left;
+		}
+		if ((right < top->size) && (top->counts[top->heap[right]] < top->counts[top->heap[smallest]]))
+		{
+			smallest = right;
+		}
+		if (smallest == at)
+		{
+			return;
+		}
+
+		int counter = top->heap[at];
+
+		top->heap[at]                       = top->heap[smallest];
+		top->heap[smallest]                 = counter;
+		top->position[top->heap[at]]        = at;
+		top->position[top->heap[smallest]]  = smallest;
+		at = smallest;
+	}
+}
+
+static void spaceSavingAdd(SpaceSaving* top, unsigned long long page)
+{
+	unsigned long long counter;
+
+	if (pageIndexFind(&top->slots, page, &counter))
+	{
+		top->counts[counter]++;
+		spaceSavingSift(top, top->position[counter]);
+		return;
+	}
+
+	if (top->size < ANALYZE_COUNTERS)
+	{
+		/* A new count of 1 is never above its parents, so the heap needs no sifting. */
+
+		counter = (unsigned long long)top->size;
+		top->heap[top->size]     = (int)counter;
+		top->position[counter]   = top->size++;
+		top->counts[counter]     = 0;
+		top->errors[counter]     = 0;
+	}
+	else
+	{
+		counter = (unsigned long long)top->heap[0];
+		pageIndexRemove(&top->slots, top->pages[counter]);
+		top->errors[counter] = top->counts[counter];
+	}
+
+	top->pages[counter] = page;
+	top->counts[counter]++;
+	pageIndexSet(&top->slots, page, counter);
+	spaceSavingSift(top, top->position[counter]);
+}
+
+static int compareTopPages(const void* first, const void* second)
+{
+	unsigned long long a = ((const TopPage*)first)->count;
+	unsigned long long b = ((const TopPage*)second)->count;
+
+	return (a < b) - (a > b);
+}
+
+/*************************************************************************
+*   @ End of Space-Saving                                                 *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ LRU prediction                                                      *
+*                                                                         *
+*  Reuse times are spread evenly over their bucket, so P(x) falls         *
+*  linearly inside each bucket and the footprint grows by its integral.   *
+ *************************************************************************/
+
+static double analyticsFootprintWindow(const TraceAnalytics* analytics, unsigned long long framesNum,
+	double* missRatio)
+{
+	double tail[ANALYZE_BUCKETS + 1];
+	double frames    = (double)framesNum;
+	double footprint = 1.0;
+
+	tail[ANALYZE_BUCKETS] = analytics->cold;
+
+	for (int b = ANALYZE_BUCKETS - 1; b >= 0; b--)
+	{
+		tail[b] = tail[b + 1] + analytics->reuse[b];
+	}
+
+	if (tail[0] <= 0.0)
+	{
+		*missRatio = 0.0;
+		return 0.0;
+	}
+
+	*missRatio = tail[1] / tail[0];
+
+	if (frames <= footprint)
+	{
+		return 1.0;
+	}
+
+	for (int b = 0; b < ANALYZE_BUCKETS; b++)
+	{
+		double low    = ldexp(1.0, b);
+		double width  = low;
+		double growth = width * (tail[b + 1] + analytics->reuse[b] / 2.0) / tail[0];
+
+		if ((growth > 0.0) && (footprint + growth >= frames))
+		{
+			double window = low + (frames - footprint) * width / growth;
+
+			*missRatio = (tail[b + 1] + analytics->reuse[b] * (low + width - window) / width) / tail[0];
+			return window;
+		}
+		footprint += growth;
+	}
+
+	*missRatio = analytics->cold / tail[0];
+
+	return ldexp(1.0, ANALYZE_BUCKETS);
+}
+
+double analyticsPredictLru(const TraceAnalytics* analytics, unsigned long long framesNum)
+{
+	double missRatio;
+
+	analyticsFootprintWindow(analytics, framesNum, &missRatio);
+
+	return missRatio * (double)analytics->references;
+}
+
+/*************************************************************************
+*   @ End of LRU prediction                                               *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Analyze command                                                     *
+*                                                                         *
+*  The hint compares the predicted LRU hits with the later references    *
+*  of the hottest pages that would fit (what a frequency policy keeps),   *
+*  and looks for reuses piled up just beyond memory (a loop that LRU,     *
+*  FIFO and CLOCK thrash on).                                             *
+ *************************************************************************/
+
+static void printAnalyzeHint(const TraceAnalytics* analytics, unsigned long long framesNum, const TopPage* ranked,
+	int phases, double largestWindow)
+{
+	double missRatio;
+	double window  = analyticsFootprintWindow(analytics, framesNum, &missRatio);
+	double hotRefs = 0.0;
+	double beyond  = 0.0;
+	double loop    = 0.0;
+	int    bucket  = window >= 1.0 ? 63 - countLeadingZeros((unsigned long long)window) : 0;
+
+	for (int r = 0; (r < analytics->top.size) & ((unsigned long long)r < framesNum); r++)
+	{
+		hotRefs += (double)(ranked[r].count - ranked[r].error - 1);
+	}
+
+	for (int b = bucket; b < ANALYZE_BUCKETS; b++)
+	{
+		beyond += analytics->reuse[b];
+		if ((b + 1 < ANALYZE_BUCKETS) && (analytics->reuse[b] + analytics->reuse[b + 1] > loop))
+		{
+			loop = analytics->reuse[b] + analytics->reuse[b + 1];
+		}
+	}
+
+	double hitRatio = 1.0 - missRatio;
+	double hotRatio = analytics->references ? hotRefs / (double)analytics->references : 0.0;
+	double total    = analytics->cold;
+
+	for (int b = 0; b < ANALYZE_BUCKETS; b++)
+	{
+		total += analytics->reuse[b];
+	}
+
+	printf(" Hint for %llu frames (predicted LRU hits %.1f%%, hottest pages %.1f%%):\n", framesNum,
+		100.0 * hitRatio, 100.0 * hotRatio);
+
+	if (largestWindow <= (double)framesNum)
+	{
+		printf("   Every window's working set fits, the policies differ only in cold faults; FIFO or CLOCK are enough.\n");
+	}
+	else if (hotRatio > hitRatio + 0.05)
+	{
+		printf("   Popularity beats recency at this size: expect LFU or a TinyLFU filter to win.\n");
+	}
+	else if ((total > 0.0) && (beyond > 0.25 * total) && (loop > 0.75 * beyond))
+	{
+		printf("   Reuses pile up just beyond memory (a loop): LRU, FIFO and CLOCK thrash, LFU and hawkeye keep part of it.\n");
+	}
+	else
+	{
+		printf("   Recency dominates: LRU or CLOCK should be within a few percent of the best online policy.\n");
+	}
+
+	if (phases > 0)
+	{
+		printf("   %d phase changes: counts from old phases mislead LFU, prefer recency or aging counts (tinylfu).\n",
+			phases);
+	}
+}
+
+int runAnalyzeCommand(int argCount, char* args[])
+{
+	TraceAnalytics*    analytics;
+	TopPage            ranked[ANALYZE_COUNTERS];
+	unsigned long long windowRefs = argCount > 3 ? (unsigned long long)atoll(args[3]) : ANALYZE_WINDOW_REFS;
+	long long          framesNum  = argCount > 4 ? atoll(args[4]) : 0;
+	int                topNum     = argCount > 5 ? atoi(args[5]) : 10;
+	int                format     = argCount > 2 ? traceFormatFromName(args[1]) : TRACE_FORMAT_UNKNOWN;
+	int                phases     = 0;
+	double             largest    = 0.0;
+
+	if ((format == TRACE_FORMAT_UNKNOWN) | (windowRefs < 1) | (framesNum < 0) | (topNum < 0) |
+		(topNum > ANALYZE_MAX_TOP))
+	{
+		printf("Usage: %s\n", ANALYZE_USAGE);
+		return -1;
+	}
+
+	analytics = (TraceAnalytics*)malloc(sizeof(TraceAnalytics));
+
+	if ((analytics == NULL) || (analyticsInit(analytics, windowRefs) != 0))
+	{
+		printf("Not enough memory for the analytics!\n");
+		free(analytics);
+		return -1;
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	if (loadTrace(args[2], format, 0, analyticsSink, analytics) != 0)
+	{
+		analyticsFree(analytics);
+		free(analytics);
+		return -1;
+	}
+
+	analyticsFinish(analytics);
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	HyperLogLog all;
+
+	memset(&all, 0, sizeof(all));
+	for (int w = 0; w < analytics->windowsNum; w++)
+	{
+		hllMerge(&all, &analytics->windows[w].pages);
+	}
+
+	double distinct = analytics->references ? hllEstimate(&all) : 0.0;
+	size_t bytes    = sizeof(TraceAnalytics) + (analytics->sampled.mask + 1 + analytics->top.slots.mask + 1) *
+		(1 + 2 * sizeof(unsigned long long));
+
+	printf("\n Trace %s: %llu references, ~%.0f distinct pages, %.1f%% writes, %.2f s, %llu KiB of analytics\n\n",
+		args[2], analytics->references, distinct,
+		analytics->references ? 100.0 * analytics->writes / analytics->references : 0.0, seconds,
+		(unsigned long long)(bytes / 1024));
+
+	/* Working set per window; a phase starts where the similarity falls well below the median. */
+
+	double similar[ANALYZE_MAX_WINDOWS];
+	double sorted[ANALYZE_MAX_WINDOWS];
+	int    comparisons = 0;
+
+	for (int w = 1; w < analytics->windowsNum; w++)
+	{
+		similar[w]            = windowSimilarity(&analytics->windows[w - 1], &analytics->windows[w]);
+		sorted[comparisons++] = similar[w];
+	}
+	qsort(sorted, (size_t)comparisons, sizeof(double), compareSimilarities);
+
+	double median = comparisons > 0 ? sorted[comparisons / 2] : 0.0;
+
+	printf(" Working set per window of %llu references:\n", analytics->windowRefs);
+	printf(" -------------------------------------------------------------------------\n");
+	printf("|     First      |    Length    |    Pages     | Writes | Similar | Phase |\n");
+	printf(" -------------------------------------------------------------------------\n");
+
+	for (int w = 0; w < analytics->windowsNum; w++)
+	{
+		const AnalyticsWindow* window = &analytics->windows[w];
+		double                 pages  = hllEstimate(&window->pages);
+
+		if (pages > largest)
+		{
+			largest = pages;
+		}
+
+		printf("| %14llu | %12llu | %12.0f | %5.1f%% |", (unsigned long long)w * analytics->windowRefs,
+			window->references, pages, window->references ? 100.0 * window->writes / window->references : 0.0);
+
+		if (w == 0)
+		{
+			printf("    -    |       |\n");
+		}
+		else
+		{
+			int phase = (median >= ANALYZE_PHASE_FLOOR) & (similar[w] * 100.0 < median * ANALYZE_PHASE_PCT);
+
+			phases += phase;
+			printf("  %5.2f  | %-5s |\n", similar[w], phase ? "new" : "");
+		}
+	}
+	printf(" -------------------------------------------------------------------------\n");
+	printf(" %d phase changes (Jaccard similarity with the previous window below %d%% of the median %.2f).\n\n",
+		phases, ANALYZE_PHASE_PCT, median);
+
+	/* Reuse times */
+
+	double total = analytics->cold;
+	double below = 0.0;
+
+	for (int b = 0; b < ANALYZE_BUCKETS; b++)
+	{
+		total += analytics->reuse[b];
+	}
+
+	printf(" Reuse times (%d pages sampled, 1 in %.0f, %+.0f references adjusted):\n", (int)analytics->sampled.count,
+		ldexp(1.0, analytics->sampleShift), analytics->adjustment);
+	printf(" ------------------------------------------------------------------\n");
+	printf("|        Reuse time         |   References   | Share  | Cumulative |\n");
+	printf(" ------------------------------------------------------------------\n");
+
+	for (int b = 0; (b < ANALYZE_BUCKETS) & (total > 0.0); b++)
+	{
+		if (analytics->reuse[b] <= 0.0)
+		{
+			continue;
+		}
+		below += analytics->reuse[b];
+
+		printf("| %12llu - %-12llu | %14.0f | %5.1f%% |    %6.1f%% |\n", 1ULL << b, (2ULL << b) - 1,
+			analytics->reuse[b] * analytics->references / total, 100.0 * analytics->reuse[b] / total,
+			100.0 * below / total);
+	}
+	if (total > 0.0)
+	{
+		printf("| %-25s | %14.0f | %5.1f%% |    %6.1f%% |\n", "first use", analytics->cold * analytics->references / total,
+			100.0 * analytics->cold / total, 100.0);
+	}
+	printf(" ------------------------------------------------------------------\n\n");
+
+	/* Popularity */
+
+	for (int c = 0; c < analytics->top.size; c++)
+	{
+		ranked[c].page  = analytics->top.pages[c];
+		ranked[c].count = analytics->top.counts[c];
+		ranked[c].error = analytics->top.errors[c];
+	}
+	qsort(ranked, (size_t)analytics->top.size, sizeof(TopPage), compareTopPages);
+
+	if (topNum > analytics->top.size)
+	{
+		topNum = analytics->top.size;
+	}
+
+	double upper = 0.0;
+	double lower = 0.0;
+	double sumX  = 0.0;
+	double sumY  = 0.0;
+	double sumXX = 0.0;
+	double sumXY = 0.0;
+	int    points = 0;
+
+	printf(" Most referenced pages (Space-Saving, %d counters):\n", ANALYZE_COUNTERS);
+	printf(" ----------------------------------------------------------------------\n");
+	printf("| Rank |        Page        |     Count      |   At least     | Share  |\n");
+	printf(" ----------------------------------------------------------------------\n");
+
+	for (int r = 0; r < topNum; r++)
+	{
+		printf("| %4d | %18llx | %14llu | %14llu | %5.1f%% |\n", r + 1, ranked[r].page, ranked[r].count,
+			ranked[r].count - ranked[r].error, 100.0 * ranked[r].count / analytics->references);
+
+		upper += (double)ranked[r].count;
+		lower += (double)(ranked[r].count - ranked[r].error);
+	}
+	printf(" ----------------------------------------------------------------------\n");
+
+	/* Zipf exponent: slope of log count over log rank among the guaranteed counts. */
+
+	for (int r = 0; r < analytics->top.size; r++)
+	{
+		if (ranked[r].count - ranked[r].error < 2)
+		{
+			continue;
+		}
+
+		double x = log((double)(r + 1));
+		double y = log((double)(ranked[r].count - ranked[r].error));
+
+		sumX  += x;
+		sumY  += y;
+		sumXX += x * x;
+		sumXY += x * y;
+		points++;
+	}
+
+	if (analytics->references > 0)
+	{
+		printf(" Top %d pages take %.1f%% to %.1f%% of the references", topNum,
+			100.0 * lower / analytics->references, 100.0 * upper / analytics->references);
+	}
+	if ((points > 2) && (points * sumXX - sumX * sumX > 0.0))
+	{
+		printf(", Zipf exponent %.2f", -(points * sumXY - sumX * sumY) / (points * sumXX - sumX * sumX));
+	}
+	printf(".\n\n");
+
+	/* Predicted LRU faults */
+
+	printf(" Predicted LRU faults:\n");
+	printf(" -----------------------------------------\n");
+	printf("|     Frames     |     Faults     | Rate  |\n");
+	printf(" -----------------------------------------\n");
+
+	for (unsigned long long frames = 1; frames < distinct * 2; frames *= 2)
+	{
+		double faults = analyticsPredictLru(analytics, frames);
+
+		printf("| %14llu | %14.0f |%5.1f%% |\n", frames, faults,
+			analytics->references ? 100.0 * faults / analytics->references : 0.0);
+	}
+	if (framesNum > 0)
+	{
+		double faults = analyticsPredictLru(analytics, (unsigned long long)framesNum);
+
+		printf(" -----------------------------------------\n");
+		printf("| %14lld | %14.0f |%5.1f%% |\n", framesNum, faults,
+			analytics->references ? 100.0 * faults / analytics->references : 0.0);
+	}
+	printf(" -----------------------------------------\n\n");
+
+	if ((framesNum > 0) & (analytics->references > 0))
+	{
+		printAnalyzeHint(analytics, (unsigned long long)framesNum, ranked, phases, largest);
+	}
+
+	analyticsFree(analytics);
+	free(analytics);
+
+	return 0;
+}
+
+/*************************************************************************
+*   @ End of Analyze command                                              *
+*                                                                         *
+ *************************************************************************/
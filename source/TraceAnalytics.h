@@ -0,0 +1,89 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: One pass, fixed memory profile of a trace, cheap enough to run on every capture
+ * before any policy is simulated. HyperLogLog sketches give the working set of every time
+ * window and the similarity of neighbouring windows (phase changes), a hash sampled set
+ * of pages gives the reuse time histogram and from it a predicted LRU fault curve, and
+ * Space-Saving counters give the most popular pages and the skew of the popularity.
+*/
+
+
+#ifndef TRACE_ANALYTICS_H
+#define TRACE_ANALYTICS_H
+
+#include "Trace.h"
+#include "PageIndex.h"
+
+#define ANALYZE_USAGE        "analyze <lackey|pin|csv|bin> <file> [windowRefs] [frames] [topK]"
+#define HLL_PRECISION        12
+#define HLL_REGISTERS        (1 << HLL_PRECISION)    /* 1.6% standard error */
+#define ANALYZE_WINDOW_REFS  100000
+#define ANALYZE_MAX_WINDOWS  64      /* neighbouring windows merge in pairs beyond */
+#define ANALYZE_SAMPLES      32768   /* pages whose reuse times are measured */
+#define ANALYZE_COUNTERS     1024    /* Space-Saving counters */
+#define ANALYZE_MAX_TOP      64
+#define ANALYZE_BUCKETS      64      /* reuse times by power of two */
+#define ANALYZE_SAMPLE_SALT  0x9e3779b97f4a7c15ULL  /* keeps page 0 from always being sampled */
+#define ANALYZE_PHASE_PCT    50      /* share of the median similarity below which a phase starts */
+#define ANALYZE_PHASE_FLOOR  0.1     /* median below which windows hardly overlap, no phases */
+
+
+struct HyperLogLog
+{
+	unsigned char registers[HLL_REGISTERS];
+};
+
+struct AnalyticsWindow
+{
+	unsigned long long references;
+	unsigned long long writes;
+	HyperLogLog        pages;
+};
+
+/* Counters stay in place, a min-heap orders them by count; slots maps a page to its counter. */
+
+struct SpaceSaving
+{
+	unsigned long long pages[ANALYZE_COUNTERS];
+	unsigned long long counts[ANALYZE_COUNTERS];
+	unsigned long long errors[ANALYZE_COUNTERS];     /* overestimation bound of each count */
+	int                heap[ANALYZE_COUNTERS];
+	int                position[ANALYZE_COUNTERS];   /* heap position of each counter */
+	int                size;
+	PageIndex          slots;
+};
+
+struct TraceAnalytics
+{
+	unsigned long long windowRefs;                    /* doubles whenever the windows merge */
+	AnalyticsWindow    windows[ANALYZE_MAX_WINDOWS];
+	int                windowsNum;
+	unsigned long long references;
+	unsigned long long writes;
+
+	PageIndex          sampled;                       /* sampled page -> last position */
+	unsigned long long sampleLimit;                   /* pages hashing below are sampled */
+	int                sampleShift;                   /* each sample stands for 2^shift pages */
+	unsigned long long dropped[ANALYZE_SAMPLES];
+	double             reuse[ANALYZE_BUCKETS];        /* weighted reuse times, [2^b, 2^(b+1)) */
+	double             cold;                          /* weighted first references */
+	double             adjustment;                    /* added to the shortest reuses by analyticsFinish */
+
+	SpaceSaving        top;
+};
+
+int  analyticsInit(TraceAnalytics* analytics, unsigned long long windowRefs);
+void analyticsFree(TraceAnalytics* analytics);
+void analyticsAccess(TraceAnalytics* analytics, const PageRef* ref);
+int  analyticsSink(void* context, const PageRef* refs, size_t count);
+void analyticsFinish(TraceAnalytics* analytics);
+
+double hllEstimate(const HyperLogLog* hll);
+
+/* LRU faults of a memory of framesNum frames predicted from the reuse time histogram. */
+
+double analyticsPredictLru(const TraceAnalytics* analytics, unsigned long long framesNum);
+
+int  runAnalyzeCommand(int argCount, char* args[]);
+
+#endif // !TRACE_ANALYTICS_H
@@ -0,0 +1,466 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: TraceCommands.cpp contains the command table and the trace import and trace
+ * simulation commands.
+*/
+
+
+
+#include "TraceCommands.h"
+#include "TraceParser.h"
+#include "PagingEngine.h"
+#include "FaultCapture.h"
+#include "IdleSampler.h"
+#include "MultiProcess.h"
+#include "SwapDevice.h"
+#include "Prefetcher.h"
+#include "HugePages.h"
+#include "NumaMemory.h"
+#include "Snapshot.h"
+#include "ReuseDistance.h"
+#include "Sweep.h"
+#include "ResultCache.h"
+#include "Belady.h"
+#include "LaneSim.h"
+#include "SampledLru.h"
+#include "Hawkeye.h"
+#include "GreedyDual.h"
+#include "TinyLfu.h"
+#include "Replay.h"
+#include "PageCache.h"
+#include "TraceAnalytics.h"
+#include "PageTables.h"
+#include "KernelLru.h"
+#include <string.h>
+#include <chrono>
+
+
+/* Commands. */
+
+static int runImport(int argCount, char* args[]);
+static int runTrace(int argCount, char* args[]);
+
+struct BatchCommand
+{
+	const char* name;
+	int       (*run)(int argCount, char* args[]);
+	const char* usage;
+};
+
+static const BatchCommand commands[] =
+{
+	{ "import", runImport, "import <lackey|pin|csv> <input> <output.ptr> [threads]" },
+	{ "trace", runTrace, "trace <lackey|pin|csv|bin> <file> <frames> [policy|streaming|all] [threads]" },
+	{ "capture", runCaptureCommand, CAPTURE_USAGE },
+	{ "idle", runIdleCommand, IDLE_USAGE },
+	{ "multi", runMultiCommand, MULTI_USAGE },
+	{ "swap", runSwapCommand, SWAP_USAGE },
+	{ "prefetch", runPrefetchCommand, PREFETCH_USAGE },
+	{ "huge", runHugeCommand, HUGE_USAGE },
+	{ "numa", runNumaCommand, NUMA_USAGE },
+	{ "snapshot", runSnapshotCommand, SNAPSHOT_USAGE },
+	{ "resume", runResumeCommand, RESUME_USAGE },
+	{ "reuse", runReuseCommand, REUSE_USAGE },
+	{ "sweep", runSweepCommand, SWEEP_USAGE },
+	{ "serve", runServeCommand, SERVE_USAGE },
+	{ "worker", runWorkerCommand, WORKER_USAGE },
+	{ "belady", runBeladyCommand, BELADY_USAGE },
+	{ "lanes", runLanesCommand, LANES_USAGE },
+	{ "sampled", runSampledCommand, SAMPLED_USAGE },
+	{ "hawkeye", runHawkeyeCommand, HAWKEYE_USAGE },
+	{ "cost", runCostCommand, COST_USAGE },
+	{ "tinylfu", runTinyLfuCommand, TINYLFU_USAGE },
+	{ "replay", runReplayCommand, REPLAY_USAGE },
+	{ "cachebench", runCacheBenchCommand, CACHEBENCH_USAGE },
+	{ "analyze", runAnalyzeCommand, ANALYZE_USAGE },
+	{ "pagetable", runPageTableCommand, PAGETABLE_USAGE },
+	{ "kernel", runKernelCommand, KERNEL_USAGE },
+};
+
+#define COMMANDS_NUM (int)(sizeof(commands) / sizeof(commands[0]))
+
+
+/* Engines fed by one pass over a trace. */
+
+struct TraceRun
+{
+	PagingEngine engines[POLICY_COUNT];
+	SwapDevice   devices[POLICY_COUNT];
+	int          enginesNum;
+	int          swap;
+	Arena        arena;          /* state of all engines of the run */
+	TraceDigest  digest;         /* of the references streamed, for the result cache */
+};
+
+
+/*************************************************************************
+*   @ Command dispatch                                                    *
+*                                                                         *
+ *************************************************************************/
+
+int isBatchCommand(const char* name)
+{
+	for (int i = 0; i < COMMANDS_NUM; i++)
+	{
+		if (strcmp(commands[i].name, name) == 0)
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+
+int runBatchCommand(int argCount, char* args[])
+{
+	for (int i = 0; i < COMMANDS_NUM; i++)
+	{
+		if (strcmp(commands[i].name, args[0]) == 0)
+		{
+			return commands[i].run(argCount, args);
+		}
+	}
+
+	printBatchUsage();
+	return -1;
+}
+
+void printBatchUsage()
+{
+	printf("Batch commands:\n");
+
+	for (int i = 0; i < COMMANDS_NUM; i++)
+	{
+		printf("  %s\n", commands[i].usage);
+	}
+}
+
+/*************************************************************************
+*   @ End of Command dispatch                                             *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Import                                                              *
+*                                                                         *
+*  Converts a text trace into the binary page trace format so repeated    *
+*  runs skip text parsing altogether.                                     *
+ *************************************************************************/
+
+static int runImport(int argCount, char* args[])
+{
+	TraceWriter writer;
+	int         format;
+	int         status;
+
+	if (argCount < 4)
+	{
+		printf("Usage: %s\n", commands[0].usage);
+		return -1;
+	}
+
+	format = traceFormatFromName(args[1]);
+
+	if ((format == TRACE_FORMAT_UNKNOWN) | (format == TRACE_FORMAT_BINARY))
+	{
+		printf("'%s' is not a text trace format!\n", args[1]);
+		return -1;
+	}
+
+	if (traceWriterOpen(&writer, args[3]) != 0)
+	{
+		return -1;
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	status = loadTrace(args[2], format, argCount > 4 ? atoi(args[4]) : 0, traceWriterSink, &writer);
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	if ((traceWriterClose(&writer) != 0) | (status != 0))
+	{
+		printf("Import failed!\n");
+		return -1;
+	}
+
+	printf("Imported %llu page references in %.2f s.\n", writer.count, seconds);
+
+	return 0;
+}
+
+/*************************************************************************
+*   @ End of Import                                                       *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Trace                                                               *
+*                                                                         *
+*  Streams a trace through one or all engines in a single pass. OPT needs *
+*  the whole future, so when it is selected the trace is first loaded     *
+*  into memory and its next-use positions are computed.                   *
+ *************************************************************************/
+
+static int traceRunSink(void* context, const PageRef* refs, size_t count)
+{
+	TraceRun*    run = (TraceRun*)context;
+	AccessResult result;
+
+	traceDigestRefs(&run->digest, refs, count);
+
+	for (int e = 0; e < run->enginesNum; e++)
+	{
+		PagingEngine* engine = &run->engines[e];
+
+		if (run->swap)
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				engineAccess(engine, &refs[i], &result);
+				swapDeviceAccess(&run->devices[e], &result);
+			}
+			continue;
+		}
+
+		for (size_t i = 0; i < count; i++)
+		{
+			engineAccess(engine, &refs[i], &result);
+		}
+	}
+
+	return 0;
+}
+
+int policySelectionFromName(const char* name)
+{
+	if ((name == NULL) || (strcmp(name, "streaming") == 0))
+	{
+		return POLICY_STREAMING;
+	}
+
+	return strcmp(name, "all") == 0 ? POLICY_COUNT : policyFromName(name);
+}
+
+static int isSelected(int selected, int policy)
+{
+	return (selected == policy) | (selected == POLICY_COUNT) |
+		((selected == POLICY_STREAMING) & (policy != POLICY_OPT));
+}
+
+static int runTrace(int argCount, char* args[])
+{
+	int format;
+	int framesNum;
+	int selected;
+
+	if (argCount < 4)
+	{
+		printf("Usage: %s\n", commands[1].usage);
+		return -1;
+	}
+
+	format    = traceFormatFromName(args[1]);
+	framesNum = atoi(args[3]);
+	selected  = policySelectionFromName(argCount > 4 ? args[4] : NULL);
+
+	if ((format == TRACE_FORMAT_UNKNOWN) | (framesNum < 1) | (selected < 0))
+	{
+		printf("Usage: %s\n", commands[1].usage);
+		return -1;
+	}
+
+	return simulateTraceFile(args[2], format, framesNum, selected, argCount > 5 ? atoi(args[5]) : 0, NULL);
+}
+
+static void printSwapTable(const TraceRun* run)
+{
+	const SwapConfig* config = &run->devices[0].config;
+
+	printf(" Swap device: %.1f us read, %.1f us write, %.0f MB/s, queue depth %d, %llu ns per reference\n\n",
+		config->readLatencyNs / 1000.0, config->writeLatencyNs / 1000.0, config->bytesPerSecond / 1000000.0,
+		config->queueDepth, config->referenceNs);
+	printf(" ---------------------------------------------------------------------------\n");
+	printf("| Policy |     Faults     |  Write-backs   |  Stall (ms)  | Behind WB (ms)  |\n");
+	printf(" ---------------------------------------------------------------------------\n");
+
+	for (int e = 0; e < run->enginesNum; e++)
+	{
+		const SwapStats* stats = &run->devices[e].stats;
+
+		printf("| %-6s | %14llu | %14llu | %12.3f | %15.3f |\n", policyName(run->engines[e].policy),
+			run->engines[e].stats.faults, run->engines[e].stats.writebacks,
+			stats->stallNs / 1000000.0, stats->writebackWaitNs / 1000000.0);
+	}
+	printf(" ---------------------------------------------------------------------------\n");
+}
+
+int simulateTraceFile(const char* path, int format, int framesNum, int selected, int threads,
+	const SwapConfig* swap)
+{
+	TraceRun            run;
+	TraceBuffer         buffer;
+	ResultKey           key;
+	TraceIdentity       identity;
+	EngineStats         cached[POLICY_COUNT];
+	int                 hit[POLICY_COUNT];
+	int                 hits    = 0;
+	unsigned long long* nextUse = NULL;
+	int                 status  = 0;
+
+	run.enginesNum = 0;
+	run.swap       = swap != NULL;
+	memset(run.devices, 0, sizeof(run.devices));
+	arenaInit(&run.arena, 0);
+	traceDigestInit(&run.digest);
+
+	/* Swap runs are not cached: their device statistics are not part of a cache record. */
+
+	int cacheable = !run.swap && (resultKeyInit(&key, &identity, path, format) == 0);
+
+	key.framesNum = framesNum;
+
+	for (int policy = 0; policy < POLICY_COUNT; policy++)
+	{
+		key.policy  = policy;
+		hit[policy] = cacheable && isSelected(selected, policy) && resultCacheFind(&key, &cached[policy]);
+		hits       += hit[policy];
+
+		if (isSelected(selected, policy) && !hit[policy])
+		{
+			int failed = engineCreateIn(&run.engines[run.enginesNum], &run.arena, policy, framesNum) != 0;
+
+			if (!failed && run.swap)
+			{
+				failed = swapDeviceCreate(&run.devices[run.enginesNum], swap) != 0;
+			}
+
+			if (failed)
+			{
+				printf("Not enough memory for %d frames!\n", framesNum);
+
+				for (int e = 0; e <= run.enginesNum; e++)
+				{
+					engineDestroy(&run.engines[e]);
+					swapDeviceDestroy(&run.devices[e]);
+				}
+				arenaFree(&run.arena);
+				return -1;
+			}
+			run.enginesNum++;
+		}
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	if (run.enginesNum == 0)
+	{
+		/* Every result came from the cache. */
+	}
+	else if (isSelected(selected, POLICY_OPT) && !hit[POLICY_OPT])
+	{
+		traceBufferInit(&buffer);
+		status = loadTrace(path, format, threads, traceBufferSink, &buffer);
+
+		if (status == 0)
+		{
+			nextUse = (unsigned long long*)malloc((buffer.count + 1) * sizeof(unsigned long long));
+			status  = (nextUse == NULL) || (computeNextUse(buffer.refs, buffer.count, nextUse) != 0) ? -1 : 0;
+		}
+
+		if (status == 0)
+		{
+			for (int e = 0; e < run.enginesNum; e++)
+			{
+				engineSetFuture(&run.engines[e], nextUse);
+			}
+			traceRunSink(&run, buffer.refs, buffer.count);
+		}
+		traceBufferFree(&buffer);
+	}
+	else
+	{
+		status = loadTrace(path, format, threads, traceRunSink, &run);
+	}
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	if (status == 0)
+	{
+		unsigned long long references = run.enginesNum > 0 ? run.engines[0].stats.references : 0;
+
+		if (cacheable & (run.enginesNum > 0))
+		{
+			unsigned long long digest[2];
+
+			traceDigestFinal(&run.digest, digest);
+			resultKeyFinish(&key, &identity, digest);
+		}
+
+		for (int e = 0; (e < run.enginesNum) & cacheable; e++)
+		{
+			key.policy = run.engines[e].policy;
+			resultCacheStore(&key, &run.engines[e].stats);
+		}
+
+		for (int policy = 0; (policy < POLICY_COUNT) & (run.enginesNum == 0); policy++)
+		{
+			references = hit[policy] ? cached[policy].references : references;
+		}
+
+		printf("\n Trace %s: %llu references, %d frames, %.2f s", path, references, framesNum, seconds);
+
+		if (hits > 0)
+		{
+			printf(", %d from cache", hits);
+		}
+		printf("\n\n");
+		printf(" --------------------------------------------------\n");
+		printf("| Policy |     Faults     |   Evictions    | Rate  |\n");
+		printf(" --------------------------------------------------\n");
+
+		for (int policy = 0, e = 0; policy < POLICY_COUNT; policy++)
+		{
+			EngineStats* stats;
+
+			if (hit[policy])
+			{
+				stats = &cached[policy];
+			}
+			else if ((e < run.enginesNum) && (run.engines[e].policy == policy))
+			{
+				stats = &run.engines[e++].stats;
+			}
+			else
+			{
+				continue;
+			}
+
+			printf("| %-6s | %14llu | %14llu |%5.1f%% |\n", policyName(policy), stats->faults, stats->evictions,
+				references ? 100.0 * (double)stats->faults / (double)references : 0.0);
+		}
+		printf(" --------------------------------------------------\n");
+
+		if (run.swap)
+		{
+			printf("\n");
+			printSwapTable(&run);
+		}
+	}
+
+	for (int e = 0; e < run.enginesNum; e++)
+	{
+		engineDestroy(&run.engines[e]);
+		swapDeviceDestroy(&run.devices[e]);
+	}
+	arenaFree(&run.arena);
+	free(nextUse);
+
+	return status == 0 ? 0 : -1;
+}
+
+/*************************************************************************
+*   @ End of Trace                                                        *
+*                                                                         *
+ *************************************************************************/
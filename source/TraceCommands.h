@@ -0,0 +1,37 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: Non-interactive commands selected on the command line by a keyword in place of
+ * the number of physical frames, e.g. "simulator trace lackey run.trace 64 all".
+*/
+
+
+#ifndef TRACE_COMMANDS_H
+#define TRACE_COMMANDS_H
+
+struct SwapConfig;
+
+#define POLICY_STREAMING     (POLICY_COUNT + 1)   /* selected: every policy but OPT */
+
+
+/* args[0] is the command keyword. */
+
+int isBatchCommand(const char* name);
+int runBatchCommand(int argCount, char* args[]);
+void printBatchUsage();
+
+
+/* Maps a policy argument to a selection: a policy name, "all" (POLICY_COUNT) or, when
+ * absent or "streaming", POLICY_STREAMING; OPT keeps the whole trace in memory, so it only
+ * runs when asked for. -1 for an unknown name. */
+
+int policySelectionFromName(const char* name);
+
+
+/* Runs one policy, every policy when selected is POLICY_COUNT, or every policy but OPT
+ * for POLICY_STREAMING, over a trace file. With a swap configuration every engine also
+ * drives its own swap device. */
+
+int simulateTraceFile(const char* path, int format, int framesNum, int selected, int threads,
+	const SwapConfig* swap);
+
+#endif // !TRACE_COMMANDS_H
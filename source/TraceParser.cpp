@@ -0,0 +1,740 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: TraceParser.cpp contains the text trace importers. Numbers are scanned eight
+ * characters at a time inside a 64-bit register (SWAR), lines never go through scanf, and
+ * every block of the file is split at line boundaries and parsed by several threads while
+ * the next block is being read.
+*/
+
+
+
+#include "TraceParser.h"
+#include "Bits.h"
+#include <string.h>
+#include <thread>
+
+#define SWAR_ONES 0x0101010101010101ULL
+#define SWAR_HIGH 0x8080808080808080ULL
+#define SWAR_PAD  16
+
+#define TRACE_MAX_SPAN_PAGES 4096
+
+
+/* The references one thread parsed from its slice of a block, and what went wrong. */
+
+struct TraceSlice
+{
+	TraceBuffer        refs;
+	unsigned long long truncated;   /* accesses cut to TRACE_MAX_SPAN_PAGES pages */
+	int                failed;      /* out of memory: references were lost */
+};
+
+
+/* Parser functions. */
+
+static int  parseTextTrace(const char* path, int format, int threads, TraceSink sink, void* context);
+static void parseSlice(const char* begin, const char* end, int format, TraceSlice* out);
+static const char* parseLackeyLine(const char* p, TraceSlice* out);
+static const char* parsePinLine(const char* p, TraceSlice* out);
+static const char* parseCsvLine(const char* p, TraceSlice* out);
+
+
+/*************************************************************************
+*   @ SWAR number scanning                                                *
+*                                                                         *
+*  A word of eight characters is classified with byte-wise range checks   *
+*  and converted without branching per character. Callers guarantee       *
+*  SWAR_PAD readable bytes after the end of every buffer.                 *
+ *************************************************************************/
+
+static inline unsigned long long loadWord(const char* p)
+{
+	unsigned long long word;
+
+	memcpy(&word, p, sizeof(word));
+	return word;
+}
+
+static inline int lowestSetByte(unsigned long long mask)
+{
+	return countTrailingZeros(mask) >> 3;
+}
+
+/* 0x80 in every byte of word that lies in [lo, hi]. */
+
+static inline unsigned long long bytesInRange(unsigned long long word, unsigned char lo, unsigned char hi)
+{
+	unsigned long long low7  = word & ~SWAR_HIGH;
+	unsigned long long above = low7 + SWAR_ONES * (unsigned char)(0x80 - lo);
+	unsigned long long past  = low7 + SWAR_ONES * (unsigned char)(0x7F - hi);
+
+	return above & ~past & ~word & SWAR_HIGH;
+}
+
+static inline unsigned long long hexLetters(unsigned long long word)
+{
+	return bytesInRange(word | (SWAR_ONES * 0x20), 'a', 'f');
+}
+
+/* Number of leading characters of the word accepted by mask (0..8). */
+
+static inline int leadingRun(unsigned long long mask)
+{
+	unsigned long long rejected = ~mask & SWAR_HIGH;
+
+	return rejected == 0 ? 8 : lowestSetByte(rejected);
+}
+
+static inline unsigned long long hexChunk(unsigned long long word, int digits)
+{
+	unsigned long long letters = hexLetters(word) >> 7;
+	unsigned long long nibbles = (word & (SWAR_ONES * 0x0F)) + letters * 9;
+
+	nibbles <<= (8 - digits) * 8;
+	nibbles = ((nibbles << 4) | (nibbles >> 8)) & 0x00FF00FF00FF00FFULL;
+	nibbles = ((nibbles << 8) | (nibbles >> 16)) & 0x0000FFFF0000FFFFULL;
+	nibbles = ((nibbles << 16) | (nibbles >> 32)) & 0x00000000FFFFFFFFULL;
+
+	return nibbles;
+}
+
+static inline unsigned long long decimalChunk(unsigned long long word, int digits)
+{
+	unsigned long long value = (word - SWAR_ONES * '0') << ((8 - digits) * 8);
+
+	value = (value * 10) + (value >> 8);
+	value = (((value & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+		(((value >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+
+	return value;
+}
+
+static const char* scanHex(const char* p, unsigned long long* result)
+{
+	static const unsigned long long shiftScale[9] = { 1, 0x10, 0x100, 0x1000, 0x10000, 0x100000,
+		0x1000000, 0x10000000, 0x100000000ULL };
+	unsigned long long value = 0;
+
+	if ((p[0] == '0') & ((p[1] | 0x20) == 'x'))
+	{
+		p += 2;
+	}
+
+	for (;;)
+	{
+		unsigned long long word = loadWord(p);
+		int digits = leadingRun(bytesInRange(word, '0', '9') | hexLetters(word));
+
+		if (digits == 0)
+		{
+			break;
+		}
+		value = value * shiftScale[digits] + hexChunk(word, digits);
+		p += digits;
+
+		if (digits < 8)
+		{
+			break;
+		}
+	}
+
+	*result = value;
+	return p;
+}
+
+static const char* scanDecimal(const char* p, unsigned long long* result, int* count)
+{
+	static const unsigned long long powers[9] = { 1, 10, 100, 1000, 10000, 100000,
+		1000000, 10000000, 100000000 };
+	unsigned long long value = 0;
+	int total = 0;
+
+	for (;;)
+	{
+		unsigned long long word = loadWord(p);
+		int digits = leadingRun(bytesInRange(word, '0', '9'));
+
+		if (digits == 0)
+		{
+			break;
+		}
+		value  = value * powers[digits] + decimalChunk(word, digits);
+		p     += digits;
+		total += digits;
+
+		if (digits < 8)
+		{
+			break;
+		}
+	}
+
+	*result = value;
+
+	if (count != NULL)
+	{
+		*count = total;
+	}
+	return p;
+}
+
+static inline const char* skipBlanks(const char* p)
+{
+	while ((*p == ' ') | (*p == '\t'))
+	{
+		p++;
+	}
+	return p;
+}
+
+static inline const char* nextLine(const char* p)
+{
+	const char* newline = (const char*)strchr(p, '\n');
+
+	return newline != NULL ? newline + 1 : p + strlen(p) + 1;
+}
+
+/*************************************************************************
+*   @ End of SWAR number scanning                                         *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Reference emission                                                  *
+*                                                                         *
+*  An access of size bytes at address touches every page it spans; each   *
+*  of them becomes one reference. Longer accesses are cut to              *
+*  TRACE_MAX_SPAN_PAGES pages and counted, so the importer can warn.      *
+ *************************************************************************/
+
+static void emitAccess(TraceSlice* out, unsigned long long address, unsigned long long size,
+	unsigned long long time, unsigned int pid, unsigned char access)
+{
+	unsigned long long first = address >> TRACE_PAGE_SHIFT;
+	unsigned long long last  = (address + (size > 0 ? size - 1 : 0)) >> TRACE_PAGE_SHIFT;
+
+	if (last - first >= TRACE_MAX_SPAN_PAGES)
+	{
+		last = first + TRACE_MAX_SPAN_PAGES - 1;
+		out->truncated++;
+	}
+
+	if (traceBufferReserve(&out->refs, out->refs.count + (size_t)(last - first + 1)) != 0)
+	{
+		out->failed = 1;
+		return;
+	}
+
+	for (unsigned long long page = first; page <= last; page++)
+	{
+		PageRef* ref = &out->refs.refs[out->refs.count++];
+
+		ref->page   = page;
+		ref->time   = time;
+		ref->pid    = pid;
+		ref->access = access;
+	}
+}
+
+/*************************************************************************
+*   @ End of Reference emission                                           *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Valgrind Lackey lines                                               *
+*                                                                         *
+*  "I  04000000,3", " L 7ff000398,8", " S ...", " M ..." - everything     *
+*  else (the ==pid== banner lines) is skipped.                            *
+ *************************************************************************/
+
+static const char* parseLackeyLine(const char* p, TraceSlice* out)
+{
+	unsigned long long address;
+	unsigned long long size = 1;
+	unsigned char      access;
+
+	p = skipBlanks(p);
+
+	switch (*p)
+	{
+	case 'I':
+		access = ACCESS_FETCH;
+		break;
+	case 'L':
+		access = ACCESS_READ;
+		break;
+	case 'S':
+	case 'M':
+		access = ACCESS_WRITE;
+		break;
+	default:
+		return nextLine(p);
+	}
+
+	p = scanHex(skipBlanks(p + 1), &address);
+
+	if (*p == ',')
+	{
+		p = scanDecimal(p + 1, &size, NULL);
+	}
+
+	emitAccess(out, address, size, 0, 0, access);
+
+	return nextLine(p);
+}
+
+/*************************************************************************
+*   @ End of Valgrind Lackey lines                                        *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Pin pinatrace lines                                                 *
+*                                                                         *
+*  "0x7f2a5c0d1e1f: W 0x7ffd9b2a1c38 [size]"; '#' lines are comments.     *
+ *************************************************************************/
+
+static const char* parsePinLine(const char* p, TraceSlice* out)
+{
+	unsigned long long ip;
+	unsigned long long address;
+	unsigned long long size = 1;
+	unsigned char      access;
+
+	p = skipBlanks(p);
+
+	if ((*p == '#') | (*p == '\n') | (*p == '\r'))
+	{
+		return nextLine(p);
+	}
+
+	p = skipBlanks(scanHex(p, &ip));
+
+	if (*p == ':')
+	{
+		p = skipBlanks(p + 1);
+	}
+
+	if ((*p | 0x20) == 'r')
+	{
+		access = ACCESS_READ;
+	}
+	else if ((*p | 0x20) == 'w')
+	{
+		access = ACCESS_WRITE;
+	}
+	else
+	{
+		return nextLine(p);
+	}
+
+	p = scanHex(skipBlanks(p + 1), &address);
+	p = skipBlanks(p);
+
+	if ((*p >= '0') & (*p <= '9'))
+	{
+		p = scanDecimal(p, &size, NULL);
+	}
+
+	emitAccess(out, address, size, 0, 0, access);
+
+	return nextLine(p);
+}
+
+/*************************************************************************
+*   @ End of Pin pinatrace lines                                          *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ blktrace style CSV lines                                            *
+*                                                                         *
+*  "seconds.fraction,pid,rwbs,sector,bytes" with 512 byte sectors, as     *
+*  produced by blkparse -f "%T.%t,%p,%d,%S,%N\n". A header line or any    *
+*  line not starting with a digit is skipped.                             *
+ *************************************************************************/
+
+static const char* parseCsvLine(const char* p, TraceSlice* out)
+{
+	unsigned long long seconds;
+	unsigned long long fraction = 0;
+	unsigned long long pid;
+	unsigned long long sector;
+	unsigned long long bytes;
+	unsigned char      access = ACCESS_READ;
+	int                digits = 0;
+
+	p = skipBlanks(p);
+
+	if ((*p < '0') | (*p > '9'))
+	{
+		return nextLine(p);
+	}
+
+	p = scanDecimal(p, &seconds, NULL);
+
+	if (*p == '.')
+	{
+		p = scanDecimal(p + 1, &fraction, &digits);
+
+		for (; digits < 9; digits++)
+		{
+			fraction *= 10;
+		}
+		for (; digits > 9; digits--)
+		{
+			fraction /= 10;
+		}
+	}
+
+	if (*p++ != ',')
+	{
+		return nextLine(p - 1);
+	}
+	p = scanDecimal(skipBlanks(p), &pid, NULL);
+
+	if (*p++ != ',')
+	{
+		return nextLine(p - 1);
+	}
+
+	for (p = skipBlanks(p); (*p != ',') & (*p != '\n') & (*p != '\0'); p++)
+	{
+		if (*p == 'W')
+		{
+			access = ACCESS_WRITE;
+		}
+	}
+
+	if (*p++ != ',')
+	{
+		return nextLine(p - 1);
+	}
+	p = scanDecimal(skipBlanks(p), &sector, NULL);
+
+	if (*p++ != ',')
+	{
+		return nextLine(p - 1);
+	}
+	p = scanDecimal(skipBlanks(p), &bytes, NULL);
+
+	emitAccess(out, sector * 512, bytes, seconds * 1000000000ULL + fraction, (unsigned int)pid, access);
+
+	return nextLine(p);
+}
+
+/*************************************************************************
+*   @ End of blktrace style CSV lines                                     *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Parse slice                                                         *
+*                                                                         *
+*  Parses the complete lines in [begin, end) into out. *end must be a     *
+*  '\0' so the line scanners stop at the slice boundary. Parsing stops    *
+*  when a reference could not be stored.                                  *
+ *************************************************************************/
+
+static void parseSlice(const char* begin, const char* end, int format, TraceSlice* out)
+{
+	const char* p = begin;
+
+	out->refs.count = 0;
+	out->truncated  = 0;
+
+	while ((p < end) & !out->failed)
+	{
+		switch (format)
+		{
+		case TRACE_FORMAT_LACKEY:
+			p = parseLackeyLine(p, out);
+			break;
+		case TRACE_FORMAT_PIN:
+			p = parsePinLine(p, out);
+			break;
+		default:
+			p = parseCsvLine(p, out);
+			break;
+		}
+	}
+}
+
+/*************************************************************************
+*   @ End of Parse slice                                                  *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Parse text trace                                                    *
+*                                                                         *
+*  The file is read in blocks of threads * TRACE_BLOCK_BYTES. A block is  *
+*  cut after its last newline (the remainder is carried into the next     *
+*  block), divided into one slice per thread at newline boundaries, and   *
+*  parsed in parallel while the main thread reads the following block.    *
+*  Slices are handed to the sink strictly in file order. A slice that ran *
+*  out of memory fails the whole import, and cut spans are reported.      *
+ *************************************************************************/
+
+static int parseTextTrace(const char* path, int format, int threads, TraceSink sink, void* context)
+{
+	TraceSlice         slices[TRACE_MAX_THREADS];
+	const char*        bounds[TRACE_MAX_THREADS + 1];
+	std::thread        workers[TRACE_MAX_THREADS];
+	size_t             blockBytes = (size_t)threads * TRACE_BLOCK_BYTES;
+	size_t             filled[2]  = { 0, 0 };
+	char*              blocks[2];
+	unsigned long long truncated  = 0;
+	int                current    = 0;
+	int                status     = 0;
+	int                eof        = 0;
+
+	FILE* file = fopen(path, "rb");
+
+	if (file == NULL)
+	{
+		printf("Cannot open trace file '%s'!\n", path);
+		return -1;
+	}
+
+	blocks[0] = (char*)malloc(blockBytes + SWAR_PAD);
+	blocks[1] = (char*)malloc(blockBytes + SWAR_PAD);
+
+	if ((blocks[0] == NULL) | (blocks[1] == NULL))
+	{
+		free(blocks[0]);
+		free(blocks[1]);
+		fclose(file);
+		return -1;
+	}
+
+	for (int t = 0; t < threads; t++)
+	{
+		traceBufferInit(&slices[t].refs);
+		slices[t].truncated = 0;
+		slices[t].failed    = 0;
+	}
+
+	filled[current] = fread(blocks[current], 1, blockBytes, file);
+	eof = filled[current] < blockBytes;
+
+	while ((filled[current] > 0) & (status == 0))
+	{
+		char*  block = blocks[current];
+		char*  spare = blocks[1 - current];
+		size_t used  = filled[current];
+		size_t carry = 0;
+
+		/* Cut after the last complete line; a final line without newline is kept when at EOF. */
+
+		if (!eof)
+		{
+			while ((used > 0) && (block[used - 1] != '\n'))
+			{
+				used--;
+			}
+
+			if (used == 0)
+			{
+				printf("Trace line longer than %u bytes!\n", (unsigned int)blockBytes);
+				status = -1;
+				break;
+			}
+			carry = filled[current] - used;
+			memcpy(spare, block + used, carry);
+		}
+		memset(block + used, 0, SWAR_PAD);
+
+		bounds[0] = block;
+
+		for (int t = 1; t < threads; t++)
+		{
+			const char* cut = block + used * t / threads;
+
+			if (cut < bounds[t - 1])
+			{
+				cut = bounds[t - 1];
+			}
+
+			const char* newline = (const char*)memchr(cut, '\n', block + used - cut);
+			bounds[t] = newline != NULL ? newline + 1 : block + used;
+		}
+		bounds[threads] = block + used;
+
+		for (int t = 0; t < threads; t++)
+		{
+			workers[t] = std::thread(parseSlice, bounds[t], bounds[t + 1], format, &slices[t]);
+		}
+
+		/* Read ahead while the workers parse; slices only read below block + used. */
+
+		filled[1 - current] = carry;
+
+		if (!eof)
+		{
+			size_t got = fread(spare + carry, 1, blockBytes - carry, file);
+
+			filled[1 - current] += got;
+			eof = got < blockBytes - carry;
+		}
+
+		for (int t = 0; t < threads; t++)
+		{
+			workers[t].join();
+		}
+
+		for (int t = 0; (t < threads) & (status == 0); t++)
+		{
+			truncated += slices[t].truncated;
+
+			if (slices[t].failed)
+			{
+				printf("Out of memory while parsing '%s'!\n", path);
+				status = -1;
+			}
+			else if ((slices[t].refs.count > 0) && (sink(context, slices[t].refs.refs, slices[t].refs.count) != 0))
+			{
+				status = 1;
+			}
+		}
+
+		current = 1 - current;
+	}
+
+	if (truncated > 0)
+	{
+		printf("%llu accesses of '%s' span more than %d pages; only their first %d pages were kept!\n",
+			truncated, path, TRACE_MAX_SPAN_PAGES, TRACE_MAX_SPAN_PAGES);
+	}
+
+	for (int t = 0; t < threads; t++)
+	{
+		traceBufferFree(&slices[t].refs);
+	}
+	free(blocks[0]);
+	free(blocks[1]);
+	fclose(file);
+
+	return status;
+}
+
+/*************************************************************************
+*   @ End of Parse text trace                                             *
+*                                                                         *
+ *************************************************************************/
+
+
+/*************************************************************************
+*   @ Load trace                                                          *
+*                                                                         *
+*  Format dispatch for every trace consumer.                              *
+ *************************************************************************/
+
+int traceFormatFromName(const char* name)
+{
+	if (strcmp(name, "lackey") == 0)
+	{
+		return TRACE_FORMAT_LACKEY;
+	}
+	if (strcmp(name, "pin") == 0)
+	{
+		return TRACE_FORMAT_PIN;
+	}
+	if (strcmp(name, "csv") == 0)
+	{
+		return TRACE_FORMAT_CSV;
+	}
+	if (strcmp(name, "bin") == 0)
+	{
+		return TRACE_FORMAT_BINARY;
+	}
+	return TRACE_FORMAT_UNKNOWN;
+}
+
+int loadTrace(const char* path, int format, int threads, TraceSink sink, void* context)
+{
+	if (format == TRACE_FORMAT_BINARY)
+	{
+		return readBinaryTrace(path, sink, context);
+	}
+
+	if ((format < TRACE_FORMAT_LACKEY) | (format > TRACE_FORMAT_CSV))
+	{
+		printf("Unknown trace format!\n");
+		return -1;
+	}
+
+	if (threads <= 0)
+	{
+		threads = (int)std::thread::hardware_concurrency();
+	}
+	if (threads < 1)
+	{
+		threads = 1;
+	}
+	if (threads > TRACE_MAX_THREADS)
+	{
+		threads = TRACE_MAX_THREADS;
+	}
+
+	return parseTextTrace(path, format, threads, sink, context);
+}
+
+/* Drops the references before the first wanted one; binary traces seek there instead. */
+
+struct SkipContext
+{
+	unsigned long long skip;
+	TraceSink          sink;
+	void*              context;
+};
+
+static int skipSink(void* context, const PageRef* refs, size_t count)
+{
+	SkipContext* skip = (SkipContext*)context;
+
+	if (skip->skip >= count)
+	{
+		skip->skip -= count;
+		return 0;
+	}
+
+	refs        += skip->skip;
+	count       -= (size_t)skip->skip;
+	skip->skip   = 0;
+
+	return skip->sink(skip->context, refs, count);
+}
+
+int loadTraceFrom(const char* path, int format, int threads, unsigned long long first, TraceSink sink,
+	void* context)
+{
+	SkipContext skip;
+
+	if (first == 0)
+	{
+		return loadTrace(path, format, threads, sink, context);
+	}
+
+	if (format == TRACE_FORMAT_BINARY)
+	{
+		return readBinaryTraceFrom(path, first, sink, context);
+	}
+
+	skip.skip    = first;
+	skip.sink    = sink;
+	skip.context = context;
+
+	return loadTrace(path, format, threads, skipSink, &skip);
+}
+
+/*************************************************************************
+*   @ End of Load trace                                                   *
+*                                                                         *
+ *************************************************************************/
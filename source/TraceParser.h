@@ -0,0 +1,38 @@
+/* Date: 10/18/2026
+ *
+ * Purpose: Streaming importers for memory traces recorded by other tools. Text traces are
+ * split into blocks, parsed on several threads and handed to a sink in trace order.
+*/
+
+
+#ifndef TRACE_PARSER_H
+#define TRACE_PARSER_H
+
+#include "Trace.h"
+
+#define TRACE_FORMAT_LACKEY  0   /* valgrind --tool=lackey --trace-mem=yes */
+#define TRACE_FORMAT_PIN     1   /* pinatrace: "<ip>: R|W <address> [size]" */
+#define TRACE_FORMAT_CSV     2   /* blkparse style: time,pid,rwbs,sector,bytes */
+#define TRACE_FORMAT_BINARY  3   /* binary page trace written by 'import' */
+#define TRACE_FORMAT_UNKNOWN -1
+
+#define TRACE_BLOCK_BYTES    (8 << 20)
+#define TRACE_MAX_THREADS    64
+
+
+/* Maps "lackey", "pin", "csv" or "bin" to a TRACE_FORMAT_ value. */
+
+int traceFormatFromName(const char* name);
+
+
+/* Parses a trace of any supported format; threads <= 0 uses all hardware threads. */
+
+int loadTrace(const char* path, int format, int threads, TraceSink sink, void* context);
+
+
+/* Same, but the sink only receives the references from position first on. */
+
+int loadTraceFrom(const char* path, int format, int threads, unsigned long long first, TraceSink sink,
+	void* context);
+
+#endif // !TRACE_PARSER_H
@@ -5,26 +5,31 @@
 */
 
 #include "MemoryManager.h"
+#include "TraceCommands.h"
 
 int main(int argv, char* argc[])
 {
 	if (argv < 2)
 	{
 		printf("Number of physical pages required! Please check command line arguments!\n");
+		printBatchUsage();
 
 		return -1;
 	}
 
 
-	/* Checking physical frames number is between 1 and 8 and correcting it if it is not. */
+	/* A command keyword in place of the frame count runs a batch command instead of the menu. */
 
-	int physicalFramesNum = atoi(argc[1]);
-
-	if (physicalFramesNum > 8)
+	if (isBatchCommand(argc[1]))
 	{
-		physicalFramesNum = 8;
+		return runBatchCommand(argv - 1, argc + 1);
 	}
 
+
+	/* Checking physical frames number is at least 1 and correcting it if it is not; the menu sizes its buffers from it. */
+
+	int physicalFramesNum = atoi(argc[1]);
+
 	if (physicalFramesNum < 1)
 	{
 		physicalFramesNum = 1;